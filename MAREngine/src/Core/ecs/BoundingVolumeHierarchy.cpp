@@ -0,0 +1,512 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+
+
+#include "BoundingVolumeHierarchy.h"
+#include "../graphics/public/FrustumCuller.h"
+
+
+namespace marengine {
+
+	static FBoundingBox computeUnion(const FBoundingBox& a, const FBoundingBox& b);
+	static float computeArea(const FBoundingBox& box);
+	static bool areOverlapping(const FBoundingBox& a, const FBoundingBox& b);
+	static float getAxis(const maths::vec3& v, uint32 axis);
+
+	static constexpr uint32 g_binsCount{ 12 };
+
+
+	void FBoundingVolumeHierarchy::build(const std::vector<entt::entity>& entities, const std::vector<FBoundingBox>& boxes) {
+		clear();
+		if (entities.empty()) {
+			return;
+		}
+
+		std::vector<FBuildPrimitive> primitives;
+		primitives.reserve(entities.size());
+		for (size_t i = 0; i < entities.size(); i++) {
+			const FBoundingBox& box{ boxes[i] };
+			const maths::vec3 centroid{
+				(box.min.x + box.max.x) * 0.5f, (box.min.y + box.max.y) * 0.5f, (box.min.z + box.max.z) * 0.5f
+			};
+			primitives.push_back({ box, centroid, entities[i] });
+		}
+
+		m_nodes.reserve(2 * primitives.size() - 1);
+		m_leaves.reserve(primitives.size());
+		m_root = buildRange(primitives, 0, primitives.size(), s_nullNode);
+	}
+
+	void FBoundingVolumeHierarchy::clear() {
+		m_nodes.clear();
+		m_freeNodes.clear();
+		m_leaves.clear();
+		m_root = s_nullNode;
+	}
+
+	void FBoundingVolumeHierarchy::update(entt::entity entity, const FBoundingBox& box) {
+		const auto it{ m_leaves.find(entity) };
+		if (it == m_leaves.end()) {
+			const int32 leaf{ allocateNode() };
+			m_nodes[leaf].box = box;
+			m_nodes[leaf].entity = entity;
+			m_leaves.emplace(entity, leaf);
+			insertLeaf(leaf);
+			return;
+		}
+
+		const int32 leaf{ it->second };
+		m_nodes[leaf].box = box;
+		refitAncestors(m_nodes[leaf].parent);
+	}
+
+	void FBoundingVolumeHierarchy::update(const std::vector<entt::entity>& entities,
+										  const std::vector<FBoundingBox>& boxes) {
+		m_refitNodes.assign(m_nodes.size(), 0);
+		std::vector<size_t> insertedEntities;
+		for (size_t i = 0; i < entities.size(); i++) {
+			const auto it{ m_leaves.find(entities[i]) };
+			if (it == m_leaves.end()) {
+				insertedEntities.push_back(i);
+				continue;
+			}
+
+			const int32 leaf{ it->second };
+			m_nodes[leaf].box = boxes[i];
+			// Marking stops at first ancestor marked by other leaf, so every node is visited at most once
+			int32 node{ m_nodes[leaf].parent };
+			while (node != s_nullNode && m_refitNodes[node] == 0) {
+				m_refitNodes[node] = 1;
+				node = m_nodes[node].parent;
+			}
+		}
+
+		// Post-order walk over marked nodes only, children are refitted before their parents
+		if (m_root != s_nullNode && m_refitNodes[m_root] != 0) {
+			std::vector<std::pair<int32, bool>> stack{ { m_root, false } };
+			while (!stack.empty()) {
+				const auto [node, areChildrenRefitted] = stack.back();
+				stack.pop_back();
+				FNode& current{ m_nodes[node] };
+				if (areChildrenRefitted) {
+					current.box = computeUnion(m_nodes[current.left].box, m_nodes[current.right].box);
+					continue;
+				}
+
+				stack.emplace_back(node, true);
+				for (const int32 child : { current.left, current.right }) {
+					if (!m_nodes[child].isLeaf() && m_refitNodes[child] != 0) {
+						stack.emplace_back(child, false);
+					}
+				}
+			}
+		}
+
+		for (const size_t i : insertedEntities) {
+			update(entities[i], boxes[i]);
+		}
+	}
+
+	void FBoundingVolumeHierarchy::remove(entt::entity entity) {
+		const auto it{ m_leaves.find(entity) };
+		if (it == m_leaves.end()) {
+			return;
+		}
+
+		const int32 leaf{ it->second };
+		m_leaves.erase(it);
+		removeLeaf(leaf);
+		freeNode(leaf);
+	}
+
+	std::vector<entt::entity> FBoundingVolumeHierarchy::queryBox(const FBoundingBox& box) const {
+		return traverse([&box](const FBoundingBox& nodeBox) {
+			return areOverlapping(box, nodeBox);
+		});
+	}
+
+	std::vector<entt::entity> FBoundingVolumeHierarchy::querySphere(const maths::vec3& center, float radius) const {
+		const float radiusSquared{ radius * radius };
+		return traverse([&center, radiusSquared](const FBoundingBox& nodeBox) {
+			const float dx{ std::max({ nodeBox.min.x - center.x, 0.f, center.x - nodeBox.max.x }) };
+			const float dy{ std::max({ nodeBox.min.y - center.y, 0.f, center.y - nodeBox.max.y }) };
+			const float dz{ std::max({ nodeBox.min.z - center.z, 0.f, center.z - nodeBox.max.z }) };
+			return dx * dx + dy * dy + dz * dz <= radiusSquared;
+		});
+	}
+
+	std::vector<entt::entity> FBoundingVolumeHierarchy::queryRay(const maths::vec3& origin, const maths::vec3& direction,
+																 float maxDistance) const {
+		// Division by zero gives infinity, for which slab test below still works
+		const maths::vec3 inverseDirection{ 1.f / direction.x, 1.f / direction.y, 1.f / direction.z };
+		auto computeEntryDistance = [&origin, &inverseDirection, maxDistance](const FBoundingBox& box) {
+			float entry{ 0.f };
+			float exit{ maxDistance };
+			for (uint32 axis = 0; axis < 3; axis++) {
+				const float inverse{ getAxis(inverseDirection, axis) };
+				float entryAxis{ (getAxis(box.min, axis) - getAxis(origin, axis)) * inverse };
+				float exitAxis{ (getAxis(box.max, axis) - getAxis(origin, axis)) * inverse };
+				if (entryAxis > exitAxis) {
+					std::swap(entryAxis, exitAxis);
+				}
+				// Comparisons are written so that NaN (0 * infinity) does not narrow the interval
+				entry = entryAxis > entry ? entryAxis : entry;
+				exit = exitAxis < exit ? exitAxis : exit;
+			}
+			return entry <= exit ? entry : -1.f;
+		};
+
+		std::vector<entt::entity> hits{ traverse([&computeEntryDistance](const FBoundingBox& nodeBox) {
+			return computeEntryDistance(nodeBox) >= 0.f;
+		}) };
+
+		std::vector<std::pair<float, entt::entity>> sortedHits;
+		sortedHits.reserve(hits.size());
+		for (const entt::entity entity : hits) {
+			sortedHits.emplace_back(computeEntryDistance(m_nodes[m_leaves.at(entity)].box), entity);
+		}
+		std::sort(sortedHits.begin(), sortedHits.end(), [](const auto& lhs, const auto& rhs) {
+			return lhs.first < rhs.first;
+		});
+
+		for (size_t i = 0; i < sortedHits.size(); i++) {
+			hits[i] = sortedHits[i].second;
+		}
+		return hits;
+	}
+
+	std::vector<entt::entity> FBoundingVolumeHierarchy::queryFrustum(const maths::mat4& viewProjection) const {
+		const std::array<maths::vec4, 6> planes{ FFrustumCuller::computePlanes(viewProjection) };
+		return traverse([&planes](const FBoundingBox& nodeBox) {
+			const float cx{ (nodeBox.min.x + nodeBox.max.x) * 0.5f };
+			const float cy{ (nodeBox.min.y + nodeBox.max.y) * 0.5f };
+			const float cz{ (nodeBox.min.z + nodeBox.max.z) * 0.5f };
+			const float ex{ (nodeBox.max.x - nodeBox.min.x) * 0.5f };
+			const float ey{ (nodeBox.max.y - nodeBox.min.y) * 0.5f };
+			const float ez{ (nodeBox.max.z - nodeBox.min.z) * 0.5f };
+			for (const maths::vec4& plane : planes) {
+				const float distance{ plane.x * cx + plane.y * cy + plane.z * cz + plane.w };
+				const float reach{ std::abs(plane.x) * ex + std::abs(plane.y) * ey + std::abs(plane.z) * ez };
+				if (distance + reach < 0.f) {
+					return false;
+				}
+			}
+			return true;
+		});
+	}
+
+	bool FBoundingVolumeHierarchy::contains(entt::entity entity) const {
+		return m_leaves.find(entity) != m_leaves.end();
+	}
+
+	size_t FBoundingVolumeHierarchy::getCount() const {
+		return m_leaves.size();
+	}
+
+	FBoundingBox FBoundingVolumeHierarchy::computeBox(const FMeshBounds& bounds, const maths::mat4& transform) {
+		const float* m{ transform.value_ptr() };
+		const maths::vec3 center{
+			(bounds.boxMin.x + bounds.boxMax.x) * 0.5f,
+			(bounds.boxMin.y + bounds.boxMax.y) * 0.5f,
+			(bounds.boxMin.z + bounds.boxMax.z) * 0.5f
+		};
+		const float ex{ (bounds.boxMax.x - bounds.boxMin.x) * 0.5f };
+		const float ey{ (bounds.boxMax.y - bounds.boxMin.y) * 0.5f };
+		const float ez{ (bounds.boxMax.z - bounds.boxMin.z) * 0.5f };
+
+		const maths::vec3 worldCenter{
+			m[0] * center.x + m[4] * center.y + m[8] * center.z + m[12],
+			m[1] * center.x + m[5] * center.y + m[9] * center.z + m[13],
+			m[2] * center.x + m[6] * center.y + m[10] * center.z + m[14]
+		};
+		const maths::vec3 worldExtent{
+			std::abs(m[0]) * ex + std::abs(m[4]) * ey + std::abs(m[8]) * ez,
+			std::abs(m[1]) * ex + std::abs(m[5]) * ey + std::abs(m[9]) * ez,
+			std::abs(m[2]) * ex + std::abs(m[6]) * ey + std::abs(m[10]) * ez
+		};
+
+		return {
+			{ worldCenter.x - worldExtent.x, worldCenter.y - worldExtent.y, worldCenter.z - worldExtent.z },
+			{ worldCenter.x + worldExtent.x, worldCenter.y + worldExtent.y, worldCenter.z + worldExtent.z }
+		};
+	}
+
+	int32 FBoundingVolumeHierarchy::allocateNode() {
+		if (!m_freeNodes.empty()) {
+			const int32 node{ m_freeNodes.back() };
+			m_freeNodes.pop_back();
+			m_nodes[node] = FNode{};
+			return node;
+		}
+
+		m_nodes.emplace_back();
+		return (int32)m_nodes.size() - 1;
+	}
+
+	void FBoundingVolumeHierarchy::freeNode(int32 node) {
+		m_nodes[node] = FNode{};
+		m_freeNodes.push_back(node);
+	}
+
+	int32 FBoundingVolumeHierarchy::buildRange(std::vector<FBuildPrimitive>& primitives, size_t begin, size_t end,
+											   int32 parent) {
+		const int32 node{ allocateNode() };
+		m_nodes[node].parent = parent;
+
+		if (end - begin == 1) {
+			m_nodes[node].box = primitives[begin].box;
+			m_nodes[node].entity = primitives[begin].entity;
+			m_leaves[primitives[begin].entity] = node;
+			return node;
+		}
+
+		FBoundingBox box{ primitives[begin].box };
+		FBoundingBox centroidBox{ primitives[begin].centroid, primitives[begin].centroid };
+		for (size_t i = begin + 1; i < end; i++) {
+			box = computeUnion(box, primitives[i].box);
+			centroidBox = computeUnion(centroidBox, { primitives[i].centroid, primitives[i].centroid });
+		}
+		m_nodes[node].box = box;
+
+		uint32 axis{ 0 };
+		float axisExtent{ 0.f };
+		for (uint32 i = 0; i < 3; i++) {
+			const float extent{ getAxis(centroidBox.max, i) - getAxis(centroidBox.min, i) };
+			if (extent > axisExtent) {
+				axis = i;
+				axisExtent = extent;
+			}
+		}
+
+		size_t middle{ begin + (end - begin) / 2 };
+		if (axisExtent > 0.f) {
+			// Binned SAH: primitives are put into bins by centroid, split is chosen between bins with lowest
+			// countLeft * areaLeft + countRight * areaRight
+			const float axisMin{ getAxis(centroidBox.min, axis) };
+			const float binScale{ (float)g_binsCount / axisExtent };
+			auto computeBin = [axis, axisMin, binScale](const FBuildPrimitive& primitive) {
+				const auto bin{ (uint32)((getAxis(primitive.centroid, axis) - axisMin) * binScale) };
+				return std::min(bin, g_binsCount - 1);
+			};
+
+			std::array<uint32, g_binsCount> binCounts{};
+			std::array<FBoundingBox, g_binsCount> binBoxes{};
+			for (size_t i = begin; i < end; i++) {
+				const uint32 bin{ computeBin(primitives[i]) };
+				binBoxes[bin] = binCounts[bin] == 0 ? primitives[i].box : computeUnion(binBoxes[bin], primitives[i].box);
+				binCounts[bin]++;
+			}
+
+			std::array<float, g_binsCount> rightCosts{};
+			uint32 rightCount{ 0 };
+			FBoundingBox rightBox{};
+			for (uint32 bin = g_binsCount - 1; bin > 0; bin--) {
+				if (binCounts[bin] != 0) {
+					rightBox = rightCount == 0 ? binBoxes[bin] : computeUnion(rightBox, binBoxes[bin]);
+					rightCount += binCounts[bin];
+				}
+				rightCosts[bin] = (float)rightCount * computeArea(rightBox);
+			}
+
+			uint32 bestSplit{ 0 };
+			float bestCost{ std::numeric_limits<float>::max() };
+			uint32 leftCount{ 0 };
+			FBoundingBox leftBox{};
+			for (uint32 bin = 0; bin < g_binsCount - 1; bin++) {
+				if (binCounts[bin] != 0) {
+					leftBox = leftCount == 0 ? binBoxes[bin] : computeUnion(leftBox, binBoxes[bin]);
+					leftCount += binCounts[bin];
+				}
+				const float cost{ (float)leftCount * computeArea(leftBox) + rightCosts[bin + 1] };
+				if (leftCount != 0 && cost < bestCost) {
+					bestCost = cost;
+					bestSplit = bin;
+				}
+			}
+
+			const auto it{ std::partition(primitives.begin() + begin, primitives.begin() + end,
+				[&computeBin, bestSplit](const FBuildPrimitive& primitive) {
+					return computeBin(primitive) <= bestSplit;
+				}) };
+			middle = (size_t)(it - primitives.begin());
+		}
+
+		if (middle == begin || middle == end) {
+			middle = begin + (end - begin) / 2;
+			std::nth_element(primitives.begin() + begin, primitives.begin() + middle, primitives.begin() + end,
+				[axis](const FBuildPrimitive& lhs, const FBuildPrimitive& rhs) {
+					return getAxis(lhs.centroid, axis) < getAxis(rhs.centroid, axis);
+				});
+		}
+
+		// Children are built before being assigned, because allocation may reallocate m_nodes
+		const int32 left{ buildRange(primitives, begin, middle, node) };
+		const int32 right{ buildRange(primitives, middle, end, node) };
+		m_nodes[node].left = left;
+		m_nodes[node].right = right;
+		return node;
+	}
+
+	void FBoundingVolumeHierarchy::insertLeaf(int32 leaf) {
+		if (m_root == s_nullNode) {
+			m_root = leaf;
+			m_nodes[leaf].parent = s_nullNode;
+			return;
+		}
+
+		// Descend to sibling, which causes the lowest increase of surface area (branch and bound as in Box2D)
+		const FBoundingBox leafBox{ m_nodes[leaf].box };
+		int32 sibling{ m_root };
+		while (!m_nodes[sibling].isLeaf()) {
+			const FNode& node{ m_nodes[sibling] };
+			const float area{ computeArea(node.box) };
+			const float combinedArea{ computeArea(computeUnion(node.box, leafBox)) };
+			const float cost{ 2.f * combinedArea };
+			const float inheritanceCost{ 2.f * (combinedArea - area) };
+
+			auto computeChildCost = [this, &leafBox, inheritanceCost](int32 child) {
+				const FNode& childNode{ m_nodes[child] };
+				const float unionArea{ computeArea(computeUnion(childNode.box, leafBox)) };
+				if (childNode.isLeaf()) {
+					return unionArea + inheritanceCost;
+				}
+				return unionArea - computeArea(childNode.box) + inheritanceCost;
+			};
+
+			const float leftCost{ computeChildCost(node.left) };
+			const float rightCost{ computeChildCost(node.right) };
+			if (cost < leftCost && cost < rightCost) {
+				break;
+			}
+			sibling = leftCost < rightCost ? node.left : node.right;
+		}
+
+		const int32 oldParent{ m_nodes[sibling].parent };
+		const int32 newParent{ allocateNode() };
+		m_nodes[newParent].parent = oldParent;
+		m_nodes[newParent].box = computeUnion(leafBox, m_nodes[sibling].box);
+		m_nodes[newParent].left = sibling;
+		m_nodes[newParent].right = leaf;
+		m_nodes[sibling].parent = newParent;
+		m_nodes[leaf].parent = newParent;
+
+		if (oldParent == s_nullNode) {
+			m_root = newParent;
+		}
+		else if (m_nodes[oldParent].left == sibling) {
+			m_nodes[oldParent].left = newParent;
+		}
+		else {
+			m_nodes[oldParent].right = newParent;
+		}
+
+		refitAncestors(oldParent);
+	}
+
+	void FBoundingVolumeHierarchy::removeLeaf(int32 leaf) {
+		if (leaf == m_root) {
+			m_root = s_nullNode;
+			return;
+		}
+
+		const int32 parent{ m_nodes[leaf].parent };
+		const int32 grandParent{ m_nodes[parent].parent };
+		const int32 sibling{ m_nodes[parent].left == leaf ? m_nodes[parent].right : m_nodes[parent].left };
+
+		m_nodes[sibling].parent = grandParent;
+		if (grandParent == s_nullNode) {
+			m_root = sibling;
+		}
+		else {
+			if (m_nodes[grandParent].left == parent) {
+				m_nodes[grandParent].left = sibling;
+			}
+			else {
+				m_nodes[grandParent].right = sibling;
+			}
+			refitAncestors(grandParent);
+		}
+
+		freeNode(parent);
+	}
+
+	void FBoundingVolumeHierarchy::refitAncestors(int32 node) {
+		while (node != s_nullNode) {
+			FNode& current{ m_nodes[node] };
+			current.box = computeUnion(m_nodes[current.left].box, m_nodes[current.right].box);
+			node = current.parent;
+		}
+	}
+
+	template<typename TOverlapCallback>
+	std::vector<entt::entity> FBoundingVolumeHierarchy::traverse(TOverlapCallback&& overlaps) const {
+		std::vector<entt::entity> result;
+		if (m_root == s_nullNode) {
+			return result;
+		}
+
+		std::vector<int32> stack;
+		stack.push_back(m_root);
+		while (!stack.empty()) {
+			const FNode& node{ m_nodes[stack.back()] };
+			stack.pop_back();
+			if (!overlaps(node.box)) {
+				continue;
+			}
+
+			if (node.isLeaf()) {
+				result.push_back(node.entity);
+			}
+			else {
+				stack.push_back(node.left);
+				stack.push_back(node.right);
+			}
+		}
+
+		return result;
+	}
+
+	FBoundingBox computeUnion(const FBoundingBox& a, const FBoundingBox& b) {
+		return {
+			{ std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z) },
+			{ std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z) }
+		};
+	}
+
+	float computeArea(const FBoundingBox& box) {
+		const float dx{ box.max.x - box.min.x };
+		const float dy{ box.max.y - box.min.y };
+		const float dz{ box.max.z - box.min.z };
+		return dx * dy + dy * dz + dz * dx;
+	}
+
+	bool areOverlapping(const FBoundingBox& a, const FBoundingBox& b) {
+		return a.min.x <= b.max.x && a.max.x >= b.min.x &&
+			   a.min.y <= b.max.y && a.max.y >= b.min.y &&
+			   a.min.z <= b.max.z && a.max.z >= b.min.z;
+	}
+
+	float getAxis(const maths::vec3& v, uint32 axis) {
+		return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+	}
+
+
+}
@@ -0,0 +1,152 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+
+
+#ifndef MAR_ENGINE_ECS_BOUNDING_VOLUME_HIERARCHY_H
+#define MAR_ENGINE_ECS_BOUNDING_VOLUME_HIERARCHY_H
+
+
+#include "../../mar.h"
+
+
+namespace marengine {
+
+	struct FMeshBounds;
+
+
+	/// @brief Axis aligned box in world space
+	struct FBoundingBox {
+		maths::vec3 min{ 0.f, 0.f, 0.f };
+		maths::vec3 max{ 0.f, 0.f, 0.f };
+	};
+
+
+	/**
+	 * @class FBoundingVolumeHierarchy BoundingVolumeHierarchy.h "Core/ecs/BoundingVolumeHierarchy.h"
+	 * @brief Dynamic tree of axis aligned boxes, where every leaf holds single entity. Tree is built at once
+	 * with binned surface area heuristic, afterwards entities are refitted when their boxes change and
+	 * inserted / removed one by one. Refitting keeps topology, so tree should be rebuilt after larger changes
+	 * of scene (loading, exiting play mode).
+	 */
+	class FBoundingVolumeHierarchy {
+	public:
+
+		/**
+		 * @brief Builds whole tree from scratch. Previous content is cleared.
+		 * @param entities entities, that will be held in leaves
+		 * @param boxes boxes of entities, boxes[i] belongs to entities[i]
+		 */
+		void build(const std::vector<entt::entity>& entities, const std::vector<FBoundingBox>& boxes);
+
+		/// @brief Removes all nodes from tree.
+		void clear();
+
+		/**
+		 * @brief Refits leaf of given entity with new box and all of its ancestors.
+		 * If entity is not yet in tree, it is inserted.
+		 * @param entity entity, which box has changed
+		 * @param box new box of entity
+		 */
+		void update(entt::entity entity, const FBoundingBox& box);
+
+		/**
+		 * @brief Refits leaves of many entities at once, every ancestor shared by them is refitted only once.
+		 * Entities, that are not yet in tree, are inserted afterwards.
+		 * @param entities entities, which boxes have changed
+		 * @param boxes new boxes of entities, boxes[i] belongs to entities[i]
+		 */
+		void update(const std::vector<entt::entity>& entities, const std::vector<FBoundingBox>& boxes);
+
+		/**
+		 * @brief Removes leaf of given entity, its sibling takes place of their parent.
+		 * Nothing happens, if entity is not in tree.
+		 * @param entity entity, that should be removed
+		 */
+		void remove(entt::entity entity);
+
+		/// @brief Returns all entities, which boxes overlap given box.
+		MAR_NO_DISCARD std::vector<entt::entity> queryBox(const FBoundingBox& box) const;
+
+		/// @brief Returns all entities, which boxes overlap given sphere.
+		MAR_NO_DISCARD std::vector<entt::entity> querySphere(const maths::vec3& center, float radius) const;
+
+		/**
+		 * @brief Returns all entities, which boxes are hit by given ray, sorted by distance at which ray enters them.
+		 * @param origin starting point of ray
+		 * @param direction direction of ray, does not have to be normalized (distance is then measured in its lengths)
+		 * @param maxDistance ray is tested only on [0, maxDistance]
+		 */
+		MAR_NO_DISCARD std::vector<entt::entity> queryRay(const maths::vec3& origin, const maths::vec3& direction,
+														  float maxDistance) const;
+
+		/// @brief Returns all entities, which boxes are not fully outside of frustum of given view-projection matrix.
+		MAR_NO_DISCARD std::vector<entt::entity> queryFrustum(const maths::mat4& viewProjection) const;
+
+		MAR_NO_DISCARD bool contains(entt::entity entity) const;
+		MAR_NO_DISCARD size_t getCount() const;
+
+		/// @brief Computes world space box enclosing given model space bounds transformed by given matrix (Arvo).
+		MAR_NO_DISCARD static FBoundingBox computeBox(const FMeshBounds& bounds, const maths::mat4& transform);
+
+	private:
+
+		static constexpr int32 s_nullNode{ -1 };
+
+		struct FNode {
+			FBoundingBox box;
+			int32 parent{ s_nullNode };
+			int32 left{ s_nullNode };
+			int32 right{ s_nullNode };
+			entt::entity entity{ entt::null };
+
+			MAR_NO_DISCARD bool isLeaf() const { return left == s_nullNode; }
+		};
+
+		struct FBuildPrimitive {
+			FBoundingBox box;
+			maths::vec3 centroid;
+			entt::entity entity;
+		};
+
+		MAR_NO_DISCARD int32 allocateNode();
+		void freeNode(int32 node);
+		MAR_NO_DISCARD int32 buildRange(std::vector<FBuildPrimitive>& primitives, size_t begin, size_t end, int32 parent);
+		void insertLeaf(int32 leaf);
+		void removeLeaf(int32 leaf);
+		void refitAncestors(int32 node);
+
+		template<typename TOverlapCallback>
+		MAR_NO_DISCARD std::vector<entt::entity> traverse(TOverlapCallback&& overlaps) const;
+
+		std::vector<FNode> m_nodes;
+		std::vector<int32> m_freeNodes;
+		/// @brief 1 if node is ancestor of leaf changed at batched update, valid only during that update
+		std::vector<uint8_t> m_refitNodes;
+		std::unordered_map<entt::entity, int32> m_leaves;
+		int32 m_root{ s_nullNode };
+
+	};
+
+
+}
+
+
+#endif // !MAR_ENGINE_ECS_BOUNDING_VOLUME_HIERARCHY_H
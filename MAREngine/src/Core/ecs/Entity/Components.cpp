@@ -30,10 +30,45 @@ namespace marengine {
         return index != -1 && type != EMaterialType::NONE && !path.empty() && path != "None";
     }
 
-	maths::mat4 CTransform::getTransform() const {
-		maths::mat4 tran;
-		tran.recompose(position, maths::quat(rotation), scale);
-		return tran;
+	const maths::mat4& CTransform::getTransform() const {
+		return m_transform;
+	}
+
+	maths::vec3 CTransform::getWorldPosition() const {
+		const float* pMatrix{ m_transform.value_ptr() };
+		return { pMatrix[12], pMatrix[13], pMatrix[14] };
+	}
+
+	maths::vec3 CTransform::getWorldScale() const {
+		const float* pMatrix{ m_transform.value_ptr() };
+		auto computeColumnLength = [pMatrix](uint32 column) {
+			const float* pColumn{ pMatrix + 4 * column };
+			return std::sqrt(pColumn[0] * pColumn[0] + pColumn[1] * pColumn[1] + pColumn[2] * pColumn[2]);
+		};
+		return { computeColumnLength(0), computeColumnLength(1), computeColumnLength(2) };
+	}
+
+	void CTransform::markDirty() {
+		m_isDirty = true;
+	}
+
+	bool CTransform::isDirty() const {
+		return m_isDirty;
+	}
+
+	bool CTransform::updateTransform() const {
+		if (!m_isDirty) {
+			return false;
+		}
+
+		m_transform.recompose(position, maths::quat(rotation), scale);
+		m_isDirty = false;
+		return true;
+	}
+
+	void CTransform::passTransform(const maths::mat4& transform) const {
+		m_transform = transform;
+		m_isDirty = false;
 	}
 
     bool CCamera::isMainCamera() const {
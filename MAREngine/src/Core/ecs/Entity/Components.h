@@ -40,6 +40,19 @@ namespace marengine {
 	struct CTag  { std::string tag{ "New Entity" }; };
 
 
+	/**
+	 * @brief Places entity at parent / children tree. Children of entity form singly linked list, that starts
+	 * at its firstChild and continues through nextSibling of every child. Depth is count of ancestors,
+	 * FTransformSystem sorts by it, so that parent is always updated before its children.
+	 */
+	struct CHierarchy {
+		entt::entity parent{ entt::null };
+		entt::entity firstChild{ entt::null };
+		entt::entity nextSibling{ entt::null };
+		uint32 depth{ 0 };
+	};
+
+
 	struct CRenderable {
 	    struct MeshInfo {
 	        /// @brief path used to retrieve external FMeshProxy from FMeshStorage (can be empty if used default Mesh)
@@ -50,6 +63,8 @@ namespace marengine {
             int32 index{ -1 };
             /// @brief asset ID for more convenient way to retrieve already loaded asset
             uint32 assetID{ 0 };
+            /// @brief level of detail of external mesh selected from screen size (0 is full mesh), see FMeshLevelOfDetail
+            uint32 levelOfDetail{ 0 };
 	    };
 	    struct MaterialInfo {
             /// @brief type used to retrieve correct implementation of FMaterialProxy from FMaterialStorage
@@ -72,6 +87,8 @@ namespace marengine {
             int32 transformIndex{ -1 };
             /// @brief material index at batch (with this we can update only one material at batch)
             int32 materialIndex{ -1 };
+            /// @brief true if entity is culled, its indices (or instance) are left out of batch draw commands then
+            bool isCulled{ false };
 
             int32 startVert{ -1 };
             int32 endVert{ -1 };
@@ -104,15 +121,48 @@ namespace marengine {
 	struct CTransform {
 
 		/**
-		 * @brief Calculates transform matrix from position, rotation and scale vec3's and returns it.
-		 * @return calculated transform matrix
+		 * @brief Returns world matrix composed from position, rotation and scale vec3's (relative to parent,
+		 * if entity has one at CHierarchy). Matrix is only read here, it is composed by FTransformSystem, which
+		 * knows parent of entity, so after markDirty it stays previous one until next FTransformSystem::update.
+		 * @return cached transform matrix
 		 */
-		MAR_NO_DISCARD maths::mat4 getTransform() const;
+		MAR_NO_DISCARD const maths::mat4& getTransform() const;
+
+		/// @brief Returns translation of cached world matrix (position includes parent's transform).
+		MAR_NO_DISCARD maths::vec3 getWorldPosition() const;
+
+		/// @brief Returns lengths of axes of cached world matrix (scale includes parent's transform).
+		MAR_NO_DISCARD maths::vec3 getWorldScale() const;
+
+		/**
+		 * @brief Only flags cached matrix as outdated. Use FTransformSystem::markDirty whenever position, rotation
+		 * or scale is changed, it also lists entity, so that cached matrix is composed again at next update.
+		 */
+		void markDirty();
+
+		MAR_NO_DISCARD bool isDirty() const;
+
+		/**
+		 * @brief Composes cached matrix of root entity, if transform is dirty. Used by FTransformSystem.
+		 * @return true if matrix was composed
+		 */
+		bool updateTransform() const;
+
+		/**
+		 * @brief Caches matrix composed outside of component (many at once by FTransformSystem) and clears dirty flag.
+		 * @param transform world matrix composed from current position, rotation and scale
+		 */
+		void passTransform(const maths::mat4& transform) const;
 
 		maths::vec3 position{ 0.f, 0.f, 0.f };
 		maths::vec3 rotation{ 0.f, 0.f, 0.f };
 		maths::vec3 scale{ 1.f, 1.f, 1.f };
 
+	private:
+
+		mutable maths::mat4 m_transform;
+		mutable bool m_isDirty{ true };
+
 	};
 
 
@@ -21,6 +21,8 @@
 
 
 #include "Entity.h"
+#include "../TransformSystem.h"
+#include "../../../Logging/Logger.h"
 
 
 namespace marengine {
@@ -39,22 +41,48 @@ namespace marengine {
 	}
 
 	bool Entity::isValid() const {
-		return m_pSceneRegistry->valid(m_entityHandle);
+		return m_pSceneRegistry != nullptr && m_pSceneRegistry->valid(m_entityHandle);
+	}
+
+	entt::entity Entity::getHandle() const {
+		return m_entityHandle;
 	}
 
 	void Entity::fillEntityWithBasicComponents(const Entity& entity) {
 		entity.addComponent<CTag>();
-		entity.addComponent<CTransform>();
-		entity.addComponent<CChildren>();
+		// New entity has no parent yet, so its default transform can be composed right away
+		entity.addComponent<CTransform>().updateTransform();
+		entity.addComponent<CHierarchy>();
 	}
 
 	void Entity::destroyYourself() const {
 		m_pSceneRegistry->destroy(m_entityHandle);
 	}
 
-	const Entity& Entity::assignChild(const Entity& child) const {
-		auto& children{ getComponent<CChildren>().children };
-		return children.emplace_back(child);
+	void Entity::assignChild(const Entity& child) const {
+		if (child.isAncestorOf(*this)) {
+			MARLOG_WARN(ELoggerType::ECS, "Cannot assign entity {} as child of its descendant {}",
+						child.getComponent<CTag>().tag, getComponent<CTag>().tag);
+			return;
+		}
+		if (child.hasParent()) {
+			child.getParent().removeChild(child);
+		}
+
+		auto& cHierarchy{ getComponent<CHierarchy>() };
+		if (cHierarchy.firstChild == entt::null) {
+			cHierarchy.firstChild = child.m_entityHandle;
+		}
+		else {
+			entt::entity lastChild{ cHierarchy.firstChild };
+			while (m_pSceneRegistry->get<CHierarchy>(lastChild).nextSibling != entt::null) {
+				lastChild = m_pSceneRegistry->get<CHierarchy>(lastChild).nextSibling;
+			}
+			m_pSceneRegistry->get<CHierarchy>(lastChild).nextSibling = child.m_entityHandle;
+		}
+
+		child.getComponent<CHierarchy>().parent = m_entityHandle;
+		child.setDepth(cHierarchy.depth + 1);
 	}
 
 	void Entity::removeChild(size_t index) const {
@@ -62,29 +90,91 @@ namespace marengine {
 	}
 
 	void Entity::removeChild(const Entity& child) const {
-		auto& children{ getComponent<CChildren>().children };
+		auto& cChildHierarchy{ child.getComponent<CHierarchy>() };
+		if (cChildHierarchy.parent != m_entityHandle) {
+			return;
+		}
 
-		auto it = std::find_if(children.begin(), children.end(), [&child](const Entity& iterator) {
-			return 	&iterator == &child;
-		});
+		auto& cHierarchy{ getComponent<CHierarchy>() };
+		if (cHierarchy.firstChild == child.m_entityHandle) {
+			cHierarchy.firstChild = cChildHierarchy.nextSibling;
+		}
+		else {
+			entt::entity sibling{ cHierarchy.firstChild };
+			while (sibling != entt::null) {
+				auto& cSiblingHierarchy{ m_pSceneRegistry->get<CHierarchy>(sibling) };
+				if (cSiblingHierarchy.nextSibling == child.m_entityHandle) {
+					cSiblingHierarchy.nextSibling = cChildHierarchy.nextSibling;
+					break;
+				}
+				sibling = cSiblingHierarchy.nextSibling;
+			}
+		}
 
-		const bool canRemoveChild{ it != children.end() };
+		cChildHierarchy.parent = entt::null;
+		cChildHierarchy.nextSibling = entt::null;
+		child.setDepth(0);
+	}
 
-		if (canRemoveChild) {
-            children.erase(it);
+	void Entity::detachFromHierarchy() const {
+		if (hasParent()) {
+			getParent().removeChild(*this);
+		}
+		while (hasChildren()) {
+			removeChild(getChild(0));
 		}
 	}
 
 	bool Entity::hasChildren() const {
-		return !getComponent<CChildren>().children.empty();
+		return getComponent<CHierarchy>().firstChild != entt::null;
 	}
 
-	const Entity& Entity::getChild(size_t index) const {
-		return getComponent<CChildren>().children[index];
+	Entity Entity::getChild(size_t index) const {
+		entt::entity child{ getComponent<CHierarchy>().firstChild };
+		for (size_t i = 0; i < index && child != entt::null; i++) {
+			child = m_pSceneRegistry->get<CHierarchy>(child).nextSibling;
+		}
+		return { child, m_pSceneRegistry };
+	}
+
+	FEntityArray Entity::getChildren() const {
+		FEntityArray children;
+		entt::entity child{ getComponent<CHierarchy>().firstChild };
+		while (child != entt::null) {
+			children.emplace_back(child, m_pSceneRegistry);
+			child = m_pSceneRegistry->get<CHierarchy>(child).nextSibling;
+		}
+		return children;
 	}
 
-	const std::vector<Entity>& Entity::getChildren() const {
-		return getComponent<CChildren>().children;
+	bool Entity::hasParent() const {
+		return getComponent<CHierarchy>().parent != entt::null;
+	}
+
+	Entity Entity::getParent() const {
+		return { getComponent<CHierarchy>().parent, m_pSceneRegistry };
+	}
+
+	bool Entity::isAncestorOf(const Entity& entity) const {
+		entt::entity ancestor{ entity.m_entityHandle };
+		while (ancestor != entt::null) {
+			if (ancestor == m_entityHandle) {
+				return true;
+			}
+			ancestor = m_pSceneRegistry->get<CHierarchy>(ancestor).parent;
+		}
+		return false;
+	}
+
+	void Entity::setDepth(uint32 depth) const {
+		getComponent<CHierarchy>().depth = depth;
+		FTransformSystem::markDirty(*this);
+
+		entt::entity child{ getComponent<CHierarchy>().firstChild };
+		while (child != entt::null) {
+			Entity(child, m_pSceneRegistry).setDepth(depth + 1);
+			child = m_pSceneRegistry->get<CHierarchy>(child).nextSibling;
+		}
 	}
 
 
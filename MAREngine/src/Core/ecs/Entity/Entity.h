@@ -43,10 +43,7 @@ namespace marengine {
 	class Entity {
 
 		friend class Scene;
-
-		struct CChildren {
-			FEntityArray children;
-		};
+		friend class FTransformSystem;
 
 	public:
 
@@ -82,7 +79,7 @@ namespace marengine {
 		 * - CTransform (we want every entity to have its own position, rotation, scale)
 		 * - LightBatchInfoComponent (engine-only component, it remembers light batches that other components are stored in, optimization)
 		 * - MeshBatchInfoComponent (engine-only component, it remembers mesh batches that other components are stored in, optimization)
-		 * - CChildren (used to store some children, that will be relative to base entity - parent)
+		 * - CHierarchy (parent and children of entity, children transforms are relative to their parent)
 		 * @param entity entity, which will be filled with basic components
 		 */
 		static void fillEntityWithBasicComponents(const Entity& entity);
@@ -94,32 +91,46 @@ namespace marengine {
 		void destroyYourself() const;
 
 		/**
-		 * @brief Method checks, if entity is valid one and returns result.
+		 * @brief Method checks, if entity is valid one and returns result. Entity without registry is never valid.
 		 * @return returns true if entity is valid (it exists and is fine).
 		 */
 		MAR_NO_DISCARD bool isValid() const;
 
 		/**
-		 * @brief Assigns child to current entity. Places child to array at CChildren.
-		 * @warning Make sure that child is a valid entity!
+		 * @brief Returns handle of entity at scene registry. Unlike CTag, handle is unique among alive entities
+		 * of the scene, it is reused only after entity is destroyed (with new version).
+		 * @return entt::entity handle of current entity
+		 */
+		MAR_NO_DISCARD entt::entity getHandle() const;
+
+		/**
+		 * @brief Assigns child to current entity, child is appended to the end of its children list.
+		 * If child already has parent, it is removed from it first. From now on child's transform is relative
+		 * to current entity (see FTransformSystem).
+		 * @warning Make sure that child is a valid entity! Entity cannot become child of itself or of its descendant.
 		 * @param child valid entity, which will be assigned as child
 		 */
-		const Entity& assignChild(const Entity& child) const;
+		void assignChild(const Entity& child) const;
 
 		/**
-		 * @brief Removes child from CChildren by its index in array.
-		 * @warning child is not destroyed, only removed from array!
+		 * @brief Removes child by its index at children list.
+		 * @warning child is not destroyed, it only becomes root entity!
 		 * @param index index at which child will be removed
 		 */
 		void removeChild(size_t index) const;
 
 		/**
-		 * @brief Removes child from CChildren, only if child is assigned to entity.
-		 * @warning child is not destroyed, only removed from array!
-		 * @param child child, which we want to be removed from array
+		 * @brief Removes child from current entity, only if child is assigned to it.
+		 * @warning child is not destroyed, it only becomes root entity!
+		 * @param child child, which we want to be removed
 		 */
 		void removeChild(const Entity& child) const;
 
+		/**
+		 * @brief Removes entity from its parent and removes all of its children, so that entity can be safely destroyed.
+		 */
+		void detachFromHierarchy() const;
+
 		/**
 		 * @brief Method checks, if current entity contains children and returns result.
 		 * @return Returns true, if current entity contains any children.
@@ -127,18 +138,31 @@ namespace marengine {
 		MAR_NO_DISCARD bool hasChildren() const;
 
 		/**
-		 * @brief Returns children assigned to an entity in array.
+		 * @brief Returns children assigned to an entity in array (in order of assignment).
 		 * @return Returns all children of current entity.
 		 */
-		MAR_NO_DISCARD const FEntityArray& getChildren() const;
-		
+		MAR_NO_DISCARD FEntityArray getChildren() const;
+
 		/**
-		 * @brief Returns child by its index in array.
-		 * @warning Method does not check if it is valid entity! If index is too large, it may cause overflow.
+		 * @brief Returns child by its index at children list.
+		 * @warning Method does not check if index is valid! If index is too large, returned entity is null one.
 		 * @param index index of child
 		 * @return child instance at given index
 		 */
-		MAR_NO_DISCARD const Entity& getChild(size_t index) const;
+		MAR_NO_DISCARD Entity getChild(size_t index) const;
+
+		/**
+		 * @brief Method checks, if current entity is assigned as child to other entity.
+		 * @return Returns true, if current entity has parent.
+		 */
+		MAR_NO_DISCARD bool hasParent() const;
+
+		/**
+		 * @brief Returns parent of current entity.
+		 * @warning Make sure, that entity has parent (hasParent())!
+		 * @return parent instance
+		 */
+		MAR_NO_DISCARD Entity getParent() const;
 
 		/**
 		 * @brief Checks, if current entity has TComponent assigned and returns result.
@@ -202,6 +226,11 @@ namespace marengine {
 		template<typename TComponent> void removeComponent() const;
 
 	private:
+
+		/// @brief Returns true, if current entity is given entity or one of its ancestors.
+		MAR_NO_DISCARD bool isAncestorOf(const Entity& entity) const;
+		/// @brief Sets depth at whole subtree of current entity and marks its transforms dirty.
+		void setDepth(uint32 depth) const;
 		
 		entt::registry* m_pSceneRegistry{ nullptr };
 		entt::entity m_entityHandle{ entt::null };
@@ -23,6 +23,7 @@
 #include "EventsComponentEntity.inl"
 #include "EventsCameraEntity.h"
 #include "../SceneManagerEditor.h"
+#include "../TransformSystem.h"
 #include "../../graphics/public/MeshManager.h"
 #include "../../graphics/public/RenderManager.h"
 #include "../../graphics/public/BatchManager.h"
@@ -53,19 +54,13 @@ namespace marengine {
 	/***************************** TRANSFORM COMPONENT TEMPLATES ***************************************/
 
 	template<> void FEventsComponentEntity::onUpdate<CTransform>(const Entity& entity) {
-		if (entity.getComponent<CRenderable>().isEntityRendered()) {
-            s_pBatchManager->update<CTransform>(entity);
-		}
+		// Matrices, batches, bounding volumes and lights are updated for all dirty entities at once,
+		// see FSceneManagerEditor::updateTransforms
+		FTransformSystem::markDirty(entity);
 
 		if (entity.hasComponent<CCamera>() && entity.getComponent<CCamera>().isMainCamera()) {
 			FEventsCameraEntity::onMainCameraUpdate(entity);
 		}
-
-		if (entity.hasComponent<CPointLight>()) {
-		    entity.getComponent<CPointLight>().pointLight.position =
-		            maths::vec4(entity.getComponent<CTransform>().position, 1.f);
-		    s_pBatchManager->update<CPointLight>(entity);
-		}
 	}
 
 	/***************************** RENDERABLE COMPONENT TEMPLATES ***************************************/
@@ -77,11 +72,14 @@ namespace marengine {
 	}
 
 	template<> void FEventsComponentEntity::onUpdate<CRenderable>(const Entity& entity) {
-	    // TODO: remember about WA with mesh update and texture update
         const auto& cEvent{ entity.getComponent<CEvent>() };
 	    if(cEvent.eventUpdateType == EEventType::RENDERABLE_MESH_UPDATE
 	            || cEvent.eventUpdateType == EEventType::RENDERABLE_TEX2D_LOAD) {
-            s_pSceneManagerEditor->updateSceneAtBatchManager();
+            s_pBatchManager->removeEntityFromRender(entity);
+            if(!s_pBatchManager->insertEntityToRender(entity)) {
+                s_pSceneManagerEditor->updateSceneAtBatchManager();
+            }
+            s_pSceneManagerEditor->updateEntityAtBoundingVolumes(entity);
 	    }
 	    else {
             s_pBatchManager->update<CRenderable>(entity);
@@ -89,17 +87,15 @@ namespace marengine {
 	}
 
 	template<> void FEventsComponentEntity::onRemove<CRenderable>(const Entity& entity) {
+        s_pBatchManager->removeEntityFromRender(entity);
 		entity.removeComponent<CRenderable>();
-        // TODO: implement better event that whole scene reinitialization
-        s_pSceneManagerEditor->updateSceneAtBatchManager();
 	}
 
 	/***************************** LIGHT COMPONENT TEMPLATES ***************************************/
 
 	template<> void FEventsComponentEntity::onAdd<CPointLight>(const Entity& entity) {
 		entity.addComponent<CPointLight>();
-        // TODO: implement better event that whole scene reinitialization
-        s_pSceneManagerEditor->updateSceneAtBatchManager();
+        s_pBatchManager->pushLightsToRender(s_pSceneManagerEditor->getScene());
 	}
 
 	template<> void FEventsComponentEntity::onUpdate<CPointLight>(const Entity& entity) {
@@ -109,8 +105,7 @@ namespace marengine {
 
 	template<> void FEventsComponentEntity::onRemove<CPointLight>(const Entity& entity) {
 		entity.removeComponent<CPointLight>();
-        // TODO: implement better event that whole scene reinitialization
-        s_pSceneManagerEditor->updateSceneAtBatchManager();
+        s_pBatchManager->pushLightsToRender(s_pSceneManagerEditor->getScene());
 	}
 
 	/***************************** CAMERA COMPONENT TEMPLATES ***************************************/
@@ -35,7 +35,7 @@ namespace marengine {
 		Scene scene(std::move(sceneName));
 
 		{ // create Camera entity
-			const Entity& cameraEntity{ scene.createEntity() };
+			const Entity cameraEntity{ scene.createEntity() };
 			auto& cCamera{ cameraEntity.addComponent<CCamera>() };
             cCamera.id = "main";
 
@@ -43,7 +43,7 @@ namespace marengine {
 			tag.tag = "CameraEntity";
 		}
 		{ // create Light Entity
-			const Entity& pointLightEntity{ scene.createEntity() };
+			const Entity pointLightEntity{ scene.createEntity() };
 			pointLightEntity.addComponent<CPointLight>();
 
 			CTag& tag{ pointLightEntity.getComponent<CTag>() };
@@ -54,32 +54,26 @@ namespace marengine {
 	}
 
 	void Scene::close() {
-		for (const auto& entity : m_entities) {
-			destroyEntity(entity);
-		}
-
-		m_entities.clear();
 		m_sceneRegistry.clear();
+		m_boundingVolumes.clear();
 	}
 
-	const Entity& Scene::createEntity() {
-		const Entity& entity{ m_entities.emplace_back(&m_sceneRegistry) };
+	Entity Scene::createEntity() {
+		const Entity entity{ &m_sceneRegistry };
 		Entity::fillEntityWithBasicComponents(entity);
 
 		return entity;
 	}
 
 	void Scene::destroyEntity(const Entity& entity) {
-		auto it = std::find_if(m_entities.begin(), m_entities.end(), [&entity](const Entity& iterator) {
-			return 	&iterator == &entity;
-		});
-
-		const bool canDestroyEntity{ it != m_entities.end() && (*it).isValid() };
-
-		if (canDestroyEntity) {
-			it->destroyYourself();
-			m_entities.erase(it);
+		const bool canDestroyEntity{ entity.m_pSceneRegistry == &m_sceneRegistry && entity.isValid() };
+		if (!canDestroyEntity) {
+			return;
 		}
+
+		m_boundingVolumes.remove(entity.m_entityHandle);
+		entity.detachFromHierarchy();
+		entity.destroyYourself();
 	}
 
 	void Scene::setName(std::string newSceneName) {
@@ -102,13 +96,67 @@ namespace marengine {
 		return &m_sceneRegistry; 
 	}
 
-	const FEntityArray& Scene::getEntities() const { 
-		return m_entities;
+	FEntityArray Scene::getEntities() const {
+		// Entity modifies its components through registry, so it is always given non-const one
+		entt::registry* pSceneRegistry{ const_cast<entt::registry*>(&m_sceneRegistry) };
+		// Every entity has CTag, view iterates from the newest component, so it is walked backwards
+		const auto view{ pSceneRegistry->view<CTag>() };
+		FEntityArray entities;
+		entities.reserve(view.size());
+		for (auto it = view.rbegin(); it != view.rend(); ++it) {
+			entities.emplace_back(*it, pSceneRegistry);
+		}
+
+		return entities;
+	}
+
+	size_t Scene::getEntitiesCount() const {
+		return m_sceneRegistry.alive();
 	}
 
 	bool Scene::isValid(entt::entity enttEntity) const {
 		return m_sceneRegistry.valid(enttEntity);
 	}
 
+	void Scene::buildBoundingVolumes(const std::vector<entt::entity>& enttEntities,
+									 const std::vector<FBoundingBox>& boxes) {
+		m_boundingVolumes.build(enttEntities, boxes);
+	}
+
+	void Scene::updateBoundingVolume(const Entity& entity, const FBoundingBox& box) {
+		m_boundingVolumes.update(entity.m_entityHandle, box);
+	}
+
+	void Scene::updateBoundingVolumes(const std::vector<entt::entity>& enttEntities,
+									  const std::vector<FBoundingBox>& boxes) {
+		m_boundingVolumes.update(enttEntities, boxes);
+	}
+
+	FEntityArray Scene::queryBox(const FBoundingBox& box) {
+		return createEntities(m_boundingVolumes.queryBox(box));
+	}
+
+	FEntityArray Scene::querySphere(const maths::vec3& center, float radius) {
+		return createEntities(m_boundingVolumes.querySphere(center, radius));
+	}
+
+	FEntityArray Scene::queryRay(const maths::vec3& origin, const maths::vec3& direction, float maxDistance) {
+		return createEntities(m_boundingVolumes.queryRay(origin, direction, maxDistance));
+	}
+
+	FEntityArray Scene::queryFrustum(const maths::mat4& viewProjection) {
+		return createEntities(m_boundingVolumes.queryFrustum(viewProjection));
+	}
+
+	FEntityArray Scene::createEntities(const std::vector<entt::entity>& enttEntities) {
+		FEntityArray entities;
+		entities.reserve(enttEntities.size());
+		for (const entt::entity enttEntity : enttEntities) {
+			entities.emplace_back(enttEntity, &m_sceneRegistry);
+		}
+
+		return entities;
+	}
+
 
 }
@@ -26,6 +26,7 @@
 
 #include "../../mar.h"
 #include "Entity/Entity.h"
+#include "BoundingVolumeHierarchy.h"
 
 
 namespace marengine {
@@ -62,22 +63,28 @@ namespace marengine {
 		void close();
 
 		/**
-		* @brief Method creates Entity at m_entities, assigns to it some basic components and returns it.
-		* @return created entity pushed to scene
+		* @brief Method creates entity at scene registry, assigns to it some basic components and returns it.
+		* Returned Entity is only a handle, it can be copied and kept as long as entity is not destroyed.
+		* @return created entity
 		*/
-		MAR_NO_DISCARD const Entity& createEntity();
+		MAR_NO_DISCARD Entity createEntity();
 
 		/**
-		* @brief Method checks if given entity exists in m_entities, if so entity is being destroyed and popped from m_entities.
+		* @brief Method checks if given entity is still alive at scene registry, if so entity is detached from
+		* its hierarchy, removed from bounding volumes and destroyed. Registry releases its handle in constant time.
 		* @param entity that will be deleted from current scene
 		*/
 		void destroyEntity(const Entity& entity);
 
 		/**
-		* @brief Method returns all entities.
-		* @return m_entities const reference to array of entities
+		* @brief Method returns all entities. Array is built from scene registry at every call, so code running
+		* every frame should iterate getView<TComponent>() instead.
+		* @return array of entities, the oldest one first (order is not preserved after destroying entities)
 		*/
-		MAR_NO_DISCARD const FEntityArray& getEntities() const;
+		MAR_NO_DISCARD FEntityArray getEntities() const;
+
+		/// @brief Returns count of alive entities at scene registry.
+		MAR_NO_DISCARD size_t getEntitiesCount() const;
 
 		/**
 		* @brief Sets new scene name
@@ -131,13 +138,48 @@ namespace marengine {
 		 */
 		MAR_NO_DISCARD bool isValid(entt::entity enttEntity) const;
 
+		/**
+		 * @brief Builds bounding volume hierarchy of scene from scratch.
+		 * @param enttEntities entities put into hierarchy
+		 * @param boxes world space boxes of entities, boxes[i] belongs to enttEntities[i]
+		 */
+		void buildBoundingVolumes(const std::vector<entt::entity>& enttEntities, const std::vector<FBoundingBox>& boxes);
+
+		/**
+		 * @brief Refits box of given entity at bounding volume hierarchy (entity is inserted, if it is not there yet).
+		 * @param entity entity, which transform or mesh has changed
+		 * @param box new world space box of entity
+		 */
+		void updateBoundingVolume(const Entity& entity, const FBoundingBox& box);
+
+		/**
+		 * @brief Refits boxes of many entities at bounding volume hierarchy at once (see FBoundingVolumeHierarchy::update).
+		 * @param enttEntities entities, which transforms or meshes have changed
+		 * @param boxes new world space boxes of entities, boxes[i] belongs to enttEntities[i]
+		 */
+		void updateBoundingVolumes(const std::vector<entt::entity>& enttEntities, const std::vector<FBoundingBox>& boxes);
+
+		/// @brief Returns all entities, which bounding boxes overlap given box.
+		MAR_NO_DISCARD FEntityArray queryBox(const FBoundingBox& box);
+
+		/// @brief Returns all entities, which bounding boxes overlap given sphere.
+		MAR_NO_DISCARD FEntityArray querySphere(const maths::vec3& center, float radius);
+
+		/// @brief Returns all entities, which bounding boxes are hit by given ray, from the nearest one.
+		MAR_NO_DISCARD FEntityArray queryRay(const maths::vec3& origin, const maths::vec3& direction, float maxDistance);
+
+		/// @brief Returns all entities, which bounding boxes are not fully outside of given view-projection frustum.
+		MAR_NO_DISCARD FEntityArray queryFrustum(const maths::mat4& viewProjection);
+
 	private:
 
-		std::string m_name{ "Empty Scene" };
-		FEntityArray m_entities;
+		MAR_NO_DISCARD FEntityArray createEntities(const std::vector<entt::entity>& enttEntities);
 
+
+		std::string m_name{ "Empty Scene" };
 		maths::vec3 m_backgroundColor{ 0.22f, 0.69f, 0.87f };
 		entt::registry m_sceneRegistry;
+		FBoundingVolumeHierarchy m_boundingVolumes;
 
 	};
 
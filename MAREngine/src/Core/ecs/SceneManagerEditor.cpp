@@ -22,11 +22,13 @@
 
 #include "SceneManagerEditor.h"
 #include "Scene.h"
+#include "TransformSystem.h"
 #include "Entity/EventsComponentEntity.h"
 #include "Entity/EventsCameraEntity.h"
 #include "../graphics/public/BatchManager.h"
 #include "../graphics/public/MeshManager.h"
 #include "../graphics/public/MaterialManager.h"
+#include "../scripting/PythonScript.h"
 
 
 namespace marengine {
@@ -37,9 +39,12 @@ namespace marengine {
 		m_pBatchManager = pBatchManager;
 		m_pMeshManager = pMeshManager;
         m_pMaterialManager = pMaterialManager;
+        FTransformSystem::update(m_pScene);
         updateSceneAtMeshManager();
         updateSceneAtMaterialManager();
         updateSceneAtBatchManager();
+        updateSceneAtBoundingVolumes();
+        PythonScript::passScene(m_pScene);
 	}
 
     void FSceneManagerEditor::updateSceneAtBatchManager() {
@@ -54,6 +59,49 @@ namespace marengine {
         m_pMaterialManager->updateSceneMaterialData(m_pScene);
     }
 
+	void FSceneManagerEditor::updateSceneAtBoundingVolumes() {
+		// Every entity has CTag, so view over it visits whole scene
+		const auto view{ m_pScene->getView<CTag>() };
+		std::vector<entt::entity> enttEntities;
+		std::vector<FBoundingBox> boxes;
+		enttEntities.reserve(view.size());
+		boxes.reserve(view.size());
+		for (const entt::entity enttEntity : view) {
+			enttEntities.push_back(enttEntity);
+			boxes.push_back(computeBoundingBox(Entity(enttEntity, m_pScene->getRegistry())));
+		}
+
+		m_pScene->buildBoundingVolumes(enttEntities, boxes);
+	}
+
+	void FSceneManagerEditor::updateEntityAtBoundingVolumes(const Entity& entity) {
+		m_pScene->updateBoundingVolume(entity, computeBoundingBox(entity));
+	}
+
+	void FSceneManagerEditor::updateTransforms() {
+		const std::vector<entt::entity>& composedEntities{ FTransformSystem::update(m_pScene) };
+		if (composedEntities.empty()) {
+			return;
+		}
+
+		std::vector<FBoundingBox> boxes;
+		boxes.reserve(composedEntities.size());
+		for (const entt::entity enttEntity : composedEntities) {
+			const Entity entity(enttEntity, m_pScene->getRegistry());
+			if (entity.hasComponent<CRenderable>() && entity.getComponent<CRenderable>().isEntityRendered()) {
+				m_pBatchManager->update<CTransform>(entity);
+			}
+			if (entity.hasComponent<CPointLight>()) {
+				entity.getComponent<CPointLight>().pointLight.position =
+					maths::vec4(entity.getComponent<CTransform>().getWorldPosition(), 1.f);
+				m_pBatchManager->update<CPointLight>(entity);
+			}
+			boxes.push_back(computeBoundingBox(entity));
+		}
+
+		m_pScene->updateBoundingVolumes(composedEntities, boxes);
+	}
+
 	void FSceneManagerEditor::update() {
 		if (isPlayMode()) {
 			if (isPauseMode()) {
@@ -70,7 +118,7 @@ namespace marengine {
 	}
 
 	void FSceneManagerEditor::initPlayMode() {
-		const FEntityArray& entities{ m_pScene->getEntities() };
+		const FEntityArray entities{ m_pScene->getEntities() };
 		for (const Entity& entity : entities) {
 			FScenePlayStorage::pushEntityToStorage(entity);
 		}
@@ -121,13 +169,30 @@ namespace marengine {
 	}
 
 	void FSceneManagerEditor::exitPlayMode() {
-		const FEntityArray& entities{ m_pScene->getEntities() };
+		const FEntityArray entities{ m_pScene->getEntities() };
 
 		for (const Entity& entity : entities) {
 			FScenePlayStorage::loadEntityFromStorage(entity);
 		}
 
+		// Restored transforms must be composed, before batches and bounding volumes read them
+		FTransformSystem::update(m_pScene);
         updateSceneAtBatchManager();
+        updateSceneAtBoundingVolumes();
+	}
+
+	FBoundingBox FSceneManagerEditor::computeBoundingBox(const Entity& entity) const {
+		const auto& cTransform{ entity.getComponent<CTransform>() };
+		if (entity.hasComponent<CRenderable>()) {
+			const FMeshProxy* pMesh{ m_pMeshManager->getStorage()->retrieve(entity.getComponent<CRenderable>()) };
+			if (pMesh != nullptr) {
+				return FBoundingVolumeHierarchy::computeBox(pMesh->getBounds(), cTransform.getTransform());
+			}
+		}
+
+		// Entities without mesh (cameras, lights) are still queryable by their position
+		const maths::vec3 position{ cTransform.getWorldPosition() };
+		return { position, position };
 	}
 
 	Scene* FSceneManagerEditor::getScene() { 
@@ -35,6 +35,7 @@ namespace marengine {
 	class FBatchManager;
 	class FMeshManager;
     class FMaterialManager;
+	struct FBoundingBox;
 
 
 	/**
@@ -59,6 +60,19 @@ namespace marengine {
         // TODO: update method docs
         void updateSceneAtMaterialManager();
 
+		/// @brief Rebuilds Scene's bounding volume hierarchy from current transforms and meshes of all entities.
+		void updateSceneAtBoundingVolumes();
+
+		/// @brief Refits bounding volume of single entity, should be called whenever its transform or mesh changes.
+		void updateEntityAtBoundingVolumes(const Entity& entity);
+
+		/**
+		 * @brief Composes matrices of all transforms marked dirty since last call (see FTransformSystem) and
+		 * afterwards updates batches, bounding volumes and point lights of recomposed entities. Should be called
+		 * once per frame, before culling and batching.
+		 */
+		void updateTransforms();
+
 		/**
 		 * @brief Updates Scene in SceneManager's state. During EditorMode there is no need to update the scene,
 		 * everything should operate on events. During PlayMode we need to call update PythonScripts and then 
@@ -134,6 +148,8 @@ namespace marengine {
 		void updateEntityInPlaymode(const Entity& entity);
 		void exitPlayMode();
 
+		MAR_NO_DISCARD FBoundingBox computeBoundingBox(const Entity& entity) const;
+
 
 		Scene* m_pScene{ nullptr };
 		FBatchManager* m_pBatchManager{ nullptr };
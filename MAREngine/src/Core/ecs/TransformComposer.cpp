@@ -0,0 +1,483 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+
+
+#include "TransformComposer.h"
+#include "Entity/Components.h"
+#include "../../Logging/Logger.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define MARENGINE_TRANSFORM_COMPOSER_X86 1
+	#include <immintrin.h>
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+		// MSVC emits any intrinsic without per function target, CPU support is checked before kernel is called
+		#define MARENGINE_TARGET_SSE41
+		#define MARENGINE_TARGET_AVX2
+	#else
+		#define MARENGINE_TARGET_SSE41 __attribute__((target("sse4.1")))
+		#define MARENGINE_TARGET_AVX2 __attribute__((target("avx2")))
+	#endif
+#else
+	#define MARENGINE_TRANSFORM_COMPOSER_X86 0
+#endif
+
+
+namespace marengine {
+
+	static_assert(sizeof(maths::mat4) == 16 * sizeof(float), "Kernels write mat4 as 16 column-major floats");
+
+	static bool isKernelSupported(ETransformKernel kernel);
+	static bool isKernelMatchingRecompose(ETransformKernel kernel, float halfAngleScale);
+	static void composeWith(ETransformKernel kernel, float halfAngleScale, const FTransformsSoA& transforms,
+							maths::mat4* pOutput);
+	static void composeScalar(const FTransformsSoA& transforms, size_t begin, maths::mat4* pOutput);
+
+#if MARENGINE_TRANSFORM_COMPOSER_X86
+	MARENGINE_TARGET_SSE41 static void composeSSE41(const FTransformsSoA& transforms, float halfAngleScale,
+													maths::mat4* pOutput);
+	MARENGINE_TARGET_SSE41 static void sinCosSSE41(__m128 x, __m128* pSin, __m128* pCos);
+	MARENGINE_TARGET_SSE41 static void storeColumnSSE41(__m128 row0, __m128 row1, __m128 row2, __m128 row3,
+														uint32 column, maths::mat4* pOutput);
+
+	MARENGINE_TARGET_AVX2 static void composeAVX2(const FTransformsSoA& transforms, float halfAngleScale,
+												  maths::mat4* pOutput);
+	MARENGINE_TARGET_AVX2 static void sinCosAVX2(__m256 x, __m256* pSin, __m256* pCos);
+	MARENGINE_TARGET_AVX2 static void storeColumnAVX2(__m256 row0, __m256 row1, __m256 row2, __m256 row3,
+													  uint32 column, maths::mat4* pOutput);
+#endif
+
+	// Half of euler angle is passed to sin / cos, in degrees it is additionally converted to radians
+	constexpr float g_halfAngleScaleRadians{ 0.5f };
+	constexpr float g_halfAngleScaleDegrees{ 0.5f * 3.14159265358979f / 180.f };
+	constexpr float g_kernelTolerance{ 1e-3f };
+
+	ETransformKernel FTransformComposer::s_kernel{ ETransformKernel::AVX2 };
+	float FTransformComposer::s_halfAngleScale{ g_halfAngleScaleRadians };
+	bool FTransformComposer::s_isKernelSelected{ false };
+
+
+	void FTransformsSoA::clear() {
+		positionX.clear();
+		positionY.clear();
+		positionZ.clear();
+		rotationX.clear();
+		rotationY.clear();
+		rotationZ.clear();
+		scaleX.clear();
+		scaleY.clear();
+		scaleZ.clear();
+	}
+
+	void FTransformsSoA::reserve(size_t count) {
+		positionX.reserve(count);
+		positionY.reserve(count);
+		positionZ.reserve(count);
+		rotationX.reserve(count);
+		rotationY.reserve(count);
+		rotationZ.reserve(count);
+		scaleX.reserve(count);
+		scaleY.reserve(count);
+		scaleZ.reserve(count);
+	}
+
+	void FTransformsSoA::push(const CTransform& cTransform) {
+		positionX.push_back(cTransform.position.x);
+		positionY.push_back(cTransform.position.y);
+		positionZ.push_back(cTransform.position.z);
+		rotationX.push_back(cTransform.rotation.x);
+		rotationY.push_back(cTransform.rotation.y);
+		rotationZ.push_back(cTransform.rotation.z);
+		scaleX.push_back(cTransform.scale.x);
+		scaleY.push_back(cTransform.scale.y);
+		scaleZ.push_back(cTransform.scale.z);
+	}
+
+	size_t FTransformsSoA::size() const {
+		return positionX.size();
+	}
+
+	void FTransformComposer::compose(const FTransformsSoA& transforms, maths::mat4* pOutput) {
+		if (!s_isKernelSelected) {
+			selectKernel();
+		}
+
+		composeWith(s_kernel, s_halfAngleScale, transforms, pOutput);
+	}
+
+	void FTransformComposer::passKernel(ETransformKernel kernel) {
+		s_kernel = kernel;
+		s_isKernelSelected = false;
+	}
+
+	ETransformKernel FTransformComposer::getKernel() {
+		if (!s_isKernelSelected) {
+			selectKernel();
+		}
+
+		return s_kernel;
+	}
+
+	const char* FTransformComposer::getKernelName(ETransformKernel kernel) {
+		switch (kernel) {
+		case ETransformKernel::AVX2: return "AVX2";
+		case ETransformKernel::SSE41: return "SSE4.1";
+		default: return "Scalar";
+		}
+	}
+
+	void FTransformComposer::selectKernel() {
+		// Starting from requested kernel, falls back to narrower ones until supported and correct one is found
+		constexpr std::array<ETransformKernel, 2> vectorKernels{ ETransformKernel::AVX2, ETransformKernel::SSE41 };
+		const ETransformKernel requestedKernel{ s_kernel };
+		s_kernel = ETransformKernel::SCALAR;
+		s_halfAngleScale = g_halfAngleScaleRadians;
+		s_isKernelSelected = true;
+
+		for (const ETransformKernel kernel : vectorKernels) {
+			if (kernel > requestedKernel || !isKernelSupported(kernel)) {
+				continue;
+			}
+
+			// maths::quat may take euler angles in radians or degrees, kernel must follow the same convention
+			for (const float halfAngleScale : { g_halfAngleScaleRadians, g_halfAngleScaleDegrees }) {
+				if (isKernelMatchingRecompose(kernel, halfAngleScale)) {
+					s_kernel = kernel;
+					s_halfAngleScale = halfAngleScale;
+					MARLOG_INFO(ELoggerType::ECS, "Selected {} transform composing kernel", getKernelName(kernel));
+					return;
+				}
+			}
+
+			MARLOG_WARN(ELoggerType::ECS, "{} transform composing kernel does not match maths::mat4::recompose!",
+						getKernelName(kernel));
+		}
+
+		MARLOG_INFO(ELoggerType::ECS, "Selected {} transform composing kernel", getKernelName(s_kernel));
+	}
+
+	bool isKernelSupported(ETransformKernel kernel) {
+#if MARENGINE_TRANSFORM_COMPOSER_X86
+	#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		const int maxLeaf{ info[0] };
+		__cpuid(info, 1);
+		const bool hasSSE41{ (info[2] & (1 << 19)) != 0 };
+		// AVX registers are usable only if OS saves them at context switch (OSXSAVE + XCR0)
+		const bool isAVXEnabled{ (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 &&
+								 (_xgetbv(0) & 0x6) == 0x6 };
+		bool hasAVX2{ false };
+		if (maxLeaf >= 7 && isAVXEnabled) {
+			__cpuidex(info, 7, 0);
+			hasAVX2 = (info[1] & (1 << 5)) != 0;
+		}
+	#else
+		__builtin_cpu_init();
+		const bool hasSSE41{ __builtin_cpu_supports("sse4.1") != 0 };
+		const bool hasAVX2{ __builtin_cpu_supports("avx2") != 0 };
+	#endif
+
+		switch (kernel) {
+		case ETransformKernel::AVX2: return hasAVX2;
+		case ETransformKernel::SSE41: return hasSSE41;
+		default: return true;
+		}
+#else
+		return kernel == ETransformKernel::SCALAR;
+#endif
+	}
+
+	bool isKernelMatchingRecompose(ETransformKernel kernel, float halfAngleScale) {
+		// Two full AVX2 blocks, so that every lane of vector kernels is compared
+		constexpr size_t samplesCount{ 16 };
+		FTransformsSoA samples;
+		samples.reserve(samplesCount);
+		for (size_t i = 0; i < samplesCount; i++) {
+			const float value{ (float)i };
+			CTransform cTransform;
+			cTransform.position = maths::vec3{ 3.1f * value - 20.f, 0.5f * value, 7.f - 1.3f * value };
+			cTransform.rotation = maths::vec3{ 23.7f * value - 170.f, 41.3f * value - 300.f, 17.9f * value + 5.f };
+			cTransform.scale = maths::vec3{ 0.25f + 0.5f * value, 2.f - 0.1f * value, 1.f + 0.3f * value };
+			samples.push(cTransform);
+		}
+
+		std::vector<maths::mat4> expected(samplesCount);
+		std::vector<maths::mat4> composed(samplesCount);
+		composeScalar(samples, 0, expected.data());
+		composeWith(kernel, halfAngleScale, samples, composed.data());
+
+		for (size_t i = 0; i < samplesCount; i++) {
+			const float* pExpected{ expected[i].value_ptr() };
+			const float* pComposed{ composed[i].value_ptr() };
+			for (size_t k = 0; k < 16; k++) {
+				const float tolerance{ g_kernelTolerance * std::max(1.f, std::abs(pExpected[k])) };
+				if (std::abs(pExpected[k] - pComposed[k]) > tolerance) {
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	void composeWith(ETransformKernel kernel, float halfAngleScale, const FTransformsSoA& transforms,
+					 maths::mat4* pOutput) {
+#if MARENGINE_TRANSFORM_COMPOSER_X86
+		switch (kernel) {
+		case ETransformKernel::AVX2: composeAVX2(transforms, halfAngleScale, pOutput); return;
+		case ETransformKernel::SSE41: composeSSE41(transforms, halfAngleScale, pOutput); return;
+		default: break;
+		}
+#endif
+		composeScalar(transforms, 0, pOutput);
+	}
+
+	void composeScalar(const FTransformsSoA& transforms, size_t begin, maths::mat4* pOutput) {
+		const size_t count{ transforms.size() };
+		for (size_t i = begin; i < count; i++) {
+			const maths::vec3 position{ transforms.positionX[i], transforms.positionY[i], transforms.positionZ[i] };
+			const maths::vec3 rotation{ transforms.rotationX[i], transforms.rotationY[i], transforms.rotationZ[i] };
+			const maths::vec3 scale{ transforms.scaleX[i], transforms.scaleY[i], transforms.scaleZ[i] };
+			pOutput[i].recompose(position, maths::quat(rotation), scale);
+		}
+	}
+
+#if MARENGINE_TRANSFORM_COMPOSER_X86
+
+	void composeSSE41(const FTransformsSoA& transforms, float halfAngleScale, maths::mat4* pOutput) {
+		constexpr size_t width{ 4 };
+		const size_t count{ transforms.size() };
+		const __m128 halfScale{ _mm_set1_ps(halfAngleScale) };
+		const __m128 one{ _mm_set1_ps(1.f) };
+		const __m128 zero{ _mm_setzero_ps() };
+
+		size_t i{ 0 };
+		for (; i + width <= count; i += width) {
+			__m128 sinX, cosX, sinY, cosY, sinZ, cosZ;
+			sinCosSSE41(_mm_mul_ps(_mm_loadu_ps(&transforms.rotationX[i]), halfScale), &sinX, &cosX);
+			sinCosSSE41(_mm_mul_ps(_mm_loadu_ps(&transforms.rotationY[i]), halfScale), &sinY, &cosY);
+			sinCosSSE41(_mm_mul_ps(_mm_loadu_ps(&transforms.rotationZ[i]), halfScale), &sinZ, &cosZ);
+
+			// Quaternion from euler angles, then its rotation matrix (same as maths::quat and recompose)
+			const __m128 cosYcosZ{ _mm_mul_ps(cosY, cosZ) };
+			const __m128 sinYsinZ{ _mm_mul_ps(sinY, sinZ) };
+			const __m128 cosYsinZ{ _mm_mul_ps(cosY, sinZ) };
+			const __m128 sinYcosZ{ _mm_mul_ps(sinY, cosZ) };
+			const __m128 qw{ _mm_add_ps(_mm_mul_ps(cosX, cosYcosZ), _mm_mul_ps(sinX, sinYsinZ)) };
+			const __m128 qx{ _mm_sub_ps(_mm_mul_ps(sinX, cosYcosZ), _mm_mul_ps(cosX, sinYsinZ)) };
+			const __m128 qy{ _mm_add_ps(_mm_mul_ps(cosX, sinYcosZ), _mm_mul_ps(sinX, cosYsinZ)) };
+			const __m128 qz{ _mm_sub_ps(_mm_mul_ps(cosX, cosYsinZ), _mm_mul_ps(sinX, sinYcosZ)) };
+
+			const __m128 qx2{ _mm_add_ps(qx, qx) };
+			const __m128 qy2{ _mm_add_ps(qy, qy) };
+			const __m128 qz2{ _mm_add_ps(qz, qz) };
+			const __m128 xx{ _mm_mul_ps(qx, qx2) };
+			const __m128 yy{ _mm_mul_ps(qy, qy2) };
+			const __m128 zz{ _mm_mul_ps(qz, qz2) };
+			const __m128 xy{ _mm_mul_ps(qx, qy2) };
+			const __m128 xz{ _mm_mul_ps(qx, qz2) };
+			const __m128 yz{ _mm_mul_ps(qy, qz2) };
+			const __m128 wx{ _mm_mul_ps(qw, qx2) };
+			const __m128 wy{ _mm_mul_ps(qw, qy2) };
+			const __m128 wz{ _mm_mul_ps(qw, qz2) };
+
+			const __m128 scaleX{ _mm_loadu_ps(&transforms.scaleX[i]) };
+			const __m128 scaleY{ _mm_loadu_ps(&transforms.scaleY[i]) };
+			const __m128 scaleZ{ _mm_loadu_ps(&transforms.scaleZ[i]) };
+
+			maths::mat4* pMatrices{ pOutput + i };
+			storeColumnSSE41(_mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), scaleX),
+							 _mm_mul_ps(_mm_add_ps(xy, wz), scaleX),
+							 _mm_mul_ps(_mm_sub_ps(xz, wy), scaleX),
+							 zero, 0, pMatrices);
+			storeColumnSSE41(_mm_mul_ps(_mm_sub_ps(xy, wz), scaleY),
+							 _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), scaleY),
+							 _mm_mul_ps(_mm_add_ps(yz, wx), scaleY),
+							 zero, 1, pMatrices);
+			storeColumnSSE41(_mm_mul_ps(_mm_add_ps(xz, wy), scaleZ),
+							 _mm_mul_ps(_mm_sub_ps(yz, wx), scaleZ),
+							 _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), scaleZ),
+							 zero, 2, pMatrices);
+			storeColumnSSE41(_mm_loadu_ps(&transforms.positionX[i]),
+							 _mm_loadu_ps(&transforms.positionY[i]),
+							 _mm_loadu_ps(&transforms.positionZ[i]),
+							 one, 3, pMatrices);
+		}
+
+		composeScalar(transforms, i, pOutput);
+	}
+
+	void sinCosSSE41(__m128 x, __m128* pSin, __m128* pCos) {
+		// Reduction to [-pi/4, pi/4] by nearest multiple of pi/2 (subtracted in three parts to keep precision)
+		const __m128 quadrant{ _mm_round_ps(_mm_mul_ps(x, _mm_set1_ps(0.636619772f)),
+											_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC) };
+		__m128 r{ _mm_sub_ps(x, _mm_mul_ps(quadrant, _mm_set1_ps(1.5703125f))) };
+		r = _mm_sub_ps(r, _mm_mul_ps(quadrant, _mm_set1_ps(4.837512969970703125e-4f)));
+		r = _mm_sub_ps(r, _mm_mul_ps(quadrant, _mm_set1_ps(7.54978995489188216e-8f)));
+		const __m128 r2{ _mm_mul_ps(r, r) };
+
+		__m128 sinPoly{ _mm_add_ps(_mm_mul_ps(r2, _mm_set1_ps(-1.9515295891e-4f)), _mm_set1_ps(8.3321608736e-3f)) };
+		sinPoly = _mm_add_ps(_mm_mul_ps(sinPoly, r2), _mm_set1_ps(-1.6666654611e-1f));
+		sinPoly = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sinPoly, r2), r), r);
+
+		__m128 cosPoly{ _mm_add_ps(_mm_mul_ps(r2, _mm_set1_ps(2.443315711809948e-5f)),
+								   _mm_set1_ps(-1.388731625493765e-3f)) };
+		cosPoly = _mm_add_ps(_mm_mul_ps(cosPoly, r2), _mm_set1_ps(4.166664568298827e-2f));
+		cosPoly = _mm_mul_ps(_mm_mul_ps(cosPoly, r2), r2);
+		cosPoly = _mm_add_ps(_mm_sub_ps(cosPoly, _mm_mul_ps(r2, _mm_set1_ps(0.5f))), _mm_set1_ps(1.f));
+
+		// Odd quadrants swap sin with cos, quadrants 2, 3 negate sin and 1, 2 negate cos
+		const __m128i quadrantIndex{ _mm_cvtps_epi32(quadrant) };
+		const __m128i one{ _mm_set1_epi32(1) };
+		const __m128i two{ _mm_set1_epi32(2) };
+		const __m128 isSwapped{ _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrantIndex, one), one)) };
+		const __m128i sinSign{ _mm_slli_epi32(_mm_and_si128(quadrantIndex, two), 30) };
+		const __m128i cosSign{ _mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrantIndex, one), two), 30) };
+		*pSin = _mm_xor_ps(_mm_blendv_ps(sinPoly, cosPoly, isSwapped), _mm_castsi128_ps(sinSign));
+		*pCos = _mm_xor_ps(_mm_blendv_ps(cosPoly, sinPoly, isSwapped), _mm_castsi128_ps(cosSign));
+	}
+
+	void storeColumnSSE41(__m128 row0, __m128 row1, __m128 row2, __m128 row3, uint32 column, maths::mat4* pOutput) {
+		// Rows hold given column of 4 matrices, after transpose every register holds whole column of one matrix
+		_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+		_mm_storeu_ps(pOutput[0].value_ptr_nonconst() + 4 * column, row0);
+		_mm_storeu_ps(pOutput[1].value_ptr_nonconst() + 4 * column, row1);
+		_mm_storeu_ps(pOutput[2].value_ptr_nonconst() + 4 * column, row2);
+		_mm_storeu_ps(pOutput[3].value_ptr_nonconst() + 4 * column, row3);
+	}
+
+	void composeAVX2(const FTransformsSoA& transforms, float halfAngleScale, maths::mat4* pOutput) {
+		constexpr size_t width{ 8 };
+		const size_t count{ transforms.size() };
+		const __m256 halfScale{ _mm256_set1_ps(halfAngleScale) };
+		const __m256 one{ _mm256_set1_ps(1.f) };
+		const __m256 zero{ _mm256_setzero_ps() };
+
+		size_t i{ 0 };
+		for (; i + width <= count; i += width) {
+			__m256 sinX, cosX, sinY, cosY, sinZ, cosZ;
+			sinCosAVX2(_mm256_mul_ps(_mm256_loadu_ps(&transforms.rotationX[i]), halfScale), &sinX, &cosX);
+			sinCosAVX2(_mm256_mul_ps(_mm256_loadu_ps(&transforms.rotationY[i]), halfScale), &sinY, &cosY);
+			sinCosAVX2(_mm256_mul_ps(_mm256_loadu_ps(&transforms.rotationZ[i]), halfScale), &sinZ, &cosZ);
+
+			const __m256 cosYcosZ{ _mm256_mul_ps(cosY, cosZ) };
+			const __m256 sinYsinZ{ _mm256_mul_ps(sinY, sinZ) };
+			const __m256 cosYsinZ{ _mm256_mul_ps(cosY, sinZ) };
+			const __m256 sinYcosZ{ _mm256_mul_ps(sinY, cosZ) };
+			const __m256 qw{ _mm256_add_ps(_mm256_mul_ps(cosX, cosYcosZ), _mm256_mul_ps(sinX, sinYsinZ)) };
+			const __m256 qx{ _mm256_sub_ps(_mm256_mul_ps(sinX, cosYcosZ), _mm256_mul_ps(cosX, sinYsinZ)) };
+			const __m256 qy{ _mm256_add_ps(_mm256_mul_ps(cosX, sinYcosZ), _mm256_mul_ps(sinX, cosYsinZ)) };
+			const __m256 qz{ _mm256_sub_ps(_mm256_mul_ps(cosX, cosYsinZ), _mm256_mul_ps(sinX, sinYcosZ)) };
+
+			const __m256 qx2{ _mm256_add_ps(qx, qx) };
+			const __m256 qy2{ _mm256_add_ps(qy, qy) };
+			const __m256 qz2{ _mm256_add_ps(qz, qz) };
+			const __m256 xx{ _mm256_mul_ps(qx, qx2) };
+			const __m256 yy{ _mm256_mul_ps(qy, qy2) };
+			const __m256 zz{ _mm256_mul_ps(qz, qz2) };
+			const __m256 xy{ _mm256_mul_ps(qx, qy2) };
+			const __m256 xz{ _mm256_mul_ps(qx, qz2) };
+			const __m256 yz{ _mm256_mul_ps(qy, qz2) };
+			const __m256 wx{ _mm256_mul_ps(qw, qx2) };
+			const __m256 wy{ _mm256_mul_ps(qw, qy2) };
+			const __m256 wz{ _mm256_mul_ps(qw, qz2) };
+
+			const __m256 scaleX{ _mm256_loadu_ps(&transforms.scaleX[i]) };
+			const __m256 scaleY{ _mm256_loadu_ps(&transforms.scaleY[i]) };
+			const __m256 scaleZ{ _mm256_loadu_ps(&transforms.scaleZ[i]) };
+
+			maths::mat4* pMatrices{ pOutput + i };
+			storeColumnAVX2(_mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(yy, zz)), scaleX),
+							_mm256_mul_ps(_mm256_add_ps(xy, wz), scaleX),
+							_mm256_mul_ps(_mm256_sub_ps(xz, wy), scaleX),
+							zero, 0, pMatrices);
+			storeColumnAVX2(_mm256_mul_ps(_mm256_sub_ps(xy, wz), scaleY),
+							_mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, zz)), scaleY),
+							_mm256_mul_ps(_mm256_add_ps(yz, wx), scaleY),
+							zero, 1, pMatrices);
+			storeColumnAVX2(_mm256_mul_ps(_mm256_add_ps(xz, wy), scaleZ),
+							_mm256_mul_ps(_mm256_sub_ps(yz, wx), scaleZ),
+							_mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, yy)), scaleZ),
+							zero, 2, pMatrices);
+			storeColumnAVX2(_mm256_loadu_ps(&transforms.positionX[i]),
+							_mm256_loadu_ps(&transforms.positionY[i]),
+							_mm256_loadu_ps(&transforms.positionZ[i]),
+							one, 3, pMatrices);
+		}
+
+		composeScalar(transforms, i, pOutput);
+	}
+
+	void sinCosAVX2(__m256 x, __m256* pSin, __m256* pCos) {
+		const __m256 quadrant{ _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(0.636619772f)),
+											   _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC) };
+		__m256 r{ _mm256_sub_ps(x, _mm256_mul_ps(quadrant, _mm256_set1_ps(1.5703125f))) };
+		r = _mm256_sub_ps(r, _mm256_mul_ps(quadrant, _mm256_set1_ps(4.837512969970703125e-4f)));
+		r = _mm256_sub_ps(r, _mm256_mul_ps(quadrant, _mm256_set1_ps(7.54978995489188216e-8f)));
+		const __m256 r2{ _mm256_mul_ps(r, r) };
+
+		__m256 sinPoly{ _mm256_add_ps(_mm256_mul_ps(r2, _mm256_set1_ps(-1.9515295891e-4f)),
+									  _mm256_set1_ps(8.3321608736e-3f)) };
+		sinPoly = _mm256_add_ps(_mm256_mul_ps(sinPoly, r2), _mm256_set1_ps(-1.6666654611e-1f));
+		sinPoly = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(sinPoly, r2), r), r);
+
+		__m256 cosPoly{ _mm256_add_ps(_mm256_mul_ps(r2, _mm256_set1_ps(2.443315711809948e-5f)),
+									  _mm256_set1_ps(-1.388731625493765e-3f)) };
+		cosPoly = _mm256_add_ps(_mm256_mul_ps(cosPoly, r2), _mm256_set1_ps(4.166664568298827e-2f));
+		cosPoly = _mm256_mul_ps(_mm256_mul_ps(cosPoly, r2), r2);
+		cosPoly = _mm256_add_ps(_mm256_sub_ps(cosPoly, _mm256_mul_ps(r2, _mm256_set1_ps(0.5f))), _mm256_set1_ps(1.f));
+
+		const __m256i quadrantIndex{ _mm256_cvtps_epi32(quadrant) };
+		const __m256i one{ _mm256_set1_epi32(1) };
+		const __m256i two{ _mm256_set1_epi32(2) };
+		const __m256 isSwapped{ _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrantIndex, one), one)) };
+		const __m256i sinSign{ _mm256_slli_epi32(_mm256_and_si256(quadrantIndex, two), 30) };
+		const __m256i cosSign{ _mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(quadrantIndex, one), two), 30) };
+		*pSin = _mm256_xor_ps(_mm256_blendv_ps(sinPoly, cosPoly, isSwapped), _mm256_castsi256_ps(sinSign));
+		*pCos = _mm256_xor_ps(_mm256_blendv_ps(cosPoly, sinPoly, isSwapped), _mm256_castsi256_ps(cosSign));
+	}
+
+	void storeColumnAVX2(__m256 row0, __m256 row1, __m256 row2, __m256 row3, uint32 column, maths::mat4* pOutput) {
+		// Transpose works within 128-bit lanes, low lanes hold matrices 0-3 and high lanes matrices 4-7
+		const __m256 low01{ _mm256_unpacklo_ps(row0, row1) };
+		const __m256 high01{ _mm256_unpackhi_ps(row0, row1) };
+		const __m256 low23{ _mm256_unpacklo_ps(row2, row3) };
+		const __m256 high23{ _mm256_unpackhi_ps(row2, row3) };
+		const __m256 columns04{ _mm256_shuffle_ps(low01, low23, _MM_SHUFFLE(1, 0, 1, 0)) };
+		const __m256 columns15{ _mm256_shuffle_ps(low01, low23, _MM_SHUFFLE(3, 2, 3, 2)) };
+		const __m256 columns26{ _mm256_shuffle_ps(high01, high23, _MM_SHUFFLE(1, 0, 1, 0)) };
+		const __m256 columns37{ _mm256_shuffle_ps(high01, high23, _MM_SHUFFLE(3, 2, 3, 2)) };
+
+		_mm_storeu_ps(pOutput[0].value_ptr_nonconst() + 4 * column, _mm256_castps256_ps128(columns04));
+		_mm_storeu_ps(pOutput[1].value_ptr_nonconst() + 4 * column, _mm256_castps256_ps128(columns15));
+		_mm_storeu_ps(pOutput[2].value_ptr_nonconst() + 4 * column, _mm256_castps256_ps128(columns26));
+		_mm_storeu_ps(pOutput[3].value_ptr_nonconst() + 4 * column, _mm256_castps256_ps128(columns37));
+		_mm_storeu_ps(pOutput[4].value_ptr_nonconst() + 4 * column, _mm256_extractf128_ps(columns04, 1));
+		_mm_storeu_ps(pOutput[5].value_ptr_nonconst() + 4 * column, _mm256_extractf128_ps(columns15, 1));
+		_mm_storeu_ps(pOutput[6].value_ptr_nonconst() + 4 * column, _mm256_extractf128_ps(columns26, 1));
+		_mm_storeu_ps(pOutput[7].value_ptr_nonconst() + 4 * column, _mm256_extractf128_ps(columns37, 1));
+	}
+
+#endif
+
+
+}
@@ -0,0 +1,105 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+
+
+#ifndef MAR_ENGINE_ECS_TRANSFORM_COMPOSER_H
+#define MAR_ENGINE_ECS_TRANSFORM_COMPOSER_H
+
+
+#include "../../mar.h"
+
+
+namespace marengine {
+
+	struct CTransform;
+
+
+	/**
+	 * @struct FTransformsSoA TransformComposer.h "Core/ecs/TransformComposer.h"
+	 * @brief Position, rotation (euler angles) and scale of many CTransform components laid out as structure
+	 * of arrays, so that composing kernels can load the same component of several transforms at once.
+	 */
+	struct FTransformsSoA {
+
+		void clear();
+		void reserve(size_t count);
+		void push(const CTransform& cTransform);
+
+		MAR_NO_DISCARD size_t size() const;
+
+		std::vector<float> positionX;
+		std::vector<float> positionY;
+		std::vector<float> positionZ;
+		std::vector<float> rotationX;
+		std::vector<float> rotationY;
+		std::vector<float> rotationZ;
+		std::vector<float> scaleX;
+		std::vector<float> scaleY;
+		std::vector<float> scaleZ;
+
+	};
+
+
+	enum class ETransformKernel {
+		SCALAR, SSE41, AVX2
+	};
+
+
+	/**
+	 * @class FTransformComposer TransformComposer.h "Core/ecs/TransformComposer.h"
+	 * @brief Composes many translation * rotation * scale matrices in one call. SSE4.1 / AVX2 kernels compose
+	 * 4 / 8 matrices at once, the fastest one supported by CPU is selected on first use. Every kernel is checked
+	 * against maths::mat4::recompose before it is selected, scalar one (which calls recompose) is the fallback.
+	 */
+	class FTransformComposer {
+	public:
+
+		/**
+		 * @brief Composes matrices of all transforms with selected kernel.
+		 * @param transforms transforms to compose
+		 * @param pOutput column-major matrices are written here, it must hold at least transforms.size() matrices
+		 */
+		static void compose(const FTransformsSoA& transforms, maths::mat4* pOutput);
+
+		/**
+		 * @brief Forces given kernel (e.g. to compare it against scalar one), if CPU does not support it or it
+		 * does not match maths::mat4::recompose, scalar kernel is used.
+		 * @param kernel kernel, that should be used by compose
+		 */
+		static void passKernel(ETransformKernel kernel);
+		MAR_NO_DISCARD static ETransformKernel getKernel();
+		MAR_NO_DISCARD static const char* getKernelName(ETransformKernel kernel);
+
+	private:
+
+		static void selectKernel();
+
+		static ETransformKernel s_kernel;
+		static float s_halfAngleScale;
+		static bool s_isKernelSelected;
+
+	};
+
+
+}
+
+
+#endif // !MAR_ENGINE_ECS_TRANSFORM_COMPOSER_H
@@ -0,0 +1,102 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+
+
+#include "TransformSystem.h"
+#include "Scene.h"
+
+
+namespace marengine {
+
+
+	std::vector<entt::entity> FTransformSystem::s_dirtyEntities;
+	FTransformsSoA FTransformSystem::s_dirtyTransforms;
+	std::vector<maths::mat4> FTransformSystem::s_localTransforms;
+
+
+	const std::vector<entt::entity>& FTransformSystem::update(Scene* pScene) {
+		s_dirtyEntities.clear();
+		if (pScene == nullptr) {
+			return s_dirtyEntities;
+		}
+
+		entt::registry* pRegistry{ pScene->getRegistry() };
+		FDirtyList* pDirtyList{ pRegistry->try_ctx<FDirtyList>() };
+		if (pDirtyList == nullptr || pDirtyList->entities.empty()) {
+			return s_dirtyEntities;
+		}
+
+		// Listed entities may be destroyed since or listed many times, the list is left empty for next frame
+		s_dirtyEntities.swap(pDirtyList->entities);
+		const auto isDestroyed = [pRegistry](entt::entity enttEntity) { return !pRegistry->valid(enttEntity); };
+		s_dirtyEntities.erase(std::remove_if(s_dirtyEntities.begin(), s_dirtyEntities.end(), isDestroyed),
+							  s_dirtyEntities.end());
+		std::sort(s_dirtyEntities.begin(), s_dirtyEntities.end());
+		s_dirtyEntities.erase(std::unique(s_dirtyEntities.begin(), s_dirtyEntities.end()), s_dirtyEntities.end());
+
+		// Subtrees of listed entities are appended, children listed on their own are expanded only once
+		const auto listedEnd{ (std::ptrdiff_t)s_dirtyEntities.size() };
+		for (size_t i = 0; i < s_dirtyEntities.size(); i++) {
+			entt::entity child{ pRegistry->get<CHierarchy>(s_dirtyEntities[i]).firstChild };
+			while (child != entt::null) {
+				if (!std::binary_search(s_dirtyEntities.cbegin(), s_dirtyEntities.cbegin() + listedEnd, child)) {
+					pRegistry->get<CTransform>(child).markDirty();
+					s_dirtyEntities.push_back(child);
+				}
+				child = pRegistry->get<CHierarchy>(child).nextSibling;
+			}
+		}
+
+		std::sort(s_dirtyEntities.begin(), s_dirtyEntities.end(), [pRegistry](entt::entity lhs, entt::entity rhs) {
+			return pRegistry->get<CHierarchy>(lhs).depth < pRegistry->get<CHierarchy>(rhs).depth;
+		});
+
+		s_dirtyTransforms.clear();
+		for (const entt::entity enttEntity : s_dirtyEntities) {
+			s_dirtyTransforms.push(pRegistry->get<CTransform>(enttEntity));
+		}
+
+		const uint32 dirtyCount{ (uint32)s_dirtyEntities.size() };
+		s_localTransforms.resize(dirtyCount);
+		FTransformComposer::compose(s_dirtyTransforms, s_localTransforms.data());
+
+		// Still in depth order, so parent's world matrix is already cached, when its child is visited
+		for (uint32 i = 0; i < dirtyCount; i++) {
+			const entt::entity parent{ pRegistry->get<CHierarchy>(s_dirtyEntities[i]).parent };
+			const CTransform& cTransform{ pRegistry->get<CTransform>(s_dirtyEntities[i]) };
+			if (parent == entt::null) {
+				cTransform.passTransform(s_localTransforms[i]);
+			}
+			else {
+				cTransform.passTransform(pRegistry->get<CTransform>(parent).getTransform() * s_localTransforms[i]);
+			}
+		}
+
+		return s_dirtyEntities;
+	}
+
+	void FTransformSystem::markDirty(const Entity& entity) {
+		entity.getComponent<CTransform>().markDirty();
+		entity.m_pSceneRegistry->ctx_or_set<FDirtyList>().entities.push_back(entity.m_entityHandle);
+	}
+
+
+}
@@ -0,0 +1,83 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+
+
+#ifndef MAR_ENGINE_ECS_TRANSFORM_SYSTEM_H
+#define MAR_ENGINE_ECS_TRANSFORM_SYSTEM_H
+
+
+#include "../../mar.h"
+#include "TransformComposer.h"
+
+
+namespace marengine {
+
+	class Scene;
+	class Entity;
+
+
+	/**
+	 * @class FTransformSystem TransformSystem.h "Core/ecs/TransformSystem.h"
+	 * @brief Composes cached world matrices of dirty CTransform components, child matrices are multiplied by
+	 * world matrix of their parent (see CHierarchy). Events only mark transforms dirty and list their entities
+	 * (see markDirty), calling update once per frame (before culling and batching) does all of the work over
+	 * listed entities and their subtrees sorted by depth, so that consumers only read cached matrices. Local
+	 * matrices of all dirty transforms are composed at once with FTransformComposer (SIMD kernels), only then
+	 * children are multiplied by parents. Frame without listed entities touches no transform.
+	 */
+	class FTransformSystem {
+	public:
+
+		/**
+		 * @brief Composes world matrix of every entity listed with markDirty at given scene and of all of their
+		 * descendants. Composed entities are sorted by hierarchy depth, so that parents are visited before their
+		 * children. Returns right away, if nothing was listed since last call.
+		 * @param pScene scene, which transforms should be updated
+		 * @return entities with composed matrices in depth order, valid until next update call
+		 */
+		static const std::vector<entt::entity>& update(Scene* pScene);
+
+		/**
+		 * @brief Marks transform of given entity dirty and lists entity for next update at its scene. Must be
+		 * called whenever position, rotation, scale or depth of entity is changed, as update composes only listed
+		 * entities (CTransform::markDirty alone does not list it).
+		 * @param entity valid entity with CTransform
+		 */
+		static void markDirty(const Entity& entity);
+
+	private:
+
+		/// @brief Entities listed with markDirty, kept at context of scene registry, so that scenes do not share it
+		struct FDirtyList {
+			std::vector<entt::entity> entities;
+		};
+
+		// Reused between updates, so that composing every frame does not allocate
+		static std::vector<entt::entity> s_dirtyEntities;
+		static FTransformsSoA s_dirtyTransforms;
+		static std::vector<maths::mat4> s_localTransforms;
+
+	};
+
+}
+
+
+#endif // !MAR_ENGINE_ECS_TRANSFORM_SYSTEM_H
@@ -25,6 +25,7 @@
 #include "../../../ProjectManager.h"
 #include "MARJsonDefinitions.inl"
 #include "../../ecs/Scene.h"
+#include "../../ecs/TransformSystem.h"
 
 
 namespace marengine {
@@ -60,13 +61,13 @@ namespace marengine {
 
 		uint32_t i = 0;
 		for (nlohmann::json& jsonEntity : json[jScene][sceneName][jEntity]) {
-			const Entity& entity{ pScene->createEntity() };
+			const Entity entity{ pScene->createEntity() };
 			loadEntity(entity, i, json, sceneName);
 			i++;
 		}
 
 		MARLOG_INFO(ELoggerType::FILESYSTEM, "Loaded scene {}\n-Scene {}\n-Entities {}",
-              path, pScene->getName(), pScene->getEntities().size());
+              path, pScene->getName(), pScene->getEntitiesCount());
 	}
 
 	void loadEntity(const Entity& entity, uint32_t index, nlohmann::json& json, const std::string& sceneName) {
@@ -107,6 +108,7 @@ namespace marengine {
         cTransform.position = loadVec3(jCTransform, jCTransformPosition);
         cTransform.rotation = loadVec3(jCTransform, jCTransformRotation);
         cTransform.scale = loadVec3(jCTransform, jCTransformScale);
+        FTransformSystem::markDirty(entity);
 
 		if (jsonContains(jCRenderable)) {
 			auto& cRenderable{ entity.addComponent<CRenderable>() };
@@ -51,7 +51,7 @@ namespace marengine {
 		json[jScene][sceneName][jSceneBackground][jY] = background.y;
 		json[jScene][sceneName][jSceneBackground][jZ] = background.z;
 
-		const std::vector<Entity>& entities{ scene->getEntities() };
+		const FEntityArray entities{ scene->getEntities() };
 		const auto entitiesSize{ entities.size() };
 
 		for (auto i = 0; i < entitiesSize; i++) {
@@ -0,0 +1,125 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+#include "../public/BatchFillWorkers.h"
+#include "../public/MeshBatch.h"
+#include "../../../Logging/Logger.h"
+
+
+namespace marengine {
+
+
+    FBatchFillWorkers::~FBatchFillWorkers() {
+        close();
+    }
+
+    void FBatchFillWorkers::fill(const std::vector<FMeshBatchStatic*>& batches, uint32 fillsCount) {
+        if(batches.size() < 2 || fillsCount < GraphicLimits::minParallelFillsCount) {
+            MARLOG_DEBUG(ELoggerType::GRAPHICS, "Filling {} batches ({} entities) serially...", batches.size(),
+                         fillsCount);
+            for(FMeshBatchStatic* pBatch : batches) {
+                pBatch->fillDeferred();
+            }
+            return;
+        }
+
+        if(m_workers.empty()) {
+            spawnWorkers();
+        }
+        MARLOG_DEBUG(ELoggerType::GRAPHICS, "Filling {} batches ({} entities) with {} workers...", batches.size(),
+                     fillsCount, m_workers.size() + 1);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pBatches = &batches;
+            m_nextBatch = 0;
+            m_busyWorkersCount = (uint32)m_workers.size();
+            m_jobIndex++;
+        }
+        m_jobStarted.notify_all();
+
+        fillNextBatches();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_jobFinished.wait(lock, [this]() { return m_busyWorkersCount == 0; });
+        m_pBatches = nullptr;
+    }
+
+    void FBatchFillWorkers::close() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_isClosing = true;
+        }
+        m_jobStarted.notify_all();
+        for(std::thread& worker : m_workers) {
+            worker.join();
+        }
+        m_workers.clear();
+        m_isClosing = false;
+    }
+
+    uint32 FBatchFillWorkers::getWorkersCount() const {
+        return (uint32)m_workers.size();
+    }
+
+    void FBatchFillWorkers::spawnWorkers() {
+        // Calling thread fills batches too, so one hardware thread is left for it
+        const uint32 hardwareThreads{ std::max(std::thread::hardware_concurrency(), 1u) };
+        const uint32 workersCount{ hardwareThreads - 1 };
+        MARLOG_INFO(ELoggerType::GRAPHICS, "Spawning {} batch fill workers...", workersCount);
+        m_workers.reserve(workersCount);
+        for(uint32 i = 0; i < workersCount; i++) {
+            m_workers.emplace_back(&FBatchFillWorkers::work, this, m_jobIndex);
+        }
+    }
+
+    void FBatchFillWorkers::work(uint32 jobIndex) {
+        while(true) {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_jobStarted.wait(lock, [this, jobIndex]() { return m_isClosing || m_jobIndex != jobIndex; });
+                if(m_isClosing) {
+                    return;
+                }
+                jobIndex = m_jobIndex;
+            }
+
+            fillNextBatches();
+
+            bool isLastWorker{ false };
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                isLastWorker = --m_busyWorkersCount == 0;
+            }
+            if(isLastWorker) {
+                m_jobFinished.notify_one();
+            }
+        }
+    }
+
+    void FBatchFillWorkers::fillNextBatches() {
+        const std::vector<FMeshBatchStatic*>& batches{ *m_pBatches };
+        for(uint32 i = m_nextBatch++; i < batches.size(); i = m_nextBatch++) {
+            batches[i]->fillDeferred();
+        }
+    }
+
+
+}
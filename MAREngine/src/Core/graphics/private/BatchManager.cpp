@@ -22,6 +22,7 @@
 
 #include "../public/BatchManager.h"
 #include "../public/RenderManager.h"
+#include "../public/RenderCamera.h"
 #include "../public/MeshManager.h"
 #include "../public/MaterialManager.h"
 #include "../../ecs/Entity/EventsCameraEntity.h"
@@ -33,10 +34,45 @@
 namespace marengine {
 
 
+    void FOpenBatchList::reset() {
+        m_batches.clear();
+    }
+
+    void FOpenBatchList::open(int32 textureSetKey, int32 batchIndex) {
+        m_batches[textureSetKey].push_back(batchIndex);
+    }
+
+    void FOpenBatchList::close(int32 textureSetKey, int32 batchIndex) {
+        const auto it{ m_batches.find(textureSetKey) };
+        if(it == m_batches.end()) {
+            return;
+        }
+        std::vector<int32>& batches{ it->second };
+        batches.erase(std::remove(batches.begin(), batches.end(), batchIndex), batches.end());
+    }
+
+    const std::vector<int32>& FOpenBatchList::getBatches(int32 textureSetKey) const {
+        static const std::vector<int32> noBatches;
+        const auto it{ m_batches.find(textureSetKey) };
+        return it != m_batches.cend() ? it->second : noBatches;
+    }
+
+    int32 FOpenBatchList::getTextureSetKey(const FMaterialStorage* pMaterialStorage,
+                                           const CRenderable& cRenderable) {
+        const bool hasTexture{ cRenderable.material.isValid() && cRenderable.material.type == EMaterialType::TEX2D };
+        if(!hasTexture || pMaterialStorage == nullptr || pMaterialStorage->isBindless()) {
+            return -1;
+        }
+        return pMaterialStorage->getTex2D(cRenderable.material.index)->getPlacement().arrayIndex;
+    }
+
+
     void FBatchManager::create(FRenderManager* pRenderManager, FMeshStorage* pMeshStorage,
                                FMaterialStorage* pMaterialStorage) {
         MARLOG_TRACE(ELoggerType::GRAPHICS, "Creating Batch Manager...");
         m_pRenderManager = pRenderManager;
+        m_pMeshStorage = pMeshStorage;
+        m_pMaterialStorage = pMaterialStorage;
         m_meshBatchFactory.passMeshStorage(pMeshStorage);
         m_meshBatchFactory.passMaterialStorage(pMaterialStorage);
     }
@@ -63,27 +99,78 @@ namespace marengine {
         return const_cast<FLightBatchStorage*>(m_lightFactory.getStorage());
     }
 
+    template<typename TMeshBatchStorage>
+    static uint32 collectDeferredBatches(TMeshBatchStorage* pMeshBatchStorage, std::vector<FMeshBatchStatic*>& batches);
+
     void FBatchManager::pushSceneToRender(Scene* pScene) {
         MARLOG_TRACE(ELoggerType::GRAPHICS, "Pushing scene {} to render...", pScene->getName());
-        m_pRenderManager->reset();
+        if(m_pRenderManager != nullptr) {
+            m_pRenderManager->reset();
+        }
+        batchScene(pScene);
+        if(m_pRenderManager != nullptr) {
+            m_pRenderManager->onBatchesReadyToDraw(this);
+        }
+        MARLOG_INFO(ELoggerType::GRAPHICS, "Pushed scene {} to render!", pScene->getName());
+    }
+
+    void FBatchManager::batchScene(Scene* pScene) {
         reset();
 
-        const FEntityArray& entities{ pScene->getEntities() };
+        const FEntityArray entities{ pScene->getEntities() };
+        m_visibleEntities.clear();
+        m_meshUsagesCount.clear();
+        m_openStaticColor.reset();
+        m_openStaticTex2D.reset();
+        m_openInstancedColor.clear();
+        m_openInstancedTex2D.clear();
+        for(const Entity& entity : entities) {
+            if(entity.hasComponent<CRenderable>()) {
+                const FMeshProxy* pMesh{ m_pMeshStorage->retrieve(entity.getComponent<CRenderable>()) };
+                m_meshUsagesCount[pMesh]++;
+            }
+        }
+
+        // Assignment pass is serial and only reserves place at batches, they are filled in parallel after it
+        m_meshBatchFactory.passDeferredFill(true);
         for(const Entity& entity : entities) {
             pushEntityToRender(entity);
         }
-        m_pRenderManager->onBatchesReadyToDraw(this);
-        MARLOG_INFO(ELoggerType::GRAPHICS, "Pushed scene {} to render!", pScene->getName());
+        m_meshBatchFactory.passDeferredFill(false);
+        std::vector<FMeshBatchStatic*> deferredBatches;
+        uint32 deferredFillsCount{ 0 };
+        deferredFillsCount += collectDeferredBatches(getMeshBatchStorage()->getStorageStaticColor(), deferredBatches);
+        deferredFillsCount += collectDeferredBatches(getMeshBatchStorage()->getStorageStaticTex2D(), deferredBatches);
+        deferredFillsCount += collectDeferredBatches(getMeshBatchStorage()->getStorageInstancedColor(), deferredBatches);
+        deferredFillsCount += collectDeferredBatches(getMeshBatchStorage()->getStorageInstancedTex2D(), deferredBatches);
+        m_fillWorkers.fill(deferredBatches, deferredFillsCount);
+        m_meshUsagesCount.clear();
+        m_openStaticColor.reset();
+        m_openStaticTex2D.reset();
+        m_openInstancedColor.clear();
+        m_openInstancedTex2D.clear();
     }
 
-    template<typename TMeshBatchArray>
-    static int32 getAvailableBatch(TMeshBatchArray* pBatchArray, const Entity& entity);
+    template<typename TMeshBatchStorage>
+    static int32 getAvailableBatch(TMeshBatchStorage* pMeshBatchStorage, FOpenBatchList& openBatches,
+                                   int32 textureSetKey, const FMeshProxy* pMesh, const Entity& entity);
 
     template<typename TMeshBatchStorage>
     static bool pushEntityToBatchStorage(TMeshBatchStorage* pMeshBatchStorage,
                                          FMeshBatchFactory* pFactory,
+                                         FOpenBatchList& openBatches,
+                                         int32 textureSetKey,
+                                         const FMeshProxy* pMesh,
                                          const Entity& entity);
 
+    template<typename TMeshBatchStorage>
+    static bool pushEntityToInstancedBatchStorage(TMeshBatchStorage* pMeshBatchStorage,
+                                                  FMeshBatchFactory* pFactory,
+                                                  std::unordered_map<int64, int32>& openBatches,
+                                                  const Entity& entity);
+
+    static int64 getInstancedMeshKey(const CRenderable& cRenderable);
+
     void FBatchManager::pushEntityToRender(const Entity& entity) {
         const std::string& entityTag{ entity.getComponent<CTag>().tag };
         MARLOG_TRACE(ELoggerType::GRAPHICS, "Push entity {} to render...", entityTag);
@@ -91,15 +178,33 @@ namespace marengine {
             MARLOG_TRACE(ELoggerType::GRAPHICS, "Entity {} has CRenderable, trying to push assigned mesh and material...",
                          entityTag);
             [&entity, &entityTag, this]() {
+                const FMeshProxy* pMesh{ m_pMeshStorage->retrieve(entity.getComponent<CRenderable>()) };
+                const int32 textureSetKey{
+                    FOpenBatchList::getTextureSetKey(m_pMaterialStorage, entity.getComponent<CRenderable>()) };
+                if(isMeshInstanced(entity.getComponent<CRenderable>())) {
+                    MARLOG_TRACE(ELoggerType::GRAPHICS, "Mesh of {} entity is shared, validating instanced batches...",
+                                 entityTag);
+                    const auto& material{ entity.getComponent<CRenderable>().material };
+                    const bool isTex2D{ material.isValid() && material.type == EMaterialType::TEX2D };
+                    const bool pushed{ isTex2D ?
+                        pushEntityToInstancedBatchStorage(getMeshBatchStorage()->getStorageInstancedTex2D(),
+                                                          getMeshBatchFactory(), m_openInstancedTex2D, entity) :
+                        pushEntityToInstancedBatchStorage(getMeshBatchStorage()->getStorageInstancedColor(),
+                                                          getMeshBatchFactory(), m_openInstancedColor, entity) };
+                    if(pushed) {
+                        MARLOG_DEBUG(ELoggerType::GRAPHICS, "Pushed entity {} to instanced MeshBatch", entityTag);
+                        return;
+                    }
+                }
                 MARLOG_TRACE(ELoggerType::GRAPHICS, "Validating Tex2D MeshBatchStorage for {} entity...", entityTag);
                 if(pushEntityToBatchStorage(getMeshBatchStorage()->getStorageStaticTex2D(),
-                                            getMeshBatchFactory(), entity)) {
+                                            getMeshBatchFactory(), m_openStaticTex2D, textureSetKey, pMesh, entity)) {
                     MARLOG_DEBUG(ELoggerType::GRAPHICS, "Pushed entity {} to MeshBatch with Tex2D", entityTag);
                     return;
                 }
                 MARLOG_TRACE(ELoggerType::GRAPHICS, "Validating Color MeshBatchStorage for {} entity...", entityTag);
                 if(pushEntityToBatchStorage(getMeshBatchStorage()->getStorageStaticColor(),
-                                            getMeshBatchFactory(), entity)) {
+                                            getMeshBatchFactory(), m_openStaticColor, textureSetKey, pMesh, entity)) {
                     MARLOG_DEBUG(ELoggerType::GRAPHICS, "Pushed entity {} to MeshBatch with Color", entityTag);
                     return;
                 }
@@ -140,17 +245,333 @@ namespace marengine {
     }
 
 
-    template<typename TMeshBatchArray>
-    int32 getAvailableBatch(TMeshBatchArray* pBatchArray, const Entity& entity) {
-        MARLOG_TRACE(ELoggerType::GRAPHICS, "Looking for available batch for an entity...");
-        auto canBatchEntity = [&entity](const auto& batch)->bool {
-            return batch.canBeBatched(entity);
+    template<typename TMeshBatch, typename TMeshBatchStorage>
+    static TMeshBatch* getAvailableDrawnBatch(TMeshBatchStorage* pMeshBatchStorage, const Entity& entity);
+
+    template<typename TMeshBatch>
+    static void pushEntityRangesToRender(const FRenderManager* pRenderManager, TMeshBatch* pBatch,
+                                         const Entity& entity);
+
+    bool FBatchManager::insertEntityToRender(const Entity& entity) {
+        const std::string& entityTag{ entity.getComponent<CTag>().tag };
+        MARLOG_TRACE(ELoggerType::GRAPHICS, "Inserting entity {} to already drawn batch...", entityTag);
+        if(!entity.hasComponent<CRenderable>()) {
+            return true;
+        }
+
+        const auto& cRenderable{ entity.getComponent<CRenderable>() };
+        if(cRenderable.material.isValid() && cRenderable.material.type == EMaterialType::TEX2D) {
+            auto* pBatch{ getAvailableDrawnBatch<FMeshBatchStaticTex2D>(
+                    getMeshBatchStorage()->getStorageInstancedTex2D(), entity) };
+            if(pBatch == nullptr) {
+                pBatch = getAvailableDrawnBatch<FMeshBatchStaticTex2D>(
+                        getMeshBatchStorage()->getStorageStaticTex2D(), entity);
+            }
+            if(pBatch == nullptr) {
+                MARLOG_DEBUG(ELoggerType::GRAPHICS, "No drawn Tex2D batch can take entity {}", entityTag);
+                return false;
+            }
+
+            pBatch->submitToBatch(entity);
+            if(m_pRenderManager != nullptr) {
+                pushEntityRangesToRender(m_pRenderManager, pBatch, entity);
+                m_pRenderManager->update<ERenderBatchUpdateType::RENDERABLE_TEX2D>(pBatch);
+            }
+            MARLOG_DEBUG(ELoggerType::GRAPHICS, "Inserted entity {} to drawn Tex2D batch!", entityTag);
+            return true;
+        }
+
+        auto* pBatch{ getAvailableDrawnBatch<FMeshBatchStaticColor>(
+                getMeshBatchStorage()->getStorageInstancedColor(), entity) };
+        if(pBatch == nullptr) {
+            pBatch = getAvailableDrawnBatch<FMeshBatchStaticColor>(
+                    getMeshBatchStorage()->getStorageStaticColor(), entity);
+        }
+        if(pBatch == nullptr) {
+            MARLOG_DEBUG(ELoggerType::GRAPHICS, "No drawn Color batch can take entity {}", entityTag);
+            return false;
+        }
+
+        pBatch->submitToBatch(entity);
+        if(m_pRenderManager != nullptr) {
+            pushEntityRangesToRender(m_pRenderManager, pBatch, entity);
+            m_pRenderManager->update<ERenderBatchUpdateType::RENDERABLE_COLOR>(pBatch);
+        }
+        MARLOG_DEBUG(ELoggerType::GRAPHICS, "Inserted entity {} to drawn Color batch!", entityTag);
+        return true;
+    }
+
+    void FBatchManager::removeEntityFromRender(const Entity& entity) {
+        const std::string& entityTag{ entity.getComponent<CTag>().tag };
+        MARLOG_TRACE(ELoggerType::GRAPHICS, "Removing entity {} from render...", entityTag);
+        if(!entity.hasComponent<CRenderable>()) {
+            return;
+        }
+
+        const auto& cRenderable{ entity.getComponent<CRenderable>() };
+        if(!cRenderable.isEntityRendered() || !cRenderable.isBatchUpdateValid()) {
+            MARLOG_DEBUG(ELoggerType::GRAPHICS, "Entity {} is not rendered, nothing to remove", entityTag);
+            return;
+        }
+
+        const CRenderable::BatchInfo batchInfo{ cRenderable.batch };
+        FMeshBatch* pMeshBatch{ getMeshBatchStorage()->retrieve(cRenderable) };
+        pMeshBatch->removeFromBatch(entity);
+        const bool isUploaded{ m_pRenderManager != nullptr && pMeshBatch->getPipeline() != -1 };
+        const bool isInstanced{ batchInfo.type == EBatchType::MESH_INSTANCED_COLOR ||
+                                batchInfo.type == EBatchType::MESH_INSTANCED_TEX2D };
+        if(isUploaded && isInstanced) {
+            m_pRenderManager->update<ERenderBatchUpdateType::TRANSFORM>(pMeshBatch);
+        }
+        else if(isUploaded) {
+            const FMeshBatchRange removedIndices{ (uint32)batchInfo.startInd,
+                                                  (uint32)(batchInfo.endInd - batchInfo.startInd) };
+            m_pRenderManager->update<ERenderBatchUpdateType::INDICES>(pMeshBatch, removedIndices);
+        }
+        const bool isTex2D{ batchInfo.type == EBatchType::MESH_STATIC_TEX2D ||
+                            batchInfo.type == EBatchType::MESH_INSTANCED_TEX2D };
+        if(isUploaded && isTex2D) {
+            // Texture arrays no longer sampled by batch were released, so bound samplers are updated
+            FMeshBatchStaticTex2D* pBatch{ isInstanced ?
+                    getMeshBatchStorage()->getStorageInstancedTex2D()->get(batchInfo.index) :
+                    getMeshBatchStorage()->getStorageStaticTex2D()->get(batchInfo.index) };
+            m_pRenderManager->update<ERenderBatchUpdateType::RENDERABLE_TEX2D>(pBatch);
+        }
+        MARLOG_DEBUG(ELoggerType::GRAPHICS, "Removed entity {} from render!", entityTag);
+    }
+
+    static float computeScreenSize(const FRenderCamera* pRenderCamera, const CTransform& cTransform,
+                                   const FMeshProxy* pMesh);
+
+    void FBatchManager::updateLevelsOfDetail(Scene* pScene) {
+        const FRenderCamera* pRenderCamera{ m_pRenderManager->getCamera() };
+        if(pScene == nullptr || pRenderCamera == nullptr) {
+            return;
+        }
+
+        // Every slice is visited once per levelOfDetailSlicesCount frames, so cost of selection is spread
+        constexpr uint32 slicesCount{ GraphicLimits::levelOfDetailSlicesCount };
+        m_levelOfDetailSlice = (m_levelOfDetailSlice + 1) % slicesCount;
+        entt::registry* pRegistry{ pScene->getRegistry() };
+        for(size_t i = m_levelOfDetailSlice; i < m_visibleEntities.size(); i += slicesCount) {
+            const entt::entity enttEntity{ m_visibleEntities[i] };
+            if(!pRegistry->valid(enttEntity) || !pRegistry->has<CRenderable>(enttEntity)) {
+                continue;
+            }
+            const Entity entity(enttEntity, pRegistry);
+            auto& cRenderable{ entity.getComponent<CRenderable>() };
+            if(cRenderable.mesh.type != EMeshType::EXTERNAL || !cRenderable.isEntityRendered()) {
+                continue;
+            }
+            const FMeshExternal* pMesh{ m_pMeshStorage->getExternalMesh(cRenderable.mesh.index) };
+            if(pMesh == nullptr || pMesh->getLevelsOfDetailCount() == 1) {
+                continue;
+            }
+
+            const float screenSize{ computeScreenSize(pRenderCamera, entity.getComponent<CTransform>(), pMesh) };
+            const uint32 currentLevel{ cRenderable.mesh.levelOfDetail };
+            const uint32 levelOfDetail{ FMeshLevelOfDetail::select(currentLevel, pMesh->getLevelsOfDetailCount(),
+                                                                   screenSize) };
+            if(levelOfDetail == currentLevel) {
+                continue;
+            }
+
+            MARLOG_TRACE(ELoggerType::GRAPHICS, "Entity {} changes level of detail {} -> {}",
+                         entity.getComponent<CTag>().tag, currentLevel, levelOfDetail);
+            removeEntityFromRender(entity);
+            cRenderable.mesh.levelOfDetail = levelOfDetail;
+            if(insertEntityToRender(entity)) {
+                continue;
+            }
+
+            // Place released by entity fits its current level, so it is put back there
+            MARLOG_DEBUG(ELoggerType::GRAPHICS, "No drawn batch has place for level {} of entity {}, keeping {}",
+                         levelOfDetail, entity.getComponent<CTag>().tag, currentLevel);
+            cRenderable.mesh.levelOfDetail = currentLevel;
+            if(!insertEntityToRender(entity)) {
+                MARLOG_WARN(ELoggerType::GRAPHICS, "Entity {} is not rendered until scene is pushed again",
+                            entity.getComponent<CTag>().tag);
+            }
+        }
+    }
+
+    template<typename TMeshBatchStorage>
+    static void pushBatchesVisibilityToRender(const FRenderManager* pRenderManager,
+                                              TMeshBatchStorage* pMeshBatchStorage);
+
+    void FBatchManager::cullEntities(Scene* pScene) {
+        m_cullingStats = {};
+        const FRenderCamera* pRenderCamera{ m_pRenderManager->getCamera() };
+        if(pScene == nullptr || pRenderCamera == nullptr) {
+            return;
+        }
+
+        m_frustumCuller.extractPlanes(pRenderCamera->getMVP());
+        m_frustumCuller.clear();
+        m_cullableEntities.clear();
+        m_visibleEntities.clear();
+        const auto view{ pScene->getView<CRenderable>() };
+        for(const entt::entity enttEntity : view) {
+            const auto& cRenderable{ view.get<CRenderable>(enttEntity) };
+            const FMeshProxy* pMesh{ m_pMeshStorage->retrieve(cRenderable) };
+            if(!cRenderable.isEntityRendered() || pMesh == nullptr) {
+                continue;
+            }
+            m_frustumCuller.push(pMesh->getBounds(), pScene->getComponent<CTransform>(enttEntity).getTransform());
+            m_cullableEntities.push_back(enttEntity);
+        }
+        m_frustumCuller.cull();
+
+        const auto occlusionStart{ std::chrono::high_resolution_clock::now() };
+        m_occludedEntities.assign(m_cullableEntities.size(), 0);
+        if(FOcclusionCulling::isEnabled()) {
+            cullOccludedEntities(pRenderCamera, pScene->getRegistry());
+        }
+        const std::chrono::duration<float, std::milli> occlusionTime{
+            std::chrono::high_resolution_clock::now() - occlusionStart
         };
-        const auto validBatchIt = std::find_if(pBatchArray->cbegin(), pBatchArray->cend(),
-                                               canBatchEntity);
-        if (validBatchIt != pBatchArray->cend()) {
-            MARLOG_DEBUG(ELoggerType::GRAPHICS, "Found available batch, returning...");
-            return (int32)std::distance(pBatchArray->cbegin(), validBatchIt);
+
+        FMeshBatchStorage* pStorage{ getMeshBatchStorage() };
+        for(uint32 i = 0; i < m_cullableEntities.size(); i++) {
+            const Entity entity(m_cullableEntities[i], pScene->getRegistry());
+            const auto& cRenderable{ entity.getComponent<CRenderable>() };
+            const bool isCulled{ !m_frustumCuller.isVisible(i) || m_occludedEntities[i] != 0 };
+            if(cRenderable.batch.isCulled != isCulled) {
+                pStorage->retrieve(cRenderable)->updateCulled(entity, isCulled);
+            }
+            if(!isCulled) {
+                m_visibleEntities.push_back(m_cullableEntities[i]);
+            }
+        }
+        m_cullableEntities.clear();
+
+        pushBatchesVisibilityToRender(m_pRenderManager, pStorage->getStorageStaticColor());
+        pushBatchesVisibilityToRender(m_pRenderManager, pStorage->getStorageStaticTex2D());
+        pushBatchesVisibilityToRender(m_pRenderManager, pStorage->getStorageInstancedColor());
+        pushBatchesVisibilityToRender(m_pRenderManager, pStorage->getStorageInstancedTex2D());
+
+        m_cullingStats.occludedEntitiesCount = (uint32)std::count(m_occludedEntities.begin(),
+                                                                  m_occludedEntities.end(), 1u);
+        m_cullingStats.visibleEntitiesCount = m_frustumCuller.getVisibleCount() - m_cullingStats.occludedEntitiesCount;
+        m_cullingStats.culledEntitiesCount = m_frustumCuller.getCount() - m_frustumCuller.getVisibleCount();
+        m_cullingStats.occlusionCullingTime = occlusionTime.count();
+    }
+
+    void FBatchManager::cullOccludedEntities(const FRenderCamera* pRenderCamera, entt::registry* pSceneRegistry) {
+        // The biggest entities on screen become occluders, external meshes are rasterized with their
+        // coarsest level of detail
+        std::vector<std::pair<float, uint32>> occluderCandidates;
+        for(uint32 i = 0; i < m_cullableEntities.size(); i++) {
+            if(!m_frustumCuller.isVisible(i)) {
+                continue;
+            }
+            const Entity entity(m_cullableEntities[i], pSceneRegistry);
+            const FMeshProxy* pMesh{ m_pMeshStorage->retrieve(entity.getComponent<CRenderable>()) };
+            occluderCandidates.emplace_back(computeScreenSize(pRenderCamera, entity.getComponent<CTransform>(), pMesh), i);
+        }
+
+        const size_t occludersCount{ std::min<size_t>(FOcclusionCulling::getOccludersCount(), occluderCandidates.size()) };
+        std::partial_sort(occluderCandidates.begin(), occluderCandidates.begin() + occludersCount,
+                          occluderCandidates.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.first > rhs.first;
+        });
+
+        m_occlusionCuller.begin(pRenderCamera->getMVP());
+        for(size_t i = 0; i < occludersCount; i++) {
+            const Entity entity(m_cullableEntities[occluderCandidates[i].second], pSceneRegistry);
+            const auto& cRenderable{ entity.getComponent<CRenderable>() };
+            const FMeshProxy* pMesh{ m_pMeshStorage->retrieve(cRenderable) };
+            if(cRenderable.mesh.type == EMeshType::EXTERNAL) {
+                const FMeshExternal* pMeshExternal{ m_pMeshStorage->getExternalMesh(cRenderable.mesh.index) };
+                pMesh = pMeshExternal->getLevelOfDetail(pMeshExternal->getLevelsOfDetailCount() - 1);
+            }
+            m_occlusionCuller.rasterize(pMesh->getVertices(), pMesh->getIndices(),
+                                        entity.getComponent<CTransform>().getTransform());
+        }
+        m_occlusionCuller.buildHierarchy();
+
+        for(const auto& candidate : occluderCandidates) {
+            const Entity entity(m_cullableEntities[candidate.second], pSceneRegistry);
+            const FMeshProxy* pMesh{ m_pMeshStorage->retrieve(entity.getComponent<CRenderable>()) };
+            const bool isOccluded{ m_occlusionCuller.isOccluded(pMesh->getBounds(),
+                                                                entity.getComponent<CTransform>().getTransform()) };
+            m_occludedEntities[candidate.second] = isOccluded ? 1 : 0;
+        }
+        m_cullingStats.occludersCount = occludersCount;
+    }
+
+    const FBatchCullingStats& FBatchManager::getCullingStats() const {
+        return m_cullingStats;
+    }
+
+    static uint32 getDirtyElementsCount(const FBatchDirtyRanges& dirtyRanges);
+
+    template<typename TMeshBatchStorage>
+    static void pushBatchesDirtyRangesToRender(const FRenderManager* pRenderManager,
+                                               TMeshBatchStorage* pMeshBatchStorage,
+                                               FBatchUploadStats& uploadStats);
+
+    void FBatchManager::pushDirtyRangesToRender() {
+        m_uploadStats = {};
+
+        FMeshBatchStorage* pStorage{ getMeshBatchStorage() };
+        pushBatchesDirtyRangesToRender(m_pRenderManager, pStorage->getStorageStaticColor(), m_uploadStats);
+        pushBatchesDirtyRangesToRender(m_pRenderManager, pStorage->getStorageStaticTex2D(), m_uploadStats);
+        pushBatchesDirtyRangesToRender(m_pRenderManager, pStorage->getStorageInstancedColor(), m_uploadStats);
+        pushBatchesDirtyRangesToRender(m_pRenderManager, pStorage->getStorageInstancedTex2D(), m_uploadStats);
+
+        FPointLightBatch* pPointLightBatch{ getLightBatchStorage()->getPointLightBatch() };
+        const FBatchDirtyRanges& dirtyLights{ pPointLightBatch->getDirtyLights() };
+        if(!dirtyLights.isEmpty()) {
+            m_uploadStats.lightsBytes += getDirtyElementsCount(dirtyLights) * sizeof(FPointLight);
+            m_uploadStats.updatesCount += dirtyLights.getRanges().size() + 1;
+            m_pRenderManager->update<ERenderBatchUpdateType::POINTLIGHT>(pPointLightBatch);
+        }
+    }
+
+    const FBatchUploadStats& FBatchManager::getUploadStats() const {
+        return m_uploadStats;
+    }
+
+    void FBatchManager::pushLightsToRender(Scene* pScene) {
+        MARLOG_TRACE(ELoggerType::GRAPHICS, "Pushing lights from scene {} to render...", pScene->getName());
+        FPointLightBatch* pPointLightBatch{ getLightBatchStorage()->getPointLightBatch() };
+        pPointLightBatch->reset();
+
+        const auto view{ pScene->getView<CPointLight>() };
+        for(const entt::entity enttEntity : view) {
+            const Entity entity(enttEntity, pScene->getRegistry());
+            if(pPointLightBatch->canBeBatched(entity)) {
+                pPointLightBatch->submitToBatch(entity);
+            }
+        }
+        m_pRenderManager->update<ERenderBatchUpdateType::POINTLIGHT>(pPointLightBatch);
+        MARLOG_DEBUG(ELoggerType::GRAPHICS, "Pushed lights from scene {} to render!", pScene->getName());
+    }
+
+
+    template<typename TMeshBatchStorage>
+    int32 getAvailableBatch(TMeshBatchStorage* pMeshBatchStorage, FOpenBatchList& openBatches,
+                            int32 textureSetKey, const FMeshProxy* pMesh, const Entity& entity) {
+        MARLOG_TRACE(ELoggerType::GRAPHICS, "Looking for available batch for an entity...");
+        if(pMesh == nullptr) {
+            MARLOG_DEBUG(ELoggerType::GRAPHICS, "Entity has no mesh, could not find available batch...");
+            return -1;
+        }
+
+        // Newest batches are the emptiest ones, so they are tried first. Closing batch erases only
+        // the one being checked, so batches before it stay in place.
+        const std::vector<int32>& batches{ openBatches.getBatches(textureSetKey) };
+        for(size_t i = batches.size(); i > 0; i--) {
+            const int32 batchIndex{ batches[i - 1] };
+            const FMeshBatchStatic* pBatch{ pMeshBatchStorage->get(batchIndex) };
+            if(pBatch->canBeBatched(entity)) {
+                MARLOG_DEBUG(ELoggerType::GRAPHICS, "Found available batch, returning...");
+                return batchIndex;
+            }
+            // Batch of the same texture set rejects entity only for lack of place, which it never regains
+            // during batchScene, so it is not checked again for any later entity
+            openBatches.close(textureSetKey, batchIndex);
         }
 
         MARLOG_DEBUG(ELoggerType::GRAPHICS, "Could not find available batch, returning...");
@@ -160,35 +581,212 @@ namespace marengine {
     template<typename TMeshBatchStorage>
     static bool pushEntityToBatchStorage(TMeshBatchStorage* pMeshBatchStorage,
                                          FMeshBatchFactory* pFactory,
+                                         FOpenBatchList& openBatches,
+                                         int32 textureSetKey,
+                                         const FMeshProxy* pMesh,
                                          const Entity& entity) {
         const std::string& entityTag{ entity.template getComponent<CTag>().tag };
         MARLOG_TRACE(ELoggerType::GRAPHICS, "Trying to push entity {} to batch storage", entityTag);
-        if(pMeshBatchStorage->isEmpty()) {
-            MARLOG_TRACE(ELoggerType::GRAPHICS, "Adding new MeshBatch to MeshBatchStorage as it is empty...");
-            FMeshBatchStatic* pBatch{ pFactory->emplaceStatic(pMeshBatchStorage) };
+        FMeshBatchStatic* pFirstBatch{ pMeshBatchStorage->isEmpty() ? pFactory->emplaceStatic(pMeshBatchStorage) :
+                                                                      pMeshBatchStorage->get(0) };
+        // Entity of other batch type would be rejected by every open batch, closing them all
+        if(!pFirstBatch->shouldBeBatched(entity)) {
+            MARLOG_DEBUG(ELoggerType::GRAPHICS, "Entity {} should not be batched at this MeshBatchStorage", entityTag);
+            return false;
         }
 
-        const int32 index{ getAvailableBatch(pMeshBatchStorage->getArray(), entity) };
+        const int32 index{ getAvailableBatch(pMeshBatchStorage, openBatches, textureSetKey, pMesh, entity) };
         if (index != -1) {
             MARLOG_DEBUG(ELoggerType::GRAPHICS, "Found available batch, pushing entity {}", entityTag);
             pMeshBatchStorage->get(index)->submitToBatch(entity);
             return true;
         }
-        else {
-            MARLOG_TRACE(ELoggerType::GRAPHICS, "Checking, if entity {} should be batched at first MeshBatch...",
-                         entityTag);
-            if (pMeshBatchStorage->get(0)->shouldBeBatched(entity)) {
-                MARLOG_DEBUG(ELoggerType::GRAPHICS, "Entity {} should be batched, creating new batch and submitting...",
-                             entityTag);
-                FMeshBatchStatic* pBatch{ pFactory->emplaceStatic(pMeshBatchStorage) };
-                pBatch->submitToBatch(entity);
-                return true;
-            }
+
+        // First batch is emplaced above only to check kind of entity, so it is opened by the first entity of its kind
+        MARLOG_DEBUG(ELoggerType::GRAPHICS, "Entity {} should be batched, opening new batch and submitting...",
+                     entityTag);
+        FMeshBatchStatic* pBatch{ pFirstBatch->getInstancesCount() == 0 ? pFirstBatch :
+                                                                           pFactory->emplaceStatic(pMeshBatchStorage) };
+        openBatches.open(textureSetKey, pBatch->getIndex());
+        pBatch->submitToBatch(entity);
+        return true;
+    }
+
+
+    bool FBatchManager::isMeshInstanced(const CRenderable& cRenderable) const {
+        const FMeshProxy* pMesh{ m_pMeshStorage->retrieve(cRenderable) };
+        const auto it{ m_meshUsagesCount.find(pMesh) };
+        if(pMesh == nullptr || it == m_meshUsagesCount.cend()) {
+            return false;
+        }
+
+        return it->second > FMeshBatchBudget::getInstancingThreshold();
+    }
+
+    template<typename TMeshBatchStorage>
+    bool pushEntityToInstancedBatchStorage(TMeshBatchStorage* pMeshBatchStorage,
+                                           FMeshBatchFactory* pFactory,
+                                           std::unordered_map<int64, int32>& openBatches,
+                                           const Entity& entity) {
+        const std::string& entityTag{ entity.template getComponent<CTag>().tag };
+        MARLOG_TRACE(ELoggerType::GRAPHICS, "Trying to push entity {} to instanced batch storage", entityTag);
+        const auto& cRenderable{ entity.template getComponent<CRenderable>() };
+        const int64 meshKey{ getInstancedMeshKey(cRenderable) };
+        const auto openIt{ openBatches.find(meshKey) };
+        if (openIt != openBatches.cend() && pMeshBatchStorage->get(openIt->second)->canBeBatched(entity)) {
+            MARLOG_DEBUG(ELoggerType::GRAPHICS, "Found available instanced batch, pushing entity {}", entityTag);
+            pMeshBatchStorage->get(openIt->second)->submitToBatch(entity);
+            return true;
         }
 
-        MARLOG_WARN(ELoggerType::GRAPHICS, "Could not push entity {} to batch storage...", entityTag);
+        const auto& meshInfo{ cRenderable.mesh };
+        FMeshBatchStatic* pBatch{ nullptr };
+        if constexpr (std::is_same_v<TMeshBatchStorage, FMeshBatchStorageStaticColor>) {
+            pBatch = pFactory->emplaceInstancedColor(meshInfo.type, meshInfo.index, meshInfo.levelOfDetail);
+        }
+        else if constexpr (std::is_same_v<TMeshBatchStorage, FMeshBatchStorageStaticTex2D>) {
+            pBatch = pFactory->emplaceInstancedTex2D(meshInfo.type, meshInfo.index, meshInfo.levelOfDetail);
+        }
+
+        if(pBatch->shouldBeBatched(entity) && pBatch->canBeBatched(entity)) {
+            MARLOG_DEBUG(ELoggerType::GRAPHICS, "Created new instanced batch, pushing entity {}", entityTag);
+            openBatches[meshKey] = pBatch->getIndex();
+            pBatch->submitToBatch(entity);
+            return true;
+        }
+
+        MARLOG_WARN(ELoggerType::GRAPHICS, "Could not push entity {} to instanced batch storage...", entityTag);
         return false;
     }
 
+    template<typename TMeshBatch, typename TMeshBatchStorage>
+    TMeshBatch* getAvailableDrawnBatch(TMeshBatchStorage* pMeshBatchStorage, const Entity& entity) {
+        const uint32 batchCount{ pMeshBatchStorage->getCount() };
+        for(uint32 i = 0; i < batchCount; i++) {
+            TMeshBatch* pBatch{ pMeshBatchStorage->get(i) };
+            if(pBatch->getPipeline() != -1 && pBatch->canBeBatched(entity)) {
+                return pBatch;
+            }
+        }
+
+        return nullptr;
+    }
+
+    template<typename TMeshBatch>
+    void pushEntityRangesToRender(const FRenderManager* pRenderManager, TMeshBatch* pBatch,
+                                  const Entity& entity) {
+        const auto& batchInfo{ entity.template getComponent<CRenderable>().batch };
+        FMeshBatch* pMeshBatch{ pBatch };
+        FMeshBatchStatic* pStaticBatch{ pBatch };
+        if(pStaticBatch->isInstanced()) {
+            pRenderManager->update<ERenderBatchUpdateType::TRANSFORM>(pMeshBatch);
+            pRenderManager->update<ERenderBatchUpdateType::INSTANCES>(pStaticBatch);
+            return;
+        }
+
+        const FMeshBatchRange verticesRange{ (uint32)batchInfo.startVert,
+                                             (uint32)(batchInfo.endVert - batchInfo.startVert) };
+        const FMeshBatchRange indicesRange{ (uint32)batchInfo.startInd,
+                                            (uint32)(batchInfo.endInd - batchInfo.startInd) };
+        pRenderManager->update<ERenderBatchUpdateType::VERTICES>(pMeshBatch, verticesRange);
+        pRenderManager->update<ERenderBatchUpdateType::INDICES>(pMeshBatch, indicesRange);
+        pRenderManager->update<ERenderBatchUpdateType::TRANSFORM>(pMeshBatch);
+    }
+
+    template<typename TMeshBatchStorage>
+    uint32 collectDeferredBatches(TMeshBatchStorage* pMeshBatchStorage, std::vector<FMeshBatchStatic*>& batches) {
+        uint32 fillsCount{ 0 };
+        const uint32 count{ pMeshBatchStorage->getCount() };
+        for(uint32 i = 0; i < count; i++) {
+            FMeshBatchStatic* pBatch{ pMeshBatchStorage->get((int32)i) };
+            if(pBatch->hasDeferredFill()) {
+                batches.push_back(pBatch);
+                fillsCount += pBatch->getDeferredFillsCount();
+            }
+        }
+        return fillsCount;
+    }
+
+    int64 getInstancedMeshKey(const CRenderable& cRenderable) {
+        // Only external meshes are told apart by index and level of detail, see FMeshBatchStatic::isInstanceOf
+        if(cRenderable.mesh.type != EMeshType::EXTERNAL) {
+            return (int64)cRenderable.mesh.type << 32;
+        }
+        return ((int64)cRenderable.mesh.type << 32) | ((int64)cRenderable.mesh.levelOfDetail << 24) |
+               ((uint32)cRenderable.mesh.index & 0xFFFFFF);
+    }
+
+    float computeScreenSize(const FRenderCamera* pRenderCamera, const CTransform& cTransform,
+                            const FMeshProxy* pMesh) {
+        const maths::vec4 center{ cTransform.getTransform() * maths::vec4(pMesh->getBounds().sphereCenter, 1.f) };
+        const maths::vec3& eye{ pRenderCamera->getPosition() };
+        const float dx{ center.x - eye.x };
+        const float dy{ center.y - eye.y };
+        const float dz{ center.z - eye.z };
+        const float distance{ std::sqrt(dx * dx + dy * dy + dz * dz) };
+
+        const maths::vec3 scale{ cTransform.getWorldScale() };
+        const float maxScale{ std::max({ std::abs(scale.x), std::abs(scale.y), std::abs(scale.z) }) };
+        const float radius{ pMesh->getBounds().sphereRadius * maxScale };
+        if(distance <= radius) {
+            return std::numeric_limits<float>::max();
+        }
+
+        // projection[1][1] is cot(fov / 2), so radius * cot / distance is radius relative to half of screen
+        // height, which equals diameter relative to whole screen height
+        const float projectionScale{ pRenderCamera->getProjection().value_ptr()[5] };
+        return radius * projectionScale / distance;
+    }
+
+    uint32 getDirtyElementsCount(const FBatchDirtyRanges& dirtyRanges) {
+        uint32 elementsCount{ 0 };
+        for(const FMeshBatchRange& range : dirtyRanges.getRanges()) {
+            elementsCount += range.count;
+        }
+        return elementsCount;
+    }
+
+    template<typename TMeshBatchStorage>
+    void pushBatchesDirtyRangesToRender(const FRenderManager* pRenderManager,
+                                        TMeshBatchStorage* pMeshBatchStorage,
+                                        FBatchUploadStats& uploadStats) {
+        const uint32 batchesCount{ pMeshBatchStorage->getCount() };
+        for(uint32 i = 0; i < batchesCount; i++) {
+            auto* pBatch{ pMeshBatchStorage->get((int32)i) };
+            if(pBatch->getPipeline() == -1) {
+                continue;
+            }
+
+            const FBatchDirtyRanges& dirtyTransforms{ pBatch->getDirtyTransforms() };
+            if(!dirtyTransforms.isEmpty()) {
+                uploadStats.transformsBytes += getDirtyElementsCount(dirtyTransforms) * sizeof(maths::mat4);
+                uploadStats.updatesCount += dirtyTransforms.getRanges().size();
+                FMeshBatch* pMeshBatch{ pBatch };
+                pRenderManager->update<ERenderBatchUpdateType::TRANSFORM>(pMeshBatch);
+            }
+
+            if constexpr (std::is_same_v<TMeshBatchStorage, FMeshBatchStorageStaticColor>) {
+                const FBatchDirtyRanges& dirtyColors{ pBatch->getDirtyColors() };
+                if(!dirtyColors.isEmpty()) {
+                    uploadStats.colorsBytes += getDirtyElementsCount(dirtyColors) * sizeof(maths::vec4);
+                    uploadStats.updatesCount += dirtyColors.getRanges().size();
+                    pRenderManager->update<ERenderBatchUpdateType::RENDERABLE_COLOR>(pBatch);
+                }
+            }
+        }
+    }
+
+
+    template<typename TMeshBatchStorage>
+    void pushBatchesVisibilityToRender(const FRenderManager* pRenderManager,
+                                       TMeshBatchStorage* pMeshBatchStorage) {
+        const uint32 batchesCount{ pMeshBatchStorage->getCount() };
+        for(uint32 i = 0; i < batchesCount; i++) {
+            FMeshBatch* pBatch{ pMeshBatchStorage->get((int32)i) };
+            if(pBatch->getPipeline() != -1 && pBatch->isCullingDirty()) {
+                pRenderManager->update<ERenderBatchUpdateType::VISIBILITY>(pBatch);
+            }
+        }
+    }
 
 }
@@ -35,10 +35,8 @@ namespace marengine {
         const auto& cEvent{ entity.getComponent<CEvent>() };
 
         if(cEvent.eventUpdateType == EEventType::RENDERABLE_COLOR_UPDATE) {
-            FMeshBatchStaticColor* pMeshBatch =
-                    getMeshBatchStorage()->getStorageStaticColor()->get(cRenderable.batch.index);
+            FMeshBatchStaticColor* pMeshBatch{ getMeshBatchStorage()->retrieveColor(cRenderable) };
            pMeshBatch->updateColor(entity);
-           m_pRenderManager->update<ERenderBatchUpdateType::RENDERABLE_COLOR>(pMeshBatch);
         }
         else if(cEvent.eventUpdateType == EEventType::RENDERABLE_MESH_UPDATE) {
 
@@ -48,13 +46,11 @@ namespace marengine {
     template<> void FBatchManager::update<CTransform>(const Entity& entity) const {
         FMeshBatch* pMeshBatch{ getMeshBatchStorage()->retrieve(entity.getComponent<CRenderable>()) };
         pMeshBatch->updateTransform(entity);
-        m_pRenderManager->update<ERenderBatchUpdateType::TRANSFORM>(pMeshBatch);
     }
 
     template<> void FBatchManager::update<CPointLight>(const Entity& entity) const {
         FPointLightBatch* pLightBatch{ getLightBatchStorage()->getPointLightBatch() };
         pLightBatch->updateLight(entity);
-        m_pRenderManager->update<ERenderBatchUpdateType::POINTLIGHT>(pLightBatch);
     }
 
 
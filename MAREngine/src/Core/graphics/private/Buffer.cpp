@@ -49,6 +49,30 @@ namespace marengine {
         return p_indicesCount;
     }
 
+    void FIndexBuffer::passIndexType(EIndexType indexType) {
+        p_indexType = indexType;
+    }
+
+    EIndexType FIndexBuffer::getIndexType() const {
+        return p_indexType;
+    }
+
+    std::vector<uint16_t> FIndexBuffer::s_shortIndices;
+
+    void FIndexBuffer::updateIndices(const FIndicesArray& indices, uint32 begin, uint32 count, uint32 offset) const {
+        if(p_indexType == EIndexType::UINT32) {
+            update(&indices.at(begin), offset * sizeof(uint32), count * sizeof(uint32));
+            return;
+        }
+
+        // Scratch array is reused between uploads, so that narrowing does not allocate every frame
+        s_shortIndices.resize(count);
+        for(uint32 i = 0; i < count; i++) {
+            s_shortIndices[i] = (uint16_t)indices[begin + i];
+        }
+        update(s_shortIndices.data(), offset * sizeof(uint16_t), count * sizeof(uint16_t));
+    }
+
 
     const FShaderInputDescription& FShaderBuffer::getInputDescription() const {
         return p_inputDescription;
@@ -63,12 +87,80 @@ namespace marengine {
     }
 
 
+    int64 FBufferStorage::getReservedMemory() const {
+        return p_vertexArena.getReservedMemory() + p_packedVertexArena.getReservedMemory() +
+               p_indexArena.getReservedMemory() + p_shortIndexArena.getReservedMemory();
+    }
+
+    int64 FBufferStorage::getUsedMemory() const {
+        return p_vertexArena.getUsedMemory() + p_packedVertexArena.getUsedMemory() +
+               p_indexArena.getUsedMemory() + p_shortIndexArena.getUsedMemory();
+    }
+
+    FBufferArena* FBufferStorage::getVertexArena(EVertexFormat format) {
+        if(format == EVertexFormat::PACKED) {
+            return &p_packedVertexArena;
+        }
+        return &p_vertexArena;
+    }
+
+    FBufferArena* FBufferStorage::getIndexArena(EIndexType indexType) {
+        if(indexType == EIndexType::UINT16) {
+            return &p_shortIndexArena;
+        }
+        return &p_indexArena;
+    }
+
+
+    FBufferAllocation FBufferFactory::allocateVertices(uint32 verticesCount, EVertexFormat format) {
+        FBufferArena* const pArena{ p_pRenderContext->getBufferStorage()->getVertexArena(format) };
+        const FBufferAllocation allocation{ pArena->allocate(verticesCount) };
+        if(allocation.isValid()) {
+            return allocation;
+        }
+
+        return pArena->allocate(verticesCount, emplaceVerticesPage(verticesCount, format));
+    }
+
+    FBufferAllocation FBufferFactory::allocateIndices(uint32 indicesCount, EIndexType indexType) {
+        FBufferArena* const pArena{ p_pRenderContext->getBufferStorage()->getIndexArena(indexType) };
+        const FBufferAllocation allocation{ pArena->allocate(indicesCount) };
+        if(allocation.isValid()) {
+            return allocation;
+        }
+
+        return pArena->allocate(indicesCount, emplaceIndicesPage(indicesCount, indexType));
+    }
+
+    int32 FBufferFactory::emplaceVerticesPage(uint32 verticesCount, EVertexFormat format) {
+        FBufferArena* const pArena{ p_pRenderContext->getBufferStorage()->getVertexArena(format) };
+        const uint32 pageCapacity{ pArena->getPageCapacity(verticesCount) };
+
+        FVertexBuffer* const pVertexBuffer{ emplaceVBO() };
+        pVertexBuffer->create((int64)pageCapacity * pArena->getElementSize());
+        pArena->pushPage(pVertexBuffer->getIndex(), pageCapacity);
+        return pVertexBuffer->getIndex();
+    }
+
+    int32 FBufferFactory::emplaceIndicesPage(uint32 indicesCount, EIndexType indexType) {
+        FBufferArena* const pArena{ p_pRenderContext->getBufferStorage()->getIndexArena(indexType) };
+        const uint32 pageCapacity{ pArena->getPageCapacity(indicesCount) };
+
+        FIndexBuffer* const pIndexBuffer{ emplaceIBO() };
+        pIndexBuffer->create((int64)pageCapacity * pArena->getElementSize());
+        pIndexBuffer->passIndexType(indexType);
+        pArena->pushPage(pIndexBuffer->getIndex(), pageCapacity);
+        return pIndexBuffer->getIndex();
+    }
+
+
     uint32 FBufferFactory::fillCameraSSBO(FShaderBuffer* pShaderBuffer,
                                           const FRenderCamera* const pRenderCamera) const {
         FShaderInputDescription description;
         description.binding = 0;
         description.shaderStage = EShaderStage::VERTEX;
         description.bufferType = EBufferType::SSBO;
+        description.usage = EBufferUsage::PER_FRAME;
 
         FShaderInputVariableInfo mvpInfo;
         mvpInfo.count = 1;
@@ -94,6 +186,7 @@ namespace marengine {
         description.binding = 2;
         description.shaderStage = EShaderStage::FRAGMENT;
         description.bufferType = EBufferType::SSBO;
+        description.usage = EBufferUsage::PER_FRAME;
 
         // TODO: change in shader code to proper PointLights...
         FShaderInputVariableInfo materialInfo;
@@ -0,0 +1,198 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+
+
+#include "../public/BufferArena.h"
+
+
+namespace marengine {
+
+    static uint32 getPowerOfTwoCeil(uint32 value);
+
+
+    void FBuddyAllocator::create(uint32 capacity, uint32 minBlockCapacity) {
+        m_capacity = capacity;
+        m_minBlockCapacity = minBlockCapacity;
+        reset();
+    }
+
+    void FBuddyAllocator::reset() {
+        m_freeBlocks.clear();
+        m_freeBlocks.resize(getOrder(m_capacity) + 1);
+        m_freeBlocks.back().push_back(0);
+        m_allocatedOrders.clear();
+    }
+
+    bool FBuddyAllocator::allocate(uint32 count, uint32& offset, uint32& blockCapacity) {
+        if(count > m_capacity) {
+            return false;
+        }
+
+        const uint32 order{ getOrder(count) };
+        uint32 freeOrder{ order };
+        while(freeOrder < m_freeBlocks.size() && m_freeBlocks[freeOrder].empty()) {
+            freeOrder++;
+        }
+        if(freeOrder == m_freeBlocks.size()) {
+            return false;
+        }
+
+        offset = m_freeBlocks[freeOrder].back();
+        m_freeBlocks[freeOrder].pop_back();
+
+        // Split found block in halves, until it is the smallest one able to hold count elements
+        while(freeOrder > order) {
+            freeOrder--;
+            m_freeBlocks[freeOrder].push_back(offset + (m_minBlockCapacity << freeOrder));
+        }
+
+        m_allocatedOrders[offset] = order;
+        blockCapacity = m_minBlockCapacity << order;
+        return true;
+    }
+
+    void FBuddyAllocator::free(uint32 offset) {
+        const auto it{ m_allocatedOrders.find(offset) };
+        if(it == m_allocatedOrders.end()) {
+            return;
+        }
+
+        uint32 order{ it->second };
+        m_allocatedOrders.erase(it);
+
+        const uint32 maxOrder{ (uint32)m_freeBlocks.size() - 1 };
+        while(order < maxOrder) {
+            const uint32 buddyOffset{ offset ^ (m_minBlockCapacity << order) };
+            std::vector<uint32>& freeBlocks{ m_freeBlocks[order] };
+            const auto buddyIt{ std::find(freeBlocks.begin(), freeBlocks.end(), buddyOffset) };
+            if(buddyIt == freeBlocks.end()) {
+                break;
+            }
+
+            freeBlocks.erase(buddyIt);
+            offset = std::min(offset, buddyOffset);
+            order++;
+        }
+
+        m_freeBlocks[order].push_back(offset);
+    }
+
+    uint32 FBuddyAllocator::getCapacity() const {
+        return m_capacity;
+    }
+
+    uint32 FBuddyAllocator::getOrder(uint32 count) const {
+        uint32 order{ 0 };
+        while((m_minBlockCapacity << order) < count) {
+            order++;
+        }
+        return order;
+    }
+
+
+    FBufferArena::FBufferArena(uint32 elementSize, uint32 defaultPageCapacity) :
+        m_elementSize(elementSize),
+        m_defaultPageCapacity(getPowerOfTwoCeil(defaultPageCapacity))
+    { }
+
+    FBufferAllocation FBufferArena::allocate(uint32 count) {
+        for(const FPage& page : m_pages) {
+            const FBufferAllocation allocation{ allocate(count, page.bufferIndex) };
+            if(allocation.isValid()) {
+                return allocation;
+            }
+        }
+        return {};
+    }
+
+    FBufferAllocation FBufferArena::allocate(uint32 count, int32 bufferIndex) {
+        for(FPage& page : m_pages) {
+            if(page.bufferIndex != bufferIndex) {
+                continue;
+            }
+
+            FBufferAllocation allocation;
+            if(!page.allocator.allocate(count, allocation.offset, allocation.capacity)) {
+                return {};
+            }
+
+            allocation.bufferIndex = bufferIndex;
+            allocation.count = count;
+            m_usedCount += count;
+            return allocation;
+        }
+        return {};
+    }
+
+    void FBufferArena::free(const FBufferAllocation& allocation) {
+        for(FPage& page : m_pages) {
+            if(page.bufferIndex == allocation.bufferIndex) {
+                page.allocator.free(allocation.offset);
+                m_usedCount -= allocation.count;
+                return;
+            }
+        }
+    }
+
+    void FBufferArena::pushPage(int32 bufferIndex, uint32 capacity) {
+        FPage& page{ m_pages.emplace_back() };
+        page.bufferIndex = bufferIndex;
+        page.allocator.create(capacity, GraphicLimits::minBufferBlockCount);
+        m_reservedCount += capacity;
+    }
+
+    void FBufferArena::reset() {
+        m_pages.clear();
+        m_reservedCount = 0;
+        m_usedCount = 0;
+    }
+
+    uint32 FBufferArena::getPageCapacity(uint32 count) const {
+        return std::max(m_defaultPageCapacity, getBlockCapacity(count));
+    }
+
+    uint32 FBufferArena::getBlockCapacity(uint32 count) {
+        return getPowerOfTwoCeil(std::max(count, GraphicLimits::minBufferBlockCount));
+    }
+
+    uint32 FBufferArena::getElementSize() const {
+        return m_elementSize;
+    }
+
+    int64 FBufferArena::getReservedMemory() const {
+        return m_reservedCount * m_elementSize;
+    }
+
+    int64 FBufferArena::getUsedMemory() const {
+        return m_usedCount * m_elementSize;
+    }
+
+
+    uint32 getPowerOfTwoCeil(uint32 value) {
+        uint32 powerOfTwo{ 1 };
+        while(powerOfTwo < value) {
+            powerOfTwo <<= 1;
+        }
+        return powerOfTwo;
+    }
+
+
+}
@@ -0,0 +1,142 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+
+
+#include "../public/FrustumCuller.h"
+
+
+namespace marengine {
+
+
+    std::array<maths::vec4, 6> FFrustumCuller::computePlanes(const maths::mat4& viewProjection) {
+        // Matrix is column major, so row r is made of elements r, 4 + r, 8 + r, 12 + r
+        const float* m{ viewProjection.value_ptr() };
+        auto computePlane = [m](uint32 row, float sign) {
+            const float a{ m[3] + sign * m[row] };
+            const float b{ m[7] + sign * m[4 + row] };
+            const float c{ m[11] + sign * m[8 + row] };
+            const float d{ m[15] + sign * m[12 + row] };
+            const float length{ std::sqrt(a * a + b * b + c * c) };
+            const float inverseLength{ length > 0.f ? 1.f / length : 0.f };
+            return maths::vec4(a * inverseLength, b * inverseLength, c * inverseLength, d * inverseLength);
+        };
+
+        return {
+            computePlane(0, 1.f),   // left
+            computePlane(0, -1.f),  // right
+            computePlane(1, 1.f),   // bottom
+            computePlane(1, -1.f),  // top
+            computePlane(2, 1.f),   // near
+            computePlane(2, -1.f)   // far
+        };
+    }
+
+    void FFrustumCuller::extractPlanes(const maths::mat4& viewProjection) {
+        const std::array<maths::vec4, s_planesCount> planes{ computePlanes(viewProjection) };
+        for(uint32 plane = 0; plane < s_planesCount; plane++) {
+            m_planeA[plane] = planes[plane].x;
+            m_planeB[plane] = planes[plane].y;
+            m_planeC[plane] = planes[plane].z;
+            m_planeD[plane] = planes[plane].w;
+        }
+    }
+
+    void FFrustumCuller::clear() {
+        m_centerX.clear();
+        m_centerY.clear();
+        m_centerZ.clear();
+        m_extentX.clear();
+        m_extentY.clear();
+        m_extentZ.clear();
+        m_radius.clear();
+        m_visible.clear();
+        m_visibleCount = 0;
+    }
+
+    uint32 FFrustumCuller::push(const FMeshBounds& bounds, const maths::mat4& transform) {
+        const float* m{ transform.value_ptr() };
+        const maths::vec3& center{ bounds.sphereCenter };
+        m_centerX.push_back(m[0] * center.x + m[4] * center.y + m[8] * center.z + m[12]);
+        m_centerY.push_back(m[1] * center.x + m[5] * center.y + m[9] * center.z + m[13]);
+        m_centerZ.push_back(m[2] * center.x + m[6] * center.y + m[10] * center.z + m[14]);
+
+        // Box transformed by matrix is enclosed by box, which half-extents are |M| * extents (Arvo)
+        const float ex{ (bounds.boxMax.x - bounds.boxMin.x) * 0.5f };
+        const float ey{ (bounds.boxMax.y - bounds.boxMin.y) * 0.5f };
+        const float ez{ (bounds.boxMax.z - bounds.boxMin.z) * 0.5f };
+        m_extentX.push_back(std::abs(m[0]) * ex + std::abs(m[4]) * ey + std::abs(m[8]) * ez);
+        m_extentY.push_back(std::abs(m[1]) * ex + std::abs(m[5]) * ey + std::abs(m[9]) * ez);
+        m_extentZ.push_back(std::abs(m[2]) * ex + std::abs(m[6]) * ey + std::abs(m[10]) * ez);
+
+        const float scaleX{ m[0] * m[0] + m[1] * m[1] + m[2] * m[2] };
+        const float scaleY{ m[4] * m[4] + m[5] * m[5] + m[6] * m[6] };
+        const float scaleZ{ m[8] * m[8] + m[9] * m[9] + m[10] * m[10] };
+        m_radius.push_back(bounds.sphereRadius * std::sqrt(std::max({ scaleX, scaleY, scaleZ })));
+
+        return (uint32)m_centerX.size() - 1;
+    }
+
+    void FFrustumCuller::cull() {
+        const size_t count{ m_centerX.size() };
+        m_visible.resize(count);
+
+        const float* centerX{ m_centerX.data() };
+        const float* centerY{ m_centerY.data() };
+        const float* centerZ{ m_centerZ.data() };
+        const float* extentX{ m_extentX.data() };
+        const float* extentY{ m_extentY.data() };
+        const float* extentZ{ m_extentZ.data() };
+        const float* radius{ m_radius.data() };
+        uint32_t* visible{ m_visible.data() };
+
+        // Loop over volumes is the vectorized one, planes are broadcast and the inner loop is unrolled
+        uint32 visibleCount{ 0 };
+        for(size_t i = 0; i < count; i++) {
+            uint32_t isInside{ 1 };
+            for(uint32 plane = 0; plane < s_planesCount; plane++) {
+                const float distance{ m_planeA[plane] * centerX[i] + m_planeB[plane] * centerY[i] +
+                                      m_planeC[plane] * centerZ[i] + m_planeD[plane] };
+                const float boxRadius{ std::abs(m_planeA[plane]) * extentX[i] +
+                                       std::abs(m_planeB[plane]) * extentY[i] +
+                                       std::abs(m_planeC[plane]) * extentZ[i] };
+                const float reach{ std::min(radius[i], boxRadius) };
+                isInside &= (uint32_t)(distance + reach >= 0.f);
+            }
+            visible[i] = isInside;
+            visibleCount += isInside;
+        }
+        m_visibleCount = visibleCount;
+    }
+
+    bool FFrustumCuller::isVisible(uint32 index) const {
+        return m_visible.at(index) != 0;
+    }
+
+    uint32 FFrustumCuller::getCount() const {
+        return (uint32)m_visible.size();
+    }
+
+    uint32 FFrustumCuller::getVisibleCount() const {
+        return m_visibleCount;
+    }
+
+
+}
@@ -41,6 +41,7 @@ namespace marengine {
 
 	void FPointLightBatch::reset() {
 		m_lights.clear();
+		m_dirtyLights.clear();
 	}
 
     const float* FPointLightBatch::getBatchData() const {
@@ -95,6 +96,7 @@ namespace marengine {
 		pointLightData.position = maths::vec4(cTransform.position, 1.f);
 
         cPointLight.batch.index = (int8)(m_lights.size() - 1);
+        m_dirtyLights.mark(cPointLight.batch.index);
         cPointLight.batch.type = ELightBatchType::POINTLIGHT;
 
         MARLOG_DEBUG(ELoggerType::GRAPHICS, "Entity {} submitted to batch!", entityTag);
@@ -103,6 +105,15 @@ namespace marengine {
 	void FPointLightBatch::updateLight(const Entity& entity) {
 	    const auto& cPointLight{ entity.getComponent<CPointLight>() };
 	    m_lights.at(cPointLight.batch.index) = cPointLight.pointLight;
+	    m_dirtyLights.mark(cPointLight.batch.index);
+	}
+
+    const FBatchDirtyRanges& FPointLightBatch::getDirtyLights() const {
+	    return m_dirtyLights;
+	}
+
+    void FPointLightBatch::clearDirtyLights() {
+	    m_dirtyLights.clear();
 	}
 
 	ELightBatchType FPointLightBatch::getType() const {
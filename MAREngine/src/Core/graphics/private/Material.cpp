@@ -0,0 +1,93 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+
+
+#include "../public/Material.h"
+
+
+namespace marengine {
+
+
+    void FMaterialTex2DArray::passFormat(uint32 width, uint32 height, uint32 channels) {
+        p_width = width;
+        p_height = height;
+        p_channels = channels;
+    }
+
+    bool FMaterialTex2DArray::isMatching(uint32 width, uint32 height, uint32 channels) const {
+        return !p_isAtlas && p_width == width && p_height == height && p_channels == channels;
+    }
+
+    uint32 FMaterialTex2DArray::pushLayer(int32 textureIndex) {
+        const uint32 layer{ p_layersCount };
+        p_regions.push_back({ textureIndex, layer, 0, 0, p_width, p_height });
+        p_layersCount++;
+        p_dirty = true;
+        return layer;
+    }
+
+    bool FMaterialTex2DArray::isDirty() const {
+        return p_dirty;
+    }
+
+    void FMaterialTex2DArray::passAtlasFormat(uint32 pageSize, uint32 channels) {
+        passFormat(pageSize, pageSize, channels);
+        p_atlas.create(pageSize, GraphicLimits::atlasPadding);
+        p_isAtlas = true;
+    }
+
+    bool FMaterialTex2DArray::isAtlas() const {
+        return p_isAtlas;
+    }
+
+    bool FMaterialTex2DArray::isMatchingAtlas(uint32 channels) const {
+        return p_isAtlas && p_channels == channels;
+    }
+
+    bool FMaterialTex2DArray::pushToAtlas(int32 textureIndex, uint32 width, uint32 height,
+                                          FTex2DPlacement& placement) {
+        FTextureAtlasRegion atlasRegion;
+        if(!p_isAtlas || !p_atlas.insert(width, height, atlasRegion)) {
+            return false;
+        }
+
+        p_regions.push_back({ textureIndex, atlasRegion.page, atlasRegion.x, atlasRegion.y, width, height });
+        p_layersCount = p_atlas.getPageCount();
+        p_dirty = true;
+
+        // Rect is shrunk by half texel, so that linear filtering at edges never reaches neighbour at page
+        const auto pageSize{ (float)p_atlas.getPageSize() };
+        placement.layer = atlasRegion.page;
+        placement.uvRect = maths::vec4{
+            ((float)atlasRegion.x + 0.5f) / pageSize,
+            ((float)atlasRegion.y + 0.5f) / pageSize,
+            ((float)width - 1.f) / pageSize,
+            ((float)height - 1.f) / pageSize
+        };
+        return true;
+    }
+
+    float FMaterialTex2DArray::getOccupancy() const {
+        return p_atlas.getOccupancy();
+    }
+
+
+}
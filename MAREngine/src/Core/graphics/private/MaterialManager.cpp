@@ -38,7 +38,7 @@ namespace marengine {
     void FMaterialManager::updateSceneMaterialData(Scene* pScene) {
         MARLOG_TRACE(ELoggerType::GRAPHICS, "Pushing scene {} to material update...", pScene->getName());
         reset();
-        const FEntityArray& entities{ pScene->getEntities() };
+        const FEntityArray entities{ pScene->getEntities() };
         for(const Entity& entity : entities) {
             updateEntityMaterialData(entity);
         }
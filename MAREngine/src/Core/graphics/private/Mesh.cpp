@@ -21,6 +21,8 @@
 
 
 #include "../public/Mesh.h"
+#include "../public/MeshOptimizer.h"
+#include "../public/MeshSimplifier.h"
 #include "loader_obj/OBJ_Loader.h"
 #include "../../filesystem/public/FileManager.h"
 #include "../../ecs/Entity/Components.h"
@@ -31,6 +33,51 @@
 namespace marengine {
 
 
+    uint32 FMeshLevelOfDetail::s_levelsCount{ GraphicLimits::maxMeshLevelsOfDetail };
+    float FMeshLevelOfDetail::s_screenSizeThreshold{ GraphicLimits::defaultLevelOfDetailScreenSize };
+    float FMeshLevelOfDetail::s_hysteresis{ GraphicLimits::defaultLevelOfDetailHysteresis };
+
+    void FMeshLevelOfDetail::setLevelsCount(uint32 levelsCount) {
+        s_levelsCount = std::clamp<uint32>(levelsCount, 1, GraphicLimits::maxMeshLevelsOfDetail);
+    }
+
+    uint32 FMeshLevelOfDetail::getLevelsCount() {
+        return s_levelsCount;
+    }
+
+    void FMeshLevelOfDetail::setScreenSizeThreshold(float screenSize) {
+        s_screenSizeThreshold = screenSize;
+    }
+
+    float FMeshLevelOfDetail::getScreenSizeThreshold() {
+        return s_screenSizeThreshold;
+    }
+
+    void FMeshLevelOfDetail::setHysteresis(float hysteresis) {
+        s_hysteresis = hysteresis;
+    }
+
+    float FMeshLevelOfDetail::getHysteresis() {
+        return s_hysteresis;
+    }
+
+    uint32 FMeshLevelOfDetail::select(uint32 currentLevel, uint32 levelsCount, float screenSize) {
+        // threshold between level - 1 and level
+        auto getThreshold = [](uint32 level)->float {
+            return s_screenSizeThreshold / (float)(1u << (level - 1));
+        };
+
+        uint32 level{ std::min(currentLevel, levelsCount - 1) };
+        while(level + 1 < levelsCount && screenSize < getThreshold(level + 1) * (1.f - s_hysteresis)) {
+            level++;
+        }
+        while(level > 0 && screenSize > getThreshold(level) * (1.f + s_hysteresis)) {
+            level--;
+        }
+        return level;
+    }
+
+
     const FVertexArray& FMeshProxy::getVertices() const {
         return p_vertices;
     }
@@ -43,6 +90,50 @@ namespace marengine {
         return p_type;
     }
 
+    const FMeshBounds& FMeshProxy::getBounds() const {
+        return p_bounds;
+    }
+
+    void FMeshProxy::computeBounds() {
+        p_bounds = FMeshBounds{};
+        if(p_vertices.empty()) {
+            return;
+        }
+
+        maths::vec3& min{ p_bounds.boxMin };
+        maths::vec3& max{ p_bounds.boxMax };
+        min = p_vertices[0].position;
+        max = p_vertices[0].position;
+        for(const Vertex& vertex : p_vertices) {
+            min.x = std::min(min.x, vertex.position.x);
+            min.y = std::min(min.y, vertex.position.y);
+            min.z = std::min(min.z, vertex.position.z);
+            max.x = std::max(max.x, vertex.position.x);
+            max.y = std::max(max.y, vertex.position.y);
+            max.z = std::max(max.z, vertex.position.z);
+        }
+
+        maths::vec3& center{ p_bounds.sphereCenter };
+        center = { (min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f };
+        float radiusSquared{ 0.f };
+        for(const Vertex& vertex : p_vertices) {
+            const float dx{ vertex.position.x - center.x };
+            const float dy{ vertex.position.y - center.y };
+            const float dz{ vertex.position.z - center.z };
+            radiusSquared = std::max(radiusSquared, dx * dx + dy * dy + dz * dz);
+        }
+        p_bounds.sphereRadius = std::sqrt(radiusSquared);
+    }
+
+
+    FMeshExternalLevel::FMeshExternalLevel(std::string name, FVertexArray vertices, FIndicesArray indices) :
+        p_name(std::move(name)) {
+        p_type = EMeshType::EXTERNAL;
+        p_vertices = std::move(vertices);
+        p_indices = std::move(indices);
+        computeBounds();
+    }
+
 
     FMeshExternal::FMeshExternal() {
         p_type = EMeshType::EXTERNAL;
@@ -75,6 +166,19 @@ namespace marengine {
             }
         }
 
+        if(FMeshOptimizer::isEnabledAtImport()) {
+            const uint32 cacheSize{ GraphicLimits::vertexCacheSize };
+            const uint32 verticesCount{ (uint32)p_vertices.size() };
+            const float acmrBefore{ FMeshOptimizer::computeACMR(p_indices, verticesCount, cacheSize) };
+            FMeshOptimizer::optimize(p_vertices, p_indices);
+            const float acmrAfter{ FMeshOptimizer::computeACMR(p_indices, (uint32)p_vertices.size(), cacheSize) };
+            MARLOG_INFO(ELoggerType::GRAPHICS, "Optimized mesh {}, vertices {} -> {}, ACMR {:.3f} -> {:.3f}",
+                        path, verticesCount, p_vertices.size(), acmrBefore, acmrAfter);
+        }
+
+        computeBounds();
+        generateLevelsOfDetail();
+
         MARLOG_INFO(ELoggerType::GRAPHICS, "Loaded External Mesh -> {}", path);
     }
 
@@ -82,6 +186,43 @@ namespace marengine {
         return p_info;
     }
 
+    const FMeshProxy* FMeshExternal::getLevelOfDetail(uint32 levelOfDetail) const {
+        if(levelOfDetail == 0 || p_levelsOfDetail.empty()) {
+            return this;
+        }
+        return &p_levelsOfDetail[std::min<size_t>(levelOfDetail, p_levelsOfDetail.size()) - 1];
+    }
+
+    uint32 FMeshExternal::getLevelsOfDetailCount() const {
+        return (uint32)p_levelsOfDetail.size() + 1;
+    }
+
+    void FMeshExternal::generateLevelsOfDetail() {
+        p_levelsOfDetail.clear();
+        FMeshSimplifier simplifier;
+        FIndicesArray simplifiedIndices{ p_indices };
+
+        for(uint32 level = 1; level < FMeshLevelOfDetail::getLevelsCount(); level++) {
+            const uint32 previousTrianglesCount{ (uint32)simplifiedIndices.size() / 3 };
+            simplifiedIndices = simplifier.simplify(p_vertices, simplifiedIndices, previousTrianglesCount / 2);
+
+            // Collapses stopped early (flat boundaries, tiny mesh), level would cost batch rebuilds for nothing
+            const uint32 trianglesCount{ (uint32)simplifiedIndices.size() / 3 };
+            if(trianglesCount == 0 || 10 * trianglesCount > 9 * previousTrianglesCount) {
+                break;
+            }
+
+            FVertexArray vertices{ p_vertices };
+            FIndicesArray indices{ simplifiedIndices };
+            FMeshOptimizer::optimizeVertexCache(indices, vertices.size(), GraphicLimits::vertexCacheSize);
+            FMeshOptimizer::optimizeVertexFetch(vertices, indices);
+            p_levelsOfDetail.emplace_back(p_info.path, std::move(vertices), std::move(indices));
+
+            MARLOG_DEBUG(ELoggerType::GRAPHICS, "Generated level of detail {} of mesh {}, triangles {} -> {}",
+                         level, p_info.path, p_indices.size() / 3, trianglesCount);
+        }
+    }
+
 
     const FMeshProxy* FMeshStorage::getExternal(int32 index) const {
         if(index < 0) {
@@ -91,6 +232,13 @@ namespace marengine {
         return &m_externalArray.at(index);
     }
 
+    const FMeshExternal* FMeshStorage::getExternalMesh(int32 index) const {
+        if(index < 0 || index >= (int32)m_externalArray.size()) {
+            return nullptr;
+        }
+        return &m_externalArray[index];
+    }
+
     uint32 FMeshStorage::getCountExternal() const {
         return m_externalArray.size();
     }
@@ -109,7 +257,10 @@ namespace marengine {
 
     const FMeshProxy* FMeshStorage::retrieve(const CRenderable& renderable) const {
         switch(renderable.mesh.type) {
-            case EMeshType::EXTERNAL: return getExternal(renderable.mesh.index);
+            case EMeshType::EXTERNAL: {
+                const FMeshExternal* pMesh{ getExternalMesh(renderable.mesh.index) };
+                return pMesh ? pMesh->getLevelOfDetail(renderable.mesh.levelOfDetail) : nullptr;
+            }
             case EMeshType::CUBE: return getCube();
             case EMeshType::PYRAMID: return getPyramid();
             case EMeshType::SURFACE: return getSurface();
@@ -201,6 +352,7 @@ namespace marengine {
                 1, 0, 4,	6, 7, 3
         };
         p_type = EMeshType::CUBE;
+        computeBounds();
     }
 
     const char* FMeshCube::getName() const {
@@ -223,6 +375,7 @@ namespace marengine {
                 2, 3, 4,	3, 0, 4
         };
         p_type = EMeshType::PYRAMID;
+        computeBounds();
     }
 
     const char* FMeshPyramid::getName() const {
@@ -243,6 +396,7 @@ namespace marengine {
                 2, 3, 0  // second triangle
         };
         p_type = EMeshType::SURFACE;
+        computeBounds();
     }
 
     const char* FMeshSurface::getName() const {
@@ -29,12 +29,81 @@
 namespace marengine {
 
 
+    uint32 FMeshBatchBudget::s_entitiesCount{ GraphicLimits::defaultEntitiesBudget };
+    uint32 FMeshBatchBudget::s_instancingThreshold{ GraphicLimits::defaultInstancingThreshold };
+
+    void FMeshBatchBudget::setEntitiesCount(uint32 entitiesCount) {
+        s_entitiesCount = entitiesCount;
+    }
+
+    uint32 FMeshBatchBudget::getEntitiesCount() {
+        return s_entitiesCount;
+    }
+
+    void FMeshBatchBudget::setInstancingThreshold(uint32 instancingThreshold) {
+        s_instancingThreshold = instancingThreshold;
+    }
+
+    uint32 FMeshBatchBudget::getInstancingThreshold() {
+        return s_instancingThreshold;
+    }
+
+
+    void FBatchDirtyRanges::mark(uint32 index) {
+        mark(FMeshBatchRange{ index, 1 });
+    }
+
+    void FBatchDirtyRanges::mark(const FMeshBatchRange& range) {
+        if(range.count == 0) {
+            return;
+        }
+
+        // Most often the same or next element is marked again, so check the last range first
+        if(!m_ranges.empty() && m_ranges.back().begin <= range.begin && range.begin <= m_ranges.back().end()) {
+            FMeshBatchRange& last{ m_ranges.back() };
+            last.count = std::max(last.end(), range.end()) - last.begin;
+            return;
+        }
+
+        auto it = std::lower_bound(m_ranges.begin(), m_ranges.end(), range,
+                                   [](const FMeshBatchRange& lhs, const FMeshBatchRange& rhs) {
+            return lhs.end() < rhs.begin;
+        });
+        uint32 begin{ range.begin };
+        uint32 end{ range.end() };
+        auto last = it;
+        while(last != m_ranges.end() && last->begin <= end) {
+            begin = std::min(begin, last->begin);
+            end = std::max(end, last->end());
+            ++last;
+        }
+        it = m_ranges.erase(it, last);
+        m_ranges.insert(it, FMeshBatchRange{ begin, end - begin });
+    }
+
+    void FBatchDirtyRanges::clear() {
+        m_ranges.clear();
+    }
+
+    bool FBatchDirtyRanges::isEmpty() const {
+        return m_ranges.empty();
+    }
+
+    const FMeshBatchRangeArray& FBatchDirtyRanges::getRanges() const {
+        return m_ranges;
+    }
+
+
 	void FMeshBatch::reset() {
         MARLOG_DEBUG(ELoggerType::GRAPHICS, "Resetting MeshBatch...");
 		p_vertices.clear();
 		p_indices.clear();
 		p_transforms.clear();
-        p_vbo = p_ibo = p_transformSSBO = -1;
+		p_dirtyTransforms.clear();
+        p_vbo = p_ibo = p_transformSSBO = p_pipeline = -1;
+        p_arenaInfo = {};
+        p_culledRanges.clear();
+        p_isCullingDirty = false;
 	}
 
     const FVertexArray& FMeshBatch::getVertices() const {
@@ -49,19 +118,21 @@ namespace marengine {
 	    return p_transforms;
 	}
 
-    void FMeshBatch::updateVertices(const Entity& entity) {
-        // TODO: implement FMeshBatch::updateVertices
-	    //const auto& cRenderable{ entity.getComponent<CRenderable>() };
+    void FMeshBatch::updateTransform(const Entity& entity) {
+	    const CRenderable::BatchInfo& batchInfo{ entity.getComponent<CRenderable>().batch };
+	    if(batchInfo.isCulled) {
+	        return;
+	    }
+        p_transforms.at(batchInfo.transformIndex) = entity.getComponent<CTransform>().getTransform();
+        p_dirtyTransforms.mark(batchInfo.transformIndex);
 	}
 
-    void FMeshBatch::updateIndices(const Entity& entity) {
-	    // TODO: implement FMeshBatch::updateIndices
-        //const auto& cRenderable{ entity.getComponent<CRenderable>() };
+    const FBatchDirtyRanges& FMeshBatch::getDirtyTransforms() const {
+	    return p_dirtyTransforms;
 	}
 
-    void FMeshBatch::updateTransform(const Entity& entity) {
-        p_transforms.at(entity.getComponent<CRenderable>().batch.transformIndex) =
-                entity.getComponent<CTransform>().getTransform();
+    void FMeshBatch::clearDirtyTransforms() {
+	    p_dirtyTransforms.clear();
 	}
 
     void FMeshBatch::passVBO(int32 index) {
@@ -76,6 +147,10 @@ namespace marengine {
 	    p_transformSSBO = index;
 	}
 
+    void FMeshBatch::passPipeline(int32 index) {
+	    p_pipeline = index;
+	}
+
     int32 FMeshBatch::getVBO() const {
 	    return p_vbo;
 	}
@@ -88,6 +163,30 @@ namespace marengine {
 	    return p_transformSSBO;
 	}
 
+    int32 FMeshBatch::getPipeline() const {
+	    return p_pipeline;
+	}
+
+    void FMeshBatch::passArenaInfo(const FMeshBatchArenaInfo& arenaInfo) {
+	    p_arenaInfo = arenaInfo;
+	}
+
+    const FMeshBatchArenaInfo& FMeshBatch::getArenaInfo() const {
+	    return p_arenaInfo;
+	}
+
+    const FMeshBatchRangeArray& FMeshBatch::getCulledRanges() const {
+        return p_culledRanges;
+    }
+
+    bool FMeshBatch::isCullingDirty() const {
+        return p_isCullingDirty;
+    }
+
+    void FMeshBatch::clearCullingDirty() {
+        p_isCullingDirty = false;
+    }
+
     void FMeshBatch::passMeshStorage(FMeshStorage* pMeshStorage) {
 	    p_pMeshStorage = pMeshStorage;
 	}
@@ -96,6 +195,12 @@ namespace marengine {
         p_pMaterialStorage = pMaterialStorage;
 	}
 
+    maths::mat4 FMeshBatch::getHiddenTransform() {
+        CTransform hiddenTransform;
+        hiddenTransform.scale = maths::vec3{ 0.f, 0.f, 0.f };
+        return hiddenTransform.getTransform();
+    }
+
 
     FMeshBatchStaticColor* FMeshBatchStorageStaticColor::get(int32 index) const {
 	    return const_cast<FMeshBatchStaticColor*>(&m_meshBatches.at(index));
@@ -139,12 +244,34 @@ namespace marengine {
         return const_cast<FMeshBatchStorageStaticTex2D*>(&m_storageStaticTex2D);
 	}
 
+    FMeshBatchStorageStaticColor* FMeshBatchStorage::getStorageInstancedColor() const {
+        return const_cast<FMeshBatchStorageStaticColor*>(&m_storageInstancedColor);
+    }
+
+    FMeshBatchStorageStaticTex2D* FMeshBatchStorage::getStorageInstancedTex2D() const {
+        return const_cast<FMeshBatchStorageStaticTex2D*>(&m_storageInstancedTex2D);
+    }
+
     FMeshBatch* FMeshBatchStorage::retrieve(const CRenderable& cRenderable) const {
         switch(cRenderable.batch.type) {
             case EBatchType::MESH_STATIC_COLOR:
                 return m_storageStaticColor.get(cRenderable.batch.index);
             case EBatchType::MESH_STATIC_TEX2D:
                 return m_storageStaticTex2D.get(cRenderable.batch.index);
+            case EBatchType::MESH_INSTANCED_COLOR:
+                return m_storageInstancedColor.get(cRenderable.batch.index);
+            case EBatchType::MESH_INSTANCED_TEX2D:
+                return m_storageInstancedTex2D.get(cRenderable.batch.index);
+            default: return nullptr;
+        }
+    }
+
+    FMeshBatchStaticColor* FMeshBatchStorage::retrieveColor(const CRenderable& cRenderable) const {
+        switch(cRenderable.batch.type) {
+            case EBatchType::MESH_STATIC_COLOR:
+                return m_storageStaticColor.get(cRenderable.batch.index);
+            case EBatchType::MESH_INSTANCED_COLOR:
+                return m_storageInstancedColor.get(cRenderable.batch.index);
             default: return nullptr;
         }
     }
@@ -161,17 +288,20 @@ namespace marengine {
         MARLOG_DEBUG(ELoggerType::GRAPHICS, "Resetting MeshBatchStorage...");
         clearBatchArray(*m_storageStaticColor.getArray());
         clearBatchArray(*m_storageStaticTex2D.getArray());
+        clearBatchArray(*m_storageInstancedColor.getArray());
+        clearBatchArray(*m_storageInstancedTex2D.getArray());
 	}
 
 
 	template<typename TReturnType, typename TStorageType>
 	static TReturnType* emplaceStorageType(TStorageType* pStorage, FMeshStorage* pMeshStorage,
-                                FMaterialStorage* pMaterialStorage) {
+                                FMaterialStorage* pMaterialStorage, bool isFillDeferred) {
         TReturnType* pBatch{ &pStorage->getArray()->emplace_back() };
         const auto currentSize{ pStorage->getCount() };
         pBatch->setIndex(currentSize - 1);
         pBatch->passMeshStorage(pMeshStorage);
         pBatch->passMaterialStorage(pMaterialStorage);
+        pBatch->passDeferredFill(isFillDeferred);
         return pBatch;
 	}
 
@@ -179,16 +309,42 @@ namespace marengine {
         MARLOG_DEBUG(ELoggerType::GRAPHICS, "Adding new MeshBatch Color...");
         return emplaceStorageType<FMeshBatchStaticColor>(&m_storage.m_storageStaticColor,
                                                          m_pMeshStorage,
-                                                         m_pMaterialStorage);
+                                                         m_pMaterialStorage,
+                                                         m_isFillDeferred);
 	}
 
     FMeshBatchStaticTex2D* FMeshBatchFactory::emplaceStaticTex2D() {
         MARLOG_DEBUG(ELoggerType::GRAPHICS, "Adding new MeshBatch Tex2D...");
         return emplaceStorageType<FMeshBatchStaticTex2D>(&m_storage.m_storageStaticTex2D,
                                                          m_pMeshStorage,
-                                                         m_pMaterialStorage);
+                                                         m_pMaterialStorage,
+                                                         m_isFillDeferred);
 	}
 
+    FMeshBatchStaticColor* FMeshBatchFactory::emplaceInstancedColor(EMeshType meshType, int32 meshIndex,
+                                                                        uint32 levelOfDetail) {
+        MARLOG_DEBUG(ELoggerType::GRAPHICS, "Adding new MeshBatch Instanced Color...");
+        FMeshBatchStaticColor* pBatch{
+            emplaceStorageType<FMeshBatchStaticColor>(&m_storage.m_storageInstancedColor,
+                                                      m_pMeshStorage,
+                                                      m_pMaterialStorage,
+                                                      m_isFillDeferred) };
+        pBatch->passInstancedMesh(meshType, meshIndex, levelOfDetail);
+        return pBatch;
+    }
+
+    FMeshBatchStaticTex2D* FMeshBatchFactory::emplaceInstancedTex2D(EMeshType meshType, int32 meshIndex,
+                                                                        uint32 levelOfDetail) {
+        MARLOG_DEBUG(ELoggerType::GRAPHICS, "Adding new MeshBatch Instanced Tex2D...");
+        FMeshBatchStaticTex2D* pBatch{
+            emplaceStorageType<FMeshBatchStaticTex2D>(&m_storage.m_storageInstancedTex2D,
+                                                      m_pMeshStorage,
+                                                      m_pMaterialStorage,
+                                                      m_isFillDeferred) };
+        pBatch->passInstancedMesh(meshType, meshIndex, levelOfDetail);
+        return pBatch;
+    }
+
 	FMeshBatchStorage* FMeshBatchFactory::getStorage() const {
 	    return const_cast<FMeshBatchStorage*>(&m_storage);
 	}
@@ -201,5 +357,9 @@ namespace marengine {
 	    m_pMaterialStorage = pMaterialStorage;
 	}
 
+    void FMeshBatchFactory::passDeferredFill(bool isFillDeferred) {
+        m_isFillDeferred = isFillDeferred;
+    }
+
 
 }
@@ -30,11 +30,103 @@
 namespace marengine {
 
 
+    static bool isRangeAvailable(const FMeshBatchRangeArray& freeRanges, uint32 count) {
+        auto isRangeBigEnough = [count](const FMeshBatchRange& range)->bool {
+            return range.count >= count;
+        };
+        return std::any_of(freeRanges.cbegin(), freeRanges.cend(), isRangeBigEnough);
+    }
+
+    static bool acquireRange(FMeshBatchRangeArray& freeRanges, uint32 count, uint32& begin) {
+        auto isRangeBigEnough = [count](const FMeshBatchRange& range)->bool {
+            return range.count >= count;
+        };
+        const auto it = std::find_if(freeRanges.begin(), freeRanges.end(), isRangeBigEnough);
+        if(it == freeRanges.end()) {
+            return false;
+        }
+
+        begin = it->begin;
+        it->begin += count;
+        it->count -= count;
+        if(it->count == 0) {
+            freeRanges.erase(it);
+        }
+        return true;
+    }
+
+    static void insertRange(FMeshBatchRangeArray& ranges, FMeshBatchRange range) {
+        if(range.count == 0) {
+            return;
+        }
+
+        auto isAfterRange = [&range](const FMeshBatchRange& existingRange)->bool {
+            return existingRange.begin > range.begin;
+        };
+        auto it = ranges.insert(std::find_if(ranges.begin(), ranges.end(), isAfterRange), range);
+
+        const auto next = it + 1;
+        if(next != ranges.end() && it->end() == next->begin) {
+            it->count += next->count;
+            ranges.erase(next);
+        }
+        if(it != ranges.begin()) {
+            const auto previous = it - 1;
+            if(previous->end() == it->begin) {
+                previous->count += it->count;
+                ranges.erase(it);
+            }
+        }
+    }
+
+    static void eraseRange(FMeshBatchRangeArray& ranges, FMeshBatchRange range) {
+        auto isRangeInside = [&range](const FMeshBatchRange& existingRange)->bool {
+            return existingRange.begin <= range.begin && range.end() <= existingRange.end();
+        };
+        const auto it = std::find_if(ranges.begin(), ranges.end(), isRangeInside);
+        if(range.count == 0 || it == ranges.end()) {
+            return;
+        }
+
+        const FMeshBatchRange before{ it->begin, range.begin - it->begin };
+        const FMeshBatchRange after{ range.end(), it->end() - range.end() };
+        auto next = ranges.erase(it);
+        if(after.count != 0) {
+            next = ranges.insert(next, after);
+        }
+        if(before.count != 0) {
+            ranges.insert(next, before);
+        }
+    }
+
+    /// @brief range drawn for entity, indices for static batch and single instance for instanced one
+    static FMeshBatchRange getDrawnRange(bool isInstanced, const CRenderable::BatchInfo& batchInfo) {
+        if(isInstanced) {
+            return { (uint32)batchInfo.transformIndex, 1 };
+        }
+        return { (uint32)batchInfo.startInd, (uint32)(batchInfo.endInd - batchInfo.startInd) };
+    }
+
+    template<typename TArray>
+    static void trimReleasedTail(FMeshBatchRangeArray& freeRanges, TArray& array) {
+        if(!freeRanges.empty() && freeRanges.back().end() == (uint32)array.size()) {
+            array.resize(freeRanges.back().begin);
+            freeRanges.pop_back();
+        }
+    }
+
+
     void FMeshBatchStatic::reset() {
         MARLOG_DEBUG(ELoggerType::GRAPHICS, "Resetting MeshBatchStatic...");
         FMeshBatch::reset();
+        p_freeVertices.clear();
+        p_freeIndices.clear();
+        p_freeSlots.clear();
         p_shapeID = 0.f;
         p_indicesMaxValue = 0;
+        p_entitiesBudget = FMeshBatchBudget::getEntitiesCount();
+        p_deferredFills.clear();
+        p_isFillDeferred = false;
     }
 
     bool FMeshBatchStatic::shouldBeBatched(const Entity& entity) const {
@@ -72,78 +164,286 @@ namespace marengine {
             return false;
         }
 
-        const uint32 verticesToPush{ (uint32)pMesh->getVertices().size() };
-        const uint32 indicesToPush{ (uint32)pMesh->getIndices().size() };
-
-        const uint32 currentVerticesSize{ (uint32)p_vertices.size() };
-        const uint32 currentIndicesSize{ (uint32)p_indices.size() };
-        const uint32 currentTransformSize{ (uint32)p_transforms.size() };
+        if(isInstanced() && !isInstanceOf(cRenderable)) {
+            MARLOG_DEBUG(ELoggerType::GRAPHICS, "Entity {} cannot be batched at MeshBatchStatic, other mesh instanced!",
+                         entityTag);
+            return false;
+        }
 
-        const bool cannotPushVertices = (currentVerticesSize + verticesToPush) >= GraphicLimits::maxVerticesCount;
-        const bool cannotPushIndices = (currentIndicesSize + indicesToPush) >= GraphicLimits::maxIndicesCount;
-        const bool cannotPushTransform = (currentTransformSize + 1) >= GraphicLimits::maxTransforms;
+        // Instanced batch stores its mesh only once, so only first instance pushes any vertices / indices
+        const bool isMeshStored{ isInstanced() && !p_vertices.empty() };
+        const uint32 verticesToPush{ isMeshStored ? 0 : (uint32)pMesh->getVertices().size() };
+        const uint32 indicesToPush{ isMeshStored ? 0 : (uint32)pMesh->getIndices().size() };
 
-        const bool placeInBatchExist = !(cannotPushVertices || cannotPushIndices || cannotPushTransform);
+        const bool placeInBatchExist{ hasPlaceFor(verticesToPush, indicesToPush) };
 
         MARLOG_DEBUG(ELoggerType::GRAPHICS, "Checked, if entity {} can be batched at MeshBatchStatic, result: {}",
                      entityTag, placeInBatchExist);
         return placeInBatchExist; // true if there is place
     }
 
+    bool FMeshBatchStatic::hasPlaceFor(uint32 verticesToPush, uint32 indicesToPush) const {
+        const uint32 currentVerticesSize{ (uint32)p_vertices.size() };
+        const uint32 currentIndicesSize{ (uint32)p_indices.size() };
+        const uint32 currentTransformSize{ (uint32)p_transforms.size() };
+
+        // Once batch is placed at shared buffers, it cannot outgrow range reserved for it there,
+        // nor reference vertices above the range of its index type
+        const uint32 maxIndexedVerticesCount{ p_arenaInfo.indexType == EIndexType::UINT16 ?
+                GraphicLimits::maxShortIndexedVerticesCount : GraphicLimits::maxVerticesCount };
+        const uint32 maxVerticesCount{ p_arenaInfo.isValid() ?
+                std::min(p_arenaInfo.verticesCapacity, maxIndexedVerticesCount) :
+                GraphicLimits::maxVerticesCount };
+        const uint32 maxIndicesCount{ p_arenaInfo.isValid() ?
+                std::min(p_arenaInfo.indicesCapacity, GraphicLimits::maxIndicesCount) :
+                GraphicLimits::maxIndicesCount };
+
+        const bool cannotPushVertices = !isRangeAvailable(p_freeVertices, verticesToPush) &&
+                (currentVerticesSize + verticesToPush) >= maxVerticesCount;
+        const bool cannotPushIndices = !isRangeAvailable(p_freeIndices, indicesToPush) &&
+                (currentIndicesSize + indicesToPush) >= maxIndicesCount;
+        const bool cannotPushTransform = !hasFreeSlot() && currentTransformSize >= p_entitiesBudget;
+
+        return !(cannotPushVertices || cannotPushIndices || cannotPushTransform);
+    }
+
     void FMeshBatchStatic::submitToBatch(const Entity& entity) {
         const std::string& entityTag{ entity.getComponent<CTag>().tag };
         MARLOG_TRACE(ELoggerType::GRAPHICS, "Submitting entity {} to MeshBatchStatic...", entityTag);
         auto& cRenderable{ entity.getComponent<CRenderable>() };
+        const int32 slot{ acquireSlot() };
+        p_shapeID = (float)slot;
+        if(p_isFillDeferred) {
+            FDeferredFill& deferredFill{ p_deferredFills.emplace_back() };
+            deferredFill.transform = entity.getComponent<CTransform>().getTransform();
+            deferredFill.slot = slot;
+            deferredFill.shapeID = p_shapeID;
+        }
         submitRenderable(cRenderable);
-        submitTransform(entity.getComponent<CTransform>());
+        submitTransform(slot, entity.getComponent<CTransform>());
 
         cRenderable.batch.index = getIndex();
-        cRenderable.batch.transformIndex = (int32)(p_transforms.size() - 1);
+        cRenderable.batch.transformIndex = slot;
+        cRenderable.batch.isCulled = false;
         MARLOG_DEBUG(ELoggerType::GRAPHICS, "Submitted entity {} to MeshBatchStatic!", entityTag);
     }
 
+    void FMeshBatchStatic::removeFromBatch(const Entity& entity) {
+        const std::string& entityTag{ entity.getComponent<CTag>().tag };
+        MARLOG_TRACE(ELoggerType::GRAPHICS, "Removing entity {} from MeshBatchStatic...", entityTag);
+        auto& cRenderable{ entity.getComponent<CRenderable>() };
+        const CRenderable::BatchInfo& batchInfo{ cRenderable.batch };
+        if(batchInfo.isCulled) {
+            eraseRange(p_culledRanges, getDrawnRange(isInstanced(), batchInfo));
+            p_isCullingDirty = true;
+        }
+
+        if(isInstanced()) {
+            // Mesh is shared by other instances, so only instance's transform is collapsed to zero scale.
+            p_transforms.at(batchInfo.transformIndex) = getHiddenTransform();
+            p_dirtyTransforms.mark(batchInfo.transformIndex);
+            p_freeSlots.push_back(batchInfo.transformIndex);
+
+            cRenderable.batch = CRenderable::BatchInfo{};
+            MARLOG_DEBUG(ELoggerType::GRAPHICS, "Removed instance of entity {} from MeshBatchStatic!", entityTag);
+            return;
+        }
+
+        // Indices of removed entity become degenerate triangles, so that nothing is rasterized in their place
+        // until the range is reused. Vertices and transform are left as they are, as nothing references them.
+        // Degenerate triangles point at the first vertex of batch, as released vertices may be trimmed below.
+        const auto fromBeginOfRemovedIndices = p_indices.begin() + batchInfo.startInd;
+        const auto toItsEnd = p_indices.begin() + batchInfo.endInd;
+        std::fill(fromBeginOfRemovedIndices, toItsEnd, 0u);
+
+        insertRange(p_freeVertices, { (uint32)batchInfo.startVert, (uint32)(batchInfo.endVert - batchInfo.startVert) });
+        insertRange(p_freeIndices, { (uint32)batchInfo.startInd, (uint32)(batchInfo.endInd - batchInfo.startInd) });
+        p_freeSlots.push_back(batchInfo.transformIndex);
+
+        trimReleasedTail(p_freeVertices, p_vertices);
+        trimReleasedTail(p_freeIndices, p_indices);
+        // Last vertex left after trimming belongs to live entity, so no live index is above it
+        p_indicesMaxValue = p_vertices.empty() ? 0 : (uint32)p_vertices.size() - 1;
+
+        cRenderable.batch = CRenderable::BatchInfo{};
+        MARLOG_DEBUG(ELoggerType::GRAPHICS, "Removed entity {} from MeshBatchStatic!", entityTag);
+    }
+
+    void FMeshBatchStatic::updateCulled(const Entity& entity, bool isCulled) {
+        CRenderable::BatchInfo& batchInfo{ entity.getComponent<CRenderable>().batch };
+        batchInfo.isCulled = isCulled;
+        p_isCullingDirty = true;
+        if(isCulled) {
+            insertRange(p_culledRanges, getDrawnRange(isInstanced(), batchInfo));
+            return;
+        }
+
+        // Transform of culled entity is not updated, so the current one is restored
+        eraseRange(p_culledRanges, getDrawnRange(isInstanced(), batchInfo));
+        p_transforms.at(batchInfo.transformIndex) = entity.getComponent<CTransform>().getTransform();
+        p_dirtyTransforms.mark(batchInfo.transformIndex);
+    }
+
+    uint32 FMeshBatchStatic::getEntitiesBudget() const {
+        return p_entitiesBudget;
+    }
+
+    EIndexType FMeshBatchStatic::getFittingIndexType() const {
+        if(p_indicesMaxValue <= GraphicLimits::maxShortIndexedVerticesCount) {
+            return EIndexType::UINT16;
+        }
+        return EIndexType::UINT32;
+    }
+
+    void FMeshBatchStatic::passInstancedMesh(EMeshType meshType, int32 meshIndex, uint32 levelOfDetail) {
+        p_instancedMeshType = meshType;
+        p_instancedMeshIndex = meshIndex;
+        p_instancedMeshLevelOfDetail = levelOfDetail;
+    }
+
+    bool FMeshBatchStatic::isInstanced() const {
+        return p_instancedMeshType != EMeshType::NONE;
+    }
+
+    bool FMeshBatchStatic::isInstanceOf(const CRenderable& cRenderable) const {
+        if(cRenderable.mesh.type != p_instancedMeshType) {
+            return false;
+        }
+
+        return p_instancedMeshType != EMeshType::EXTERNAL ||
+               (cRenderable.mesh.index == p_instancedMeshIndex &&
+                cRenderable.mesh.levelOfDetail == p_instancedMeshLevelOfDetail);
+    }
+
+    uint32 FMeshBatchStatic::getInstancesCount() const {
+        return (uint32)p_transforms.size();
+    }
+
+    void FMeshBatchStatic::passDeferredFill(bool isFillDeferred) {
+        p_isFillDeferred = isFillDeferred;
+    }
+
+    void FMeshBatchStatic::fillDeferred() {
+        for(const FDeferredFill& deferredFill : p_deferredFills) {
+            if(deferredFill.pVertices != nullptr) {
+                copyVertices(deferredFill.startVert, *deferredFill.pVertices, deferredFill.shapeID);
+            }
+            if(deferredFill.pIndices != nullptr) {
+                copyIndices(deferredFill.startInd, *deferredFill.pIndices, deferredFill.startVert);
+            }
+            p_transforms.at(deferredFill.slot) = deferredFill.transform;
+        }
+        p_deferredFills.clear();
+        p_isFillDeferred = false;
+    }
+
+    bool FMeshBatchStatic::hasDeferredFill() const {
+        return !p_deferredFills.empty();
+    }
+
+    uint32 FMeshBatchStatic::getDeferredFillsCount() const {
+        return (uint32)p_deferredFills.size();
+    }
+
+    bool FMeshBatchStatic::hasFreeSlot() const {
+        return !p_freeSlots.empty();
+    }
+
+    int32 FMeshBatchStatic::acquireSlot() {
+        if(hasFreeSlot()) {
+            const int32 slot{ p_freeSlots.back() };
+            p_freeSlots.pop_back();
+            return slot;
+        }
+
+        return (int32)p_transforms.size();
+    }
+
     void FMeshBatchStatic::submitRenderable(CRenderable& cRenderable) {
+        if(isInstanced() && !p_vertices.empty()) {
+            cRenderable.batch.startVert = 0;
+            cRenderable.batch.endVert = (int32)p_vertices.size();
+            cRenderable.batch.startInd = 0;
+            cRenderable.batch.endInd = (int32)p_indices.size();
+            return;
+        }
+
         const FMeshProxy* pMesh{ p_pMeshStorage->retrieve(cRenderable) };
-        const FVertexArray& vertices{ pMesh->getVertices() };
-        submitVertices(cRenderable, vertices);
+        submitVertices(cRenderable, pMesh->getVertices());
         submitIndices(cRenderable, pMesh->getIndices());
-
-        p_indicesMaxValue += (vertices.size() * sizeof(Vertex) / 4) / g_MeshStride;
-        p_shapeID++;
     }
 
     void FMeshBatchStatic::submitVertices(CRenderable& cRenderable, const FVertexArray& vertices) {
-        p_vertices.insert(p_vertices.end(), vertices.begin(), vertices.end());
+        uint32 begin{ 0 };
+        if(!acquireRange(p_freeVertices, (uint32)vertices.size(), begin)) {
+            begin = (uint32)p_vertices.size();
+            p_vertices.resize(p_vertices.size() + vertices.size());
+        }
 
-        auto fromBeginOfInsertedVertices = p_vertices.end() - vertices.size();
-        auto toItsEnd = p_vertices.end();
-        auto modifyShaderID = [this](Vertex& vertex) {
-            vertex.shapeID = p_shapeID;
-        };
+        cRenderable.batch.startVert = (int32)begin;
+        cRenderable.batch.endVert = (int32)(begin + vertices.size());
+        if(!vertices.empty()) {
+            p_indicesMaxValue = std::max(p_indicesMaxValue, begin + (uint32)vertices.size() - 1);
+        }
 
-        std::for_each(fromBeginOfInsertedVertices, toItsEnd, modifyShaderID);
+        if(p_isFillDeferred) {
+            FDeferredFill& deferredFill{ p_deferredFills.back() };
+            deferredFill.pVertices = &vertices;
+            deferredFill.startVert = begin;
+            return;
+        }
 
-        cRenderable.batch.startVert = std::distance(p_vertices.begin(), fromBeginOfInsertedVertices);
-        cRenderable.batch.endVert = std::distance(p_vertices.begin(), toItsEnd);
+        copyVertices(begin, vertices, p_shapeID);
     }
 
     void FMeshBatchStatic::submitIndices(CRenderable& cRenderable, const FIndicesArray& indices) {
-        p_indices.insert(p_indices.end(), indices.begin(), indices.end());
+        uint32 begin{ 0 };
+        if(!acquireRange(p_freeIndices, (uint32)indices.size(), begin)) {
+            begin = (uint32)p_indices.size();
+            p_indices.resize(p_indices.size() + indices.size());
+        }
 
-        auto fromBeginOfInsertedIndices = p_indices.end() - indices.size();
-        auto toItsEnd = p_indices.end();
-        auto extendIndices = [this](uint32_t& indice) {
-            indice += p_indicesMaxValue;
-        };
+        cRenderable.batch.startInd = (int32)begin;
+        cRenderable.batch.endInd = (int32)(begin + indices.size());
 
-        std::for_each(fromBeginOfInsertedIndices, toItsEnd, extendIndices);
+        if(p_isFillDeferred) {
+            FDeferredFill& deferredFill{ p_deferredFills.back() };
+            deferredFill.pIndices = &indices;
+            deferredFill.startInd = begin;
+            return;
+        }
 
-        cRenderable.batch.startInd = std::distance(p_indices.begin(), fromBeginOfInsertedIndices);
-        cRenderable.batch.endInd = std::distance(p_indices.begin(), toItsEnd);
+        copyIndices(begin, indices, (uint32)cRenderable.batch.startVert);
     }
 
-    void FMeshBatchStatic::submitTransform(const CTransform& transformComponent) {
-        p_transforms.emplace_back(transformComponent.getTransform());
+    void FMeshBatchStatic::submitTransform(int32 slot, const CTransform& transformComponent) {
+        if(slot == (int32)p_transforms.size()) {
+            p_transforms.emplace_back();
+        }
+        if(!p_isFillDeferred) {
+            p_transforms.at(slot) = transformComponent.getTransform();
+        }
+        p_dirtyTransforms.mark(slot);
+    }
+
+    void FMeshBatchStatic::copyVertices(uint32 begin, const FVertexArray& vertices, float shapeID) {
+        auto fromBeginOfInsertedVertices = p_vertices.begin() + begin;
+        auto toItsEnd = std::copy(vertices.begin(), vertices.end(), fromBeginOfInsertedVertices);
+        auto modifyShaderID = [shapeID](Vertex& vertex) {
+            vertex.shapeID = shapeID;
+        };
+
+        std::for_each(fromBeginOfInsertedVertices, toItsEnd, modifyShaderID);
+    }
+
+    void FMeshBatchStatic::copyIndices(uint32 begin, const FIndicesArray& indices, uint32 startVert) {
+        auto fromBeginOfInsertedIndices = p_indices.begin() + begin;
+        auto toItsEnd = std::copy(indices.begin(), indices.end(), fromBeginOfInsertedIndices);
+        auto extendIndices = [startVert](uint32_t& indice) {
+            indice += startVert;
+        };
+
+        std::for_each(fromBeginOfInsertedIndices, toItsEnd, extendIndices);
     }
 
 
@@ -151,6 +451,7 @@ namespace marengine {
         MARLOG_DEBUG(ELoggerType::GRAPHICS, "Resetting MeshBatchStaticColor...");
         FMeshBatchStatic::reset();
         m_colors.clear();
+        m_dirtyColors.clear();
     }
 
     bool FMeshBatchStaticColor::shouldBeBatched(const Entity& entity) const {
@@ -158,10 +459,9 @@ namespace marengine {
         MARLOG_TRACE(ELoggerType::GRAPHICS, "Checking, if entity {} should be batched at MeshBatchStaticColor...",
                      entityTag);
 
-        const auto currentColorSize{ m_colors.size() };
-        const bool cannotPushColor = (currentColorSize + 1) >= GraphicLimits::maxTransforms;
-
-        if(!FMeshBatchStatic::shouldBeBatched(entity) || cannotPushColor) {
+        // Only kind of entity is checked here, place for its color is checked by canBeBatched, as color shares
+        // slot with transform. Otherwise no entity would be batched, once the first batch is full.
+        if(!FMeshBatchStatic::shouldBeBatched(entity)) {
             MARLOG_DEBUG(ELoggerType::GRAPHICS, "Entity {} should not be batched at MeshBatchStaticColor...", entityTag);
             return false;
         }
@@ -190,15 +490,21 @@ namespace marengine {
 
         FMeshBatchStatic::submitToBatch(entity);
         auto& cRenderable{ entity.getComponent<CRenderable>() };
-        submitColor(cRenderable.color);
+        submitColor(cRenderable.batch.transformIndex, cRenderable.color);
 
-        cRenderable.batch.materialIndex = (int32)(m_colors.size() - 1);
-        cRenderable.batch.type = EBatchType::MESH_STATIC_COLOR;
+        cRenderable.batch.materialIndex = cRenderable.batch.transformIndex;
+        cRenderable.batch.type = getType();
         MARLOG_DEBUG(ELoggerType::GRAPHICS, "Submitted entity {} to MeshBatchStaticColor!", entityTag);
     }
 
-    void FMeshBatchStaticColor::submitColor(const maths::vec4& color) {
-        m_colors.emplace_back(color);
+    void FMeshBatchStaticColor::submitColor(int32 slot, const maths::vec4& color) {
+        if(slot == (int32)m_colors.size()) {
+            m_colors.emplace_back(color);
+        }
+        else {
+            m_colors.at(slot) = color;
+        }
+        m_dirtyColors.mark(slot);
     }
 
     const FColorsArray& FMeshBatchStaticColor::getColors() const {
@@ -208,6 +514,15 @@ namespace marengine {
     void FMeshBatchStaticColor::updateColor(const Entity& entity) {
         const auto& cRenderable{ entity.getComponent<CRenderable>() };
         m_colors.at(cRenderable.batch.materialIndex) = cRenderable.color;
+        m_dirtyColors.mark(cRenderable.batch.materialIndex);
+    }
+
+    const FBatchDirtyRanges& FMeshBatchStaticColor::getDirtyColors() const {
+        return m_dirtyColors;
+    }
+
+    void FMeshBatchStaticColor::clearDirtyColors() {
+        m_dirtyColors.clear();
     }
 
     int32 FMeshBatchStaticColor::getColorSSBO() const {
@@ -219,12 +534,17 @@ namespace marengine {
     }
 
     EBatchType FMeshBatchStaticColor::getType() const {
-        return EBatchType::MESH_STATIC_COLOR;
+        return isInstanced() ? EBatchType::MESH_INSTANCED_COLOR : EBatchType::MESH_STATIC_COLOR;
     }
 
 
     void FMeshBatchStaticTex2D::reset() {
+        MARLOG_DEBUG(ELoggerType::GRAPHICS, "Resetting MeshBatchStaticTex2D...");
+        FMeshBatchStatic::reset();
+        m_textures.clear();
+        m_textureUsages.clear();
         m_textureIndexes.clear();
+        m_areSamplersLocked = false;
     }
 
     bool FMeshBatchStaticTex2D::shouldBeBatched(const Entity& entity) const {
@@ -257,9 +577,9 @@ namespace marengine {
         }
 
         const auto& cRenderable{ entity.getComponent<CRenderable>() };
-        const auto currentTexturesSize{ m_textureIndexes.size() };
-        const bool cannotPushTexture = cRenderable.material.type != EMaterialType::TEX2D ||
-                (currentTexturesSize + 1) >= GraphicLimits::maxTransforms;
+        const bool cannotPushTexture = !cRenderable.material.isValid() ||
+                cRenderable.material.type != EMaterialType::TEX2D ||
+                !isTextureAvailable(p_pMaterialStorage->getTex2D(cRenderable.material.index));
 
         if(cannotPushTexture) {
             MARLOG_DEBUG(ELoggerType::GRAPHICS, "Entity {} cannot be batched at MeshBatchStaticTex2D...", entityTag);
@@ -277,26 +597,111 @@ namespace marengine {
         FMeshBatchStatic::submitToBatch(entity);
         auto& cRenderable{ entity.getComponent<CRenderable>() };
         FMaterialTex2D* pTexture{ p_pMaterialStorage->getTex2D(cRenderable.material.index) };
-        pTexture->setSampler(cRenderable.batch.transformIndex);
-        submitTexture(pTexture);
+        submitTexture(cRenderable.batch.transformIndex, pTexture);
 
-        cRenderable.batch.materialIndex = (int32)(m_textureIndexes.size() - 1);
-        cRenderable.batch.type = EBatchType::MESH_STATIC_TEX2D;
+        cRenderable.batch.materialIndex = cRenderable.batch.transformIndex;
+        cRenderable.batch.type = getType();
 
         MARLOG_DEBUG(ELoggerType::GRAPHICS, "Submitted entity {} to MeshBatchStaticTex2D!", entityTag);
     }
 
-    void FMeshBatchStaticTex2D::submitTexture(FMaterialTex2D* pTexture2D) {
-        m_textureIndexes.emplace_back(pTexture2D->getIndex());
+    void FMeshBatchStaticTex2D::removeFromBatch(const Entity& entity) {
+        const auto& cRenderable{ entity.getComponent<CRenderable>() };
+        releaseTexture(cRenderable.batch.materialIndex);
+        FMeshBatchStatic::removeFromBatch(entity);
+    }
+
+    bool FMeshBatchStaticTex2D::isTextureAvailable(const FMaterialTex2D* pTexture2D) const {
+        if(p_pMaterialStorage->isBindless()) {
+            return true;
+        }
+
+        const int32 arrayIndex{ pTexture2D->getPlacement().arrayIndex };
+        const bool arrayAlreadyBound{
+            std::find(m_textures.cbegin(), m_textures.cend(), arrayIndex) != m_textures.cend() };
+        if(m_areSamplersLocked) {
+            return arrayAlreadyBound;
+        }
+
+        const bool freeSamplerExists{
+            std::find(m_textureUsages.cbegin(), m_textureUsages.cend(), 0) != m_textureUsages.cend() };
+        return arrayAlreadyBound || freeSamplerExists || m_textures.size() < GraphicLimits::maxTextureSamplers;
+    }
+
+    void FMeshBatchStaticTex2D::submitTexture(int32 slot, FMaterialTex2D* pTexture2D) {
+        const FTex2DPlacement& placement{ pTexture2D->getPlacement() };
+        FTex2DShaderRef shaderRef;
+        if(p_pMaterialStorage->isBindless()) {
+            shaderRef.first = (uint32)(placement.handle & 0xFFFFFFFF);
+            shaderRef.second = (uint32)(placement.handle >> 32);
+        }
+        else {
+            // Sampler bound to array already is shared, otherwise free one is rebound before new one is added
+            auto arrayIt = std::find(m_textures.begin(), m_textures.end(), placement.arrayIndex);
+            if(arrayIt == m_textures.end()) {
+                const auto freeIt = std::find(m_textureUsages.cbegin(), m_textureUsages.cend(), 0);
+                if(freeIt != m_textureUsages.cend()) {
+                    arrayIt = m_textures.begin() + std::distance(m_textureUsages.cbegin(), freeIt);
+                    *arrayIt = placement.arrayIndex;
+                }
+                else {
+                    m_textures.emplace_back(placement.arrayIndex);
+                    m_textureUsages.emplace_back(0);
+                    arrayIt = m_textures.end() - 1;
+                }
+            }
+            const auto sampler{ (uint32)std::distance(m_textures.begin(), arrayIt) };
+            m_textureUsages.at(sampler)++;
+            shaderRef.uvRect = placement.uvRect;
+            shaderRef.first = sampler;
+            shaderRef.second = placement.layer;
+        }
+
+        if(slot == (int32)m_textureIndexes.size()) {
+            m_textureIndexes.emplace_back(shaderRef);
+        }
+        else {
+            m_textureIndexes.at(slot) = shaderRef;
+        }
+    }
+
+    void FMeshBatchStaticTex2D::releaseTexture(int32 slot) {
+        if(p_pMaterialStorage->isBindless()) {
+            return;
+        }
+
+        const uint32 sampler{ m_textureIndexes.at(slot).first };
+        m_textureUsages.at(sampler)--;
+        // Samplers in the middle keep their position, as other entities reference them at m_textureIndexes
+        while(!m_areSamplersLocked && !m_textureUsages.empty() && m_textureUsages.back() == 0) {
+            m_textureUsages.pop_back();
+            m_textures.pop_back();
+        }
     }
 
     EBatchType FMeshBatchStaticTex2D::getType() const {
-        return EBatchType::MESH_STATIC_TEX2D;
+        return isInstanced() ? EBatchType::MESH_INSTANCED_TEX2D : EBatchType::MESH_STATIC_TEX2D;
+    }
+
+    const std::vector<int32>& FMeshBatchStaticTex2D::getTextures() const {
+        return m_textures;
     }
 
-    const std::vector<int32>& FMeshBatchStaticTex2D::getTextureIndexes() const {
+    const std::vector<FTex2DShaderRef>& FMeshBatchStaticTex2D::getTextureIndexes() const {
         return m_textureIndexes;
     }
 
+    int32 FMeshBatchStaticTex2D::getTextureIndexesSSBO() const {
+        return m_textureIndexesSSBO;
+    }
+
+    void FMeshBatchStaticTex2D::passTextureIndexesSSBO(int32 id) {
+        m_textureIndexesSSBO = id;
+    }
+
+    void FMeshBatchStaticTex2D::lockSamplers() {
+        m_areSamplersLocked = true;
+    }
+
 
 }
@@ -0,0 +1,231 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+
+
+#include "../public/MeshOptimizer.h"
+
+
+namespace marengine {
+
+
+    static int32 getNextFanningVertex(const std::vector<uint32>& candidates,
+                                      const std::vector<uint32>& liveTriangles,
+                                      const std::vector<uint32>& cacheTime, uint32 timestamp, uint32 cacheSize,
+                                      std::vector<uint32>& deadEnd, uint32& cursor);
+
+
+    bool FMeshOptimizer::s_enabledAtImport{ true };
+
+    void FMeshOptimizer::setEnabledAtImport(bool enabled) {
+        s_enabledAtImport = enabled;
+    }
+
+    bool FMeshOptimizer::isEnabledAtImport() {
+        return s_enabledAtImport;
+    }
+
+    void FMeshOptimizer::optimize(FVertexArray& vertices, FIndicesArray& indices) {
+        deduplicateVertices(vertices, indices);
+        optimizeVertexCache(indices, vertices.size(), GraphicLimits::vertexCacheSize);
+        optimizeVertexFetch(vertices, indices);
+    }
+
+    void FMeshOptimizer::deduplicateVertices(FVertexArray& vertices, FIndicesArray& indices) {
+        // Vertex is made only of floats, so it can be hashed and compared as raw bytes
+        struct FVertexHash {
+            size_t operator()(const Vertex& vertex) const {
+                const auto* bytes{ reinterpret_cast<const uint8_t*>(&vertex) };
+                uint64_t hash{ 14695981039346656037ull };
+                for(size_t i = 0; i < sizeof(Vertex); i++) {
+                    hash = (hash ^ bytes[i]) * 1099511628211ull;
+                }
+                return (size_t)hash;
+            }
+        };
+        struct FVertexEqual {
+            bool operator()(const Vertex& lhs, const Vertex& rhs) const {
+                return std::memcmp(&lhs, &rhs, sizeof(Vertex)) == 0;
+            }
+        };
+
+        std::unordered_map<Vertex, uint32, FVertexHash, FVertexEqual> uniqueIndexes;
+        uniqueIndexes.reserve(vertices.size());
+        std::vector<uint32> remap(vertices.size());
+        FVertexArray uniqueVertices;
+        uniqueVertices.reserve(vertices.size());
+
+        for(uint32 i = 0; i < vertices.size(); i++) {
+            const auto inserted{ uniqueIndexes.emplace(vertices[i], (uint32)uniqueVertices.size()) };
+            if(inserted.second) {
+                uniqueVertices.push_back(vertices[i]);
+            }
+            remap[i] = inserted.first->second;
+        }
+
+        for(uint32& index : indices) {
+            index = remap[index];
+        }
+        vertices = std::move(uniqueVertices);
+    }
+
+    void FMeshOptimizer::optimizeVertexCache(FIndicesArray& indices, uint32 verticesCount, uint32 cacheSize) {
+        const uint32 trianglesCount{ (uint32)indices.size() / 3 };
+        if(trianglesCount == 0 || verticesCount == 0) {
+            return;
+        }
+
+        // Triangles using vertex v are stored at adjacency[offsets[v], offsets[v + 1])
+        std::vector<uint32> liveTriangles(verticesCount, 0);
+        for(uint32 i = 0; i < trianglesCount * 3; i++) {
+            liveTriangles[indices[i]]++;
+        }
+        std::vector<uint32> offsets(verticesCount + 1, 0);
+        for(uint32 v = 0; v < verticesCount; v++) {
+            offsets[v + 1] = offsets[v] + liveTriangles[v];
+        }
+        std::vector<uint32> adjacency(trianglesCount * 3);
+        std::vector<uint32> fillOffsets(offsets.begin(), offsets.end() - 1);
+        for(uint32 i = 0; i < trianglesCount * 3; i++) {
+            adjacency[fillOffsets[indices[i]]++] = i / 3;
+        }
+
+        std::vector<uint32> cacheTime(verticesCount, 0);
+        std::vector<bool> emitted(trianglesCount, false);
+        std::vector<uint32> deadEnd;
+        std::vector<uint32> candidates;
+        FIndicesArray output;
+        output.reserve(trianglesCount * 3);
+
+        uint32 timestamp{ cacheSize + 1 };
+        uint32 cursor{ 0 };
+        int32 fanning{ 0 };
+        while(fanning >= 0) {
+            // Emit every not yet emitted triangle around fanning vertex
+            candidates.clear();
+            for(uint32 a = offsets[fanning]; a < offsets[fanning + 1]; a++) {
+                const uint32 triangle{ adjacency[a] };
+                if(emitted[triangle]) {
+                    continue;
+                }
+                for(uint32 k = 0; k < 3; k++) {
+                    const uint32 v{ indices[triangle * 3 + k] };
+                    output.push_back(v);
+                    deadEnd.push_back(v);
+                    candidates.push_back(v);
+                    liveTriangles[v]--;
+                    if(timestamp - cacheTime[v] > cacheSize) {
+                        cacheTime[v] = timestamp;
+                        timestamp++;
+                    }
+                }
+                emitted[triangle] = true;
+            }
+
+            fanning = getNextFanningVertex(candidates, liveTriangles, cacheTime, timestamp, cacheSize,
+                                           deadEnd, cursor);
+        }
+
+        // Trailing indices, which did not form full triangle, are kept as they were
+        for(uint32 i = trianglesCount * 3; i < indices.size(); i++) {
+            output.push_back(indices[i]);
+        }
+        indices = std::move(output);
+    }
+
+    void FMeshOptimizer::optimizeVertexFetch(FVertexArray& vertices, FIndicesArray& indices) {
+        constexpr uint32 notUsed{ std::numeric_limits<uint32>::max() };
+        std::vector<uint32> remap(vertices.size(), notUsed);
+        FVertexArray orderedVertices;
+        orderedVertices.reserve(vertices.size());
+
+        for(uint32& index : indices) {
+            if(remap[index] == notUsed) {
+                remap[index] = (uint32)orderedVertices.size();
+                orderedVertices.push_back(vertices[index]);
+            }
+            index = remap[index];
+        }
+        vertices = std::move(orderedVertices);
+    }
+
+    float FMeshOptimizer::computeACMR(const FIndicesArray& indices, uint32 verticesCount, uint32 cacheSize) {
+        const uint32 trianglesCount{ (uint32)indices.size() / 3 };
+        if(trianglesCount == 0) {
+            return 0.f;
+        }
+
+        // FIFO cache, vertex is still cached if fewer than cacheSize misses happened since it was loaded
+        std::vector<int64> loadTime(verticesCount, -(int64)cacheSize - 1);
+        int64 misses{ 0 };
+        for(uint32 i = 0; i < trianglesCount * 3; i++) {
+            const uint32 v{ indices[i] };
+            if(misses - loadTime[v] > (int64)cacheSize) {
+                loadTime[v] = misses;
+                misses++;
+            }
+        }
+        return (float)misses / (float)trianglesCount;
+    }
+
+
+    int32 getNextFanningVertex(const std::vector<uint32>& candidates,
+                               const std::vector<uint32>& liveTriangles,
+                               const std::vector<uint32>& cacheTime, uint32 timestamp, uint32 cacheSize,
+                               std::vector<uint32>& deadEnd, uint32& cursor) {
+        // Prefer candidate, which stays longest in cache, as long as its remaining triangles still fit there
+        int32 best{ -1 };
+        int64 bestPriority{ -1 };
+        for(uint32 v : candidates) {
+            if(liveTriangles[v] == 0) {
+                continue;
+            }
+            int64 priority{ 0 };
+            if(timestamp - cacheTime[v] + 2 * liveTriangles[v] <= cacheSize) {
+                priority = timestamp - cacheTime[v];
+            }
+            if(priority > bestPriority) {
+                bestPriority = priority;
+                best = (int32)v;
+            }
+        }
+        if(best != -1) {
+            return best;
+        }
+
+        // Dead end, recently emitted vertices are tried first, then the first one with triangles left
+        while(!deadEnd.empty()) {
+            const uint32 v{ deadEnd.back() };
+            deadEnd.pop_back();
+            if(liveTriangles[v] > 0) {
+                return (int32)v;
+            }
+        }
+        while(cursor < liveTriangles.size()) {
+            if(liveTriangles[cursor] > 0) {
+                return (int32)cursor;
+            }
+            cursor++;
+        }
+        return -1;
+    }
+
+
+}
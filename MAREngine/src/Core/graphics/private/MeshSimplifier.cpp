@@ -0,0 +1,335 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+
+
+#include "../public/MeshSimplifier.h"
+
+
+namespace marengine {
+
+
+    /// @brief boundary edges are preserved with planes perpendicular to their triangle, scaled by this factor
+    static constexpr double g_boundaryWeight{ 10.0 };
+
+
+    FIndicesArray FMeshSimplifier::simplify(const FVertexArray& vertices, const FIndicesArray& indices,
+                                            uint32 targetTrianglesCount) {
+        if(indices.size() / 3 <= targetTrianglesCount) {
+            return indices;
+        }
+
+        weldPositions(vertices);
+        createTriangles(indices);
+        computeQuadrics();
+
+        for(uint32 t = 0; t < m_alive.size(); t++) {
+            if(!m_alive[t]) {
+                continue;
+            }
+            for(uint32 k = 0; k < 3; k++) {
+                const uint32 a{ m_triangles[3 * t + k] };
+                const uint32 b{ m_triangles[3 * t + (k + 1) % 3] };
+                if(a < b) {
+                    pushCollapse(a, b);
+                }
+            }
+        }
+
+        while(m_aliveCount > targetTrianglesCount && !m_collapses.empty()) {
+            const FCollapse candidate{ m_collapses.top() };
+            m_collapses.pop();
+
+            if(m_removed[candidate.from] || m_removed[candidate.to] ||
+               m_versions[candidate.from] != candidate.fromVersion ||
+               m_versions[candidate.to] != candidate.toVersion) {
+                continue;
+            }
+            if(isFlipping(candidate.from, candidate.to)) {
+                continue;
+            }
+
+            collapse(candidate.from, candidate.to);
+        }
+
+        FIndicesArray simplified;
+        simplified.reserve(3 * m_aliveCount);
+        for(uint32 t = 0; t < m_alive.size(); t++) {
+            if(!m_alive[t]) {
+                continue;
+            }
+            for(uint32 k = 0; k < 3; k++) {
+                const uint32 vertex{ indices[3 * t + k] };
+                const uint32 position{ m_triangles[3 * t + k] };
+                simplified.push_back(m_positionOfVertex[vertex] == position ?
+                                     vertex : getClosestWedge(vertices, vertex, position));
+            }
+        }
+
+        m_collapses = {};
+        return simplified;
+    }
+
+    void FMeshSimplifier::weldPositions(const FVertexArray& vertices) {
+        m_positions.clear();
+        m_wedges.clear();
+        m_positionOfVertex.resize(vertices.size());
+
+        std::unordered_map<uint64_t, std::vector<uint32>> buckets;
+        buckets.reserve(vertices.size());
+        for(uint32 v = 0; v < vertices.size(); v++) {
+            const maths::vec3& position{ vertices[v].position };
+            uint64_t hash{ 14695981039346656037ULL };
+            const auto* bytes{ (const uint8_t*)&position };
+            for(size_t i = 0; i < sizeof(maths::vec3); i++) {
+                hash = (hash ^ bytes[i]) * 1099511628211ULL;
+            }
+
+            std::vector<uint32>& bucket{ buckets[hash] };
+            const auto it = std::find_if(bucket.cbegin(), bucket.cend(), [this, &position](uint32 p) {
+                return m_positions[p].x == position.x && m_positions[p].y == position.y &&
+                       m_positions[p].z == position.z;
+            });
+            if(it != bucket.cend()) {
+                m_positionOfVertex[v] = *it;
+                m_wedges[*it].push_back(v);
+                continue;
+            }
+
+            const auto newPosition{ (uint32)m_positions.size() };
+            m_positions.push_back({ position.x, position.y, position.z });
+            m_wedges.push_back({ v });
+            bucket.push_back(newPosition);
+            m_positionOfVertex[v] = newPosition;
+        }
+
+        m_quadrics.assign(m_positions.size(), FQuadric{});
+        m_versions.assign(m_positions.size(), 0);
+        m_removed.assign(m_positions.size(), false);
+    }
+
+    void FMeshSimplifier::createTriangles(const FIndicesArray& indices) {
+        const size_t trianglesCount{ indices.size() / 3 };
+        m_triangles.resize(3 * trianglesCount);
+        m_alive.assign(trianglesCount, true);
+        m_aliveCount = 0;
+        m_adjacency.assign(m_positions.size(), {});
+
+        for(uint32 t = 0; t < trianglesCount; t++) {
+            for(uint32 k = 0; k < 3; k++) {
+                m_triangles[3 * t + k] = m_positionOfVertex[indices[3 * t + k]];
+            }
+            const uint32* corners{ &m_triangles[3 * t] };
+            if(corners[0] == corners[1] || corners[1] == corners[2] || corners[0] == corners[2]) {
+                m_alive[t] = false;
+                continue;
+            }
+            for(uint32 k = 0; k < 3; k++) {
+                m_adjacency[corners[k]].push_back(t);
+            }
+            m_aliveCount++;
+        }
+    }
+
+    void FMeshSimplifier::computeQuadrics() {
+        std::unordered_map<uint64_t, uint32> edgeUsages;
+        edgeUsages.reserve(m_triangles.size());
+
+        for(uint32 t = 0; t < m_alive.size(); t++) {
+            if(!m_alive[t]) {
+                continue;
+            }
+            const uint32* corners{ &m_triangles[3 * t] };
+            const FPoint normal{ (m_positions[corners[1]] - m_positions[corners[0]])
+                                 .cross(m_positions[corners[2]] - m_positions[corners[0]]) };
+            const double doubleArea{ std::sqrt(normal.dot(normal)) };
+            if(doubleArea == 0.0) {
+                continue;
+            }
+            const FPoint unit{ normal.x / doubleArea, normal.y / doubleArea, normal.z / doubleArea };
+            const double distance{ -unit.dot(m_positions[corners[0]]) };
+            for(uint32 k = 0; k < 3; k++) {
+                m_quadrics[corners[k]].addPlane(unit, distance, 0.5 * doubleArea);
+
+                const uint32 a{ std::min(corners[k], corners[(k + 1) % 3]) };
+                const uint32 b{ std::max(corners[k], corners[(k + 1) % 3]) };
+                edgeUsages[((uint64_t)a << 32u) | b]++;
+            }
+        }
+
+        for(uint32 t = 0; t < m_alive.size(); t++) {
+            if(!m_alive[t]) {
+                continue;
+            }
+            const uint32* corners{ &m_triangles[3 * t] };
+            const FPoint normal{ (m_positions[corners[1]] - m_positions[corners[0]])
+                                 .cross(m_positions[corners[2]] - m_positions[corners[0]]) };
+            for(uint32 k = 0; k < 3; k++) {
+                const uint32 a{ corners[k] };
+                const uint32 b{ corners[(k + 1) % 3] };
+                if(edgeUsages[((uint64_t)std::min(a, b) << 32u) | std::max(a, b)] != 1) {
+                    continue;
+                }
+
+                const FPoint edge{ m_positions[b] - m_positions[a] };
+                const FPoint perpendicular{ edge.cross(normal) };
+                const double length{ std::sqrt(perpendicular.dot(perpendicular)) };
+                if(length == 0.0) {
+                    continue;
+                }
+                const FPoint unit{ perpendicular.x / length, perpendicular.y / length, perpendicular.z / length };
+                const double distance{ -unit.dot(m_positions[a]) };
+                const double weight{ g_boundaryWeight * edge.dot(edge) };
+                m_quadrics[a].addPlane(unit, distance, weight);
+                m_quadrics[b].addPlane(unit, distance, weight);
+            }
+        }
+    }
+
+    void FMeshSimplifier::pushCollapse(uint32 a, uint32 b) {
+        FQuadric quadric{ m_quadrics[a] };
+        quadric.add(m_quadrics[b]);
+
+        const double costToB{ quadric.evaluate(m_positions[b]) };
+        const double costToA{ quadric.evaluate(m_positions[a]) };
+        if(costToB <= costToA) {
+            m_collapses.push({ costToB, a, b, m_versions[a], m_versions[b] });
+        }
+        else {
+            m_collapses.push({ costToA, b, a, m_versions[b], m_versions[a] });
+        }
+    }
+
+    bool FMeshSimplifier::isFlipping(uint32 from, uint32 to) const {
+        for(const uint32 t : m_adjacency[from]) {
+            if(!m_alive[t]) {
+                continue;
+            }
+            const uint32* corners{ &m_triangles[3 * t] };
+            if(corners[0] == to || corners[1] == to || corners[2] == to) {
+                continue;
+            }
+
+            FPoint before[3];
+            FPoint after[3];
+            for(uint32 k = 0; k < 3; k++) {
+                before[k] = m_positions[corners[k]];
+                after[k] = corners[k] == from ? m_positions[to] : before[k];
+            }
+            const FPoint normalBefore{ (before[1] - before[0]).cross(before[2] - before[0]) };
+            const FPoint normalAfter{ (after[1] - after[0]).cross(after[2] - after[0]) };
+            if(normalBefore.dot(normalAfter) <= 0.0) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void FMeshSimplifier::collapse(uint32 from, uint32 to) {
+        for(const uint32 t : m_adjacency[from]) {
+            if(!m_alive[t]) {
+                continue;
+            }
+            uint32* corners{ &m_triangles[3 * t] };
+            if(corners[0] == to || corners[1] == to || corners[2] == to) {
+                m_alive[t] = false;
+                m_aliveCount--;
+                continue;
+            }
+            for(uint32 k = 0; k < 3; k++) {
+                if(corners[k] == from) {
+                    corners[k] = to;
+                }
+            }
+            m_adjacency[to].push_back(t);
+        }
+
+        m_removed[from] = true;
+        m_adjacency[from].clear();
+        m_quadrics[to].add(m_quadrics[from]);
+        m_versions[to]++;
+
+        std::vector<uint32>& adjacency{ m_adjacency[to] };
+        adjacency.erase(std::remove_if(adjacency.begin(), adjacency.end(), [this](uint32 t) {
+            return !m_alive[t];
+        }), adjacency.end());
+
+        for(const uint32 t : adjacency) {
+            for(uint32 k = 0; k < 3; k++) {
+                const uint32 neighbour{ m_triangles[3 * t + k] };
+                if(neighbour != to) {
+                    pushCollapse(to, neighbour);
+                }
+            }
+        }
+    }
+
+    uint32 FMeshSimplifier::getClosestWedge(const FVertexArray& vertices, uint32 vertex, uint32 position) const {
+        const Vertex& original{ vertices[vertex] };
+        uint32 closest{ m_wedges[position][0] };
+        float closestDistance{ std::numeric_limits<float>::max() };
+
+        for(const uint32 wedge : m_wedges[position]) {
+            const Vertex& candidate{ vertices[wedge] };
+            const float dx{ candidate.lightNormal.x - original.lightNormal.x };
+            const float dy{ candidate.lightNormal.y - original.lightNormal.y };
+            const float dz{ candidate.lightNormal.z - original.lightNormal.z };
+            const float du{ candidate.textureCoordinates.x - original.textureCoordinates.x };
+            const float dv{ candidate.textureCoordinates.y - original.textureCoordinates.y };
+            const float distance{ dx * dx + dy * dy + dz * dz + du * du + dv * dv +
+                                  (candidate.shapeID == original.shapeID ? 0.f : 1.f) };
+            if(distance < closestDistance) {
+                closest = wedge;
+                closestDistance = distance;
+            }
+        }
+
+        return closest;
+    }
+
+    void FMeshSimplifier::FQuadric::addPlane(const FPoint& normal, double distance, double weight) {
+        a[0] += weight * normal.x * normal.x;
+        a[1] += weight * normal.x * normal.y;
+        a[2] += weight * normal.x * normal.z;
+        a[3] += weight * normal.x * distance;
+        a[4] += weight * normal.y * normal.y;
+        a[5] += weight * normal.y * normal.z;
+        a[6] += weight * normal.y * distance;
+        a[7] += weight * normal.z * normal.z;
+        a[8] += weight * normal.z * distance;
+        a[9] += weight * distance * distance;
+    }
+
+    void FMeshSimplifier::FQuadric::add(const FQuadric& other) {
+        for(uint32 i = 0; i < 10; i++) {
+            a[i] += other.a[i];
+        }
+    }
+
+    double FMeshSimplifier::FQuadric::evaluate(const FPoint& p) const {
+        return a[0] * p.x * p.x + 2.0 * a[1] * p.x * p.y + 2.0 * a[2] * p.x * p.z + 2.0 * a[3] * p.x
+             + a[4] * p.y * p.y + 2.0 * a[5] * p.y * p.z + 2.0 * a[6] * p.y
+             + a[7] * p.z * p.z + 2.0 * a[8] * p.z
+             + a[9];
+    }
+
+
+}
@@ -0,0 +1,564 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+
+
+#include "../public/OcclusionCuller.h"
+#include "../../../Logging/Logger.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define MARENGINE_OCCLUSION_CULLER_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        // MSVC emits any intrinsic without per function target, CPU support is checked before kernel is called
+        #define MARENGINE_TARGET_SSE41
+        #define MARENGINE_TARGET_AVX2
+    #else
+        #define MARENGINE_TARGET_SSE41 __attribute__((target("sse4.1")))
+        #define MARENGINE_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#else
+    #define MARENGINE_OCCLUSION_CULLER_X86 0
+#endif
+
+
+namespace marengine {
+
+
+    /// @brief Edge functions and depth at first pixel of triangle span and their change per pixel
+    struct FTriangleSpan {
+        float edge0{ 0.f }, edge1{ 0.f }, edge2{ 0.f }, depth{ 0.f };
+        float stepEdge0{ 0.f }, stepEdge1{ 0.f }, stepEdge2{ 0.f }, stepDepth{ 0.f };
+    };
+
+    /// @brief triangles and boxes with vertices closer than this clip space w are not handled (near plane)
+    static constexpr float g_minClipW{ 1e-4f };
+
+    /// @brief depth written by pixels outside of triangle, it never wins with depth already stored at buffer
+    static constexpr float g_maxDepth{ std::numeric_limits<float>::max() };
+
+    static maths::vec4 transformPoint(const float* m, float x, float y, float z, float w);
+
+    static bool isKernelSupported(EOcclusionKernel kernel);
+    static bool isKernelMatchingScalar(EOcclusionKernel kernel);
+    static void rasterizeSpanWith(EOcclusionKernel kernel, const FTriangleSpan& span, int32_t count, float* row);
+    static void rasterizeSpanScalar(const FTriangleSpan& span, int32_t begin, int32_t count, float* row);
+    static void reduceRowWith(EOcclusionKernel kernel, const float* source0, const float* source1,
+                              uint32 sourceWidth, uint32 targetWidth, float* target);
+    static void reduceRowScalar(const float* source0, const float* source1, uint32 sourceWidth, uint32 begin,
+                                uint32 targetWidth, float* target);
+
+#if MARENGINE_OCCLUSION_CULLER_X86
+    MARENGINE_TARGET_SSE41 static void rasterizeSpanSSE41(const FTriangleSpan& span, int32_t count, float* row);
+    MARENGINE_TARGET_SSE41 static void reduceRowSSE41(const float* source0, const float* source1,
+                                                      uint32 sourceWidth, uint32 targetWidth, float* target);
+
+    MARENGINE_TARGET_AVX2 static void rasterizeSpanAVX2(const FTriangleSpan& span, int32_t count, float* row);
+    MARENGINE_TARGET_AVX2 static void reduceRowAVX2(const float* source0, const float* source1,
+                                                    uint32 sourceWidth, uint32 targetWidth, float* target);
+#endif
+
+    EOcclusionKernel FOcclusionCuller::s_kernel{ EOcclusionKernel::AVX2 };
+    bool FOcclusionCuller::s_isKernelSelected{ false };
+
+
+    bool FOcclusionCulling::s_isEnabled{ true };
+    uint32 FOcclusionCulling::s_occludersCount{ GraphicLimits::defaultOccludersCount };
+
+    void FOcclusionCulling::setEnabled(bool isEnabled) {
+        s_isEnabled = isEnabled;
+    }
+
+    bool FOcclusionCulling::isEnabled() {
+        return s_isEnabled;
+    }
+
+    void FOcclusionCulling::setOccludersCount(uint32 occludersCount) {
+        s_occludersCount = occludersCount;
+    }
+
+    uint32 FOcclusionCulling::getOccludersCount() {
+        return s_occludersCount;
+    }
+
+
+    void FOcclusionCuller::begin(const maths::mat4& viewProjection) {
+        if(!s_isKernelSelected) {
+            selectKernel();
+        }
+
+        m_viewProjection = viewProjection;
+        if(m_levels.empty()) {
+            uint32 width{ GraphicLimits::occlusionBufferWidth };
+            uint32 height{ GraphicLimits::occlusionBufferHeight };
+            while(true) {
+                m_levels.push_back({ std::vector<float>(width * height), width, height });
+                if(width == 1 && height == 1) {
+                    break;
+                }
+                width = std::max<uint32>(1, (width + 1) / 2);
+                height = std::max<uint32>(1, (height + 1) / 2);
+            }
+        }
+
+        // NDC depth of far plane is 1, so empty buffer does not occlude anything inside of frustum
+        std::fill(m_levels[0].depth.begin(), m_levels[0].depth.end(), 1.f);
+    }
+
+    void FOcclusionCuller::rasterize(const FVertexArray& vertices, const FIndicesArray& indices,
+                                     const maths::mat4& transform) {
+        const float* m{ transform.value_ptr() };
+        const float* vp{ m_viewProjection.value_ptr() };
+        std::vector<maths::vec4> clipVertices;
+        clipVertices.reserve(vertices.size());
+        for(const Vertex& vertex : vertices) {
+            const maths::vec3& p{ vertex.position };
+            const maths::vec4 world{ transformPoint(m, p.x, p.y, p.z, 1.f) };
+            clipVertices.push_back(transformPoint(vp, world.x, world.y, world.z, world.w));
+        }
+
+        for(size_t i = 0; i + 2 < indices.size(); i += 3) {
+            rasterizeTriangle(clipVertices[indices[i]], clipVertices[indices[i + 1]], clipVertices[indices[i + 2]]);
+        }
+    }
+
+    void FOcclusionCuller::rasterizeTriangle(const maths::vec4& clip0, const maths::vec4& clip1,
+                                             const maths::vec4& clip2) {
+        // Triangles crossing near plane are skipped, as they would need clipping. It is conservative, they
+        // just do not occlude anything.
+        if(clip0.w < g_minClipW || clip1.w < g_minClipW || clip2.w < g_minClipW) {
+            return;
+        }
+
+        FDepthLevel& buffer{ m_levels[0] };
+        const auto width{ (float)buffer.width };
+        const auto height{ (float)buffer.height };
+        auto toScreen = [width, height](const maths::vec4& clip) {
+            const float inverseW{ 1.f / clip.w };
+            return maths::vec3((clip.x * inverseW * 0.5f + 0.5f) * width,
+                               (clip.y * inverseW * 0.5f + 0.5f) * height,
+                               clip.z * inverseW);
+        };
+        const maths::vec3 v0{ toScreen(clip0) };
+        maths::vec3 v1{ toScreen(clip1) };
+        maths::vec3 v2{ toScreen(clip2) };
+
+        float area{ (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x) };
+        if(std::abs(area) < 1e-8f) {
+            return;
+        }
+        // Both sides are rasterized, so winding is made counter-clockwise
+        if(area < 0.f) {
+            std::swap(v1, v2);
+            area = -area;
+        }
+
+        const int32 minX{ std::max<int32>(0, (int32)std::floor(std::min({ v0.x, v1.x, v2.x }))) };
+        const int32 maxX{ std::min<int32>((int32)buffer.width - 1, (int32)std::ceil(std::max({ v0.x, v1.x, v2.x }))) };
+        const int32 minY{ std::max<int32>(0, (int32)std::floor(std::min({ v0.y, v1.y, v2.y }))) };
+        const int32 maxY{ std::min<int32>((int32)buffer.height - 1, (int32)std::ceil(std::max({ v0.y, v1.y, v2.y }))) };
+        if(minX > maxX || minY > maxY) {
+            return;
+        }
+
+        // Edge functions e(x, y) = a * x + b * y + c are positive inside, NDC depth is linear at screen space
+        const float a0{ v1.y - v2.y }, b0{ v2.x - v1.x }, c0{ v1.x * v2.y - v1.y * v2.x };
+        const float a1{ v2.y - v0.y }, b1{ v0.x - v2.x }, c1{ v2.x * v0.y - v2.y * v0.x };
+        const float a2{ v0.y - v1.y }, b2{ v1.x - v0.x }, c2{ v0.x * v1.y - v0.y * v1.x };
+        const float inverseArea{ 1.f / area };
+        const float depthX{ (a0 * v0.z + a1 * v1.z + a2 * v2.z) * inverseArea };
+        const float depthY{ (b0 * v0.z + b1 * v1.z + b2 * v2.z) * inverseArea };
+        const float depthC{ (c0 * v0.z + c1 * v1.z + c2 * v2.z) * inverseArea };
+
+        for(int32 y = minY; y <= maxY; y++) {
+            const float py{ (float)y + 0.5f };
+            const float px{ (float)minX + 0.5f };
+            FTriangleSpan span;
+            span.edge0 = a0 * px + b0 * py + c0;
+            span.edge1 = a1 * px + b1 * py + c1;
+            span.edge2 = a2 * px + b2 * py + c2;
+            span.depth = depthX * px + depthY * py + depthC;
+            span.stepEdge0 = a0;
+            span.stepEdge1 = a1;
+            span.stepEdge2 = a2;
+            span.stepDepth = depthX;
+
+            float* row{ buffer.depth.data() + (size_t)y * buffer.width + minX };
+            rasterizeSpanWith(s_kernel, span, (int32_t)(maxX - minX + 1), row);
+        }
+    }
+
+    void FOcclusionCuller::buildHierarchy() {
+        for(size_t level = 1; level < m_levels.size(); level++) {
+            const FDepthLevel& source{ m_levels[level - 1] };
+            FDepthLevel& target{ m_levels[level] };
+            for(uint32 y = 0; y < target.height; y++) {
+                const uint32 y0{ std::min(2 * y, source.height - 1) };
+                const uint32 y1{ std::min(2 * y + 1, source.height - 1) };
+                reduceRowWith(s_kernel, source.depth.data() + (size_t)y0 * source.width,
+                              source.depth.data() + (size_t)y1 * source.width, source.width, target.width,
+                              target.depth.data() + (size_t)y * target.width);
+            }
+        }
+    }
+
+    bool FOcclusionCuller::isOccluded(const FMeshBounds& bounds, const maths::mat4& transform) const {
+        const float* m{ transform.value_ptr() };
+        const float* vp{ m_viewProjection.value_ptr() };
+        float minX{ std::numeric_limits<float>::max() };
+        float minY{ std::numeric_limits<float>::max() };
+        float maxX{ std::numeric_limits<float>::lowest() };
+        float maxY{ std::numeric_limits<float>::lowest() };
+        float nearestDepth{ std::numeric_limits<float>::max() };
+        for(uint32 corner = 0; corner < 8; corner++) {
+            const float x{ (corner & 1) ? bounds.boxMax.x : bounds.boxMin.x };
+            const float y{ (corner & 2) ? bounds.boxMax.y : bounds.boxMin.y };
+            const float z{ (corner & 4) ? bounds.boxMax.z : bounds.boxMin.z };
+            const maths::vec4 world{ transformPoint(m, x, y, z, 1.f) };
+            const maths::vec4 clip{ transformPoint(vp, world.x, world.y, world.z, world.w) };
+            if(clip.w < g_minClipW) {
+                return false;
+            }
+            const float inverseW{ 1.f / clip.w };
+            minX = std::min(minX, clip.x * inverseW);
+            maxX = std::max(maxX, clip.x * inverseW);
+            minY = std::min(minY, clip.y * inverseW);
+            maxY = std::max(maxY, clip.y * inverseW);
+            nearestDepth = std::min(nearestDepth, clip.z * inverseW);
+        }
+
+        const FDepthLevel& buffer{ m_levels[0] };
+        auto toPixel = [](float ndc, uint32 size) {
+            return (int32)std::floor((ndc * 0.5f + 0.5f) * (float)size);
+        };
+        int32 pixelMinX{ std::max<int32>(0, toPixel(minX, buffer.width)) };
+        int32 pixelMaxX{ std::min<int32>((int32)buffer.width - 1, toPixel(maxX, buffer.width)) };
+        int32 pixelMinY{ std::max<int32>(0, toPixel(minY, buffer.height)) };
+        int32 pixelMaxY{ std::min<int32>((int32)buffer.height - 1, toPixel(maxY, buffer.height)) };
+        if(pixelMinX > pixelMaxX || pixelMinY > pixelMaxY) {
+            return false;
+        }
+
+        // Level is chosen so that bounds cover at most few texels, each keeps the farthest depth below it
+        size_t level{ 0 };
+        while(level + 1 < m_levels.size() && std::max(pixelMaxX - pixelMinX, pixelMaxY - pixelMinY) > 2) {
+            pixelMinX /= 2;
+            pixelMaxX /= 2;
+            pixelMinY /= 2;
+            pixelMaxY /= 2;
+            level++;
+        }
+
+        const FDepthLevel& hierarchy{ m_levels[level] };
+        for(int32 y = pixelMinY; y <= pixelMaxY; y++) {
+            for(int32 x = pixelMinX; x <= pixelMaxX; x++) {
+                if(nearestDepth <= hierarchy.depth[(size_t)y * hierarchy.width + x]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    uint32 FOcclusionCuller::getWidth() const {
+        return m_levels.empty() ? 0 : m_levels[0].width;
+    }
+
+    uint32 FOcclusionCuller::getHeight() const {
+        return m_levels.empty() ? 0 : m_levels[0].height;
+    }
+
+    const std::vector<float>& FOcclusionCuller::getDepth() const {
+        return m_levels.at(0).depth;
+    }
+
+    void FOcclusionCuller::passKernel(EOcclusionKernel kernel) {
+        s_kernel = kernel;
+        s_isKernelSelected = false;
+    }
+
+    EOcclusionKernel FOcclusionCuller::getKernel() {
+        if(!s_isKernelSelected) {
+            selectKernel();
+        }
+
+        return s_kernel;
+    }
+
+    const char* FOcclusionCuller::getKernelName(EOcclusionKernel kernel) {
+        switch(kernel) {
+        case EOcclusionKernel::AVX2: return "AVX2";
+        case EOcclusionKernel::SSE41: return "SSE4.1";
+        default: return "Scalar";
+        }
+    }
+
+    void FOcclusionCuller::selectKernel() {
+        // Starting from requested kernel, falls back to narrower ones until supported and correct one is found
+        constexpr std::array<EOcclusionKernel, 2> vectorKernels{ EOcclusionKernel::AVX2, EOcclusionKernel::SSE41 };
+        const EOcclusionKernel requestedKernel{ s_kernel };
+        s_kernel = EOcclusionKernel::SCALAR;
+        s_isKernelSelected = true;
+
+        for(const EOcclusionKernel kernel : vectorKernels) {
+            if(kernel > requestedKernel || !isKernelSupported(kernel)) {
+                continue;
+            }
+
+            if(isKernelMatchingScalar(kernel)) {
+                s_kernel = kernel;
+                break;
+            }
+
+            MARLOG_WARN(ELoggerType::GRAPHICS, "{} occlusion culling kernel does not match scalar one!",
+                        getKernelName(kernel));
+        }
+
+        MARLOG_INFO(ELoggerType::GRAPHICS, "Selected {} occlusion culling kernel", getKernelName(s_kernel));
+    }
+
+    maths::vec4 transformPoint(const float* m, float x, float y, float z, float w) {
+        return maths::vec4(m[0] * x + m[4] * y + m[8] * z + m[12] * w,
+                           m[1] * x + m[5] * y + m[9] * z + m[13] * w,
+                           m[2] * x + m[6] * y + m[10] * z + m[14] * w,
+                           m[3] * x + m[7] * y + m[11] * z + m[15] * w);
+    }
+
+    bool isKernelSupported(EOcclusionKernel kernel) {
+#if MARENGINE_OCCLUSION_CULLER_X86
+    #if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        const int maxLeaf{ info[0] };
+        __cpuid(info, 1);
+        const bool hasSSE41{ (info[2] & (1 << 19)) != 0 };
+        // AVX registers are usable only if OS saves them at context switch (OSXSAVE + XCR0)
+        const bool isAVXEnabled{ (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 &&
+                                 (_xgetbv(0) & 0x6) == 0x6 };
+        bool hasAVX2{ false };
+        if(maxLeaf >= 7 && isAVXEnabled) {
+            __cpuidex(info, 7, 0);
+            hasAVX2 = (info[1] & (1 << 5)) != 0;
+        }
+    #else
+        __builtin_cpu_init();
+        const bool hasSSE41{ __builtin_cpu_supports("sse4.1") != 0 };
+        const bool hasAVX2{ __builtin_cpu_supports("avx2") != 0 };
+    #endif
+
+        switch(kernel) {
+        case EOcclusionKernel::AVX2: return hasAVX2;
+        case EOcclusionKernel::SSE41: return hasSSE41;
+        default: return true;
+        }
+#else
+        return kernel == EOcclusionKernel::SCALAR;
+#endif
+    }
+
+    bool isKernelMatchingScalar(EOcclusionKernel kernel) {
+        // Widths cover full AVX2 blocks, scalar tails and odd source rows, whose last texel is clamped. Kernels
+        // do the same float operations in the same order, so results must be exactly equal.
+        constexpr int32_t maxWidth{ 37 };
+        std::vector<float> expected(maxWidth);
+        std::vector<float> computed(maxWidth);
+        for(int32_t count = 1; count <= maxWidth; count++) {
+            const auto value{ (float)count };
+            FTriangleSpan span;
+            span.edge0 = 3.5f - 0.25f * value;
+            span.edge1 = 0.75f * value - 6.f;
+            span.edge2 = 20.f - value;
+            span.depth = 0.1f + 0.01f * value;
+            span.stepEdge0 = 0.5f;
+            span.stepEdge1 = -0.375f;
+            span.stepEdge2 = (count % 2 == 0) ? -1.5f : 0.125f;
+            span.stepDepth = 0.003f * value - 0.05f;
+            for(int32_t x = 0; x < maxWidth; x++) {
+                expected[x] = computed[x] = (x % 3 == 0) ? 1.f : 0.2f + 0.02f * (float)x;
+            }
+
+            rasterizeSpanScalar(span, 0, count, expected.data());
+            rasterizeSpanWith(kernel, span, count, computed.data());
+            if(expected != computed) {
+                return false;
+            }
+        }
+
+        std::vector<float> source0(maxWidth);
+        std::vector<float> source1(maxWidth);
+        for(int32_t x = 0; x < maxWidth; x++) {
+            source0[x] = (float)((x * 7) % 11) * 0.09f;
+            source1[x] = (float)((x * 5) % 13) * 0.07f;
+        }
+        for(uint32 sourceWidth = 1; sourceWidth <= (uint32)maxWidth; sourceWidth++) {
+            const uint32 targetWidth{ std::max<uint32>(1, (sourceWidth + 1) / 2) };
+            reduceRowScalar(source0.data(), source1.data(), sourceWidth, 0, targetWidth, expected.data());
+            reduceRowWith(kernel, source0.data(), source1.data(), sourceWidth, targetWidth, computed.data());
+            if(!std::equal(expected.cbegin(), expected.cbegin() + targetWidth, computed.cbegin())) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void rasterizeSpanWith(EOcclusionKernel kernel, const FTriangleSpan& span, int32_t count, float* row) {
+#if MARENGINE_OCCLUSION_CULLER_X86
+        switch(kernel) {
+        case EOcclusionKernel::AVX2: rasterizeSpanAVX2(span, count, row); return;
+        case EOcclusionKernel::SSE41: rasterizeSpanSSE41(span, count, row); return;
+        default: break;
+        }
+#endif
+        rasterizeSpanScalar(span, 0, count, row);
+    }
+
+    void rasterizeSpanScalar(const FTriangleSpan& span, int32_t begin, int32_t count, float* row) {
+        // 32-bit counter keeps int to float conversion vectorizable
+        for(int32_t x = begin; x < count; x++) {
+            const auto offset{ (float)x };
+            const float edge0{ span.edge0 + span.stepEdge0 * offset };
+            const float edge1{ span.edge1 + span.stepEdge1 * offset };
+            const float edge2{ span.edge2 + span.stepEdge2 * offset };
+            const float depth{ span.depth + span.stepDepth * offset };
+            // Pixel is covered, when all of edge functions are non-negative (single select, no branches)
+            const float minEdge{ std::min(std::min(edge0, edge1), edge2) };
+            row[x] = std::min(row[x], minEdge >= 0.f ? depth : g_maxDepth);
+        }
+    }
+
+    void reduceRowWith(EOcclusionKernel kernel, const float* source0, const float* source1, uint32 sourceWidth,
+                       uint32 targetWidth, float* target) {
+#if MARENGINE_OCCLUSION_CULLER_X86
+        switch(kernel) {
+        case EOcclusionKernel::AVX2: reduceRowAVX2(source0, source1, sourceWidth, targetWidth, target); return;
+        case EOcclusionKernel::SSE41: reduceRowSSE41(source0, source1, sourceWidth, targetWidth, target); return;
+        default: break;
+        }
+#endif
+        reduceRowScalar(source0, source1, sourceWidth, 0, targetWidth, target);
+    }
+
+    void reduceRowScalar(const float* source0, const float* source1, uint32 sourceWidth, uint32 begin,
+                         uint32 targetWidth, float* target) {
+        for(uint32 x = begin; x < targetWidth; x++) {
+            const uint32 x0{ std::min(2 * x, sourceWidth - 1) };
+            const uint32 x1{ std::min(2 * x + 1, sourceWidth - 1) };
+            target[x] = std::max({ source0[x0], source0[x1], source1[x0], source1[x1] });
+        }
+    }
+
+#if MARENGINE_OCCLUSION_CULLER_X86
+
+    void rasterizeSpanSSE41(const FTriangleSpan& span, int32_t count, float* row) {
+        constexpr int32_t width{ 4 };
+        const __m128 laneOffsets{ _mm_setr_ps(0.f, 1.f, 2.f, 3.f) };
+        const __m128 edge0{ _mm_set1_ps(span.edge0) }, stepEdge0{ _mm_set1_ps(span.stepEdge0) };
+        const __m128 edge1{ _mm_set1_ps(span.edge1) }, stepEdge1{ _mm_set1_ps(span.stepEdge1) };
+        const __m128 edge2{ _mm_set1_ps(span.edge2) }, stepEdge2{ _mm_set1_ps(span.stepEdge2) };
+        const __m128 depth{ _mm_set1_ps(span.depth) }, stepDepth{ _mm_set1_ps(span.stepDepth) };
+        const __m128 zero{ _mm_setzero_ps() };
+        const __m128 maxDepth{ _mm_set1_ps(g_maxDepth) };
+
+        int32_t x{ 0 };
+        for(; x + width <= count; x += width) {
+            // Separate multiply and add (no FMA), so that every lane is rounded as scalar kernel
+            const __m128 offset{ _mm_add_ps(_mm_set1_ps((float)x), laneOffsets) };
+            const __m128 pixelEdge0{ _mm_add_ps(edge0, _mm_mul_ps(stepEdge0, offset)) };
+            const __m128 pixelEdge1{ _mm_add_ps(edge1, _mm_mul_ps(stepEdge1, offset)) };
+            const __m128 pixelEdge2{ _mm_add_ps(edge2, _mm_mul_ps(stepEdge2, offset)) };
+            const __m128 pixelDepth{ _mm_add_ps(depth, _mm_mul_ps(stepDepth, offset)) };
+            const __m128 minEdge{ _mm_min_ps(_mm_min_ps(pixelEdge0, pixelEdge1), pixelEdge2) };
+            const __m128 covered{ _mm_cmpge_ps(minEdge, zero) };
+            const __m128 written{ _mm_blendv_ps(maxDepth, pixelDepth, covered) };
+            _mm_storeu_ps(row + x, _mm_min_ps(written, _mm_loadu_ps(row + x)));
+        }
+
+        rasterizeSpanScalar(span, x, count, row);
+    }
+
+    void reduceRowSSE41(const float* source0, const float* source1, uint32 sourceWidth, uint32 targetWidth,
+                        float* target) {
+        // Blocks read 8 source texels without clamping, so they stop before last (possibly odd) source texel
+        constexpr uint32 width{ 4 };
+        const uint32 blocksEnd{ std::min(targetWidth, sourceWidth / 2) };
+        uint32 x{ 0 };
+        for(; x + width <= blocksEnd; x += width) {
+            const __m128 low{ _mm_max_ps(_mm_loadu_ps(source0 + 2 * x), _mm_loadu_ps(source1 + 2 * x)) };
+            const __m128 high{ _mm_max_ps(_mm_loadu_ps(source0 + 2 * x + 4), _mm_loadu_ps(source1 + 2 * x + 4)) };
+            const __m128 even{ _mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0)) };
+            const __m128 odd{ _mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1)) };
+            _mm_storeu_ps(target + x, _mm_max_ps(even, odd));
+        }
+
+        reduceRowScalar(source0, source1, sourceWidth, x, targetWidth, target);
+    }
+
+    void rasterizeSpanAVX2(const FTriangleSpan& span, int32_t count, float* row) {
+        constexpr int32_t width{ 8 };
+        const __m256 laneOffsets{ _mm256_setr_ps(0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f) };
+        const __m256 edge0{ _mm256_set1_ps(span.edge0) }, stepEdge0{ _mm256_set1_ps(span.stepEdge0) };
+        const __m256 edge1{ _mm256_set1_ps(span.edge1) }, stepEdge1{ _mm256_set1_ps(span.stepEdge1) };
+        const __m256 edge2{ _mm256_set1_ps(span.edge2) }, stepEdge2{ _mm256_set1_ps(span.stepEdge2) };
+        const __m256 depth{ _mm256_set1_ps(span.depth) }, stepDepth{ _mm256_set1_ps(span.stepDepth) };
+        const __m256 zero{ _mm256_setzero_ps() };
+        const __m256 maxDepth{ _mm256_set1_ps(g_maxDepth) };
+
+        int32_t x{ 0 };
+        for(; x + width <= count; x += width) {
+            const __m256 offset{ _mm256_add_ps(_mm256_set1_ps((float)x), laneOffsets) };
+            const __m256 pixelEdge0{ _mm256_add_ps(edge0, _mm256_mul_ps(stepEdge0, offset)) };
+            const __m256 pixelEdge1{ _mm256_add_ps(edge1, _mm256_mul_ps(stepEdge1, offset)) };
+            const __m256 pixelEdge2{ _mm256_add_ps(edge2, _mm256_mul_ps(stepEdge2, offset)) };
+            const __m256 pixelDepth{ _mm256_add_ps(depth, _mm256_mul_ps(stepDepth, offset)) };
+            const __m256 minEdge{ _mm256_min_ps(_mm256_min_ps(pixelEdge0, pixelEdge1), pixelEdge2) };
+            const __m256 covered{ _mm256_cmp_ps(minEdge, zero, _CMP_GE_OQ) };
+            const __m256 written{ _mm256_blendv_ps(maxDepth, pixelDepth, covered) };
+            _mm256_storeu_ps(row + x, _mm256_min_ps(written, _mm256_loadu_ps(row + x)));
+        }
+
+        rasterizeSpanScalar(span, x, count, row);
+    }
+
+    void reduceRowAVX2(const float* source0, const float* source1, uint32 sourceWidth, uint32 targetWidth,
+                       float* target) {
+        constexpr uint32 width{ 8 };
+        const uint32 blocksEnd{ std::min(targetWidth, sourceWidth / 2) };
+        uint32 x{ 0 };
+        for(; x + width <= blocksEnd; x += width) {
+            const __m256 low{ _mm256_max_ps(_mm256_loadu_ps(source0 + 2 * x), _mm256_loadu_ps(source1 + 2 * x)) };
+            const __m256 high{ _mm256_max_ps(_mm256_loadu_ps(source0 + 2 * x + 8),
+                                             _mm256_loadu_ps(source1 + 2 * x + 8)) };
+            // Shuffle works within 128-bit lanes, permute puts 64-bit pairs back to texel order
+            const __m256 even{ _mm256_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0)) };
+            const __m256 odd{ _mm256_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1)) };
+            const __m256 reduced{ _mm256_max_ps(even, odd) };
+            _mm256_storeu_ps(target + x, _mm256_castpd_ps(
+                _mm256_permute4x64_pd(_mm256_castps_pd(reduced), _MM_SHUFFLE(3, 1, 2, 0))));
+        }
+
+        reduceRowScalar(source0, source1, sourceWidth, x, targetWidth, target);
+    }
+
+#endif
+
+
+}
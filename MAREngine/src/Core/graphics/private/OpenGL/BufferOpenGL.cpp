@@ -21,6 +21,7 @@
 
 
 #include "BufferOpenGL.h"
+#include "StateCacheOpenGL.h"
 #include "../../../../Logging/Logger.h"
 
 
@@ -29,18 +30,18 @@ namespace marengine {
 
     template<GLenum TBufferType>
     static void bindGL(uint32 id) {
-        GL_FUNC( glBindBuffer(TBufferType, id) );
+        FStateCacheOpenGL::bindBuffer(TBufferType, id);
     }
 
     template<GLenum TBufferType>
     static void unbindGL() {
-        GL_FUNC( glBindBuffer(TBufferType, 0) );
+        FStateCacheOpenGL::bindBuffer(TBufferType, 0);
     }
 
     template<GLenum TBufferType>
     static void createGL(uint32& id, int64 memoryToAllocate) {
         GL_FUNC( glGenBuffers(1, &id) );
-        GL_FUNC( glBindBuffer(TBufferType, id) );
+        FStateCacheOpenGL::bindBuffer(TBufferType, id);
         GL_FUNC( glBufferData(TBufferType, (long)memoryToAllocate, nullptr, GL_DYNAMIC_DRAW) );
     }
 
@@ -52,6 +53,7 @@ namespace marengine {
 
     static void closeGL(uint32& id) {
         GL_FUNC( glDeleteBuffers(1, &id) );
+        FStateCacheOpenGL::onBufferDeleted(id);
     }
 
     template<GLenum TBufferType, typename TDataType>
@@ -145,48 +147,197 @@ namespace marengine {
         updateGL<m_glBufferType>(data, offset, sizeOfData);
     }
 
+    void FIndexBufferOpenGL::update(const uint16_t* data, uint32 offset, uint32 sizeOfData) const {
+        bind();
+        updateGL<m_glBufferType>(data, offset, sizeOfData);
+    }
+
+
+    void FIndirectBufferOpenGL::create(int64 memoryToAllocate) {
+        p_allocatedMemory = memoryToAllocate;
+        createGL<m_glBufferType>(m_id, p_allocatedMemory);
+    }
+
+    void FIndirectBufferOpenGL::free() {
+        freeGL<m_glBufferType>(m_id);
+    }
+
+    void FIndirectBufferOpenGL::destroy() {
+        closeGL(m_id);
+    }
+
+    void FIndirectBufferOpenGL::bind() const {
+        bindGL<m_glBufferType>(m_id);
+    }
+
+    void FIndirectBufferOpenGL::update(const FDrawIndirectCommandsArray& commands) const {
+        bind();
+        updateGL<m_glBufferType>(commands.data(), 0, commands.size() * sizeof(commands[0]));
+    }
+
+    void FIndirectBufferOpenGL::update(const float* data, uint32 offset, uint32 sizeOfData) const {
+        bind();
+        updateGL<m_glBufferType>(data, offset, sizeOfData);
+    }
+
+    void FIndirectBufferOpenGL::update(const uint32* data, uint32 offset, uint32 sizeOfData) const {
+        bind();
+        updateGL<m_glBufferType>(data, offset, sizeOfData);
+    }
+
+    void FIndirectBufferOpenGL::update(const int32* data, uint32 offset, uint32 sizeOfData) const {
+        bind();
+        updateGL<m_glBufferType>(data, offset, sizeOfData);
+    }
+
 
     void FShaderStorageBufferOpenGL::create() {
         const int64 memoryUsed{ getMemoryUsed(p_inputDescription) };
+        if(p_inputDescription.usage == EBufferUsage::PER_FRAME) {
+            createPersistent(memoryUsed);
+            return;
+        }
+
         createGL<m_glBufferType>(m_id, memoryUsed);
-        GL_FUNC( glBindBufferBase(m_glBufferType, p_inputDescription.binding, m_id) );
+        FStateCacheOpenGL::bindBufferBase(m_glBufferType, p_inputDescription.binding, m_id);
     }
 
     void FShaderStorageBufferOpenGL::free() {
-        freeGL<m_glBufferType>(m_id);
+        // Immutable storage cannot be respecified, its memory is released with destroy()
+        if(!isPersistent()) {
+            freeGL<m_glBufferType>(m_id);
+        }
     }
 
     void FShaderStorageBufferOpenGL::destroy() {
+        // Deleting buffer unmaps it implicitly
         closeGL(m_id);
+        m_pMapped = nullptr;
     }
 
     void FShaderStorageBufferOpenGL::bind() const {
+        if(isPersistent()) {
+            FStateCacheOpenGL::bindBufferRange(m_glBufferType, p_inputDescription.binding, m_id,
+                                               m_region * m_regionSize, m_regionSize);
+            return;
+        }
+
         bindGL<m_glBufferType>(m_id);
     }
 
     void FShaderStorageBufferOpenGL::update(const float* data, uint32 offset,
                                             uint32 sizeOfData) const {
+        if(isPersistent()) {
+            updatePersistent(data, offset, sizeOfData);
+            return;
+        }
+
         bind();
         updateGL<m_glBufferType>(data, offset, sizeOfData);
     }
 
     void FShaderStorageBufferOpenGL::update(const uint32* data, uint32 offset,
                                             uint32 sizeOfData) const {
+        if(isPersistent()) {
+            updatePersistent(data, offset, sizeOfData);
+            return;
+        }
+
         bind();
         updateGL<m_glBufferType>(data, offset, sizeOfData);
     }
 
     void FShaderStorageBufferOpenGL::update(const int32* data, uint32 offset,
                                             uint32 sizeOfData) const {
+        if(isPersistent()) {
+            updatePersistent(data, offset, sizeOfData);
+            return;
+        }
+
         bind();
         updateGL<m_glBufferType>(data, offset, sizeOfData);
     }
 
+    bool FShaderStorageBufferOpenGL::isPersistent() const {
+        return m_pMapped != nullptr;
+    }
+
+    void FShaderStorageBufferOpenGL::moveToRegion(uint32 region) {
+        if(!isPersistent()) {
+            m_region = region;
+            return;
+        }
+        if(region == m_region) {
+            return;
+        }
+
+        // Callers update only changed ranges of buffer, so the region must catch up with all of them. They are
+        // copied from CPU copy, as reading mapped memory (uncached at most drivers) is very slow.
+        uint8* pRegion{ m_pMapped + region * m_regionSize };
+        if(m_staleBytes[region] >= m_regionSize) {
+            std::memcpy(pRegion, m_shadow.data(), m_regionSize);
+        }
+        else {
+            for(const FStaleRange& range : m_staleRanges[region]) {
+                std::memcpy(pRegion + range.offset, m_shadow.data() + range.offset, range.size);
+            }
+        }
+        m_staleRanges[region].clear();
+        m_staleBytes[region] = 0;
+        m_region = region;
+    }
+
+    void FShaderStorageBufferOpenGL::createPersistent(int64 memoryUsed) {
+        int32 offsetAlignment{ 0 };
+        GL_FUNC( glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment) );
+        const int64 alignment{ std::max<int64>(offsetAlignment, 1) };
+        m_regionSize = ((memoryUsed + alignment - 1) / alignment) * alignment;
+
+        constexpr GLbitfield mapFlags{ GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT };
+        const int64 memoryToAllocate{ m_regionSize * s_regionsCount };
+        GL_FUNC( glGenBuffers(1, &m_id) );
+        FStateCacheOpenGL::bindBuffer(m_glBufferType, m_id);
+        GL_FUNC( glBufferStorage(m_glBufferType, memoryToAllocate, nullptr, mapFlags) );
+        m_pMapped = (uint8*)glMapBufferRange(m_glBufferType, 0, memoryToAllocate, mapFlags);
+        if(m_pMapped == nullptr) {
+            MARLOG_ERR(ELoggerType::GRAPHICS, "Could not map PER_FRAME SSBO at binding {}",
+                       p_inputDescription.binding);
+            return;
+        }
+
+        std::memset(m_pMapped, 0, memoryToAllocate);
+        m_shadow.assign(m_regionSize, 0);
+        for(uint32 region = 0; region < s_regionsCount; region++) {
+            m_staleRanges[region].clear();
+            m_staleBytes[region] = 0;
+        }
+        bind();
+    }
+
+    void FShaderStorageBufferOpenGL::updatePersistent(const void* data, uint32 offset, uint32 sizeOfData) const {
+        std::memcpy(m_shadow.data() + offset, data, sizeOfData);
+        std::memcpy(m_pMapped + m_region * m_regionSize + offset, data, sizeOfData);
+
+        for(uint32 region = 0; region < s_regionsCount; region++) {
+            // Region, which will be copied whole anyway, does not need to remember ranges
+            if(region == m_region || m_staleBytes[region] >= m_regionSize) {
+                continue;
+            }
+            m_staleBytes[region] += sizeOfData;
+            if(m_staleBytes[region] >= m_regionSize) {
+                m_staleRanges[region].clear();
+            }
+            else {
+                m_staleRanges[region].push_back({ offset, sizeOfData });
+            }
+        }
+    }
+
 
     void FUniformBufferOpenGL::create() {
         const int64_t memoryUsed{ getMemoryUsed(p_inputDescription) };
         createGL<m_glBufferType>(m_id, memoryUsed);
-        GL_FUNC( glBindBufferBase(m_glBufferType, p_inputDescription.binding, m_id) );
+        FStateCacheOpenGL::bindBufferBase(m_glBufferType, p_inputDescription.binding, m_id);
     }
 
     void FUniformBufferOpenGL::free() {
@@ -229,6 +380,41 @@ namespace marengine {
     uint32 FBufferStorageOpenGL::getCountIBO() const {
         return m_ibos.size();
     }
+    uint32 FBufferStorageOpenGL::getCountIndirect() const {
+        return m_indirects.size();
+    }
+
+    void FBufferStorageOpenGL::endFrame() {
+        GLsync& drawnRegionFence{ m_regionFences.at(m_region) };
+        if(drawnRegionFence != nullptr) {
+            GL_FUNC( glDeleteSync(drawnRegionFence) );
+        }
+        drawnRegionFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+        m_region = (m_region + 1) % FShaderStorageBufferOpenGL::s_regionsCount;
+        GLsync& nextRegionFence{ m_regionFences.at(m_region) };
+        if(nextRegionFence != nullptr) {
+            // Usually region was drawn two frames ago and its fence is already signaled. Wait is bounded, so that
+            // lost context or hung driver does not freeze the engine, region is reused anyway after it.
+            constexpr GLuint64 maxWaitNanoseconds{ 1000000000 };
+            const GLenum waitResult{
+                glClientWaitSync(nextRegionFence, GL_SYNC_FLUSH_COMMANDS_BIT, maxWaitNanoseconds) };
+            if(waitResult == GL_TIMEOUT_EXPIRED) {
+                MARLOG_WARN(ELoggerType::GRAPHICS, "GPU still reads PER_FRAME region {} after {} ns, overwriting it",
+                            m_region, maxWaitNanoseconds);
+            }
+            else if(waitResult == GL_WAIT_FAILED) {
+                MARLOG_ERR(ELoggerType::GRAPHICS, "Waiting for fence of PER_FRAME region {} failed", m_region);
+            }
+            // Fence is consumed whatever the result, new one is placed when the region is drawn again
+            GL_FUNC( glDeleteSync(nextRegionFence) );
+            nextRegionFence = nullptr;
+        }
+
+        for(auto& ssbo : m_ssbos) {
+            ssbo.moveToRegion(m_region);
+        }
+    }
 
     FShaderBuffer* FBufferStorageOpenGL::getSSBO(int32 index) const {
         return (FShaderBuffer*)&m_ssbos.at(index);
@@ -242,6 +428,9 @@ namespace marengine {
     FIndexBuffer* FBufferStorageOpenGL::getIBO(int32 index) const {
         return (FIndexBuffer*)&m_ibos.at(index);
     }
+    FIndirectBuffer* FBufferStorageOpenGL::getIndirect(int32 index) const {
+        return (FIndirectBuffer*)&m_indirects.at(index);
+    }
 
     template<typename TBufferArray>
     void clearBuffers(TBufferArray& buffers) {
@@ -257,6 +446,19 @@ namespace marengine {
         clearBuffers(m_ubos);
         clearBuffers(m_vbos);
         clearBuffers(m_ibos);
+        clearBuffers(m_indirects);
+        p_vertexArena.reset();
+        p_packedVertexArena.reset();
+        p_indexArena.reset();
+        p_shortIndexArena.reset();
+
+        for(GLsync& fence : m_regionFences) {
+            if(fence != nullptr) {
+                GL_FUNC( glDeleteSync(fence) );
+                fence = nullptr;
+            }
+        }
+        m_region = 0;
     }
 
 
@@ -269,7 +471,10 @@ namespace marengine {
     }
 
     FShaderBuffer* FBufferFactoryOpenGL::emplaceSSBO() {
-        return emplaceBufferAtArray<FShaderBuffer>(m_storage.m_ssbos);
+        auto* pSSBO{ emplaceBufferAtArray<FShaderStorageBufferOpenGL>(m_storage.m_ssbos) };
+        // Buffer emplaced after some endFrame() calls must be created at region of current frame, not the first one
+        pSSBO->moveToRegion(m_storage.m_region);
+        return pSSBO;
     }
     FShaderBuffer* FBufferFactoryOpenGL::emplaceUBO() {
         return emplaceBufferAtArray<FShaderBuffer>(m_storage.m_ubos);
@@ -280,6 +485,9 @@ namespace marengine {
     FIndexBuffer* FBufferFactoryOpenGL::emplaceIBO() {
         return emplaceBufferAtArray<FIndexBuffer>(m_storage.m_ibos);
     }
+    FIndirectBuffer* FBufferFactoryOpenGL::emplaceIndirect() {
+        return emplaceBufferAtArray<FIndirectBuffer>(m_storage.m_indirects);
+    }
 
 
 }
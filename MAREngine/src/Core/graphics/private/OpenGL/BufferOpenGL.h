@@ -63,6 +63,7 @@ namespace marengine {
         void update(const float* data, uint32 offset, uint32 sizeOfData) const final;
         void update(const int32* data, uint32 offset, uint32 sizeOfData) const final;
         void update(const uint32* data, uint32 offset, uint32 sizeOfData) const final;
+        void update(const uint16_t* data, uint32 offset, uint32 sizeOfData) const final;
 
     private:
 
@@ -72,6 +73,27 @@ namespace marengine {
     };
 
 
+    class FIndirectBufferOpenGL : public FIndirectBuffer {
+    public:
+
+        void create(int64 memoryToAllocate) final;
+        void free() final;
+        void destroy() final;
+
+        void bind() const final;
+        void update(const FDrawIndirectCommandsArray& commands) const final;
+        void update(const float* data, uint32 offset, uint32 sizeOfData) const final;
+        void update(const int32* data, uint32 offset, uint32 sizeOfData) const final;
+        void update(const uint32* data, uint32 offset, uint32 sizeOfData) const final;
+
+    private:
+
+        static constexpr GLenum m_glBufferType{ GL_DRAW_INDIRECT_BUFFER };
+        uint32 m_id{ 0 };
+
+    };
+
+
     class FShaderStorageBufferOpenGL : public FShaderBuffer {
     public:
 
@@ -84,11 +106,41 @@ namespace marengine {
         void update(const int32* data, uint32 offset, uint32 sizeOfData) const final;
         void update(const uint32* data, uint32 offset, uint32 sizeOfData) const final;
 
+        MAR_NO_DISCARD bool isPersistent() const;
+        /**
+         * @brief Makes given region current one. Ranges updated since the region was current last time are
+         * copied into it from CPU copy of buffer, mapped memory is only written. Buffer, that is not created
+         * yet, only remembers the region, so that PER_FRAME buffer starts at region of current frame.
+         */
+        void moveToRegion(uint32 region);
+
+        static constexpr uint32 s_regionsCount{ 3 };
+
     private:
 
+        struct FStaleRange {
+            uint32 offset{ 0 };
+            uint32 size{ 0 };
+        };
+
+        void createPersistent(int64 memoryUsed);
+        void updatePersistent(const void* data, uint32 offset, uint32 sizeOfData) const;
+
+
         static constexpr GLenum m_glBufferType{ GL_SHADER_STORAGE_BUFFER };
         uint32 m_id{ 0 };
 
+        /// @brief persistent write-only mapping of all regions, nullptr if buffer is not PER_FRAME one
+        uint8* m_pMapped{ nullptr };
+        /// @brief CPU copy of current content of buffer, regions are brought up to date from it
+        mutable std::vector<uint8> m_shadow;
+        /// @brief ranges updated while other region was current, for every region
+        mutable std::array<std::vector<FStaleRange>, s_regionsCount> m_staleRanges;
+        /// @brief sum of sizes of stale ranges for every region, whole region is copied once it reaches region size
+        mutable std::array<int64, s_regionsCount> m_staleBytes{};
+        int64 m_regionSize{ 0 };
+        uint32 m_region{ 0 };
+
     };
 
 
@@ -122,11 +174,15 @@ namespace marengine {
         MAR_NO_DISCARD uint32 getCountUBO() const final;
         MAR_NO_DISCARD uint32 getCountVBO() const final;
         MAR_NO_DISCARD uint32 getCountIBO() const final;
+        MAR_NO_DISCARD uint32 getCountIndirect() const final;
+
+        void endFrame() final;
 
         MAR_NO_DISCARD FShaderBuffer* getSSBO(int32 index) const final;
         MAR_NO_DISCARD FShaderBuffer* getUBO(int32 index) const final;
         MAR_NO_DISCARD FVertexBuffer* getVBO(int32 index) const final;
         MAR_NO_DISCARD FIndexBuffer* getIBO(int32 index) const final;
+        MAR_NO_DISCARD FIndirectBuffer* getIndirect(int32 index) const final;
 
         void reset() final;
 
@@ -136,6 +192,11 @@ namespace marengine {
         std::vector<FUniformBufferOpenGL> m_ubos;
         std::vector<FVertexBufferOpenGL> m_vbos;
         std::vector<FIndexBufferOpenGL> m_ibos;
+        std::vector<FIndirectBufferOpenGL> m_indirects;
+
+        /// @brief fence for every region of PER_FRAME buffers, signaled when GPU finished reading it
+        std::array<GLsync, FShaderStorageBufferOpenGL::s_regionsCount> m_regionFences{};
+        uint32 m_region{ 0 };
 
     };
 
@@ -150,6 +211,7 @@ namespace marengine {
         MAR_NO_DISCARD FShaderBuffer* emplaceUBO() final;
         MAR_NO_DISCARD FVertexBuffer* emplaceVBO() final;
         MAR_NO_DISCARD FIndexBuffer* emplaceIBO() final;
+        MAR_NO_DISCARD FIndirectBuffer* emplaceIndirect() final;
 
     private:
 
@@ -21,6 +21,7 @@
 
 
 #include "FramebufferOpenGL.h"
+#include "StateCacheOpenGL.h"
 #include "../../../../Logging/Logger.h"
 
 
@@ -29,7 +30,7 @@ namespace marengine {
 
     static void createColorAttachmentGL(uint32& id, const FFramebufferSpecification& specs) {
         GL_FUNC( glGenTextures(1, &id) );
-        GL_FUNC( glBindTexture(GL_TEXTURE_2D, id) );
+        FStateCacheOpenGL::bindTexture(0, GL_TEXTURE_2D, id);
         GL_FUNC( glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB,
                               specs.width, specs.height, 0, GL_RGB, GL_FLOAT, 0) );
         GL_FUNC( glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR) );
@@ -47,7 +48,7 @@ namespace marengine {
     static void createFramebufferGL(uint32& id, uint32 color, uint32 depth,
                                     const FFramebufferSpecification& specs) {
         GL_FUNC( glGenFramebuffers(1, &id) );
-        GL_FUNC( glBindFramebuffer(GL_FRAMEBUFFER, id) );
+        FStateCacheOpenGL::bindFramebuffer(id);
         GL_FUNC( glFramebufferTexture2D(GL_FRAMEBUFFER,
                                         GL_COLOR_ATTACHMENT0,
                                         GL_TEXTURE_2D,
@@ -68,12 +69,14 @@ namespace marengine {
 
     static void destroyFramebufferGL(uint32& id, uint32& color, uint32& depth) {
         GL_FUNC( glDeleteFramebuffers(1, &id) );
+        FStateCacheOpenGL::onFramebufferDeleted(id);
         GL_FUNC( glDeleteTextures(1, &color) );
+        FStateCacheOpenGL::onTextureDeleted(color);
         GL_FUNC( glDeleteTextures(1, &depth) );
     }
 
     static void bindFramebufferGL(uint32 id) {
-        GL_FUNC( glBindFramebuffer(GL_FRAMEBUFFER, id) );
+        FStateCacheOpenGL::bindFramebuffer(id);
     }
 
     static void clearGL(uint32 id, const FFramebufferSpecification& specs) {
@@ -84,7 +87,7 @@ namespace marengine {
     }
 
     static void bindTextureGL(uint32 id) {
-        GL_FUNC( glBindTexture(GL_TEXTURE_2D, id) );
+        FStateCacheOpenGL::bindTexture(0, GL_TEXTURE_2D, id);
     }
 
     static void bindRenderBufferGL(uint32 id) {
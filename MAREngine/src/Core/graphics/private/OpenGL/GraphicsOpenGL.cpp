@@ -43,6 +43,7 @@ namespace marengine {
             if (!isGLAD_OK) {
                 return false;
             }
+            m_materialFactory.m_storage.loadBindlessTextures((GLADloadproc)glfwGetProcAddress);
         }
         else if constexpr (MARENGINE_USE_SDL_WINDOW) {
             MARLOG_TRACE(ELoggerType::PLATFORMS, "Loading SDL into OpenGL...");
@@ -50,6 +51,7 @@ namespace marengine {
             if (!isGLAD_OK) {
                 return false;
             }
+            m_materialFactory.m_storage.loadBindlessTextures((GLADloadproc)SDL_GL_GetProcAddress);
         }
         else {
             return false;
@@ -21,6 +21,7 @@
 
 
 #include "MaterialOpenGL.h"
+#include "StateCacheOpenGL.h"
 #include "../../../../Logging/Logger.h"
 #include "../../../filesystem/public/FileManager.h"
 #include "../../../../ProjectManager.h"
@@ -28,6 +29,14 @@
 
 namespace marengine {
 
+    typedef GLuint64 (APIENTRYP PFNMARGETTEXTUREHANDLEARBPROC)(GLuint texture);
+    typedef void (APIENTRYP PFNMARMAKETEXTUREHANDLERESIDENTARBPROC)(GLuint64 handle);
+    typedef void (APIENTRYP PFNMARMAKETEXTUREHANDLENONRESIDENTARBPROC)(GLuint64 handle);
+
+    static PFNMARGETTEXTUREHANDLEARBPROC marGetTextureHandleARB{ nullptr };
+    static PFNMARMAKETEXTUREHANDLERESIDENTARBPROC marMakeTextureHandleResidentARB{ nullptr };
+    static PFNMARMAKETEXTUREHANDLENONRESIDENTARBPROC marMakeTextureHandleNonResidentARB{ nullptr };
+
     struct FTex2DFormats {
         GLenum internal{ GL_NONE };
         GLenum data{ GL_NONE };
@@ -46,7 +55,8 @@ namespace marengine {
         return formats;
     }
 
-    static void loadTexture2D(uint32& id, const char* path) {
+    static bool loadTexture2D(uint32& id, uint32& outWidth, uint32& outHeight, uint32& outChannels,
+                              const char* path) {
         int32 width, height, bitPerPixel;
         unsigned char* localBuffer;
 
@@ -70,25 +80,85 @@ namespace marengine {
             GL_FUNC ( glTextureParameteri(id, GL_TEXTURE_MAG_FILTER, GL_LINEAR) );
 
             stbi_image_free(localBuffer);
+            outWidth = (uint32)width;
+            outHeight = (uint32)height;
+            outChannels = (uint32)bitPerPixel;
             MARLOG_INFO(ELoggerType::PLATFORMS, "Loaded Texture2D -> {}", path);
-            return;
+            return true;
         }
 
         MARLOG_ERR(ELoggerType::PLATFORMS, "Could not load texture2D -> {}", path);
+        return false;
     }
 
+    static bool isExtensionSupported(const char* extension);
+
 
     void FMaterialTex2DOpenGL::destroy() {
+        if(p_placement.handle != 0 && marMakeTextureHandleNonResidentARB) {
+            marMakeTextureHandleNonResidentARB(p_placement.handle);
+            p_placement.handle = 0;
+        }
         GL_FUNC( glDeleteTextures(1, &m_id) );
+        FStateCacheOpenGL::onTextureDeleted(m_id);
     }
 
     void FMaterialTex2DOpenGL::bind() const {
-        GL_FUNC( glActiveTexture(GL_TEXTURE0 + p_info.sampler) );
-        GL_FUNC( glBindTexture(GL_TEXTURE_2D, m_id) );
+        FStateCacheOpenGL::bindTexture(p_info.sampler, GL_TEXTURE_2D, m_id);
     }
 
     void FMaterialTex2DOpenGL::load() {
-        loadTexture2D(m_id, p_info.path.c_str());
+        loadTexture2D(m_id, m_width, m_height, m_channels, p_info.path.c_str());
+    }
+
+    uint32 FMaterialTex2DOpenGL::getID() const {
+        return m_id;
+    }
+
+
+    void FMaterialTex2DArrayOpenGL::create() {
+        destroy();
+
+        const FTex2DFormats formats{ getFormats((int32)p_channels) };
+        const auto layersCount{ (GLsizei)p_layersCount };
+
+        GL_FUNC( glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &m_id) );
+        GL_FUNC( glTextureStorage3D(m_id, 1, formats.internal, p_width, p_height, layersCount) );
+
+        for(const FTex2DArrayRegion& region : p_regions) {
+            const auto* pTexture{ (FMaterialTex2DOpenGL*)m_pStorage->getTex2D(region.textureIndex) };
+            GL_FUNC( glCopyImageSubData(pTexture->getID(), GL_TEXTURE_2D, 0, 0, 0, 0,
+                                        m_id, GL_TEXTURE_2D_ARRAY, 0, region.x, region.y, region.layer,
+                                        region.width, region.height, 1) );
+        }
+
+        GL_FUNC ( glTextureParameteri(m_id, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE) );
+        GL_FUNC ( glTextureParameteri(m_id, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE) );
+
+        GL_FUNC ( glTextureParameteri(m_id, GL_TEXTURE_MIN_FILTER, GL_LINEAR) );
+        GL_FUNC ( glTextureParameteri(m_id, GL_TEXTURE_MAG_FILTER, GL_LINEAR) );
+
+        p_dirty = false;
+        if(p_isAtlas) {
+            MARLOG_INFO(ELoggerType::PLATFORMS, "Created Texture2DAtlas {}x{}, {} textures at {} pages, occupancy {}%",
+                        p_width, p_height, p_regions.size(), layersCount, getOccupancy() * 100.f);
+        }
+        else {
+            MARLOG_DEBUG(ELoggerType::PLATFORMS, "Created Texture2DArray {}x{} with {} layers", p_width, p_height,
+                         layersCount);
+        }
+    }
+
+    void FMaterialTex2DArrayOpenGL::destroy() {
+        if(m_id != 0) {
+            GL_FUNC( glDeleteTextures(1, &m_id) );
+            FStateCacheOpenGL::onTextureDeleted(m_id);
+            m_id = 0;
+        }
+    }
+
+    void FMaterialTex2DArrayOpenGL::bind(uint32 unit) const {
+        FStateCacheOpenGL::bindTexture(unit, GL_TEXTURE_2D_ARRAY, m_id);
     }
 
 
@@ -100,6 +170,91 @@ namespace marengine {
         return m_textures2D.size();
     }
 
+    FMaterialTex2DArray* FMaterialStorageOpenGL::getTex2DArray(int32 index) const {
+        return (FMaterialTex2DArray*)&m_textures2DArrays.at(index);
+    }
+
+    uint32 FMaterialStorageOpenGL::getCountTex2DArray() const {
+        return m_textures2DArrays.size();
+    }
+
+    bool FMaterialStorageOpenGL::isBindless() const {
+        return m_bindless;
+    }
+
+    void FMaterialStorageOpenGL::prepareTex2DArrays() {
+        for(auto& textureArray : m_textures2DArrays) {
+            if(textureArray.isDirty()) {
+                textureArray.create();
+            }
+        }
+    }
+
+    void FMaterialStorageOpenGL::loadBindlessTextures(GLADloadproc loadProc) {
+        m_bindless = false;
+        if(!isExtensionSupported("GL_ARB_bindless_texture")) {
+            MARLOG_INFO(ELoggerType::PLATFORMS, "GL_ARB_bindless_texture not supported, using texture arrays");
+            return;
+        }
+
+        marGetTextureHandleARB = (PFNMARGETTEXTUREHANDLEARBPROC)loadProc("glGetTextureHandleARB");
+        marMakeTextureHandleResidentARB =
+                (PFNMARMAKETEXTUREHANDLERESIDENTARBPROC)loadProc("glMakeTextureHandleResidentARB");
+        marMakeTextureHandleNonResidentARB =
+                (PFNMARMAKETEXTUREHANDLENONRESIDENTARBPROC)loadProc("glMakeTextureHandleNonResidentARB");
+
+        m_bindless = marGetTextureHandleARB && marMakeTextureHandleResidentARB && marMakeTextureHandleNonResidentARB;
+        MARLOG_INFO(ELoggerType::PLATFORMS, "Bindless textures enabled: {}", m_bindless);
+    }
+
+    void FMaterialStorageOpenGL::placeTex2D(FMaterialTex2DOpenGL* pTexture) {
+        FTex2DPlacement& placement{ pTexture->p_placement };
+        if(m_bindless) {
+            placement.handle = marGetTextureHandleARB(pTexture->m_id);
+            marMakeTextureHandleResidentARB(placement.handle);
+            return;
+        }
+
+        const bool isAtlased{ pTexture->m_width <= GraphicLimits::atlasMaxTextureSize &&
+                              pTexture->m_height <= GraphicLimits::atlasMaxTextureSize };
+        if(isAtlased) {
+            auto isMatchingAtlas = [pTexture](const FMaterialTex2DArrayOpenGL& textureArray)->bool {
+                return textureArray.isMatchingAtlas(pTexture->m_channels);
+            };
+            auto it = std::find_if(m_textures2DArrays.begin(), m_textures2DArrays.end(), isMatchingAtlas);
+            if(it == m_textures2DArrays.end()) {
+                FMaterialTex2DArrayOpenGL* pAtlas{ emplaceTex2DArray() };
+                pAtlas->passAtlasFormat(GraphicLimits::atlasPageSize, pTexture->m_channels);
+                it = m_textures2DArrays.end() - 1;
+            }
+
+            if(it->pushToAtlas(pTexture->getIndex(), pTexture->m_width, pTexture->m_height, placement)) {
+                placement.arrayIndex = it->getIndex();
+                return;
+            }
+        }
+
+        auto isMatching = [pTexture](const FMaterialTex2DArrayOpenGL& textureArray)->bool {
+            return textureArray.isMatching(pTexture->m_width, pTexture->m_height, pTexture->m_channels);
+        };
+        auto it = std::find_if(m_textures2DArrays.begin(), m_textures2DArrays.end(), isMatching);
+        if(it == m_textures2DArrays.end()) {
+            FMaterialTex2DArrayOpenGL* pTextureArray{ emplaceTex2DArray() };
+            pTextureArray->passFormat(pTexture->m_width, pTexture->m_height, pTexture->m_channels);
+            it = m_textures2DArrays.end() - 1;
+        }
+
+        placement.arrayIndex = it->getIndex();
+        placement.layer = it->pushLayer(pTexture->getIndex());
+    }
+
+    FMaterialTex2DArrayOpenGL* FMaterialStorageOpenGL::emplaceTex2DArray() {
+        auto& textureArray{ m_textures2DArrays.emplace_back() };
+        textureArray.setIndex((int32)m_textures2DArrays.size() - 1);
+        textureArray.m_pStorage = this;
+        return &textureArray;
+    }
+
     const FMaterialProxy* FMaterialStorageOpenGL::retrieve(const CRenderable& cRenderable) const {
         // TODO: implement FMaterialStorageOpenGL::retrieve
         return nullptr;
@@ -123,6 +278,10 @@ namespace marengine {
     }
 
     void FMaterialStorageOpenGL::reset() {
+        for(auto& textureArray : m_textures2DArrays) {
+            textureArray.destroy();
+        }
+        m_textures2DArrays.clear();
         for(auto& texture : m_textures2D) {
             texture.destroy();
         }
@@ -142,6 +301,9 @@ namespace marengine {
         auto* variable = emplaceBufferAtArray<FMaterialTex2DOpenGL>(m_storage.m_textures2D);
         variable->p_info.path = FFileManager::joinPaths(FProjectManager::getProject().getAssetsPath(), path);
         variable->load();
+        if(variable->m_id != 0) {
+            m_storage.placeTex2D(variable);
+        }
         return variable;
     }
 
@@ -150,4 +312,17 @@ namespace marengine {
     }
 
 
+    bool isExtensionSupported(const char* extension) {
+        GLint extensionsCount{ 0 };
+        glGetIntegerv(GL_NUM_EXTENSIONS, &extensionsCount);
+        for(GLint i = 0; i < extensionsCount; i++) {
+            const auto* name{ (const char*)glGetStringi(GL_EXTENSIONS, i) };
+            if(name && std::strcmp(name, extension) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+
 }
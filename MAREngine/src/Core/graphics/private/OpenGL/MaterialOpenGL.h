@@ -33,8 +33,12 @@ namespace marengine {
     class FMaterialFactoryOpenGL;
 
 
+    class FMaterialStorageOpenGL;
+
+
     class FMaterialTex2DOpenGL : public FMaterialTex2D {
         friend class FMaterialFactoryOpenGL;
+        friend class FMaterialStorageOpenGL;
     public:
 
         void destroy() final;
@@ -42,8 +46,29 @@ namespace marengine {
         void bind() const final;
         void load() final;
 
+        MAR_NO_DISCARD uint32 getID() const;
+
+    private:
+
+        uint32 m_id{ 0 };
+        uint32 m_width{ 0 };
+        uint32 m_height{ 0 };
+        uint32 m_channels{ 0 };
+
+    };
+
+
+    class FMaterialTex2DArrayOpenGL : public FMaterialTex2DArray {
+        friend class FMaterialStorageOpenGL;
+    public:
+
+        void create() final;
+        void destroy() final;
+        void bind(uint32 unit) const final;
+
     private:
 
+        const FMaterialStorageOpenGL* m_pStorage{ nullptr };
         uint32 m_id{ 0 };
 
     };
@@ -57,6 +82,14 @@ namespace marengine {
 
         MAR_NO_DISCARD FMaterialTex2D* getTex2D(int32 index) const final;
         MAR_NO_DISCARD uint32 getCountTex2D() const final;
+        MAR_NO_DISCARD FMaterialTex2DArray* getTex2DArray(int32 index) const final;
+        MAR_NO_DISCARD uint32 getCountTex2DArray() const final;
+
+        MAR_NO_DISCARD bool isBindless() const final;
+        void prepareTex2DArrays() final;
+
+        /// @brief loads GL_ARB_bindless_texture entry points, textures are grouped into arrays if it fails
+        void loadBindlessTextures(GLADloadproc loadProc);
 
         MAR_NO_DISCARD const FMaterialProxy* retrieve(const CRenderable& cRenderable) const final;
 
@@ -66,7 +99,13 @@ namespace marengine {
 
     private:
 
+        void placeTex2D(FMaterialTex2DOpenGL* pTexture);
+        MAR_NO_DISCARD FMaterialTex2DArrayOpenGL* emplaceTex2DArray();
+
+
         std::vector<FMaterialTex2DOpenGL> m_textures2D;
+        std::vector<FMaterialTex2DArrayOpenGL> m_textures2DArrays;
+        bool m_bindless{ false };
 
     };
 
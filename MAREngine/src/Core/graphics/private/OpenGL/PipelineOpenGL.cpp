@@ -21,6 +21,7 @@
 
 
 #include "PipelineOpenGL.h"
+#include "StateCacheOpenGL.h"
 #include "../../public/Buffer.h"
 #include "../../public/Shaders.h"
 #include "../../public/Material.h"
@@ -33,31 +34,40 @@ namespace marengine {
 
 
     void FPipelineMeshColorOpenGL::create() {
+        // Attributes are sourced from buffer bound during VAO creation, page may be bound by other batch
+        p_pBufferStorage->getVBO(p_vboIndex)->bind();
         createVAO(m_vao, p_pBufferStorage->getVBO(p_vboIndex)->getInputDescription());
     }
 
     void FPipelineMeshColorOpenGL::close() {
         GL_FUNC( glDeleteVertexArrays(1, &m_vao) );
+        FStateCacheOpenGL::onVertexArrayDeleted(m_vao);
+        if(p_shaderIndex != -1) {
+            p_pShadersStorage->release(p_shaderIndex);
+        }
     }
 
     void FPipelineMeshColorOpenGL::bind() const {
-        GL_FUNC( glBindVertexArray(m_vao) );
+        FStateCacheOpenGL::bindVertexArray(m_vao);
         p_pBufferStorage->getVBO(p_vboIndex)->bind();
         p_pBufferStorage->getIBO(p_iboIndex)->bind();
         p_pBufferStorage->getSSBO(p_transformIndex)->bind();
         p_pBufferStorage->getSSBO(p_colorIndex)->bind();
         p_pBufferStorage->getSSBO(p_camIndex)->bind();
         p_pBufferStorage->getSSBO(p_pointLightIndex)->bind();
+        if(isIndirect()) {
+            p_pBufferStorage->getIndirect(p_indirectIndex)->bind();
+        }
         p_pShadersStorage->get(p_shaderIndex)->bind();
     }
 
 
-    void FPipelineMeshTex2DOpenGL::create() {
-        createVAO(m_vao, p_pBufferStorage->getVBO(p_vboIndex)->getInputDescription());
-    }
-
     void FPipelineMeshTex2DOpenGL::close() {
         GL_FUNC( glDeleteVertexArrays(1, &m_vao) );
+        FStateCacheOpenGL::onVertexArrayDeleted(m_vao);
+        if(p_shaderIndex != -1) {
+            p_pShadersStorage->release(p_shaderIndex);
+        }
     }
 
     template<typename TSamplerArray>
@@ -75,18 +85,30 @@ namespace marengine {
         GL_FUNC( glUniform1i(getUniformLocation(samplerArray, name), sampler) );
     }
 
+    void FPipelineMeshTex2DOpenGL::create() {
+        // Attributes are sourced from buffer bound during VAO creation, page may be bound by other batch
+        p_pBufferStorage->getVBO(p_vboIndex)->bind();
+        createVAO(m_vao, p_pBufferStorage->getVBO(p_vboIndex)->getInputDescription());
+
+        // Sampler at position i always reads texture unit i, so uniforms are set once for the program
+        p_pShadersStorage->get(p_shaderIndex)->bind();
+        for(uint32 i = 0; i < m_samplerNames.size(); i++) {
+            setUniformSamplerGL(m_samplerLocations, m_samplerNames[i], (int32)i);
+        }
+    }
+
     void FPipelineMeshTex2DOpenGL::bind() const {
-        GL_FUNC( glBindVertexArray(m_vao) );
+        FStateCacheOpenGL::bindVertexArray(m_vao);
         p_pBufferStorage->getVBO(p_vboIndex)->bind();
         p_pBufferStorage->getIBO(p_iboIndex)->bind();
         p_pBufferStorage->getSSBO(p_transformIndex)->bind();
+        p_pBufferStorage->getSSBO(p_textureIndexesIndex)->bind();
         p_pBufferStorage->getSSBO(p_camIndex)->bind();
         p_pBufferStorage->getSSBO(p_pointLightIndex)->bind();
         p_pShadersStorage->get(p_shaderIndex)->bind();
-        for(uint32 i = 0; i < m_textures.size(); i++) {
-            FMaterialTex2D* pTexture{ p_pMaterialStorage->getTex2D(m_textures.at(i)) };
-            pTexture->bind();
-            setUniformSamplerGL(m_samplerLocations, m_samplerNames[i], pTexture->getInfo().sampler);
+        // Texture array may be shared between batches, so its sampler is always its position at this pipeline
+        for(uint32 i = 0; i < m_texturesIndex; i++) {
+            p_pMaterialStorage->getTex2DArray(m_textures.at(i))->bind(i);
         }
     }
 
@@ -147,6 +169,14 @@ namespace marengine {
         case EInputType::VEC3:
         case EInputType::VEC2:
             return GL_FLOAT;
+        case EInputType::INT:
+            return GL_INT;
+        case EInputType::UINT:
+            return GL_UNSIGNED_INT;
+        case EInputType::VEC2_SNORM16:
+            return GL_SHORT;
+        case EInputType::VEC2_HALF:
+            return GL_HALF_FLOAT;
         default:
             MARLOG_CRIT(ELoggerType::PLATFORMS, "Passed wrong EBufferInputType during VAO creation - {}", inputType);
             FLogger::callDebugBreak(true);
@@ -157,9 +187,13 @@ namespace marengine {
     static uint32 getCount(EInputType inputType) {
         switch(inputType) {
         case EInputType::FLOAT: return 1;
+        case EInputType::INT: return 1;
+        case EInputType::UINT: return 1;
         case EInputType::VEC4: return 4;
         case EInputType::VEC3: return 3;
         case EInputType::VEC2: return 2;
+        case EInputType::VEC2_SNORM16: return 2;
+        case EInputType::VEC2_HALF: return 2;
         default:
             MARLOG_CRIT(ELoggerType::PLATFORMS, "Passed wrong EBufferInputType during VAO creation - {}", inputType);
             FLogger::callDebugBreak(true);
@@ -169,18 +203,30 @@ namespace marengine {
     
     void createVAO(uint32& vao, const FVertexInputDescription& inputDescription) {
         GL_FUNC( glGenVertexArrays(1, &vao) );
-		GL_FUNC( glBindVertexArray(vao) );
+        FStateCacheOpenGL::bindVertexArray(vao);
 
         const uint32 layoutsSize{ (uint32)inputDescription.inputVariables.size() };
         for(uint32 i = 0; i < layoutsSize; i++) {
             const auto& inputVariable{ inputDescription.inputVariables.at(i) };
 
-            GL_FUNC( glVertexAttribPointer(i,
-                                           getCount(inputVariable.inputType),
-                                           getType(inputVariable.inputType),
-                                           GL_FALSE,
-                                           inputDescription.stride,
-                                           (const void*)inputVariable.offset) );
+            const EInputType inputType{ inputVariable.inputType };
+            if(inputType == EInputType::INT || inputType == EInputType::UINT) {
+                // Integer attributes have to reach shader without conversion to float
+                GL_FUNC( glVertexAttribIPointer(i,
+                                                getCount(inputType),
+                                                getType(inputType),
+                                                inputDescription.stride,
+                                                (const void*)inputVariable.offset) );
+            }
+            else {
+                const GLboolean normalized{ inputType == EInputType::VEC2_SNORM16 ? GL_TRUE : GL_FALSE };
+                GL_FUNC( glVertexAttribPointer(i,
+                                               getCount(inputType),
+                                               getType(inputType),
+                                               normalized,
+                                               inputDescription.stride,
+                                               (const void*)inputVariable.offset) );
+            }
 		    GL_FUNC( glEnableVertexAttribArray(i) );
         }
     }
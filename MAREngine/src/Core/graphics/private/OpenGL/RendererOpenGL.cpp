@@ -22,6 +22,7 @@
 
 #include "RendererOpenGL.h"
 #include "PipelineOpenGL.h"
+#include "StateCacheOpenGL.h"
 #include "FramebufferOpenGL.h"
 #include "../../public/RenderManager.h"
 #include "../../../../Logging/Logger.h"
@@ -30,23 +31,50 @@
 namespace marengine {
 
 
-    void FRenderCommandOpenGL::draw(FPipelineMesh* pPipeline) const {
-        pPipeline->bind();
+    static GLenum getIndexTypeGL(EIndexType indexType);
+
+
+    void FRenderCommandOpenGL::prepareFrame() const {
+        FStateCacheOpenGL::invalidate();
+        FStateCacheOpenGL::resetCounters();
 
         GL_FUNC( glStencilFunc(GL_ALWAYS, 1, 0xFF) );
-		GL_FUNC( glStencilMask(0xFF) );
+        GL_FUNC( glStencilMask(0xFF) );
+    }
+
+    void FRenderCommandOpenGL::draw(FPipelineMesh* pPipeline) const {
+        pPipeline->updateVisibleDrawCommands();
+        const FDrawIndirectCommandsArray& drawCommands{ pPipeline->getVisibleDrawCommands() };
+        // Every entity of batches drawn by pipeline is culled (see FBatchManager::cullEntities)
+        if(drawCommands.empty()) {
+            return;
+        }
+
+        pPipeline->bind();
 
-        GL_FUNC( glDrawElements(FRenderMode::getMode(),
-                                pPipeline->getIndicesCount(),
-                                GL_UNSIGNED_INT,
-                                nullptr) );
-        p_pRenderStatistics->getStorage().drawCallsCount += 1;
+        // Visible draw commands are uploaded to pipeline's indirect buffer, instances are offset by baseInstance
+        GL_FUNC( glMultiDrawElementsIndirect(FRenderMode::getMode(),
+                                             getIndexTypeGL(pPipeline->getIndexType()),
+                                             nullptr,
+                                             (GLsizei)drawCommands.size(),
+                                             0) );
+        FRenderStatsStorage& statsStorage{ p_pRenderStatistics->getStorage() };
+        statsStorage.drawCallsCount += 1;
+        statsStorage.stateCallsIssued = FStateCacheOpenGL::getIssuedCount();
+        statsStorage.stateCallsSkipped = FStateCacheOpenGL::getSkippedCount();
     }
 
     void FRenderCommandOpenGL::draw(FFramebuffer* pFramebuffer, FPipelineMesh* pPipeline) const {
         pFramebuffer->bind();
         draw(pPipeline);
-        pFramebuffer->unbind();
+    }
+
+
+    GLenum getIndexTypeGL(EIndexType indexType) {
+        if(indexType == EIndexType::UINT16) {
+            return GL_UNSIGNED_SHORT;
+        }
+        return GL_UNSIGNED_INT;
     }
 
 
@@ -36,7 +36,11 @@ namespace marengine {
     class FRenderCommandOpenGL : public FRenderCommand {
     public:
 
+        /// @brief Should be called before first draw of frame, as state could be changed outside of renderer
+        void prepareFrame() const;
+
         void draw(FPipelineMesh* pPipeline) const;
+        /// @brief Framebuffer stays bound after draw, caller should unbind it once all pipelines are drawn
         void draw(FFramebuffer* pFramebuffer, FPipelineMesh* pPipeline) const;
 
     };
@@ -21,6 +21,7 @@
 
 
 #include "ShadersOpenGL.h"
+#include "StateCacheOpenGL.h"
 #include "../../../filesystem/public/FileManager.h"
 #include "../../../../Logging/Logger.h"
 
@@ -49,44 +50,65 @@ namespace marengine {
     }
 
     template<GLenum TShaderType>
-    static GLuint validateThenCompileGL(const char* path) {
-        if(path == nullptr) {
+    static GLuint compileThenAttachGL(GLuint shaderPipelineID, const std::string& shaderSourceCode) {
+        if(shaderSourceCode.empty()) {
             return GL_FALSE;
         }
-        else {
-            std::string shaderSourceCode{};
-            FFileManager::loadFile(shaderSourceCode, path);
-            return compileGL<TShaderType>(shaderSourceCode);
-        }   
-    }
 
-    template<GLenum TShaderType>
-    static GLuint compileThenAttachGL(GLuint shaderPipelineID, const char* path) {
-        const GLuint id{ validateThenCompileGL<TShaderType>(path) };
-        
+        const GLuint id{ compileGL<TShaderType>(shaderSourceCode) };
         if(id != GL_FALSE) {
             GL_FUNC( glAttachShader(shaderPipelineID, id) );
         }
         return id;
     }
 
+    static std::string loadSource(const char* path) {
+        std::string shaderSourceCode{};
+        if(path != nullptr) {
+            FFileManager::loadFile(shaderSourceCode, path);
+        }
+        return shaderSourceCode;
+    }
+
+    static std::string getProgramBinaryPath(const std::string& vertex, const std::string& fragment,
+                                            const std::string& compute, const std::string& tessEval,
+                                            const std::string& tessControl, const std::string& geometry);
+    static GLuint loadProgramBinaryGL(const std::string& binaryPath);
+    static void saveProgramBinaryGL(GLuint shaderPipelineID, const std::string& binaryPath);
+
 
 
     void FShadersOpenGL::compile() {
+        const std::string vertexSource{ loadSource(p_vertexPath) };
+        const std::string fragmentSource{ loadSource(p_fragPath) };
+        const std::string computeSource{ loadSource(p_computePath) };
+        const std::string tessEvalSource{ loadSource(p_tessEvalPath) };
+        const std::string tessControlSource{ loadSource(p_tessControlPath) };
+        const std::string geometrySource{ loadSource(p_geometryPath) };
+
+        const std::string binaryPath{ getProgramBinaryPath(vertexSource, fragmentSource, computeSource,
+                                                           tessEvalSource, tessControlSource, geometrySource) };
+        m_id = loadProgramBinaryGL(binaryPath);
+        m_loadedFromBinary = m_id != GL_FALSE;
+        if(m_loadedFromBinary) {
+            return;
+        }
+
         GL_FUNC_ASSIGN( GLuint shaderPipelineID = glCreateProgram() );
+        GL_FUNC( glProgramParameteri(shaderPipelineID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE) );
 
         const GLuint vertexID =
-            compileThenAttachGL<GL_VERTEX_SHADER>(shaderPipelineID, p_vertexPath);
+            compileThenAttachGL<GL_VERTEX_SHADER>(shaderPipelineID, vertexSource);
         const GLuint fragmentID =
-            compileThenAttachGL<GL_FRAGMENT_SHADER>(shaderPipelineID, p_fragPath);
+            compileThenAttachGL<GL_FRAGMENT_SHADER>(shaderPipelineID, fragmentSource);
         const GLuint computeID =
-            compileThenAttachGL<GL_COMPUTE_SHADER>(shaderPipelineID, p_computePath);
+            compileThenAttachGL<GL_COMPUTE_SHADER>(shaderPipelineID, computeSource);
         const GLuint tessEvalID =
-            compileThenAttachGL<GL_TESS_EVALUATION_SHADER>(shaderPipelineID, p_tessEvalPath);
+            compileThenAttachGL<GL_TESS_EVALUATION_SHADER>(shaderPipelineID, tessEvalSource);
         const GLuint tessControlID =
-            compileThenAttachGL<GL_TESS_CONTROL_SHADER>(shaderPipelineID, p_tessControlPath);
+            compileThenAttachGL<GL_TESS_CONTROL_SHADER>(shaderPipelineID, tessControlSource);
         const GLuint geometryID =
-            compileThenAttachGL<GL_GEOMETRY_SHADER>(shaderPipelineID, p_geometryPath);
+            compileThenAttachGL<GL_GEOMETRY_SHADER>(shaderPipelineID, geometrySource);
 
         GL_FUNC( glLinkProgram(shaderPipelineID) );
         GL_FUNC( glValidateProgram(shaderPipelineID) );
@@ -119,21 +141,30 @@ namespace marengine {
             GL_FUNC( glDeleteShader(geometryID) );
         }
 
+        if(shaderPipelineID != GL_FALSE) {
+            saveProgramBinaryGL(shaderPipelineID, binaryPath);
+        }
         m_id = shaderPipelineID;
     }
 
     void FShadersOpenGL::close() {
         GL_FUNC( glDeleteProgram(m_id) );
+        FStateCacheOpenGL::onProgramDeleted(m_id);
+        m_id = GL_FALSE;
     }
 
     void FShadersOpenGL::bind() {
-        GL_FUNC( glUseProgram(m_id) );
+        FStateCacheOpenGL::useProgram(m_id);
     }
 
     uint32 FShadersOpenGL::getID() const {
         return m_id;
     }
 
+    bool FShadersOpenGL::isLoadedFromBinary() const {
+        return m_loadedFromBinary;
+    }
+
 
     uint32 FShadersStorageOpenGL::getCount() const {
         return m_shadersArray.size();
@@ -148,13 +179,17 @@ namespace marengine {
             shaders.close();
         }
         m_shadersArray.clear();
+        p_cachedIndexes.clear();
+        p_compiledCount = 0;
+        p_loadedFromBinaryCount = 0;
+        p_compilationTime = 0.f;
     }
 
 
     template<typename TReturnType, typename TShadersArray>
     static TReturnType* emplaceShaderAtArray(TShadersArray& array) {
         auto& shaders{ array.emplace_back() };
-        const int8_t currentSize{ (int8_t)array.size() };
+        const int32 currentSize{ (int32)array.size() };
         shaders.setIndex( currentSize - 1);
         return (TReturnType*)&shaders;
     }
@@ -163,5 +198,82 @@ namespace marengine {
         return emplaceShaderAtArray<FShaders>(m_storage.m_shadersArray);
     }
 
+    static const char* s_programBinaryCacheDirectory{ "resources/shaders/cache" };
+
+    std::string getProgramBinaryPath(const std::string& vertex, const std::string& fragment,
+                                     const std::string& compute, const std::string& tessEval,
+                                     const std::string& tessControl, const std::string& geometry) {
+        const auto getGLString = [](GLenum name)->std::string {
+            const GLubyte* value{ glGetString(name) };
+            return value != nullptr ? std::string((const char*)value) : std::string();
+        };
+
+        // Stage tags keep the same source used at different stages from colliding
+        std::string key{ getGLString(GL_VENDOR) + "|" + getGLString(GL_RENDERER) + "|" + getGLString(GL_VERSION) };
+        key += "|vert|" + vertex + "|frag|" + fragment + "|comp|" + compute;
+        key += "|tese|" + tessEval + "|tesc|" + tessControl + "|geom|" + geometry;
+
+        std::stringstream fileName;
+        fileName << std::hex << std::hash<std::string>{}(key) << ".bin";
+        return FFileManager::joinPaths(s_programBinaryCacheDirectory, fileName.str());
+    }
+
+    GLuint loadProgramBinaryGL(const std::string& binaryPath) {
+        std::ifstream binaryFile(binaryPath, std::ios::binary);
+        if(!binaryFile.is_open()) {
+            return GL_FALSE;
+        }
+
+        GLenum binaryFormat{ 0 };
+        binaryFile.read((char*)&binaryFormat, sizeof(binaryFormat));
+        if(!binaryFile) {
+            return GL_FALSE;
+        }
+
+        const std::vector<char> binary{ std::istreambuf_iterator<char>(binaryFile), std::istreambuf_iterator<char>() };
+        if(binary.empty()) {
+            return GL_FALSE;
+        }
+
+        GL_FUNC_ASSIGN( const GLuint shaderPipelineID = glCreateProgram() );
+        // Driver rejects binaries made by other driver versions (raising GL error), then program is compiled
+        // from source again. It is expected, so call is not wrapped with GL_FUNC (which would break on error),
+        // error is cleared and only GL_LINK_STATUS is checked.
+        glProgramBinary(shaderPipelineID, binaryFormat, binary.data(), (GLsizei)binary.size());
+        FLogger::clearErrorOpenGL();
+
+        GLint linkStatus{ GL_FALSE };
+        GL_FUNC( glGetProgramiv(shaderPipelineID, GL_LINK_STATUS, &linkStatus) );
+        if(linkStatus == GL_FALSE) {
+            GL_FUNC( glDeleteProgram(shaderPipelineID) );
+            return GL_FALSE;
+        }
+
+        return shaderPipelineID;
+    }
+
+    void saveProgramBinaryGL(GLuint shaderPipelineID, const std::string& binaryPath) {
+        GLint binaryLength{ 0 };
+        GL_FUNC( glGetProgramiv(shaderPipelineID, GL_PROGRAM_BINARY_LENGTH, &binaryLength) );
+        if(binaryLength <= 0) {
+            return;
+        }
+
+        std::vector<char> binary(binaryLength);
+        GLenum binaryFormat{ 0 };
+        GL_FUNC( glGetProgramBinary(shaderPipelineID, binaryLength, nullptr, &binaryFormat, binary.data()) );
+
+        std::error_code errorCode;
+        std::filesystem::create_directories(s_programBinaryCacheDirectory, errorCode);
+        std::ofstream binaryFile(binaryPath, std::ios::binary | std::ios::trunc);
+        if(errorCode || !binaryFile.is_open()) {
+            MARLOG_WARN(ELoggerType::PLATFORMS, "Could not save program binary to {}", binaryPath);
+            return;
+        }
+
+        binaryFile.write((const char*)&binaryFormat, sizeof(binaryFormat));
+        binaryFile.write(binary.data(), binary.size());
+    }
+
 
 }
@@ -38,10 +38,12 @@ namespace marengine {
         void bind() final;
 
         MAR_NO_DISCARD uint32 getID() const final;
+        MAR_NO_DISCARD bool isLoadedFromBinary() const final;
 
     private:
 
         GLuint m_id{ GL_FALSE };
+        bool m_loadedFromBinary{ false };
 
     };
 
@@ -0,0 +1,189 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+
+
+#include "StateCacheOpenGL.h"
+
+
+namespace marengine {
+
+
+    uint32 FStateCacheOpenGL::s_vertexArray{ s_unknown };
+    uint32 FStateCacheOpenGL::s_program{ s_unknown };
+    uint32 FStateCacheOpenGL::s_framebuffer{ s_unknown };
+    uint32 FStateCacheOpenGL::s_activeTextureUnit{ s_unknown };
+    std::unordered_map<GLenum, uint32> FStateCacheOpenGL::s_buffers;
+    std::map<std::pair<GLenum, uint32>, FStateCacheOpenGL::FBufferRange> FStateCacheOpenGL::s_indexedBuffers;
+    std::map<std::pair<uint32, GLenum>, uint32> FStateCacheOpenGL::s_textures;
+    uint32 FStateCacheOpenGL::s_issuedCount{ 0 };
+    uint32 FStateCacheOpenGL::s_skippedCount{ 0 };
+
+
+    void FStateCacheOpenGL::bindVertexArray(uint32 vao) {
+        if(isRedundant(s_vertexArray, vao)) {
+            return;
+        }
+
+        GL_FUNC( glBindVertexArray(vao) );
+        // Element array buffer binding is part of vertex array state
+        s_buffers.erase(GL_ELEMENT_ARRAY_BUFFER);
+    }
+
+    void FStateCacheOpenGL::bindBuffer(GLenum target, uint32 id) {
+        const auto it{ s_buffers.find(target) };
+        uint32 cached{ it != s_buffers.end() ? it->second : s_unknown };
+        if(isRedundant(cached, id)) {
+            return;
+        }
+
+        GL_FUNC( glBindBuffer(target, id) );
+        s_buffers[target] = id;
+    }
+
+    void FStateCacheOpenGL::bindBufferBase(GLenum target, uint32 binding, uint32 id) {
+        // Whole buffer is bound, so range is unknown here, base binding also changes generic one
+        s_indexedBuffers.erase({ target, binding });
+        s_buffers[target] = id;
+        s_issuedCount++;
+        GL_FUNC( glBindBufferBase(target, binding, id) );
+    }
+
+    void FStateCacheOpenGL::bindBufferRange(GLenum target, uint32 binding, uint32 id, int64 offset, int64 size) {
+        const FBufferRange range{ id, offset, size };
+        const auto it{ s_indexedBuffers.find({ target, binding }) };
+        if(it != s_indexedBuffers.end() && it->second == range) {
+            s_skippedCount++;
+            return;
+        }
+
+        s_issuedCount++;
+        GL_FUNC( glBindBufferRange(target, binding, id, offset, size) );
+        s_indexedBuffers[{ target, binding }] = range;
+        s_buffers[target] = id;
+    }
+
+    void FStateCacheOpenGL::useProgram(uint32 program) {
+        if(isRedundant(s_program, program)) {
+            return;
+        }
+
+        GL_FUNC( glUseProgram(program) );
+    }
+
+    void FStateCacheOpenGL::bindTexture(uint32 unit, GLenum target, uint32 id) {
+        const auto it{ s_textures.find({ unit, target }) };
+        uint32 cached{ it != s_textures.end() ? it->second : s_unknown };
+        if(isRedundant(cached, id)) {
+            return;
+        }
+
+        if(s_activeTextureUnit != unit) {
+            GL_FUNC( glActiveTexture(GL_TEXTURE0 + unit) );
+            s_activeTextureUnit = unit;
+            s_issuedCount++;
+        }
+        GL_FUNC( glBindTexture(target, id) );
+        s_textures[{ unit, target }] = id;
+    }
+
+    void FStateCacheOpenGL::bindFramebuffer(uint32 id) {
+        if(isRedundant(s_framebuffer, id)) {
+            return;
+        }
+
+        GL_FUNC( glBindFramebuffer(GL_FRAMEBUFFER, id) );
+    }
+
+    void FStateCacheOpenGL::onVertexArrayDeleted(uint32 vao) {
+        if(s_vertexArray == vao) {
+            s_vertexArray = 0;
+            s_buffers.erase(GL_ELEMENT_ARRAY_BUFFER);
+        }
+    }
+
+    void FStateCacheOpenGL::onBufferDeleted(uint32 id) {
+        // Deleted buffer is unbound from every binding point, its name may be reused by next buffer
+        for(auto& buffer : s_buffers) {
+            if(buffer.second == id) {
+                buffer.second = 0;
+            }
+        }
+        for(auto it = s_indexedBuffers.begin(); it != s_indexedBuffers.end(); ) {
+            it = it->second.id == id ? s_indexedBuffers.erase(it) : std::next(it);
+        }
+    }
+
+    void FStateCacheOpenGL::onProgramDeleted(uint32 program) {
+        if(s_program == program) {
+            s_program = s_unknown;
+        }
+    }
+
+    void FStateCacheOpenGL::onTextureDeleted(uint32 id) {
+        for(auto& texture : s_textures) {
+            if(texture.second == id) {
+                texture.second = 0;
+            }
+        }
+    }
+
+    void FStateCacheOpenGL::onFramebufferDeleted(uint32 id) {
+        if(s_framebuffer == id) {
+            s_framebuffer = 0;
+        }
+    }
+
+    void FStateCacheOpenGL::invalidate() {
+        s_vertexArray = s_unknown;
+        s_program = s_unknown;
+        s_framebuffer = s_unknown;
+        s_activeTextureUnit = s_unknown;
+        s_buffers.clear();
+        s_indexedBuffers.clear();
+        s_textures.clear();
+    }
+
+    void FStateCacheOpenGL::resetCounters() {
+        s_issuedCount = 0;
+        s_skippedCount = 0;
+    }
+
+    uint32 FStateCacheOpenGL::getIssuedCount() {
+        return s_issuedCount;
+    }
+
+    uint32 FStateCacheOpenGL::getSkippedCount() {
+        return s_skippedCount;
+    }
+
+    bool FStateCacheOpenGL::isRedundant(uint32& cached, uint32 requested) {
+        if(cached == requested) {
+            s_skippedCount++;
+            return true;
+        }
+
+        cached = requested;
+        s_issuedCount++;
+        return false;
+    }
+
+
+}
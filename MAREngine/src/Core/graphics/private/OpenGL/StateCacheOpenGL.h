@@ -0,0 +1,93 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+
+
+#ifndef MARENGINE_STATECACHEOPENGL_H
+#define MARENGINE_STATECACHEOPENGL_H
+
+
+#include "../../public/IRender.h"
+
+
+namespace marengine {
+
+
+    /// @brief Remembers objects currently bound at OpenGL context and skips binding calls, that would not
+    /// change anything. Every bind at OpenGL backend should go through it, deleted objects must be reported.
+    class FStateCacheOpenGL {
+    public:
+
+        static void bindVertexArray(uint32 vao);
+        static void bindBuffer(GLenum target, uint32 id);
+        static void bindBufferBase(GLenum target, uint32 binding, uint32 id);
+        static void bindBufferRange(GLenum target, uint32 binding, uint32 id, int64 offset, int64 size);
+        static void useProgram(uint32 program);
+        static void bindTexture(uint32 unit, GLenum target, uint32 id);
+        static void bindFramebuffer(uint32 id);
+
+        static void onVertexArrayDeleted(uint32 vao);
+        static void onBufferDeleted(uint32 id);
+        static void onProgramDeleted(uint32 program);
+        static void onTextureDeleted(uint32 id);
+        static void onFramebufferDeleted(uint32 id);
+
+        /// @brief forgets every cached binding, should be called whenever state could be changed outside of cache
+        static void invalidate();
+        static void resetCounters();
+
+        MAR_NO_DISCARD static uint32 getIssuedCount();
+        MAR_NO_DISCARD static uint32 getSkippedCount();
+
+    private:
+
+        MAR_NO_DISCARD static bool isRedundant(uint32& cached, uint32 requested);
+
+
+        struct FBufferRange {
+            uint32 id{ 0 };
+            int64 offset{ 0 };
+            int64 size{ 0 };
+
+            MAR_NO_DISCARD bool operator==(const FBufferRange& other) const {
+                return id == other.id && offset == other.offset && size == other.size;
+            }
+        };
+
+        static constexpr uint32 s_unknown{ (uint32)-1 };
+
+        static uint32 s_vertexArray;
+        static uint32 s_program;
+        static uint32 s_framebuffer;
+        static uint32 s_activeTextureUnit;
+        static std::unordered_map<GLenum, uint32> s_buffers;
+        static std::map<std::pair<GLenum, uint32>, FBufferRange> s_indexedBuffers;
+        static std::map<std::pair<uint32, GLenum>, uint32> s_textures;
+
+        static uint32 s_issuedCount;
+        static uint32 s_skippedCount;
+
+    };
+
+
+}
+
+
+#endif //MARENGINE_STATECACHEOPENGL_H
@@ -22,11 +22,16 @@
 
 #include "../public/Pipeline.h"
 #include "../public/Buffer.h"
+#include "../public/MeshBatch.h"
 
 
 namespace marengine {
 
 
+    static void pushVisibleDrawCommands(const FDrawIndirectCommand& command, const FMeshBatchRangeArray& culledRanges,
+                                        uint32 instancesCount, FDrawIndirectCommandsArray& visibleDrawCommands);
+
+
     void FPipeline::passBufferStorage(FBufferStorage* pStorage) {
         p_pBufferStorage = pStorage;
     }
@@ -64,10 +69,86 @@ namespace marengine {
         p_shaderIndex = i;
     }
 
+    void FPipelineMesh::passInstancesCount(uint32 instancesCount) {
+        p_instancesCount = instancesCount;
+        p_areVisibleDrawCommandsDirty = true;
+    }
+
+    void FPipelineMesh::passIndirectBuffer(int32 i) {
+        p_indirectIndex = i;
+    }
+
+    void FPipelineMesh::passDrawCommands(const FDrawIndirectCommandsArray& drawCommands) {
+        p_drawCommands = drawCommands;
+        p_culledRanges.assign(drawCommands.size(), FMeshBatchRangeArray{});
+        p_areVisibleDrawCommandsDirty = true;
+    }
+
+    void FPipelineMesh::updateDrawCommand(uint32 commandIndex, uint32 indicesCount) {
+        p_drawCommands.at(commandIndex).count = indicesCount;
+        p_areVisibleDrawCommandsDirty = true;
+    }
+
+    void FPipelineMesh::passCulledRanges(uint32 commandIndex, const FMeshBatchRangeArray& culledRanges) {
+        p_culledRanges.at(commandIndex) = culledRanges;
+        p_areVisibleDrawCommandsDirty = true;
+    }
+
+    void FPipelineMesh::updateVisibleDrawCommands() {
+        if(!p_areVisibleDrawCommandsDirty) {
+            return;
+        }
+
+        p_visibleDrawCommands.clear();
+        for(uint32 i = 0; i < p_drawCommands.size(); i++) {
+            pushVisibleDrawCommands(p_drawCommands[i], p_culledRanges[i], p_instancesCount, p_visibleDrawCommands);
+        }
+        if(isIndirect() && !p_visibleDrawCommands.empty()) {
+            p_pBufferStorage->getIndirect(p_indirectIndex)->update(p_visibleDrawCommands);
+        }
+        p_areVisibleDrawCommandsDirty = false;
+    }
+
+    const FDrawIndirectCommandsArray& FPipelineMesh::getVisibleDrawCommands() const {
+        return p_visibleDrawCommands;
+    }
+
+    const FDrawIndirectCommand& FPipelineMesh::getDrawCommand(uint32 commandIndex) const {
+        return p_drawCommands.at(commandIndex);
+    }
+
     uint32_t FPipelineMesh::getIndicesCount() const {
+        // Index buffer is shared between batches, so count is taken from pipeline's draw command
+        if(!p_drawCommands.empty()) {
+            return p_drawCommands.at(0).count;
+        }
         return p_pBufferStorage->getIBO(p_iboIndex)->getIndicesCount();
     }
 
+    uint32 FPipelineMesh::getInstancesCount() const {
+        return p_instancesCount;
+    }
+
+    bool FPipelineMesh::isIndirect() const {
+        return p_indirectIndex != -1;
+    }
+
+    uint32 FPipelineMesh::getDrawCommandsCount() const {
+        return p_drawCommands.size();
+    }
+
+    void FPipelineMesh::passVertexFormat(EVertexFormat format) {
+        p_vertexFormat = format;
+    }
+
+    EVertexFormat FPipelineMesh::getVertexFormat() const {
+        return p_vertexFormat;
+    }
+
+    EIndexType FPipelineMesh::getIndexType() const {
+        return p_pBufferStorage->getIBO(p_iboIndex)->getIndexType();
+    }
+
 
     void FPipelineMeshColor::passColorSSBO(int32 i) {
         p_colorIndex = i;
@@ -83,9 +164,110 @@ namespace marengine {
         m_texturesIndex++;
     }
 
+    void FPipelineMeshTex2D::updateTexture(uint32 slot, int32 i) {
+        m_textures.at(slot) = i;
+        m_texturesIndex = std::max(m_texturesIndex, slot + 1);
+    }
+
+    void FPipelineMeshTex2D::passTexturesCount(uint32 count) {
+        m_texturesIndex = count;
+    }
+
+    void FPipelineMeshTex2D::passTextureIndexesSSBO(int32 i) {
+        p_textureIndexesIndex = i;
+    }
+
     auto FPipelineMeshTex2D::getSamplerLocations() ->decltype(m_samplerLocations)& {
         return m_samplerLocations;
     }
 
 
+    void FPipelineFactory::allocateArenaRanges(const std::vector<FMeshBatchStatic*>& batches,
+                                               std::vector<FMeshBatchArenaInfo>& arenaInfos,
+                                               EVertexFormat format, int32& vboIndex, int32& iboIndex) const {
+        FBufferFactory* const pBufferFactory{ p_pRenderContext->getBufferFactory() };
+        FBufferStorage* const pBufferStorage{ p_pRenderContext->getBufferStorage() };
+
+        // All batches have to live at the same VBO / IBO, so page sized for all of them is pushed
+        // Single multi-draw reads one index type, so 16-bit indices are used only if every batch fits them
+        uint32 verticesCount{ 0 };
+        uint32 indicesCount{ 0 };
+        EIndexType indexType{ EIndexType::UINT16 };
+        for(const FMeshBatchStatic* pBatch : batches) {
+            verticesCount += FBufferArena::getBlockCapacity(pBatch->getVertices().size());
+            indicesCount += FBufferArena::getBlockCapacity(pBatch->getIndices().size());
+            if(pBatch->getFittingIndexType() == EIndexType::UINT32) {
+                indexType = EIndexType::UINT32;
+            }
+        }
+        vboIndex = pBufferFactory->emplaceVerticesPage(verticesCount, format);
+        iboIndex = pBufferFactory->emplaceIndicesPage(indicesCount, indexType);
+
+        // Buddy blocks requested from the biggest one always fit into page, which can hold their sum
+        std::vector<uint32> order(batches.size());
+        for(uint32 i = 0; i < order.size(); i++) {
+            order[i] = i;
+        }
+
+        std::sort(order.begin(), order.end(), [&batches](uint32 lhs, uint32 rhs) {
+            return batches[lhs]->getVertices().size() > batches[rhs]->getVertices().size();
+        });
+        for(uint32 i : order) {
+            const FBufferAllocation allocation{
+                pBufferStorage->getVertexArena(format)->allocate(batches[i]->getVertices().size(), vboIndex) };
+            arenaInfos[i].verticesOffset = allocation.offset;
+            arenaInfos[i].verticesCapacity = allocation.capacity;
+        }
+
+        std::sort(order.begin(), order.end(), [&batches](uint32 lhs, uint32 rhs) {
+            return batches[lhs]->getIndices().size() > batches[rhs]->getIndices().size();
+        });
+        for(uint32 i : order) {
+            const FBufferAllocation allocation{
+                pBufferStorage->getIndexArena(indexType)->allocate(batches[i]->getIndices().size(), iboIndex) };
+            arenaInfos[i].indicesOffset = allocation.offset;
+            arenaInfos[i].indicesCapacity = allocation.capacity;
+            arenaInfos[i].indexType = indexType;
+        }
+    }
+
+
+    void pushVisibleDrawCommands(const FDrawIndirectCommand& command, const FMeshBatchRangeArray& culledRanges,
+                                 uint32 instancesCount, FDrawIndirectCommandsArray& visibleDrawCommands) {
+        // Instanced pipeline draws whole mesh for every instance, so its instances are split instead of indices
+        const bool isInstanced{ instancesCount != 0 };
+        const uint32 elementsCount{ isInstanced ? instancesCount : command.count };
+        if(command.count == 0) {
+            return;
+        }
+
+        auto pushVisibleRange = [&command, &visibleDrawCommands, isInstanced](uint32 begin, uint32 end) {
+            if(begin >= end) {
+                return;
+            }
+
+            FDrawIndirectCommand& visibleCommand{ visibleDrawCommands.emplace_back(command) };
+            if(isInstanced) {
+                visibleCommand.instanceCount = end - begin;
+                visibleCommand.baseInstance = command.baseInstance + begin;
+            }
+            else {
+                visibleCommand.count = end - begin;
+                visibleCommand.firstIndex = command.firstIndex + begin;
+            }
+        };
+
+        // Culled ranges are sorted and may point past the command, if batch shrank since they were passed
+        uint32 begin{ 0 };
+        for(const FMeshBatchRange& culledRange : culledRanges) {
+            if(culledRange.begin >= elementsCount) {
+                break;
+            }
+            pushVisibleRange(begin, culledRange.begin);
+            begin = culledRange.end();
+        }
+        pushVisibleRange(begin, elementsCount);
+    }
+
+
 }
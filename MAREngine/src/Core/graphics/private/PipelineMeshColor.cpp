@@ -23,12 +23,54 @@
 #include "../public/Pipeline.h"
 #include "../public/Buffer.h"
 #include "../public/MeshBatch.h"
+#include "../public/VertexFormat.h"
 
 
 namespace marengine {
 
 
-    static void fillDefaultVertexLayout(FVertexBuffer* const pVertexBuffer) {
+    static void fillPackedVertexLayout(FVertexBuffer* const pVertexBuffer) {
+        FVertexInputVariableInfo positionInfo;
+        positionInfo.inputType = EInputType::VEC3;
+        positionInfo.location = 0;
+        positionInfo.offset = offsetof(VertexPacked, VertexPacked::position);
+
+        FVertexInputVariableInfo normalInfo;
+        normalInfo.inputType = EInputType::VEC2_SNORM16;
+        normalInfo.location = 1;
+        normalInfo.offset = offsetof(VertexPacked, VertexPacked::normal);
+
+        FVertexInputVariableInfo texCoordsInfo;
+        texCoordsInfo.inputType = EInputType::VEC2_HALF;
+        texCoordsInfo.location = 2;
+        texCoordsInfo.offset = offsetof(VertexPacked, VertexPacked::textureCoordinates);
+
+        FVertexInputVariableInfo shapeIndexInfo;
+        shapeIndexInfo.inputType = EInputType::UINT;
+        shapeIndexInfo.location = 3;
+        shapeIndexInfo.offset = offsetof(VertexPacked, VertexPacked::shapeID);
+
+        FVertexInputDescription inputDescription;
+        inputDescription.binding = 0;
+        inputDescription.stride = sizeof(VertexPacked);
+
+        pVertexBuffer->setInputDescription(inputDescription);
+        pVertexBuffer->pushVariableInfo(positionInfo);
+        pVertexBuffer->pushVariableInfo(normalInfo);
+        pVertexBuffer->pushVariableInfo(texCoordsInfo);
+        pVertexBuffer->pushVariableInfo(shapeIndexInfo);
+    }
+
+    static void fillDefaultVertexLayout(FVertexBuffer* const pVertexBuffer, EVertexFormat format) {
+        // Vertex pages are shared between batches, so layout is pushed only for the first one
+        if(!pVertexBuffer->getInputDescription().inputVariables.empty()) {
+            return;
+        }
+        if(format == EVertexFormat::PACKED) {
+            fillPackedVertexLayout(pVertexBuffer);
+            return;
+        }
+
         FVertexInputVariableInfo positionInfo;
         positionInfo.inputType = EInputType::VEC3;
         positionInfo.location = 0;
@@ -62,13 +104,19 @@ namespace marengine {
 
     static void createPipelineVBO(FRenderContext* pContext,
                                   FPipelineMeshColor* pPipeline,
-                                  FMeshBatchStaticColor* pBatch) {
-        FVertexBuffer* const vertexBuffer{ pContext->getBufferFactory()->emplaceVBO() };
+                                  FMeshBatchStaticColor* pBatch,
+                                  FMeshBatchArenaInfo& arenaInfo) {
+        const EVertexFormat format{ pPipeline->getVertexFormat() };
+        const FVertexArray& vertices{ pBatch->getVertices() };
+        const FBufferAllocation allocation{
+            pContext->getBufferFactory()->allocateVertices(vertices.size(), format) };
+        FVertexBuffer* const vertexBuffer{ pContext->getBufferStorage()->getVBO(allocation.bufferIndex) };
 
-        fillDefaultVertexLayout(vertexBuffer);
+        fillDefaultVertexLayout(vertexBuffer, format);
 
-        vertexBuffer->create(GraphicLimits::sizeOfVertices);
-        vertexBuffer->update(pBatch->getVertices());
+        FVertexFormat::update(vertexBuffer, format, vertices, 0, vertices.size(), allocation.offset);
+        arenaInfo.verticesOffset = allocation.offset;
+        arenaInfo.verticesCapacity = allocation.capacity;
 
         pBatch->passVBO(vertexBuffer->getIndex());
         pPipeline->passVertexBuffer(vertexBuffer->getIndex());
@@ -76,30 +124,56 @@ namespace marengine {
 
     static void createPipelineIBO(FRenderContext* pContext,
                                   FPipelineMeshColor* pPipeline,
-                                  FMeshBatchStaticColor* pBatch) {
-        FIndexBuffer* const indexBuffer{ pContext->getBufferFactory()->emplaceIBO() };
-
+                                  FMeshBatchStaticColor* pBatch,
+                                  FMeshBatchArenaInfo& arenaInfo) {
+        const EIndexType indexType{ pBatch->getFittingIndexType() };
         const FIndicesArray& indices{ pBatch->getIndices() };
-        indexBuffer->create(GraphicLimits::sizeOfIndices);
-        indexBuffer->update(indices);
-        indexBuffer->passIndicesCount(indices.size());
+        const FBufferAllocation allocation{
+            pContext->getBufferFactory()->allocateIndices(indices.size(), indexType) };
+        FIndexBuffer* const indexBuffer{ pContext->getBufferStorage()->getIBO(allocation.bufferIndex) };
+
+        indexBuffer->updateIndices(indices, 0, indices.size(), allocation.offset);
+        arenaInfo.indicesOffset = allocation.offset;
+        arenaInfo.indicesCapacity = allocation.capacity;
+        arenaInfo.indexType = indexType;
 
         pBatch->passIBO(indexBuffer->getIndex());
         pPipeline->passIndexBuffer(indexBuffer->getIndex());
     }
 
-    static void fillDefaultTransformSSBO(FShaderBuffer* pTransformBuffer, uint32_t bindingPoint) {
+    static void createPipelineDrawCommand(FRenderContext* pContext,
+                                          FPipelineMeshColor* pPipeline,
+                                          FMeshBatchStaticColor* pBatch,
+                                          FMeshBatchArenaInfo& arenaInfo) {
+        arenaInfo.drawCommandIndex = 0;
+        pBatch->passArenaInfo(arenaInfo);
+
+        // Command is split around culled entities, so there is place for one command per entity
+        FIndirectBuffer* const indirectBuffer{ pContext->getBufferFactory()->emplaceIndirect() };
+        indirectBuffer->create(pBatch->getEntitiesBudget() * sizeof(FDrawIndirectCommand));
+
+        FDrawIndirectCommand command;
+        command.count = pBatch->getIndices().size();
+        command.firstIndex = arenaInfo.indicesOffset;
+        command.baseVertex = (int32)arenaInfo.verticesOffset;
+        pPipeline->passIndirectBuffer(indirectBuffer->getIndex());
+        pPipeline->passDrawCommands({ command });
+    }
+
+    static void fillDefaultTransformSSBO(FShaderBuffer* pTransformBuffer, uint32_t bindingPoint,
+                                         uint32 transformsCount) {
         FShaderInputDescription description;
         description.binding = bindingPoint;
         description.shaderStage = EShaderStage::VERTEX;
         description.bufferType = EBufferType::SSBO;
+        description.usage = EBufferUsage::PER_FRAME;
 
         FShaderInputVariableInfo inputInfo;
-        inputInfo.count = 32;
+        inputInfo.count = transformsCount;
         inputInfo.inputType = EInputType::MAT4;
-        inputInfo.name = "Transforms.Transform[32]";
+        inputInfo.name = "Transforms.Transform[]";
         inputInfo.offset = 0;
-        inputInfo.memoryUsed = 32 * sizeof(maths::mat4);
+        inputInfo.memoryUsed = transformsCount * sizeof(maths::mat4);
 
         pTransformBuffer->setInputDescription(description);
         pTransformBuffer->pushVariableInfo(inputInfo);
@@ -110,7 +184,7 @@ namespace marengine {
                                             FMeshBatchStaticColor* pBatch) {
         FShaderBuffer* const transformSSBO{ pContext->getBufferFactory()->emplaceSSBO() };
 
-        fillDefaultTransformSSBO(transformSSBO, 5);
+        fillDefaultTransformSSBO(transformSSBO, 5, pBatch->getEntitiesBudget());
         const FTransformsArray& transforms{ pBatch->getTransforms() };
         transformSSBO->create();
         transformSSBO->update(
@@ -119,22 +193,23 @@ namespace marengine {
                 transforms.size() * sizeof(maths::mat4)
         );
 
+        pBatch->clearDirtyTransforms();
         pBatch->passTransformSSBO(transformSSBO->getIndex());
         pPipeline->passTransformSSBO(transformSSBO->getIndex());
     }
 
-    static void fillDefaultColorSSBO(FShaderBuffer* pColorBuffer, uint32_t bindingPoint) {
+    static void fillDefaultColorSSBO(FShaderBuffer* pColorBuffer, uint32_t bindingPoint, uint32 colorsCount) {
         FShaderInputDescription description;
         description.binding = bindingPoint;
         description.shaderStage = EShaderStage::FRAGMENT;
         description.bufferType = EBufferType::SSBO;
 
         FShaderInputVariableInfo inputInfo;
-        inputInfo.count = 32;
+        inputInfo.count = colorsCount;
         inputInfo.inputType = EInputType::VEC4;
-        inputInfo.name = "Colors.Color[32]";
+        inputInfo.name = "Colors.Color[]";
         inputInfo.offset = 0;
-        inputInfo.memoryUsed = 32 * sizeof(maths::vec4);
+        inputInfo.memoryUsed = colorsCount * sizeof(maths::vec4);
 
         pColorBuffer->setInputDescription(description);
         pColorBuffer->pushVariableInfo(inputInfo);
@@ -145,7 +220,7 @@ namespace marengine {
                                         FMeshBatchStaticColor* pBatch) {
         FShaderBuffer* const colorSSBO{ pContext->getBufferFactory()->emplaceSSBO() };
 
-        fillDefaultColorSSBO(colorSSBO, 3);
+        fillDefaultColorSSBO(colorSSBO, 3, pBatch->getEntitiesBudget());
         const FColorsArray& colors{ pBatch->getColors() };
         colorSSBO->create();
         colorSSBO->update(
@@ -154,27 +229,158 @@ namespace marengine {
                 colors.size() * sizeof(maths::vec4)
         );
 
+        pBatch->clearDirtyColors();
         pBatch->passColorSSBO(colorSSBO->getIndex());
         pPipeline->passColorSSBO(colorSSBO->getIndex());
     }
 
     static void createPipelineShaders(FRenderContext* pContext,
-                                      FPipelineMeshColor* pPipeline) {
-        FShaders* pShaders{ pContext->getShadersFactory()->emplace() };
-        pShaders->passVertex("resources/shaders/color.vert.glsl");
-        pShaders->passFragment("resources/shaders/color.frag.glsl");
-        pShaders->compile();
+                                      FPipelineMeshColor* pPipeline,
+                                      FMeshBatchStaticColor* pBatch) {
+        const bool packed{ pPipeline->getVertexFormat() == EVertexFormat::PACKED };
+        FShaderStagesPaths stagesPaths;
+        if(pBatch->isInstanced()) {
+            stagesPaths.vertex = packed ? "resources/shaders/color_instanced_packed.vert.glsl"
+                                        : "resources/shaders/color_instanced.vert.glsl";
+            pPipeline->passInstancesCount(pBatch->getInstancesCount());
+        }
+        else {
+            stagesPaths.vertex = packed ? "resources/shaders/color_packed.vert.glsl"
+                                        : "resources/shaders/color.vert.glsl";
+        }
+        stagesPaths.fragment = "resources/shaders/color.frag.glsl";
+        FShaders* pShaders{ pContext->getShadersFactory()->emplaceCached(stagesPaths) };
         pPipeline->passShaderPipeline(pShaders->getIndex());
     }
 
 
+    static std::vector<FMeshBatchStaticColor*> getArenaBatches(FMeshBatchStorageStaticColor* pStorage) {
+        std::vector<FMeshBatchStaticColor*> batches;
+        const uint32 batchesCount{ pStorage->getCount() };
+        for(uint32 i = 0; i < batchesCount; i++) {
+            FMeshBatchStaticColor* pBatch{ pStorage->get(i) };
+            if(pBatch->getVertices().empty() || pBatch->getIndices().empty()) {
+                continue;
+            }
+            batches.push_back(pBatch);
+        }
+        return batches;
+    }
+
+    static void createArenaPipeline(FRenderContext* pContext,
+                                    FPipelineMeshColor* pPipeline,
+                                    const std::vector<FMeshBatchStaticColor*>& batches,
+                                    std::vector<FMeshBatchArenaInfo>& arenaInfos,
+                                    int32 vboIndex, int32 iboIndex) {
+        FBufferFactory* const pBufferFactory{ pContext->getBufferFactory() };
+        FBufferStorage* const pBufferStorage{ pContext->getBufferStorage() };
+        const EVertexFormat format{ pPipeline->getVertexFormat() };
+
+        FVertexBuffer* const vertexBuffer{ pBufferStorage->getVBO(vboIndex) };
+        FIndexBuffer* const indexBuffer{ pBufferStorage->getIBO(iboIndex) };
+        FShaderBuffer* const transformSSBO{ pBufferFactory->emplaceSSBO() };
+        FShaderBuffer* const colorSSBO{ pBufferFactory->emplaceSSBO() };
+        FIndirectBuffer* const indirectBuffer{ pBufferFactory->emplaceIndirect() };
+
+        uint32 entitiesBudget{ 0 };
+        FDrawIndirectCommandsArray drawCommands;
+        for(uint32 i = 0; i < batches.size(); i++) {
+            FMeshBatchStaticColor* pBatch{ batches[i] };
+
+            FMeshBatchArenaInfo& arenaInfo{ arenaInfos[i] };
+            arenaInfo.transformsOffset = entitiesBudget;
+            arenaInfo.drawCommandIndex = (int32)i;
+            pBatch->passArenaInfo(arenaInfo);
+            entitiesBudget += pBatch->getEntitiesBudget();
+
+            FDrawIndirectCommand& command{ drawCommands.emplace_back() };
+            command.count = pBatch->getIndices().size();
+            command.instanceCount = 1;
+            command.firstIndex = arenaInfo.indicesOffset;
+            command.baseVertex = (int32)arenaInfo.verticesOffset;
+            command.baseInstance = arenaInfo.transformsOffset;
+        }
+
+        fillDefaultVertexLayout(vertexBuffer, format);
+        fillDefaultTransformSSBO(transformSSBO, 5, entitiesBudget);
+        transformSSBO->create();
+        fillDefaultColorSSBO(colorSSBO, 3, entitiesBudget);
+        colorSSBO->create();
+        // Commands are split around culled entities, so there is place for one command per entity
+        indirectBuffer->create(entitiesBudget * sizeof(FDrawIndirectCommand));
+
+        for(FMeshBatchStaticColor* pBatch : batches) {
+            const FMeshBatchArenaInfo& arenaInfo{ pBatch->getArenaInfo() };
+            const FVertexArray& vertices{ pBatch->getVertices() };
+            const FIndicesArray& indices{ pBatch->getIndices() };
+            const FTransformsArray& transforms{ pBatch->getTransforms() };
+            const FColorsArray& colors{ pBatch->getColors() };
+
+            FVertexFormat::update(vertexBuffer, format, vertices, 0, vertices.size(), arenaInfo.verticesOffset);
+            indexBuffer->updateIndices(indices, 0, indices.size(), arenaInfo.indicesOffset);
+            transformSSBO->update(maths::mat4::value_ptr(transforms),
+                                  arenaInfo.transformsOffset * sizeof(maths::mat4),
+                                  transforms.size() * sizeof(maths::mat4));
+            colorSSBO->update(maths::vec4::value_ptr(colors),
+                              arenaInfo.transformsOffset * sizeof(maths::vec4),
+                              colors.size() * sizeof(maths::vec4));
+
+            pBatch->clearDirtyTransforms();
+            pBatch->clearDirtyColors();
+            pBatch->passVBO(vertexBuffer->getIndex());
+            pBatch->passIBO(indexBuffer->getIndex());
+            pBatch->passTransformSSBO(transformSSBO->getIndex());
+            pBatch->passColorSSBO(colorSSBO->getIndex());
+        }
+
+        pPipeline->passVertexBuffer(vertexBuffer->getIndex());
+        pPipeline->passIndexBuffer(indexBuffer->getIndex());
+        pPipeline->passTransformSSBO(transformSSBO->getIndex());
+        pPipeline->passColorSSBO(colorSSBO->getIndex());
+        pPipeline->passIndirectBuffer(indirectBuffer->getIndex());
+        pPipeline->passDrawCommands(drawCommands);
+    }
+
+
     void FPipelineFactory::fillPipelineFor(FPipelineMeshColor* pPipeline,
                                            FMeshBatchStaticColor* pBatch) const {
-        createPipelineVBO(p_pRenderContext, pPipeline, pBatch);
-        createPipelineIBO(p_pRenderContext, pPipeline, pBatch);
+        pPipeline->passVertexFormat(FVertexFormat::getDefault());
+        FMeshBatchArenaInfo arenaInfo;
+        createPipelineVBO(p_pRenderContext, pPipeline, pBatch, arenaInfo);
+        createPipelineIBO(p_pRenderContext, pPipeline, pBatch, arenaInfo);
+        createPipelineDrawCommand(p_pRenderContext, pPipeline, pBatch, arenaInfo);
         createPipelineTransformsSSBO(p_pRenderContext, pPipeline, pBatch);
         createPipelineColorSSBO(p_pRenderContext, pPipeline, pBatch);
-        createPipelineShaders(p_pRenderContext, pPipeline);
+        createPipelineShaders(p_pRenderContext, pPipeline, pBatch);
+
+        pPipeline->passBufferStorage(p_pRenderContext->getBufferStorage());
+        pPipeline->passShadersStorage(p_pRenderContext->getShadersStorage());
+        pPipeline->passMaterialStorage(p_pRenderContext->getMaterialStorage());
+        pPipeline->create();
+    }
+
+    void FPipelineFactory::fillPipelineFor(FPipelineMeshColor* pPipeline,
+                                           FMeshBatchStorageStaticColor* pStorage) const {
+        const std::vector<FMeshBatchStaticColor*> batches{ getArenaBatches(pStorage) };
+        if(batches.empty()) {
+            return;
+        }
+
+        pPipeline->passVertexFormat(FVertexFormat::getDefault());
+        std::vector<FMeshBatchArenaInfo> arenaInfos(batches.size());
+        int32 vboIndex{ -1 };
+        int32 iboIndex{ -1 };
+        const std::vector<FMeshBatchStatic*> staticBatches(batches.cbegin(), batches.cend());
+        allocateArenaRanges(staticBatches, arenaInfos, pPipeline->getVertexFormat(), vboIndex, iboIndex);
+        createArenaPipeline(p_pRenderContext, pPipeline, batches, arenaInfos, vboIndex, iboIndex);
+
+        FShaderStagesPaths stagesPaths;
+        stagesPaths.vertex = pPipeline->getVertexFormat() == EVertexFormat::PACKED
+                           ? "resources/shaders/color_packed.vert.glsl"
+                           : "resources/shaders/color.vert.glsl";
+        stagesPaths.fragment = "resources/shaders/color.frag.glsl";
+        FShaders* pShaders{ p_pRenderContext->getShadersFactory()->emplaceCached(stagesPaths) };
+        pPipeline->passShaderPipeline(pShaders->getIndex());
 
         pPipeline->passBufferStorage(p_pRenderContext->getBufferStorage());
         pPipeline->passShadersStorage(p_pRenderContext->getShadersStorage());
@@ -23,12 +23,54 @@
 #include "../public/Pipeline.h"
 #include "../public/Buffer.h"
 #include "../public/MeshBatch.h"
+#include "../public/VertexFormat.h"
 
 
 namespace marengine {
 
 
-    static void fillDefaultVertexLayout(FVertexBuffer* const pVertexBuffer) {
+    static void fillPackedVertexLayout(FVertexBuffer* const pVertexBuffer) {
+        FVertexInputVariableInfo positionInfo;
+        positionInfo.inputType = EInputType::VEC3;
+        positionInfo.location = 0;
+        positionInfo.offset = offsetof(VertexPacked, VertexPacked::position);
+
+        FVertexInputVariableInfo normalInfo;
+        normalInfo.inputType = EInputType::VEC2_SNORM16;
+        normalInfo.location = 1;
+        normalInfo.offset = offsetof(VertexPacked, VertexPacked::normal);
+
+        FVertexInputVariableInfo texCoordsInfo;
+        texCoordsInfo.inputType = EInputType::VEC2_HALF;
+        texCoordsInfo.location = 2;
+        texCoordsInfo.offset = offsetof(VertexPacked, VertexPacked::textureCoordinates);
+
+        FVertexInputVariableInfo shapeIndexInfo;
+        shapeIndexInfo.inputType = EInputType::UINT;
+        shapeIndexInfo.location = 3;
+        shapeIndexInfo.offset = offsetof(VertexPacked, VertexPacked::shapeID);
+
+        FVertexInputDescription inputDescription;
+        inputDescription.binding = 0;
+        inputDescription.stride = sizeof(VertexPacked);
+
+        pVertexBuffer->setInputDescription(inputDescription);
+        pVertexBuffer->pushVariableInfo(positionInfo);
+        pVertexBuffer->pushVariableInfo(normalInfo);
+        pVertexBuffer->pushVariableInfo(texCoordsInfo);
+        pVertexBuffer->pushVariableInfo(shapeIndexInfo);
+    }
+
+    static void fillDefaultVertexLayout(FVertexBuffer* const pVertexBuffer, EVertexFormat format) {
+        // Vertex pages are shared between batches, so layout is pushed only for the first one
+        if(!pVertexBuffer->getInputDescription().inputVariables.empty()) {
+            return;
+        }
+        if(format == EVertexFormat::PACKED) {
+            fillPackedVertexLayout(pVertexBuffer);
+            return;
+        }
+
         FVertexInputVariableInfo positionInfo;
         positionInfo.inputType = EInputType::VEC3;
         positionInfo.location = 0;
@@ -62,13 +104,19 @@ namespace marengine {
 
     static void createPipelineVBO(FRenderContext* pContext,
                                   FPipelineMeshTex2D* pPipeline,
-                                  FMeshBatchStaticTex2D* pBatch) {
-        FVertexBuffer* const vertexBuffer{ pContext->getBufferFactory()->emplaceVBO() };
+                                  FMeshBatchStaticTex2D* pBatch,
+                                  FMeshBatchArenaInfo& arenaInfo) {
+        const EVertexFormat format{ pPipeline->getVertexFormat() };
+        const FVertexArray& vertices{ pBatch->getVertices() };
+        const FBufferAllocation allocation{
+            pContext->getBufferFactory()->allocateVertices(vertices.size(), format) };
+        FVertexBuffer* const vertexBuffer{ pContext->getBufferStorage()->getVBO(allocation.bufferIndex) };
 
-        fillDefaultVertexLayout(vertexBuffer);
+        fillDefaultVertexLayout(vertexBuffer, format);
 
-        vertexBuffer->create(GraphicLimits::sizeOfVertices);
-        vertexBuffer->update(pBatch->getVertices());
+        FVertexFormat::update(vertexBuffer, format, vertices, 0, vertices.size(), allocation.offset);
+        arenaInfo.verticesOffset = allocation.offset;
+        arenaInfo.verticesCapacity = allocation.capacity;
 
         pBatch->passVBO(vertexBuffer->getIndex());
         pPipeline->passVertexBuffer(vertexBuffer->getIndex());
@@ -76,30 +124,56 @@ namespace marengine {
 
     static void createPipelineIBO(FRenderContext* pContext,
                                   FPipelineMeshTex2D* pPipeline,
-                                  FMeshBatchStaticTex2D* pBatch) {
-        FIndexBuffer* const indexBuffer{ pContext->getBufferFactory()->emplaceIBO() };
-
+                                  FMeshBatchStaticTex2D* pBatch,
+                                  FMeshBatchArenaInfo& arenaInfo) {
+        const EIndexType indexType{ pBatch->getFittingIndexType() };
         const FIndicesArray& indices{ pBatch->getIndices() };
-        indexBuffer->create(GraphicLimits::sizeOfIndices);
-        indexBuffer->update(indices);
-        indexBuffer->passIndicesCount(indices.size());
+        const FBufferAllocation allocation{
+            pContext->getBufferFactory()->allocateIndices(indices.size(), indexType) };
+        FIndexBuffer* const indexBuffer{ pContext->getBufferStorage()->getIBO(allocation.bufferIndex) };
+
+        indexBuffer->updateIndices(indices, 0, indices.size(), allocation.offset);
+        arenaInfo.indicesOffset = allocation.offset;
+        arenaInfo.indicesCapacity = allocation.capacity;
+        arenaInfo.indexType = indexType;
 
         pBatch->passIBO(indexBuffer->getIndex());
         pPipeline->passIndexBuffer(indexBuffer->getIndex());
     }
 
-    static void fillDefaultTransformSSBO(FShaderBuffer* pTransformBuffer, uint32_t bindingPoint) {
+    static void createPipelineDrawCommand(FRenderContext* pContext,
+                                          FPipelineMeshTex2D* pPipeline,
+                                          FMeshBatchStaticTex2D* pBatch,
+                                          FMeshBatchArenaInfo& arenaInfo) {
+        arenaInfo.drawCommandIndex = 0;
+        pBatch->passArenaInfo(arenaInfo);
+
+        // Command is split around culled entities, so there is place for one command per entity
+        FIndirectBuffer* const indirectBuffer{ pContext->getBufferFactory()->emplaceIndirect() };
+        indirectBuffer->create(pBatch->getEntitiesBudget() * sizeof(FDrawIndirectCommand));
+
+        FDrawIndirectCommand command;
+        command.count = pBatch->getIndices().size();
+        command.firstIndex = arenaInfo.indicesOffset;
+        command.baseVertex = (int32)arenaInfo.verticesOffset;
+        pPipeline->passIndirectBuffer(indirectBuffer->getIndex());
+        pPipeline->passDrawCommands({ command });
+    }
+
+    static void fillDefaultTransformSSBO(FShaderBuffer* pTransformBuffer, uint32_t bindingPoint,
+                                         uint32 transformsCount) {
         FShaderInputDescription description;
         description.binding = bindingPoint;
         description.shaderStage = EShaderStage::VERTEX;
         description.bufferType = EBufferType::SSBO;
+        description.usage = EBufferUsage::PER_FRAME;
 
         FShaderInputVariableInfo inputInfo;
-        inputInfo.count = 32;
+        inputInfo.count = transformsCount;
         inputInfo.inputType = EInputType::MAT4;
-        inputInfo.name = "Transforms.Transform[32]";
+        inputInfo.name = "Transforms.Transform[]";
         inputInfo.offset = 0;
-        inputInfo.memoryUsed = 32 * sizeof(maths::mat4);
+        inputInfo.memoryUsed = transformsCount * sizeof(maths::mat4);
 
         pTransformBuffer->setInputDescription(description);
         pTransformBuffer->pushVariableInfo(inputInfo);
@@ -110,7 +184,7 @@ namespace marengine {
                                              FMeshBatchStaticTex2D* pBatch) {
         FShaderBuffer* const transformSSBO{ pContext->getBufferFactory()->emplaceSSBO() };
 
-        fillDefaultTransformSSBO(transformSSBO, 1);
+        fillDefaultTransformSSBO(transformSSBO, 1, pBatch->getEntitiesBudget());
         const FTransformsArray& transforms{ pBatch->getTransforms() };
         transformSSBO->create();
         transformSSBO->update(
@@ -119,44 +193,81 @@ namespace marengine {
                 transforms.size() * sizeof(maths::mat4)
         );
 
+        pBatch->clearDirtyTransforms();
         pBatch->passTransformSSBO(transformSSBO->getIndex());
         pPipeline->passTransformSSBO(transformSSBO->getIndex());
     }
 
+    static void fillDefaultTextureIndexesSSBO(FShaderBuffer* pTextureIndexesBuffer, uint32_t bindingPoint,
+                                              uint32 textureIndexesCount) {
+        FShaderInputDescription description;
+        description.binding = bindingPoint;
+        description.shaderStage = EShaderStage::FRAGMENT;
+        description.bufferType = EBufferType::SSBO;
+
+        FShaderInputVariableInfo inputInfo;
+        inputInfo.count = textureIndexesCount;
+        inputInfo.inputType = EInputType::OTHER;
+        inputInfo.name = "TextureIndexes.TextureIndex[]";
+        inputInfo.offset = 0;
+        inputInfo.memoryUsed = textureIndexesCount * sizeof(FTex2DShaderRef);
+
+        pTextureIndexesBuffer->setInputDescription(description);
+        pTextureIndexesBuffer->pushVariableInfo(inputInfo);
+    }
+
+    static void createPipelineTextureIndexesSSBO(FRenderContext* pContext,
+                                                 FPipelineMeshTex2D* pPipeline,
+                                                 FMeshBatchStaticTex2D* pBatch) {
+        FShaderBuffer* const textureIndexesSSBO{ pContext->getBufferFactory()->emplaceSSBO() };
+
+        fillDefaultTextureIndexesSSBO(textureIndexesSSBO, 6, pBatch->getEntitiesBudget());
+        const std::vector<FTex2DShaderRef>& textureIndexes{ pBatch->getTextureIndexes() };
+        textureIndexesSSBO->create();
+        textureIndexesSSBO->update(
+                (const uint32*)textureIndexes.data(),
+                0,
+                textureIndexes.size() * sizeof(FTex2DShaderRef)
+        );
+
+        pBatch->passTextureIndexesSSBO(textureIndexesSSBO->getIndex());
+        pPipeline->passTextureIndexesSSBO(textureIndexesSSBO->getIndex());
+    }
+
     static void createSamplerUniformLocations(FPipelineMeshTex2D* pPipeline) {
         constexpr std::array<const char*, 32> samplerArray = {
-                "samplerTexture2D[0]",
-                "samplerTexture2D[1]",
-                "samplerTexture2D[2]",
-                "samplerTexture2D[3]",
-                "samplerTexture2D[4]",
-                "samplerTexture2D[5]",
-                "samplerTexture2D[6]",
-                "samplerTexture2D[7]",
-                "samplerTexture2D[8]",
-                "samplerTexture2D[9]",
-                "samplerTexture2D[10]",
-                "samplerTexture2D[11]",
-                "samplerTexture2D[12]",
-                "samplerTexture2D[13]",
-                "samplerTexture2D[14]",
-                "samplerTexture2D[15]",
-                "samplerTexture2D[16]",
-                "samplerTexture2D[17]",
-                "samplerTexture2D[18]",
-                "samplerTexture2D[19]",
-                "samplerTexture2D[20]",
-                "samplerTexture2D[21]",
-                "samplerTexture2D[22]",
-                "samplerTexture2D[23]",
-                "samplerTexture2D[24]",
-                "samplerTexture2D[25]",
-                "samplerTexture2D[26]",
-                "samplerTexture2D[27]",
-                "samplerTexture2D[28]",
-                "samplerTexture2D[29]",
-                "samplerTexture2D[30]",
-                "samplerTexture2D[31]"
+                "samplerTexture2DArray[0]",
+                "samplerTexture2DArray[1]",
+                "samplerTexture2DArray[2]",
+                "samplerTexture2DArray[3]",
+                "samplerTexture2DArray[4]",
+                "samplerTexture2DArray[5]",
+                "samplerTexture2DArray[6]",
+                "samplerTexture2DArray[7]",
+                "samplerTexture2DArray[8]",
+                "samplerTexture2DArray[9]",
+                "samplerTexture2DArray[10]",
+                "samplerTexture2DArray[11]",
+                "samplerTexture2DArray[12]",
+                "samplerTexture2DArray[13]",
+                "samplerTexture2DArray[14]",
+                "samplerTexture2DArray[15]",
+                "samplerTexture2DArray[16]",
+                "samplerTexture2DArray[17]",
+                "samplerTexture2DArray[18]",
+                "samplerTexture2DArray[19]",
+                "samplerTexture2DArray[20]",
+                "samplerTexture2DArray[21]",
+                "samplerTexture2DArray[22]",
+                "samplerTexture2DArray[23]",
+                "samplerTexture2DArray[24]",
+                "samplerTexture2DArray[25]",
+                "samplerTexture2DArray[26]",
+                "samplerTexture2DArray[27]",
+                "samplerTexture2DArray[28]",
+                "samplerTexture2DArray[29]",
+                "samplerTexture2DArray[30]",
+                "samplerTexture2DArray[31]"
         };
 
         pPipeline->passSamplerArray(samplerArray);
@@ -171,28 +282,147 @@ namespace marengine {
     }
 
     static void createPipelineShaders(FRenderContext* pContext,
-                                      FPipelineMeshTex2D* pPipeline) {
-        FShaders* pShaders{ pContext->getShadersFactory()->emplace() };
-        pShaders->passVertex("resources/shaders/texture2d.vert.glsl");
-        pShaders->passFragment("resources/shaders/texture2d.frag.glsl");
-        pShaders->compile();
+                                      FPipelineMeshTex2D* pPipeline,
+                                      FMeshBatchStaticTex2D* pBatch) {
+        const bool packed{ pPipeline->getVertexFormat() == EVertexFormat::PACKED };
+        FShaderStagesPaths stagesPaths;
+        if(pBatch->isInstanced()) {
+            stagesPaths.vertex = packed ? "resources/shaders/texture2d_instanced_packed.vert.glsl"
+                                        : "resources/shaders/texture2d_instanced.vert.glsl";
+            pPipeline->passInstancesCount(pBatch->getInstancesCount());
+        }
+        else {
+            stagesPaths.vertex = packed ? "resources/shaders/texture2d_packed.vert.glsl"
+                                        : "resources/shaders/texture2d.vert.glsl";
+        }
+        if(pContext->getMaterialStorage()->isBindless()) {
+            stagesPaths.fragment = "resources/shaders/texture2d_bindless.frag.glsl";
+        }
+        else {
+            stagesPaths.fragment = "resources/shaders/texture2d.frag.glsl";
+        }
+        FShaders* pShaders{ pContext->getShadersFactory()->emplaceCached(stagesPaths) };
         pPipeline->passShaderPipeline(pShaders->getIndex());
     }
 
+    static void createArenaPipeline(FRenderContext* pContext,
+                                    FPipelineMeshTex2D* pPipeline,
+                                    const std::vector<FMeshBatchStaticTex2D*>& batches,
+                                    std::vector<FMeshBatchArenaInfo>& arenaInfos,
+                                    int32 vboIndex, int32 iboIndex) {
+        FBufferFactory* const pBufferFactory{ pContext->getBufferFactory() };
+        FBufferStorage* const pBufferStorage{ pContext->getBufferStorage() };
+        const EVertexFormat format{ pPipeline->getVertexFormat() };
+
+        FVertexBuffer* const vertexBuffer{ pBufferStorage->getVBO(vboIndex) };
+        FIndexBuffer* const indexBuffer{ pBufferStorage->getIBO(iboIndex) };
+        FShaderBuffer* const transformSSBO{ pBufferFactory->emplaceSSBO() };
+        FShaderBuffer* const textureIndexesSSBO{ pBufferFactory->emplaceSSBO() };
+        FIndirectBuffer* const indirectBuffer{ pBufferFactory->emplaceIndirect() };
+
+        uint32 entitiesBudget{ 0 };
+        FDrawIndirectCommandsArray drawCommands;
+        for(uint32 i = 0; i < batches.size(); i++) {
+            FMeshBatchStaticTex2D* pBatch{ batches[i] };
+
+            FMeshBatchArenaInfo& arenaInfo{ arenaInfos[i] };
+            arenaInfo.transformsOffset = entitiesBudget;
+            arenaInfo.drawCommandIndex = (int32)i;
+            pBatch->passArenaInfo(arenaInfo);
+            entitiesBudget += pBatch->getEntitiesBudget();
+
+            FDrawIndirectCommand& command{ drawCommands.emplace_back() };
+            command.count = pBatch->getIndices().size();
+            command.instanceCount = 1;
+            command.firstIndex = arenaInfo.indicesOffset;
+            command.baseVertex = (int32)arenaInfo.verticesOffset;
+            command.baseInstance = arenaInfo.transformsOffset;
+        }
+
+        fillDefaultVertexLayout(vertexBuffer, format);
+        fillDefaultTransformSSBO(transformSSBO, 1, entitiesBudget);
+        transformSSBO->create();
+        fillDefaultTextureIndexesSSBO(textureIndexesSSBO, 6, entitiesBudget);
+        textureIndexesSSBO->create();
+        // Commands are split around culled entities, so there is place for one command per entity
+        indirectBuffer->create(entitiesBudget * sizeof(FDrawIndirectCommand));
+
+        for(FMeshBatchStaticTex2D* pBatch : batches) {
+            const FMeshBatchArenaInfo& arenaInfo{ pBatch->getArenaInfo() };
+            const FVertexArray& vertices{ pBatch->getVertices() };
+            const FIndicesArray& indices{ pBatch->getIndices() };
+            const FTransformsArray& transforms{ pBatch->getTransforms() };
+            const std::vector<FTex2DShaderRef>& textureIndexes{ pBatch->getTextureIndexes() };
+
+            FVertexFormat::update(vertexBuffer, format, vertices, 0, vertices.size(), arenaInfo.verticesOffset);
+            indexBuffer->updateIndices(indices, 0, indices.size(), arenaInfo.indicesOffset);
+            transformSSBO->update(maths::mat4::value_ptr(transforms),
+                                  arenaInfo.transformsOffset * sizeof(maths::mat4),
+                                  transforms.size() * sizeof(maths::mat4));
+            textureIndexesSSBO->update((const uint32*)textureIndexes.data(),
+                                       arenaInfo.transformsOffset * sizeof(FTex2DShaderRef),
+                                       textureIndexes.size() * sizeof(FTex2DShaderRef));
+
+            pBatch->clearDirtyTransforms();
+            pBatch->lockSamplers();
+            pBatch->passVBO(vertexBuffer->getIndex());
+            pBatch->passIBO(indexBuffer->getIndex());
+            pBatch->passTransformSSBO(transformSSBO->getIndex());
+            pBatch->passTextureIndexesSSBO(textureIndexesSSBO->getIndex());
+        }
+
+        pPipeline->passVertexBuffer(vertexBuffer->getIndex());
+        pPipeline->passIndexBuffer(indexBuffer->getIndex());
+        pPipeline->passTransformSSBO(transformSSBO->getIndex());
+        pPipeline->passTextureIndexesSSBO(textureIndexesSSBO->getIndex());
+        pPipeline->passIndirectBuffer(indirectBuffer->getIndex());
+        pPipeline->passDrawCommands(drawCommands);
+    }
+
 
     void FPipelineFactory::fillPipelineFor(FPipelineMeshTex2D* pPipeline,
                                            FMeshBatchStaticTex2D* pBatch) const {
+        pPipeline->passVertexFormat(FVertexFormat::getDefault());
         pPipeline->passBufferStorage(p_pRenderContext->getBufferStorage());
         pPipeline->passShadersStorage(p_pRenderContext->getShadersStorage());
         pPipeline->passMaterialStorage(p_pRenderContext->getMaterialStorage());
 
-        createPipelineVBO(p_pRenderContext, pPipeline, pBatch);
-        createPipelineIBO(p_pRenderContext, pPipeline, pBatch);
+        FMeshBatchArenaInfo arenaInfo;
+        createPipelineVBO(p_pRenderContext, pPipeline, pBatch, arenaInfo);
+        createPipelineIBO(p_pRenderContext, pPipeline, pBatch, arenaInfo);
+        createPipelineDrawCommand(p_pRenderContext, pPipeline, pBatch, arenaInfo);
         createPipelineTransformsSSBO(p_pRenderContext, pPipeline, pBatch);
-        createPipelineShaders(p_pRenderContext, pPipeline);
+        createPipelineTextureIndexesSSBO(p_pRenderContext, pPipeline, pBatch);
+        createPipelineShaders(p_pRenderContext, pPipeline, pBatch);
+        createSamplerUniformLocations(pPipeline);
+        const auto& textures{ pBatch->getTextures() };
+        for (int32 texInd : textures) {
+            pPipeline->passTexture(texInd);
+        }
+        pPipeline->create();
+    }
+
+    void FPipelineFactory::fillPipelineFor(FPipelineMeshTex2D* pPipeline,
+                                           const std::vector<FMeshBatchStaticTex2D*>& batches) const {
+        if(batches.empty()) {
+            return;
+        }
+
+        pPipeline->passVertexFormat(FVertexFormat::getDefault());
+        pPipeline->passBufferStorage(p_pRenderContext->getBufferStorage());
+        pPipeline->passShadersStorage(p_pRenderContext->getShadersStorage());
+        pPipeline->passMaterialStorage(p_pRenderContext->getMaterialStorage());
+
+        std::vector<FMeshBatchArenaInfo> arenaInfos(batches.size());
+        int32 vboIndex{ -1 };
+        int32 iboIndex{ -1 };
+        const std::vector<FMeshBatchStatic*> staticBatches(batches.cbegin(), batches.cend());
+        allocateArenaRanges(staticBatches, arenaInfos, pPipeline->getVertexFormat(), vboIndex, iboIndex);
+        createArenaPipeline(p_pRenderContext, pPipeline, batches, arenaInfos, vboIndex, iboIndex);
+        createPipelineShaders(p_pRenderContext, pPipeline, batches.front());
         createSamplerUniformLocations(pPipeline);
-        const auto& textureIndexes{ pBatch->getTextureIndexes() };
-        for (int32 texInd : textureIndexes) {
+        // Every batch binds the same texture arrays at the same samplers, so the first one is bound
+        for (int32 texInd : batches.front()->getTextures()) {
             pPipeline->passTexture(texInd);
         }
         pPipeline->create();
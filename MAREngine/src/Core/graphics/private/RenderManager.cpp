@@ -87,6 +87,10 @@ namespace marengine {
         return m_pRenderCamera != nullptr;
     }
 
+    const FRenderCamera* FRenderManager::getCamera() const {
+        return m_pRenderCamera;
+    }
+
     FFramebuffer* FRenderManager::getViewportFramebuffer() const {
         return m_pContext->getFramebufferStorage()->get(m_viewportFbIndex);
     }
@@ -103,11 +107,72 @@ namespace marengine {
                 continue;
             }
             auto* pPipeline{ pPipelineFactory->emplaceMeshAndFill(pMeshBatch) };
+            pMeshBatch->passPipeline(pPipeline->getIndex());
             pPipeline->passCameraSSBO(cameraIndex);
             pPipeline->passPointLightSSBO(pointLightIndex);
         }
     }
 
+    static void prepareIndirectPipelineForOnlyBindState(FMeshBatchStorageStaticColor* pStorage,
+                                                        FPipelineFactory* pPipelineFactory,
+                                                        int32 cameraIndex, int32 pointLightIndex) {
+        const uint32 batchSize{ pStorage->getCount() };
+        const auto isBatchEmpty = [pStorage](uint32 i) {
+            const FMeshBatchStaticColor* pMeshBatch{ pStorage->get(i) };
+            return pMeshBatch->getVertices().empty() || pMeshBatch->getIndices().empty();
+        };
+
+        bool anyBatchToDraw{ false };
+        for (uint32 i = 0; i < batchSize; i++) {
+            if(!isBatchEmpty(i)) {
+                anyBatchToDraw = true;
+                break;
+            }
+        }
+        if(!anyBatchToDraw) {
+            return;
+        }
+
+        FPipelineMeshColor* pPipeline{ pPipelineFactory->emplaceMeshColor() };
+        pPipelineFactory->fillPipelineFor(pPipeline, pStorage);
+        pPipeline->passCameraSSBO(cameraIndex);
+        pPipeline->passPointLightSSBO(pointLightIndex);
+
+        for (uint32 i = 0; i < batchSize; i++) {
+            if(!isBatchEmpty(i)) {
+                pStorage->get(i)->passPipeline(pPipeline->getIndex());
+            }
+        }
+    }
+
+    static void prepareIndirectPipelinesForOnlyBindState(FMeshBatchStorageStaticTex2D* pStorage,
+                                                         FPipelineFactory* pPipelineFactory,
+                                                         int32 cameraIndex, int32 pointLightIndex) {
+        // Samplers are bound per pipeline, so batches binding the same texture arrays share one pipeline.
+        // With bindless textures no arrays are bound, so all of batches share it.
+        std::map<std::vector<int32>, std::vector<FMeshBatchStaticTex2D*>> batchesByTextures;
+        const uint32 batchSize{ pStorage->getCount() };
+        for (uint32 i = 0; i < batchSize; i++) {
+            FMeshBatchStaticTex2D* pMeshBatch{ pStorage->get(i) };
+            if(pMeshBatch->getVertices().empty() || pMeshBatch->getIndices().empty()) {
+                continue;
+            }
+            batchesByTextures[pMeshBatch->getTextures()].push_back(pMeshBatch);
+        }
+
+        for (const auto& texturesBatches : batchesByTextures) {
+            const std::vector<FMeshBatchStaticTex2D*>& batches{ texturesBatches.second };
+            FPipelineMeshTex2D* pPipeline{ pPipelineFactory->emplaceMeshTex2D() };
+            pPipelineFactory->fillPipelineFor(pPipeline, batches);
+            pPipeline->passCameraSSBO(cameraIndex);
+            pPipeline->passPointLightSSBO(pointLightIndex);
+
+            for (FMeshBatchStaticTex2D* pMeshBatch : batches) {
+                pMeshBatch->passPipeline(pPipeline->getIndex());
+            }
+        }
+    }
+
     void FRenderManager::onBatchesReadyToDraw(FBatchManager* pBatchManager) {
         FBufferFactory* const pBufferFactory{ m_pContext->getBufferFactory() };
         FPipelineFactory* const pPipelineFactory{ m_pContext->getPipelineFactory() };
@@ -120,12 +185,24 @@ namespace marengine {
         m_pointLightIndex = pBufferFactory->fillPointLightSSBO(pPointLightSSBO,
                                                                pLightBatch);
         pLightBatch->passLightSSBO(m_pointLightIndex);
+        pLightBatch->clearDirtyLights();
+
+        m_pContext->getMaterialStorage()->prepareTex2DArrays();
 
         FMeshBatchStorage* pMeshBatchStorage{ pBatchManager->getMeshBatchStorage() };
-        preparePipelineForOnlyBindState(pMeshBatchStorage->getStorageStaticColor(),
+        prepareIndirectPipelineForOnlyBindState(pMeshBatchStorage->getStorageStaticColor(),
+                                                pPipelineFactory, m_cameraIndex, m_pointLightIndex);
+        prepareIndirectPipelinesForOnlyBindState(pMeshBatchStorage->getStorageStaticTex2D(),
+                                                 pPipelineFactory, m_cameraIndex, m_pointLightIndex);
+        preparePipelineForOnlyBindState(pMeshBatchStorage->getStorageInstancedColor(),
                                         pPipelineFactory, m_cameraIndex, m_pointLightIndex);
-        preparePipelineForOnlyBindState(pMeshBatchStorage->getStorageStaticTex2D(),
+        preparePipelineForOnlyBindState(pMeshBatchStorage->getStorageInstancedTex2D(),
                                         pPipelineFactory, m_cameraIndex, m_pointLightIndex);
+        m_pContext->getShadersStorage()->logCompilationStats();
+
+        const FBufferStorage* pBufferStorage{ m_pContext->getBufferStorage() };
+        MARLOG_INFO(ELoggerType::GRAPHICS, "Vertex and index buffers: reserved {} bytes, used {} bytes",
+                    pBufferStorage->getReservedMemory(), pBufferStorage->getUsedMemory());
     }
 
 
@@ -23,11 +23,19 @@
 #include "../public/RenderManager.h"
 #include "../public/MeshBatch.h"
 #include "../public/LightBatch.h"
+#include "../public/Pipeline.h"
+#include "../public/VertexFormat.h"
 #include "OpenGL/GraphicsOpenGL.h"
 
 
 namespace marengine {
 
+    static FPipelineMesh* getBatchPipeline(FPipelineStorage* pPipelineStorage, const FMeshBatch* pBatch);
+
+    template<typename TElement>
+    static void updateDirtyRanges(const FShaderBuffer* pShaderBuffer, const float* pData, uint32 elementsCount,
+                                  uint32 offset, const FBatchDirtyRanges& dirtyRanges);
+
 
     template<>
     void FRenderManager::update<ERenderBatchUpdateType::TRANSFORM>(FMeshBatch* pBatch) const {
@@ -35,11 +43,17 @@ namespace marengine {
                 m_pContext->getBufferStorage()->getSSBO(pBatch->getTransformSSBO());
 
         const FTransformsArray& transforms{ pBatch->getTransforms() };
-        pShaderBuffer->update(
-                maths::mat4::value_ptr(transforms),
-                0,
-                transforms.size() * sizeof(maths::mat4)
-        );
+        if(transforms.empty()) {
+            pBatch->clearDirtyTransforms();
+            return;
+        }
+
+        updateDirtyRanges<maths::mat4>(pShaderBuffer,
+                                       maths::mat4::value_ptr(transforms),
+                                       transforms.size(),
+                                       pBatch->getArenaInfo().transformsOffset * sizeof(maths::mat4),
+                                       pBatch->getDirtyTransforms());
+        pBatch->clearDirtyTransforms();
     }
 
     template<>
@@ -51,12 +65,15 @@ namespace marengine {
 
         const uint32 lightSize{ pBatch->getCountLight() };
         const FShaderInputDescription& inputDescription{ pShaderBuffer->getInputDescription() };
-        {
+        if(lightSize != 0) {
             const FShaderInputVariableInfo& inputInfo{ inputDescription.inputVariables.at(0) };
-            pShaderBuffer->update(pBatch->getBatchData(),
-                                  inputInfo.offset,
-                                  inputInfo.typeSize() * lightSize);
+            updateDirtyRanges<FPointLight>(pShaderBuffer,
+                                           pBatch->getBatchData(),
+                                           lightSize,
+                                           inputInfo.offset,
+                                           pBatch->getDirtyLights());
         }
+        pBatch->clearDirtyLights();
         {
             const FShaderInputVariableInfo& inputInfo{ inputDescription.inputVariables.at(1) };
             pShaderBuffer->update(&lightSize,
@@ -73,13 +90,142 @@ namespace marengine {
                 m_pContext->getBufferStorage()->getSSBO(pBatch->getColorSSBO());
 
         const FColorsArray& colors{ pBatch->getColors() };
+        if(colors.empty()) {
+            pBatch->clearDirtyColors();
+            return;
+        }
+
+        updateDirtyRanges<maths::vec4>(pShaderBuffer,
+                                       maths::vec4::value_ptr(colors),
+                                       colors.size(),
+                                       pBatch->getArenaInfo().transformsOffset * sizeof(maths::vec4),
+                                       pBatch->getDirtyColors());
+        pBatch->clearDirtyColors();
+    }
+
+
+    template<>
+    void FRenderManager::update<ERenderBatchUpdateType::RENDERABLE_TEX2D>(
+            FMeshBatchStaticTex2D* pBatch) const {
+
+        FPipelineMeshTex2D* pPipeline =
+                m_pContext->getPipelineStorage()->getTex2DMesh(pBatch->getPipeline());
+
+        m_pContext->getMaterialStorage()->prepareTex2DArrays();
+        const std::vector<int32>& textures{ pBatch->getTextures() };
+        for(uint32 i = 0; i < textures.size(); i++) {
+            pPipeline->updateTexture(i, textures.at(i));
+        }
+        pPipeline->passTexturesCount((uint32)textures.size());
+
+        FShaderBuffer* pShaderBuffer =
+                m_pContext->getBufferStorage()->getSSBO(pBatch->getTextureIndexesSSBO());
+
+        const std::vector<FTex2DShaderRef>& textureIndexes{ pBatch->getTextureIndexes() };
         pShaderBuffer->update(
-                maths::vec4::value_ptr(colors),
-                0,
-                colors.size() * sizeof(maths::vec4)
+                (const uint32*)textureIndexes.data(),
+                pBatch->getArenaInfo().transformsOffset * sizeof(FTex2DShaderRef),
+                textureIndexes.size() * sizeof(FTex2DShaderRef)
         );
     }
 
+    template<>
+    void FRenderManager::update<ERenderBatchUpdateType::INSTANCES>(
+            FMeshBatchStatic* pBatch) const {
+
+        if(!pBatch->isInstanced()) {
+            return;
+        }
+
+        FPipelineMesh* pPipeline{ getBatchPipeline(m_pContext->getPipelineStorage(), pBatch) };
+        pPipeline->passInstancesCount(pBatch->getInstancesCount());
+    }
+
+    template<>
+    void FRenderManager::update<ERenderBatchUpdateType::VISIBILITY>(FMeshBatch* pBatch) const {
+        const FMeshBatchArenaInfo& arenaInfo{ pBatch->getArenaInfo() };
+        if(!arenaInfo.isValid()) {
+            return;
+        }
+
+        FPipelineMesh* pPipeline{ getBatchPipeline(m_pContext->getPipelineStorage(), pBatch) };
+        pPipeline->passCulledRanges(arenaInfo.drawCommandIndex, pBatch->getCulledRanges());
+        pBatch->clearCullingDirty();
+    }
+
+    template<>
+    void FRenderManager::update<ERenderBatchUpdateType::VERTICES>(
+            FMeshBatch* pBatch, const FMeshBatchRange& range) const {
+
+        FVertexBuffer* pVertexBuffer =
+                m_pContext->getBufferStorage()->getVBO(pBatch->getVBO());
+
+        const FVertexArray& vertices{ pBatch->getVertices() };
+        if(range.count == 0 || range.end() > vertices.size()) {
+            return;
+        }
+
+        const EVertexFormat format{ getBatchPipeline(m_pContext->getPipelineStorage(), pBatch)->getVertexFormat() };
+        FVertexFormat::update(pVertexBuffer, format, vertices, range.begin, range.count,
+                              pBatch->getArenaInfo().verticesOffset + range.begin);
+    }
+
+    template<>
+    void FRenderManager::update<ERenderBatchUpdateType::INDICES>(
+            FMeshBatch* pBatch, const FMeshBatchRange& range) const {
+
+        FIndexBuffer* pIndexBuffer =
+                m_pContext->getBufferStorage()->getIBO(pBatch->getIBO());
+
+        // Removing entity at the end of batch shrinks indices, so range may be partially (or fully) trimmed
+        const FIndicesArray& indices{ pBatch->getIndices() };
+        const FMeshBatchArenaInfo& arenaInfo{ pBatch->getArenaInfo() };
+        if(arenaInfo.isValid()) {
+            FPipelineMesh* pPipeline{ getBatchPipeline(m_pContext->getPipelineStorage(), pBatch) };
+            pPipeline->updateDrawCommand(arenaInfo.drawCommandIndex, (uint32)indices.size());
+        }
+        else {
+            pIndexBuffer->passIndicesCount((uint32)indices.size());
+        }
+        if(range.count == 0 || range.begin >= indices.size()) {
+            return;
+        }
+
+        const uint32 indicesCount{ std::min(range.end(), (uint32)indices.size()) - range.begin };
+        pIndexBuffer->updateIndices(indices, range.begin, indicesCount, arenaInfo.indicesOffset + range.begin);
+    }
+
+
+    template<typename TElement>
+    void updateDirtyRanges(const FShaderBuffer* pShaderBuffer, const float* pData, uint32 elementsCount,
+                           uint32 offset, const FBatchDirtyRanges& dirtyRanges) {
+        constexpr uint32 floatsPerElement{ sizeof(TElement) / sizeof(float) };
+        // Removing entity at the end of batch shrinks array, so dirty ranges may point past its size
+        for(const FMeshBatchRange& range : dirtyRanges.getRanges()) {
+            if(range.begin >= elementsCount) {
+                break;
+            }
+
+            const uint32 count{ std::min(range.end(), elementsCount) - range.begin };
+            pShaderBuffer->update(pData + range.begin * floatsPerElement,
+                                  offset + range.begin * sizeof(TElement),
+                                  count * sizeof(TElement));
+        }
+    }
+
+    FPipelineMesh* getBatchPipeline(FPipelineStorage* pPipelineStorage, const FMeshBatch* pBatch) {
+        switch(pBatch->getType()) {
+        case EBatchType::MESH_STATIC_COLOR:
+        case EBatchType::MESH_INSTANCED_COLOR:
+            return pPipelineStorage->getColorMesh(pBatch->getPipeline());
+        case EBatchType::MESH_STATIC_TEX2D:
+        case EBatchType::MESH_INSTANCED_TEX2D:
+            return pPipelineStorage->getTex2DMesh(pBatch->getPipeline());
+        default:
+            return nullptr;
+        }
+    }
+
 
 }
 
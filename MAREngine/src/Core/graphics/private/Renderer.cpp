@@ -24,6 +24,8 @@
 #include "../public/BatchManager.h"
 #include "../../ecs/SceneManagerEditor.h"
 #include "../../ecs/Scene.h"
+#include "../../ecs/Entity/Entity.h"
+#include "../../ecs/Entity/Components.h"
 
 
 namespace marengine {
@@ -44,21 +46,52 @@ namespace marengine {
         const uint32 count{ pBatchStorage->getCount() };
         for(uint32 i = 0; i < count; i++) {
             const auto pBatch{ pBatchStorage->get((int32) i) };
-            statsStorage.verticesCount += pBatch->getVertices().size();
-            statsStorage.indicesCount += pBatch->getIndices().size();
+            const uint32 instancesCount{ pBatch->isInstanced() ? pBatch->getInstancesCount() : 1 };
+            statsStorage.verticesCount += pBatch->getVertices().size() * instancesCount;
+            statsStorage.indicesCount += pBatch->getIndices().size() * instancesCount;
             statsStorage.trianglesCount += (statsStorage.indicesCount / 3);
             batchEntitiesCount += pBatch->getTransforms().size();
             statsStorage.allRendererEntitiesCount += pBatch->getTransforms().size();
         }
     }
 
+    template<typename TBatchStorageType>
+    void updateTextureBindsPerBatch(const TBatchStorageType* pBatchStorage, FRenderStatsStorage& statsStorage) {
+        const uint32 count{ pBatchStorage->getCount() };
+        for(uint32 i = 0; i < count; i++) {
+            statsStorage.textureBindsCount += pBatchStorage->get((int32) i)->getTextures().size();
+        }
+    }
+
+    static uint32 countTexturesReferencedByBatches(Scene* pScene);
+
     void FRenderStatistics::update(FSceneManagerEditor* pSceneManagerEditor) {
         const FMeshBatchStorage* pBatchStorage{ m_pBatchManager->getMeshBatchStorage() };
 
         updateStatisticsStoragePerBatch(pBatchStorage->getStorageStaticColor(), m_storage, m_storage.coloredEntitiesCount);
         updateStatisticsStoragePerBatch(pBatchStorage->getStorageStaticTex2D(), m_storage, m_storage.textured2dEntitiesCount);
-
-        m_storage.entitiesCount = pSceneManagerEditor->getScene()->getEntities().size();
+        updateStatisticsStoragePerBatch(pBatchStorage->getStorageInstancedColor(), m_storage, m_storage.coloredEntitiesCount);
+        updateStatisticsStoragePerBatch(pBatchStorage->getStorageInstancedTex2D(), m_storage, m_storage.textured2dEntitiesCount);
+
+        const FBatchUploadStats& uploadStats{ m_pBatchManager->getUploadStats() };
+        m_storage.transformsUploadedBytes = uploadStats.transformsBytes;
+        m_storage.colorsUploadedBytes = uploadStats.colorsBytes;
+        m_storage.lightsUploadedBytes = uploadStats.lightsBytes;
+        m_storage.bufferUpdatesCount = uploadStats.updatesCount;
+
+        const FBatchCullingStats& cullingStats{ m_pBatchManager->getCullingStats() };
+        m_storage.visibleEntitiesCount = cullingStats.visibleEntitiesCount;
+        m_storage.culledEntitiesCount = cullingStats.culledEntitiesCount;
+        m_storage.occludedEntitiesCount = cullingStats.occludedEntitiesCount;
+        m_storage.occludersCount = cullingStats.occludersCount;
+        m_storage.occlusionCullingTime = cullingStats.occlusionCullingTime;
+
+        updateTextureBindsPerBatch(pBatchStorage->getStorageStaticTex2D(), m_storage);
+        updateTextureBindsPerBatch(pBatchStorage->getStorageInstancedTex2D(), m_storage);
+
+        Scene* pScene{ pSceneManagerEditor->getScene() };
+        m_storage.texturesReferencedCount = countTexturesReferencedByBatches(pScene);
+        m_storage.entitiesCount = pScene->getEntitiesCount();
     }
 
     void FRenderStatistics::reset() {
@@ -70,6 +103,19 @@ namespace marengine {
         m_storage.coloredEntitiesCount = 0;
         m_storage.textured2dEntitiesCount = 0;
         m_storage.allRendererEntitiesCount = 0;
+        m_storage.transformsUploadedBytes = 0;
+        m_storage.colorsUploadedBytes = 0;
+        m_storage.lightsUploadedBytes = 0;
+        m_storage.bufferUpdatesCount = 0;
+        m_storage.stateCallsIssued = 0;
+        m_storage.stateCallsSkipped = 0;
+        m_storage.textureBindsCount = 0;
+        m_storage.texturesReferencedCount = 0;
+        m_storage.visibleEntitiesCount = 0;
+        m_storage.culledEntitiesCount = 0;
+        m_storage.occludedEntitiesCount = 0;
+        m_storage.occludersCount = 0;
+        m_storage.occlusionCullingTime = 0.f;
     }
 
     FRenderStatsStorage& FRenderStatistics::getStorage() {
@@ -77,4 +123,24 @@ namespace marengine {
     }
 
 
+    uint32 countTexturesReferencedByBatches(Scene* pScene) {
+        // Texture shared by two batches has to be bound for each of them, so pairs (batch, texture) are counted
+        std::vector<std::tuple<EBatchType, int32, int32>> batchTextures;
+        const auto view{ pScene->getView<CRenderable>() };
+        for(const entt::entity enttEntity : view) {
+            const auto& cRenderable{ view.get<CRenderable>(enttEntity) };
+            const bool isTex2DBatch{ cRenderable.batch.type == EBatchType::MESH_STATIC_TEX2D ||
+                                     cRenderable.batch.type == EBatchType::MESH_INSTANCED_TEX2D };
+            if(isTex2DBatch) {
+                batchTextures.emplace_back(cRenderable.batch.type, cRenderable.batch.index,
+                                           cRenderable.material.index);
+            }
+        }
+
+        std::sort(batchTextures.begin(), batchTextures.end());
+        const auto uniqueEnd{ std::unique(batchTextures.begin(), batchTextures.end()) };
+        return (uint32)std::distance(batchTextures.begin(), uniqueEnd);
+    }
+
+
 }
@@ -21,6 +21,7 @@
 
 
 #include "../public/Shaders.h"
+#include "../../../Logging/Logger.h"
 
 
 namespace marengine {
@@ -51,5 +52,110 @@ namespace marengine {
 
     }
 
+    void FShaders::passStages(const FShaderStagesPaths& stagesPaths) {
+        passVertex(stagesPaths.vertex);
+        passFragment(stagesPaths.fragment);
+        passGeometry(stagesPaths.geometry);
+        passTessEval(stagesPaths.tessEval);
+        passTessControl(stagesPaths.tessControl);
+        passCompute(stagesPaths.compute);
+    }
+
+    void FShaders::acquire() {
+        p_referencesCount++;
+    }
+
+    uint32 FShaders::release() {
+        if(p_referencesCount != 0) {
+            p_referencesCount--;
+        }
+        return p_referencesCount;
+    }
+
+    uint32 FShaders::getReferencesCount() const {
+        return p_referencesCount;
+    }
+
+
+    static FShaderStagesKey getStagesKey(const FShaderStagesPaths& stagesPaths) {
+        const auto toString = [](const char* path)->std::string {
+            return path != nullptr ? std::string(path) : std::string();
+        };
+        return {
+            toString(stagesPaths.vertex), toString(stagesPaths.fragment), toString(stagesPaths.geometry),
+            toString(stagesPaths.tessEval), toString(stagesPaths.tessControl), toString(stagesPaths.compute)
+        };
+    }
+
+    FShaders* FShadersStorage::retrieve(const FShaderStagesPaths& stagesPaths) const {
+        const auto it{ p_cachedIndexes.find(getStagesKey(stagesPaths)) };
+        if(it != p_cachedIndexes.cend()) {
+            return get(it->second);
+        }
+
+        return nullptr;
+    }
+
+    void FShadersStorage::cache(const FShaderStagesPaths& stagesPaths, int32 index) {
+        p_cachedIndexes[getStagesKey(stagesPaths)] = index;
+    }
+
+    void FShadersStorage::release(int32 index) {
+        FShaders* pShaders{ get(index) };
+        if(pShaders->release() != 0) {
+            return;
+        }
+
+        pShaders->close();
+        for(auto it = p_cachedIndexes.begin(); it != p_cachedIndexes.end(); ++it) {
+            if(it->second == index) {
+                p_cachedIndexes.erase(it);
+                break;
+            }
+        }
+    }
+
+
+    void FShadersStorage::passCompilation(const FShaders* pShaders, float milliseconds) {
+        p_compiledCount++;
+        if(pShaders->isLoadedFromBinary()) {
+            p_loadedFromBinaryCount++;
+        }
+        p_compilationTime += milliseconds;
+    }
+
+    void FShadersStorage::logCompilationStats() const {
+        if(p_compiledCount == 0) {
+            return;
+        }
+
+        const float hitRate{ 100.f * (float)p_loadedFromBinaryCount / (float)p_compiledCount };
+        MARLOG_INFO(ELoggerType::GRAPHICS, "Created {} shader programs in {} ms, binary cache hits {}/{} ({}%)",
+                    p_compiledCount, p_compilationTime, p_loadedFromBinaryCount, p_compiledCount, hitRate);
+    }
+
+
+    FShaders* FShadersFactory::emplaceCached(const FShaderStagesPaths& stagesPaths) {
+        FShadersStorage* pStorage{ p_pRenderContext->getShadersStorage() };
+        FShaders* pShaders{ pStorage->retrieve(stagesPaths) };
+        if(pShaders == nullptr) {
+            const FShaderStagesKey key{ getStagesKey(stagesPaths) };
+            MARLOG_DEBUG(ELoggerType::GRAPHICS, "Compiling shaders {} {}, as they are not cached yet",
+                         key.at(0), key.at(1));
+            const auto compilationStart{ std::chrono::high_resolution_clock::now() };
+            pShaders = emplace();
+            pShaders->passStages(stagesPaths);
+            pShaders->compile();
+            pStorage->cache(stagesPaths, pShaders->getIndex());
+            const std::chrono::duration<float, std::milli> compilationTime{
+                std::chrono::high_resolution_clock::now() - compilationStart
+            };
+            pStorage->passCompilation(pShaders, compilationTime.count());
+        }
+
+        pShaders->acquire();
+        return pShaders;
+    }
+
 
 }
@@ -0,0 +1,178 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+
+
+#include "../public/TextureAtlas.h"
+
+
+namespace marengine {
+
+
+    void FSkylinePacker::create(uint32 width, uint32 height) {
+        m_width = width;
+        m_height = height;
+        m_usedArea = 0;
+        m_skyline.clear();
+        m_skyline.push_back({ 0, 0, width });
+    }
+
+    bool FSkylinePacker::insert(uint32 width, uint32 height, uint32& x, uint32& y) {
+        uint32 bestSegment{ (uint32)m_skyline.size() };
+        uint32 bestTop{ m_height + 1 };
+        uint32 bestWidth{ m_width + 1 };
+
+        for(uint32 i = 0; i < m_skyline.size(); i++) {
+            uint32 landingY{ 0 };
+            if(!fitsAt(i, width, height, landingY)) {
+                continue;
+            }
+
+            // Bottom-left rule, the lowest top edge wins, narrower segment breaks the ties
+            const uint32 top{ landingY + height };
+            if(top < bestTop || (top == bestTop && m_skyline[i].width < bestWidth)) {
+                bestSegment = i;
+                bestTop = top;
+                bestWidth = m_skyline[i].width;
+                x = m_skyline[i].x;
+                y = landingY;
+            }
+        }
+
+        if(bestSegment == m_skyline.size()) {
+            return false;
+        }
+
+        addSkylineLevel(bestSegment, x, y, width, height);
+        m_usedArea += (uint64)width * height;
+        return true;
+    }
+
+    float FSkylinePacker::getOccupancy() const {
+        const uint64 area{ (uint64)m_width * m_height };
+        return area != 0 ? (float)m_usedArea / (float)area : 0.f;
+    }
+
+    bool FSkylinePacker::fitsAt(uint32 segment, uint32 width, uint32 height, uint32& y) const {
+        const uint32 x{ m_skyline[segment].x };
+        if(x + width > m_width) {
+            return false;
+        }
+
+        int64 widthLeft{ width };
+        y = m_skyline[segment].y;
+        while(widthLeft > 0) {
+            y = std::max(y, m_skyline[segment].y);
+            if(y + height > m_height) {
+                return false;
+            }
+            widthLeft -= m_skyline[segment].width;
+            segment++;
+        }
+
+        return true;
+    }
+
+    void FSkylinePacker::addSkylineLevel(uint32 segment, uint32 x, uint32 y, uint32 width, uint32 height) {
+        m_skyline.insert(m_skyline.begin() + segment, { x, y + height, width });
+
+        // Segments covered by new level are shortened from the left or removed entirely
+        for(uint32 i = segment + 1; i < m_skyline.size();) {
+            const FSegment& previous{ m_skyline[i - 1] };
+            const uint32 previousEnd{ previous.x + previous.width };
+            if(m_skyline[i].x >= previousEnd) {
+                break;
+            }
+
+            const uint32 shrink{ previousEnd - m_skyline[i].x };
+            if(m_skyline[i].width <= shrink) {
+                m_skyline.erase(m_skyline.begin() + i);
+                continue;
+            }
+
+            m_skyline[i].x += shrink;
+            m_skyline[i].width -= shrink;
+            break;
+        }
+
+        for(uint32 i = 0; i + 1 < m_skyline.size();) {
+            if(m_skyline[i].y == m_skyline[i + 1].y) {
+                m_skyline[i].width += m_skyline[i + 1].width;
+                m_skyline.erase(m_skyline.begin() + i + 1);
+                continue;
+            }
+            i++;
+        }
+    }
+
+
+    void FTextureAtlas::create(uint32 pageSize, uint32 padding) {
+        m_pageSize = pageSize;
+        m_padding = padding;
+        m_pages.clear();
+    }
+
+    bool FTextureAtlas::insert(uint32 width, uint32 height, FTextureAtlasRegion& region) {
+        const uint32 paddedWidth{ width + 2 * m_padding };
+        const uint32 paddedHeight{ height + 2 * m_padding };
+        if(paddedWidth > m_pageSize || paddedHeight > m_pageSize) {
+            return false;
+        }
+
+        uint32 x{ 0 };
+        uint32 y{ 0 };
+        for(uint32 i = 0; i < m_pages.size(); i++) {
+            if(m_pages[i].insert(paddedWidth, paddedHeight, x, y)) {
+                region = { i, x + m_padding, y + m_padding };
+                return true;
+            }
+        }
+
+        auto& page{ m_pages.emplace_back() };
+        page.create(m_pageSize, m_pageSize);
+        if(!page.insert(paddedWidth, paddedHeight, x, y)) {
+            return false;
+        }
+        region = { (uint32)m_pages.size() - 1, x + m_padding, y + m_padding };
+        return true;
+    }
+
+    uint32 FTextureAtlas::getPageCount() const {
+        return m_pages.size();
+    }
+
+    uint32 FTextureAtlas::getPageSize() const {
+        return m_pageSize;
+    }
+
+    float FTextureAtlas::getOccupancy() const {
+        if(m_pages.empty()) {
+            return 0.f;
+        }
+
+        float occupancy{ 0.f };
+        for(const FSkylinePacker& page : m_pages) {
+            occupancy += page.getOccupancy();
+        }
+        return occupancy / (float)m_pages.size();
+    }
+
+
+}
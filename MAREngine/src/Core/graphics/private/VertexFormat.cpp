@@ -0,0 +1,150 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+
+
+#include "../public/VertexFormat.h"
+#include "../public/Buffer.h"
+
+
+namespace marengine {
+
+
+    static int16_t toSnorm16(float value);
+
+
+    EVertexFormat FVertexFormat::s_defaultFormat{ EVertexFormat::FLOAT };
+    FVertexPackedArray FVertexFormat::s_packedVertices;
+
+    void FVertexFormat::setDefault(EVertexFormat format) {
+        s_defaultFormat = format;
+    }
+
+    EVertexFormat FVertexFormat::getDefault() {
+        return s_defaultFormat;
+    }
+
+    uint32 FVertexFormat::getStride(EVertexFormat format) {
+        if(format == EVertexFormat::PACKED) {
+            return sizeof(VertexPacked);
+        }
+        return sizeof(Vertex);
+    }
+
+    void FVertexFormat::update(FVertexBuffer* pVertexBuffer, EVertexFormat format, const FVertexArray& vertices,
+                               uint32 begin, uint32 count, uint32 offset) {
+        if(format == EVertexFormat::FLOAT) {
+            pVertexBuffer->update(&vertices.at(begin).position.x,
+                                  offset * sizeof(Vertex),
+                                  count * sizeof(Vertex));
+            return;
+        }
+
+        // Scratch array is reused between uploads, so that packing does not allocate every frame
+        s_packedVertices.resize(count);
+        for(uint32 i = 0; i < count; i++) {
+            s_packedVertices[i] = pack(vertices[begin + i]);
+        }
+        pVertexBuffer->update(&s_packedVertices.at(0).position.x,
+                              offset * sizeof(VertexPacked),
+                              count * sizeof(VertexPacked));
+    }
+
+    VertexPacked FVertexFormat::pack(const Vertex& vertex) {
+        VertexPacked packed;
+        packed.position = vertex.position;
+        encodeOctahedral(vertex.lightNormal, packed.normal[0], packed.normal[1]);
+        packed.textureCoordinates[0] = toHalf(vertex.textureCoordinates.x);
+        packed.textureCoordinates[1] = toHalf(vertex.textureCoordinates.y);
+        packed.shapeID = (uint32_t)(vertex.shapeID + 0.5f);
+        return packed;
+    }
+
+    void FVertexFormat::encodeOctahedral(const maths::vec3& normal, int16_t& x, int16_t& y) {
+        const float length{ std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z) };
+        if(length == 0.f) {
+            x = 0;
+            y = 0;
+            return;
+        }
+
+        float px{ normal.x / length };
+        float py{ normal.y / length };
+        if(normal.z < 0.f) {
+            // Lower hemisphere is folded over diagonals of the octahedron
+            const float foldedX{ (1.f - std::abs(py)) * (px >= 0.f ? 1.f : -1.f) };
+            const float foldedY{ (1.f - std::abs(px)) * (py >= 0.f ? 1.f : -1.f) };
+            px = foldedX;
+            py = foldedY;
+        }
+
+        x = toSnorm16(px);
+        y = toSnorm16(py);
+    }
+
+    uint16_t FVertexFormat::toHalf(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(float));
+
+        const uint32_t sign{ (bits >> 16) & 0x8000 };
+        const uint32_t exponent{ (bits >> 23) & 0xFF };
+        uint32_t mantissa{ bits & 0x7FFFFF };
+
+        if(exponent == 0xFF) {
+            return (uint16_t)(sign | 0x7C00 | (mantissa != 0 ? 0x200 : 0));
+        }
+
+        const int32_t halfExponent{ (int32_t)exponent - 127 + 15 };
+        if(halfExponent >= 0x1F) {
+            return (uint16_t)(sign | 0x7C00);
+        }
+        if(halfExponent <= 0) {
+            if(halfExponent < -10) {
+                return (uint16_t)sign;
+            }
+            // Denormal half, implicit leading bit is shifted into mantissa
+            mantissa |= 0x800000;
+            const uint32_t shift{ (uint32_t)(14 - halfExponent) };
+            uint32_t halfMantissa{ mantissa >> shift };
+            const uint32_t remainder{ mantissa & ((1u << shift) - 1) };
+            const uint32_t halfway{ 1u << (shift - 1) };
+            if(remainder > halfway || (remainder == halfway && (halfMantissa & 1))) {
+                halfMantissa++;
+            }
+            return (uint16_t)(sign | halfMantissa);
+        }
+
+        uint32_t half{ sign | ((uint32_t)halfExponent << 10) | (mantissa >> 13) };
+        const uint32_t remainder{ mantissa & 0x1FFF };
+        if(remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) {
+            // Carry may overflow into exponent, which correctly rounds up to next power of two (or infinity)
+            half++;
+        }
+        return (uint16_t)half;
+    }
+
+
+    int16_t toSnorm16(float value) {
+        const float clamped{ std::max(-1.f, std::min(1.f, value)) };
+        return (int16_t)std::round(clamped * 32767.f);
+    }
+
+
+}
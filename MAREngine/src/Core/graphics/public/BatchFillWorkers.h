@@ -0,0 +1,87 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+#ifndef MARENGINE_BATCHFILLWORKERS_H
+#define MARENGINE_BATCHFILLWORKERS_H
+
+
+#include "../../../mar.h"
+
+
+namespace marengine {
+
+    class FMeshBatchStatic;
+
+
+    /**
+     * @class FBatchFillWorkers BatchFillWorkers.h "Core/graphics/public/BatchFillWorkers.h"
+     * @brief Persistent worker threads, that fill mesh batches after FBatchManager::batchScene assignment
+     * pass (see FMeshBatchStatic::passDeferredFill). Threads are spawned once, at first big enough fill, and
+     * sleep between scene pushes. Small fills are done serially at calling thread.
+     */
+    class FBatchFillWorkers {
+    public:
+
+        FBatchFillWorkers() = default;
+        ~FBatchFillWorkers();
+
+        FBatchFillWorkers(const FBatchFillWorkers&) = delete;
+        FBatchFillWorkers& operator=(const FBatchFillWorkers&) = delete;
+
+        /**
+         * @brief Calls fillDeferred of every given batch and returns, when all of them are filled. Calling thread
+         * fills batches too.
+         * @param batches batches with deferred fill
+         * @param fillsCount count of deferred entities at all given batches, below
+         * GraphicLimits::minParallelFillsCount batches are filled serially
+         */
+        void fill(const std::vector<FMeshBatchStatic*>& batches, uint32 fillsCount);
+        /// @brief Wakes up and joins all workers, next fill spawns them again
+        void close();
+
+        MAR_NO_DISCARD uint32 getWorkersCount() const;
+
+    private:
+
+        void spawnWorkers();
+        void work(uint32 jobIndex);
+        void fillNextBatches();
+
+
+        std::vector<std::thread> m_workers;
+        std::mutex m_mutex;
+        /// @brief workers wait here for next job (m_jobIndex change) or close
+        std::condition_variable m_jobStarted;
+        /// @brief calling thread waits here, until every worker is done with current job
+        std::condition_variable m_jobFinished;
+        const std::vector<FMeshBatchStatic*>* m_pBatches{ nullptr };
+        /// @brief batches are handed out one by one, so that big batches do not leave other workers idle
+        std::atomic<uint32> m_nextBatch{ 0 };
+        uint32 m_jobIndex{ 0 };
+        uint32 m_busyWorkersCount{ 0 };
+        bool m_isClosing{ false };
+
+    };
+
+
+}
+
+
+#endif //MARENGINE_BATCHFILLWORKERS_H
@@ -28,6 +28,9 @@
 #include "Mesh.h"
 #include "MeshBatch.h"
 #include "LightBatch.h"
+#include "FrustumCuller.h"
+#include "OcclusionCuller.h"
+#include "BatchFillWorkers.h"
 
 
 namespace marengine {
@@ -37,19 +40,120 @@ namespace marengine {
     class FRenderManager;
     class FMeshStorage;
     class FMaterialStorage;
+    class FRenderCamera;
     struct CPointLight;
 
 
+    /// @brief Bytes and buffer updates issued by last FBatchManager::pushDirtyRangesToRender call
+    struct FBatchUploadStats {
+        uint32 transformsBytes{ 0 };
+        uint32 colorsBytes{ 0 };
+        uint32 lightsBytes{ 0 };
+        uint32 updatesCount{ 0 };
+    };
+
+
+    /// @brief Rendered entities tested against camera frustum and occluders by last FBatchManager::cullEntities call
+    struct FBatchCullingStats {
+        /// @brief inside of frustum and not occluded
+        uint32 visibleEntitiesCount{ 0 };
+        /// @brief outside of frustum
+        uint32 culledEntitiesCount{ 0 };
+        /// @brief inside of frustum, but hidden behind occluders
+        uint32 occludedEntitiesCount{ 0 };
+        uint32 occludersCount{ 0 };
+        /// @brief time of occlusion culling stage (rasterizing occluders and testing entities) in milliseconds
+        float occlusionCullingTime{ 0.f };
+    };
+
+
+    /**
+     * @class FOpenBatchList BatchManager.h "Core/graphics/public/BatchManager.h"
+     * @brief Batches of single type, that are still filled during FBatchManager::batchScene. Every batch type
+     * has its own list, in which batches are grouped by texture set of entities submitted to them (see
+     * getTextureSetKey) and entity tries only batches of its group. Meshes of any size share batches of the group.
+     * Batches only grow during batchScene, so batch rejecting an entity of its group is closed for good. Batches
+     * are filled up before new ones are created and finding batch for an entity does not check every batch
+     * at storage.
+     */
+    class FOpenBatchList {
+    public:
+
+        void reset();
+        void open(int32 textureSetKey, int32 batchIndex);
+        void close(int32 textureSetKey, int32 batchIndex);
+
+        /// @brief Returns open batches of given group, the newest one last
+        MAR_NO_DISCARD const std::vector<int32>& getBatches(int32 textureSetKey) const;
+
+        /**
+         * @brief Returns texture array sampled by entity. Every batch keeps sampler for array of entity, which
+         * opened it, so entity of the same group is never rejected for its texture. Entities without texture
+         * and all entities with bindless textures (no samplers at batch) fall into single group.
+         */
+        MAR_NO_DISCARD static int32 getTextureSetKey(const FMaterialStorage* pMaterialStorage,
+                                                     const CRenderable& cRenderable);
+
+    private:
+
+        std::unordered_map<int32, std::vector<int32>> m_batches;
+
+    };
+
+
     class FBatchManager : public IRenderResourceManager {
     public:
 
+        /**
+         * @brief Passes storages used by batches.
+         * @param pRenderManager may be nullptr, then scene is only batched and edited at CPU, nothing is
+         * uploaded (e.g. in benchmarks without graphics context)
+         */
         void create(FRenderManager* pRenderManager, FMeshStorage* pMeshStorage,
                     FMaterialStorage* pMaterialStorage);
         void reset() const;
 
         void pushSceneToRender(Scene* pScene);
+        /**
+         * @brief Assigns every entity of given scene to batches and fills them, nothing is uploaded
+         * (pushSceneToRender calls it between resetting and notifying render manager).
+         */
+        void batchScene(Scene* pScene);
         void pushEntityToRender(const Entity& entity);
 
+        /**
+         * @brief Inserts entity's CRenderable into already drawn batch, uploading only touched ranges.
+         * @return false if there is no drawn batch with place for entity (whole scene should be pushed again)
+         */
+        MAR_NO_DISCARD bool insertEntityToRender(const Entity& entity);
+        /// @brief Removes entity's CRenderable from its batch in place, without rebuilding other batches
+        void removeEntityFromRender(const Entity& entity);
+        /// @brief Rebatches only point lights from given scene and uploads them
+        void pushLightsToRender(Scene* pScene);
+        /**
+         * @brief Uploads transforms, colors and lights changed with update<TComponent> since last call.
+         * Should be called once per frame, before drawing.
+         */
+        void pushDirtyRangesToRender();
+        /**
+         * @brief Selects level of detail of external meshes from their screen size at render camera. Only
+         * entities, that passed culling at last cullEntities call, are checked, one slice of them per frame
+         * (see GraphicLimits::levelOfDetailSlicesCount). Entities crossing level boundary (with hysteresis) are
+         * moved between drawn batches, entity without place for new level keeps the current one until scene
+         * is pushed again. Should be called once per frame, before drawing.
+         */
+        void updateLevelsOfDetail(Scene* pScene);
+        /**
+         * @brief Culls rendered entities of given scene against render camera frustum and afterwards against
+         * depth of the biggest visible entities (see FOcclusionCulling). Indices (or instance) of culled entity
+         * are left out of draw commands of its batch, which are rebuilt and uploaded only when visibility changes.
+         * Should be called once per frame, before pushDirtyRangesToRender.
+         */
+        void cullEntities(Scene* pScene);
+
+        MAR_NO_DISCARD const FBatchUploadStats& getUploadStats() const;
+        MAR_NO_DISCARD const FBatchCullingStats& getCullingStats() const;
+
         template<typename TComponent>
         void update(const Entity& entity) const { }
 
@@ -60,9 +164,38 @@ namespace marengine {
 
     private:
 
+        /// @brief returns true, if mesh of given CRenderable is shared by enough entities to be instanced
+        MAR_NO_DISCARD bool isMeshInstanced(const CRenderable& cRenderable) const;
+        /// @brief rasterizes occluders and marks frustum visible entities hidden behind them at m_occludedEntities
+        void cullOccludedEntities(const FRenderCamera* pRenderCamera, entt::registry* pSceneRegistry);
+
+
         FMeshBatchFactory m_meshBatchFactory;
         FLightBatchFactory m_lightFactory;
+        /// @brief count of entities using given mesh, valid only during batchScene
+        std::unordered_map<const FMeshProxy*, uint32> m_meshUsagesCount;
+        /// @brief batches still filled with entities, valid only during batchScene
+        FOpenBatchList m_openStaticColor;
+        FOpenBatchList m_openStaticTex2D;
+        /// @brief instanced batch still filled for given mesh (see getInstancedMeshKey), valid only during
+        /// batchScene
+        std::unordered_map<int64, int32> m_openInstancedColor;
+        std::unordered_map<int64, int32> m_openInstancedTex2D;
+        FBatchUploadStats m_uploadStats;
+        FFrustumCuller m_frustumCuller;
+        /// @brief entities, which bounds were pushed to m_frustumCuller, valid only during cullEntities
+        std::vector<entt::entity> m_cullableEntities;
+        FOcclusionCuller m_occlusionCuller;
+        /// @brief 1 if entity at the same index of m_cullableEntities is occluded, valid only during cullEntities
+        std::vector<uint32_t> m_occludedEntities;
+        /// @brief entities, that passed culling at last cullEntities, only their levels of detail are selected
+        std::vector<entt::entity> m_visibleEntities;
+        uint32 m_levelOfDetailSlice{ 0 };
+        FBatchCullingStats m_cullingStats;
+        FBatchFillWorkers m_fillWorkers;
         FRenderManager* m_pRenderManager{ nullptr };
+        FMeshStorage* m_pMeshStorage{ nullptr };
+        FMaterialStorage* m_pMaterialStorage{ nullptr };
 
     };
 
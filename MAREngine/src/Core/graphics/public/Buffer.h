@@ -25,6 +25,7 @@
 
 
 #include "IBuffer.h"
+#include "BufferArena.h"
 #include "Shaders.h"
 
 
@@ -51,11 +52,28 @@ namespace marengine {
 
         void passIndicesCount(uint32 indicesCount) final;
         MAR_NO_DISCARD uint32 getIndicesCount() const final;
+        void passIndexType(EIndexType indexType) final;
+        MAR_NO_DISCARD EIndexType getIndexType() const final;
+
+        void updateIndices(const FIndicesArray& indices, uint32 begin, uint32 count, uint32 offset) const final;
 
     protected:
 
         int64 p_allocatedMemory{ 0 };
         uint32 p_indicesCount{ 0 };
+        EIndexType p_indexType{ EIndexType::UINT32 };
+
+    private:
+
+        static std::vector<uint16_t> s_shortIndices;
+
+    };
+
+
+    class FIndirectBuffer : public IIndirectBuffer {
+    protected:
+
+        int64 p_allocatedMemory{ 0 };
 
     };
 
@@ -75,6 +93,22 @@ namespace marengine {
 
 
     class FBufferStorage : public IBufferStorage {
+    public:
+
+        MAR_NO_DISCARD int64 getReservedMemory() const final;
+        MAR_NO_DISCARD int64 getUsedMemory() const final;
+
+        /// @brief vertices of every format live at separate pages, as their stride differs
+        MAR_NO_DISCARD FBufferArena* getVertexArena(EVertexFormat format);
+        /// @brief 16-bit and 32-bit indices live at separate pages, so that single draw reads one type
+        MAR_NO_DISCARD FBufferArena* getIndexArena(EIndexType indexType);
+
+    protected:
+
+        FBufferArena p_vertexArena{ sizeof(Vertex), GraphicLimits::defaultVerticesPageCount };
+        FBufferArena p_packedVertexArena{ sizeof(VertexPacked), GraphicLimits::defaultVerticesPageCount };
+        FBufferArena p_indexArena{ sizeof(uint32), GraphicLimits::defaultIndicesPageCount };
+        FBufferArena p_shortIndexArena{ sizeof(uint16_t), GraphicLimits::defaultIndicesPageCount };
 
     };
 
@@ -82,6 +116,15 @@ namespace marengine {
     class FBufferFactory : public IBufferFactory {
     public:
 
+        /// @brief sub-allocates vertices at any page with free space, pushing new page if every one is full
+        MAR_NO_DISCARD FBufferAllocation allocateVertices(uint32 verticesCount, EVertexFormat format) final;
+        /// @brief sub-allocates indices at any page with free space, pushing new page if every one is full
+        MAR_NO_DISCARD FBufferAllocation allocateIndices(uint32 indicesCount, EIndexType indexType) final;
+        /// @brief creates new vertex page able to hold at least verticesCount, returns its VBO index
+        MAR_NO_DISCARD int32 emplaceVerticesPage(uint32 verticesCount, EVertexFormat format) final;
+        /// @brief creates new index page able to hold at least indicesCount, returns its IBO index
+        MAR_NO_DISCARD int32 emplaceIndicesPage(uint32 indicesCount, EIndexType indexType) final;
+
         MAR_NO_DISCARD uint32 fillCameraSSBO(FShaderBuffer* const pShaderBuffer,
                                              const FRenderCamera* const pRenderCamera) const final;
         MAR_NO_DISCARD uint32 fillPointLightSSBO(FShaderBuffer* const pShaderBuffer,
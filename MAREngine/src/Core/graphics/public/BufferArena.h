@@ -0,0 +1,105 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+
+
+#ifndef MARENGINE_FBUFFERARENA_H
+#define MARENGINE_FBUFFERARENA_H
+
+
+#include "IBuffer.h"
+
+
+namespace marengine {
+
+
+    /// @brief Buddy allocator over single power-of-two page, all sizes and offsets are counted in elements.
+    /// Only bookkeeping is done here, memory itself lives at GPU buffer backing the page.
+    class FBuddyAllocator {
+    public:
+
+        void create(uint32 capacity, uint32 minBlockCapacity);
+        void reset();
+
+        /// @brief finds smallest free block that can hold count elements, returns false if page is full
+        MAR_NO_DISCARD bool allocate(uint32 count, uint32& offset, uint32& blockCapacity);
+        /// @brief returns block back to page, merging it with its free buddies
+        void free(uint32 offset);
+
+        MAR_NO_DISCARD uint32 getCapacity() const;
+
+    private:
+
+        MAR_NO_DISCARD uint32 getOrder(uint32 count) const;
+
+
+        std::vector<std::vector<uint32>> m_freeBlocks;
+        std::unordered_map<uint32, uint32> m_allocatedOrders;
+        uint32 m_capacity{ 0 };
+        uint32 m_minBlockCapacity{ 0 };
+
+    };
+
+
+    /// @brief Hands out exact-size sub-ranges of few big vertex / index buffers (pages) to batches.
+    /// New page is pushed by buffer factory, when none of existing ones can hold requested range.
+    class FBufferArena {
+    public:
+
+        FBufferArena(uint32 elementSize, uint32 defaultPageCapacity);
+
+        MAR_NO_DISCARD FBufferAllocation allocate(uint32 count);
+        MAR_NO_DISCARD FBufferAllocation allocate(uint32 count, int32 bufferIndex);
+        void free(const FBufferAllocation& allocation);
+
+        void pushPage(int32 bufferIndex, uint32 capacity);
+        void reset();
+
+        /// @brief returns capacity of page, that should be pushed in order to hold count elements
+        MAR_NO_DISCARD uint32 getPageCapacity(uint32 count) const;
+        /// @brief returns count of elements, that is really reserved when count elements are requested
+        MAR_NO_DISCARD static uint32 getBlockCapacity(uint32 count);
+        MAR_NO_DISCARD uint32 getElementSize() const;
+
+        /// @brief returns memory of all pages in bytes
+        MAR_NO_DISCARD int64 getReservedMemory() const;
+        /// @brief returns memory requested by all live allocations in bytes
+        MAR_NO_DISCARD int64 getUsedMemory() const;
+
+    private:
+
+        struct FPage {
+            FBuddyAllocator allocator;
+            int32 bufferIndex{ -1 };
+        };
+
+        std::vector<FPage> m_pages;
+        int64 m_reservedCount{ 0 };
+        int64 m_usedCount{ 0 };
+        uint32 m_elementSize{ 0 };
+        uint32 m_defaultPageCapacity{ 0 };
+
+    };
+
+
+}
+
+
+#endif //MARENGINE_FBUFFERARENA_H
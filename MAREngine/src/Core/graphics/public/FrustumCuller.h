@@ -0,0 +1,88 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+
+
+#ifndef MARENGINE_FRUSTUMCULLER_H
+#define MARENGINE_FRUSTUMCULLER_H
+
+
+#include "IMesh.h"
+
+
+namespace marengine {
+
+
+    /**
+     * @class FFrustumCuller FrustumCuller.h "Core/graphics/public/FrustumCuller.h"
+     * @brief Tests world space bounds of meshes against camera frustum. Bounds are kept as structure of arrays
+     * (one array per component), so that culling loop has no branches and is vectorized by compiler. Every
+     * volume is intersection of its box and sphere sharing the same center, it is culled when either of them
+     * lies fully outside of some plane.
+     */
+    class FFrustumCuller {
+    public:
+
+        /**
+         * @brief Computes normalized frustum planes (Gribb-Hartmann) from given view-projection matrix.
+         * Every plane is stored as (a, b, c, d), where a*x + b*y + c*z + d >= 0 contains inside of frustum.
+         * Order of planes is left, right, bottom, top, near, far.
+         */
+        MAR_NO_DISCARD static std::array<maths::vec4, 6> computePlanes(const maths::mat4& viewProjection);
+
+        /// @brief extracts normalized frustum planes from given view-projection matrix into culler
+        void extractPlanes(const maths::mat4& viewProjection);
+
+        void clear();
+        /// @brief transforms model space bounds with given model matrix and pushes them, returns their index
+        uint32 push(const FMeshBounds& bounds, const maths::mat4& transform);
+        void cull();
+
+        MAR_NO_DISCARD bool isVisible(uint32 index) const;
+        MAR_NO_DISCARD uint32 getCount() const;
+        MAR_NO_DISCARD uint32 getVisibleCount() const;
+
+    private:
+
+        static constexpr uint32 s_planesCount{ 6 };
+
+        /// @brief planes a*x + b*y + c*z + d >= 0 contain inside of frustum
+        std::array<float, s_planesCount> m_planeA{};
+        std::array<float, s_planesCount> m_planeB{};
+        std::array<float, s_planesCount> m_planeC{};
+        std::array<float, s_planesCount> m_planeD{};
+
+        std::vector<float> m_centerX;
+        std::vector<float> m_centerY;
+        std::vector<float> m_centerZ;
+        std::vector<float> m_extentX;
+        std::vector<float> m_extentY;
+        std::vector<float> m_extentZ;
+        std::vector<float> m_radius;
+        std::vector<uint32_t> m_visible;
+        uint32 m_visibleCount{ 0 };
+
+    };
+
+
+}
+
+
+#endif //MARENGINE_FRUSTUMCULLER_H
@@ -34,6 +34,7 @@ namespace marengine {
     class FShaderBuffer;
     class FVertexBuffer;
     class FIndexBuffer;
+    class FIndirectBuffer;
     struct FShaderInputDescription;
     struct FShaderInputVariableInfo;
 
@@ -50,6 +51,28 @@ namespace marengine {
         uint32 stride{ 0 };
     };
 
+    /// @brief Single indexed draw at indirect buffer, layout must match DrawElementsIndirectCommand
+    struct FDrawIndirectCommand {
+        uint32 count{ 0 };
+        uint32 instanceCount{ 1 };
+        uint32 firstIndex{ 0 };
+        int32 baseVertex{ 0 };
+        uint32 baseInstance{ 0 };
+    };
+
+    typedef std::vector<FDrawIndirectCommand> FDrawIndirectCommandsArray;
+
+    /// @brief Sub-range of shared vertex / index buffer, offset and sizes are counted in elements.
+    /// Capacity is count of elements reserved for owner, count is the one requested by it.
+    struct FBufferAllocation {
+        int32 bufferIndex{ -1 };
+        uint32 offset{ 0 };
+        uint32 capacity{ 0 };
+        uint32 count{ 0 };
+
+        MAR_NO_DISCARD bool isValid() const { return bufferIndex != -1; }
+    };
+
 
     class IBuffer : public FRenderResource {
     public:
@@ -76,6 +99,8 @@ namespace marengine {
     class IVertexBuffer : public IMeshBuffer {
     public:
 
+        using IBuffer::update;
+
         virtual const FVertexInputDescription& getInputDescription() const = 0;
         virtual void setInputDescription(const FVertexInputDescription& inputDescription) = 0;
         virtual void pushVariableInfo(const FVertexInputVariableInfo& info) = 0;
@@ -88,10 +113,27 @@ namespace marengine {
     class IIndexBuffer : public IMeshBuffer {
     public:
 
+        using IBuffer::update;
+
         virtual void passIndicesCount(uint32 indicesCount) = 0;
         virtual uint32 getIndicesCount() const = 0;
+        virtual void passIndexType(EIndexType indexType) = 0;
+        virtual EIndexType getIndexType() const = 0;
 
         virtual void update(const FIndicesArray& indices) const = 0;
+        virtual void update(const uint16_t* data, uint32 offset, uint32 sizeOfData) const = 0;
+        /// @brief uploads count of indices starting at begin to buffer at element offset, narrowing them
+        /// first if buffer holds 16-bit indices
+        virtual void updateIndices(const FIndicesArray& indices, uint32 begin, uint32 count,
+                                   uint32 offset) const = 0;
+
+    };
+
+
+    class IIndirectBuffer : public IMeshBuffer {
+    public:
+
+        virtual void update(const FDrawIndirectCommandsArray& commands) const = 0;
 
     };
 
@@ -115,11 +157,21 @@ namespace marengine {
         virtual uint32 getCountUBO() const = 0;
         virtual uint32 getCountVBO() const = 0;
         virtual uint32 getCountIBO() const = 0;
+        virtual uint32 getCountIndirect() const = 0;
+
+        /// @brief Should be called after frame is drawn, moves PER_FRAME buffers to next free region
+        virtual void endFrame() = 0;
 
         virtual FShaderBuffer* getSSBO(int32 index) const = 0;
         virtual FShaderBuffer* getUBO(int32 index) const = 0;
         virtual FVertexBuffer* getVBO(int32 index) const = 0;
         virtual FIndexBuffer* getIBO(int32 index) const = 0;
+        virtual FIndirectBuffer* getIndirect(int32 index) const = 0;
+
+        /// @brief returns memory of all vertex / index pages in bytes
+        virtual int64 getReservedMemory() const = 0;
+        /// @brief returns memory of vertex / index pages handed out to batches in bytes
+        virtual int64 getUsedMemory() const = 0;
 
     };
 
@@ -131,6 +183,12 @@ namespace marengine {
         virtual FShaderBuffer* emplaceUBO() = 0;
         virtual FVertexBuffer* emplaceVBO() = 0;
         virtual FIndexBuffer* emplaceIBO() = 0;
+        virtual FIndirectBuffer* emplaceIndirect() = 0;
+
+        virtual FBufferAllocation allocateVertices(uint32 verticesCount, EVertexFormat format) = 0;
+        virtual FBufferAllocation allocateIndices(uint32 indicesCount, EIndexType indexType) = 0;
+        virtual int32 emplaceVerticesPage(uint32 verticesCount, EVertexFormat format) = 0;
+        virtual int32 emplaceIndicesPage(uint32 indicesCount, EIndexType indexType) = 0;
 
         virtual uint32 fillCameraSSBO(FShaderBuffer* const pShaderBuffer,
                                       const FRenderCamera* const pRenderCamera) const = 0;
@@ -31,6 +31,7 @@ namespace marengine {
 
     class FMaterialProxy;
     class FMaterialTex2D;
+    class FMaterialTex2DArray;
     struct CRenderable;
 
 
@@ -44,6 +45,36 @@ namespace marengine {
         int32 id{ -1 };
     };
 
+    /// @brief Where shaders find loaded texture, either by its bindless handle, or by layer of texture array
+    /// grouping all textures with the same resolution and format. Small textures are packed into atlas pages,
+    /// then uvRect (offset xy, scale zw) maps texture coordinates of mesh into its region at the page.
+    struct FTex2DPlacement {
+        maths::vec4 uvRect{ 0.f, 0.f, 1.f, 1.f };
+        uint64 handle{ 0 };
+        int32 arrayIndex{ -1 };
+        uint32 layer{ 0 };
+    };
+
+    /// @brief Texture reference of single entity read by Tex2D shaders. With bindless textures it is handle
+    /// split into low and high word, otherwise sampler of texture array bound at batch and layer at it.
+    /// Laid out as std430 struct, hence padding at the end.
+    struct FTex2DShaderRef {
+        maths::vec4 uvRect{ 0.f, 0.f, 1.f, 1.f };
+        uint32 first{ 0 };
+        uint32 second{ 0 };
+        uint32 padding[2]{ 0, 0 };
+    };
+
+    /// @brief Part of texture array layer filled with single texture, whole layer if array is not an atlas
+    struct FTex2DArrayRegion {
+        int32 textureIndex{ -1 };
+        uint32 layer{ 0 };
+        uint32 x{ 0 };
+        uint32 y{ 0 };
+        uint32 width{ 0 };
+        uint32 height{ 0 };
+    };
+
 
     class IMaterialProxy : public FRenderResource {
     public:
@@ -57,11 +88,43 @@ namespace marengine {
     };
 
 
+    class IMaterialTex2DArray : public FRenderResource {
+    public:
+
+        /// @brief (re)creates texture array with every layer pushed so far
+        virtual void create() = 0;
+        virtual void destroy() = 0;
+        virtual void bind(uint32 unit) const = 0;
+
+        virtual void passFormat(uint32 width, uint32 height, uint32 channels) = 0;
+        virtual bool isMatching(uint32 width, uint32 height, uint32 channels) const = 0;
+        virtual uint32 pushLayer(int32 textureIndex) = 0;
+        virtual bool isDirty() const = 0;
+
+        /// @brief makes array an atlas, which layers are square pages shared by many small textures
+        virtual void passAtlasFormat(uint32 pageSize, uint32 channels) = 0;
+        virtual bool isAtlas() const = 0;
+        virtual bool isMatchingAtlas(uint32 channels) const = 0;
+        /// @brief packs texture into atlas, fills layer and uvRect of placement, returns false if it does not fit
+        virtual bool pushToAtlas(int32 textureIndex, uint32 width, uint32 height, FTex2DPlacement& placement) = 0;
+        /// @brief returns fraction of atlas pages area covered with textures
+        virtual float getOccupancy() const = 0;
+
+    };
+
+
     class IMaterialStorage : public IRenderResourceStorage {
     public:
 
         virtual FMaterialTex2D* getTex2D(int32 index) const = 0;
         virtual uint32 getCountTex2D() const = 0;
+        virtual FMaterialTex2DArray* getTex2DArray(int32 index) const = 0;
+        virtual uint32 getCountTex2DArray() const = 0;
+
+        /// @brief returns true if textures are reached with bindless handles, instead of texture arrays
+        virtual bool isBindless() const = 0;
+        /// @brief recreates texture arrays, that got new layers since last call
+        virtual void prepareTex2DArrays() = 0;
 
         virtual const FMaterialProxy* retrieve(const CRenderable& cRenderable) const = 0;
 
@@ -40,6 +40,14 @@ namespace marengine {
         std::string path{};
     };
 
+    /// @brief axis aligned box and sphere around mesh vertices, both in model space
+    struct FMeshBounds {
+        maths::vec3 boxMin{ 0.f, 0.f, 0.f };
+        maths::vec3 boxMax{ 0.f, 0.f, 0.f };
+        maths::vec3 sphereCenter{ 0.f, 0.f, 0.f };
+        float sphereRadius{ 0.f };
+    };
+
     enum class EMeshType {
         NONE, CUBE, PYRAMID, SURFACE, EXTERNAL
     };
@@ -52,6 +60,7 @@ namespace marengine {
         virtual const FIndicesArray& getIndices() const = 0;
         virtual EMeshType getType() const = 0;
         virtual const char* getName() const = 0;
+        virtual const FMeshBounds& getBounds() const = 0;
 
     };
 
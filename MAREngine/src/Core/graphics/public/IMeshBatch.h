@@ -25,6 +25,7 @@
 
 
 #include "IRenderResource.h"
+#include "IMesh.h"
 
 
 namespace marengine {
@@ -39,7 +40,51 @@ namespace marengine {
 
 
     enum class EBatchType {
-        NONE, MESH_STATIC_COLOR, MESH_STATIC_TEX2D
+        NONE, MESH_STATIC_COLOR, MESH_STATIC_TEX2D, MESH_INSTANCED_COLOR, MESH_INSTANCED_TEX2D
+    };
+
+    /// @brief Continuous range of elements at batch array (vertices, indices), used for in-place updates.
+    struct FMeshBatchRange {
+        uint32 begin{ 0 };
+        uint32 count{ 0 };
+
+        MAR_NO_DISCARD uint32 end() const { return begin + count; }
+    };
+
+    typedef std::vector<FMeshBatchRange> FMeshBatchRangeArray;
+
+    /**
+     * @brief Elements of batch array changed since last upload. Ranges are kept sorted and coalesced,
+     * so that whole set can be flushed once per frame with minimal count of buffer updates.
+     */
+    class FBatchDirtyRanges {
+    public:
+
+        void mark(uint32 index);
+        void mark(const FMeshBatchRange& range);
+        void clear();
+
+        MAR_NO_DISCARD bool isEmpty() const;
+        MAR_NO_DISCARD const FMeshBatchRangeArray& getRanges() const;
+
+    private:
+
+        FMeshBatchRangeArray m_ranges;
+
+    };
+
+    /// @brief Placement of batch at shared (arena) buffers. Offsets and capacities are counted in elements,
+    /// drawCommandIndex is -1 until pipeline for batch is filled.
+    struct FMeshBatchArenaInfo {
+        uint32 verticesOffset{ 0 };
+        uint32 indicesOffset{ 0 };
+        uint32 transformsOffset{ 0 };
+        uint32 verticesCapacity{ 0 };
+        uint32 indicesCapacity{ 0 };
+        int32 drawCommandIndex{ -1 };
+        EIndexType indexType{ EIndexType::UINT32 };
+
+        MAR_NO_DISCARD bool isValid() const { return drawCommandIndex != -1; }
     };
 
 
@@ -51,22 +96,31 @@ namespace marengine {
         virtual const FVertexArray& getVertices() const = 0;
         virtual const FIndicesArray& getIndices() const = 0;
         virtual const FTransformsArray& getTransforms() const = 0;
+        virtual const FBatchDirtyRanges& getDirtyTransforms() const = 0;
+        virtual void clearDirtyTransforms() = 0;
 
-        virtual void updateVertices(const Entity& entity) = 0;
-        virtual void updateIndices(const Entity& entity) = 0;
         virtual void updateTransform(const Entity& entity) = 0;
+        virtual void updateCulled(const Entity& entity, bool isCulled) = 0;
 
         virtual bool shouldBeBatched(const Entity& entity) const = 0;
         virtual bool canBeBatched(const Entity& entity) const = 0;
         virtual void submitToBatch(const Entity& entity) = 0;
+        virtual void removeFromBatch(const Entity& entity) = 0;
 
         virtual void passVBO(int32 index) = 0;
         virtual void passIBO(int32 index) = 0;
         virtual void passTransformSSBO(int32 index) = 0;
+        virtual void passPipeline(int32 index) = 0;
+        virtual void passArenaInfo(const FMeshBatchArenaInfo& arenaInfo) = 0;
 
         virtual int32 getVBO() const = 0;
         virtual int32 getIBO() const = 0;
         virtual int32 getTransformSSBO() const = 0;
+        virtual int32 getPipeline() const = 0;
+        virtual const FMeshBatchArenaInfo& getArenaInfo() const = 0;
+        virtual const FMeshBatchRangeArray& getCulledRanges() const = 0;
+        virtual bool isCullingDirty() const = 0;
+        virtual void clearCullingDirty() = 0;
 
         virtual void passMeshStorage(FMeshStorage* pMeshStorage) = 0;
         virtual void passMaterialStorage(FMaterialStorage* pMaterialStorage) = 0;
@@ -81,6 +135,8 @@ namespace marengine {
 
         virtual FMeshBatchStorageStaticColor* getStorageStaticColor() const = 0;
         virtual FMeshBatchStorageStaticTex2D* getStorageStaticTex2D() const = 0;
+        virtual FMeshBatchStorageStaticColor* getStorageInstancedColor() const = 0;
+        virtual FMeshBatchStorageStaticTex2D* getStorageInstancedTex2D() const = 0;
 
     };
 
@@ -90,6 +146,10 @@ namespace marengine {
 
         virtual FMeshBatchStaticColor* emplaceStaticColor() = 0;
         virtual FMeshBatchStaticTex2D* emplaceStaticTex2D() = 0;
+        virtual FMeshBatchStaticColor* emplaceInstancedColor(EMeshType meshType, int32 meshIndex,
+                                                             uint32 levelOfDetail) = 0;
+        virtual FMeshBatchStaticTex2D* emplaceInstancedTex2D(EMeshType meshType, int32 meshIndex,
+                                                             uint32 levelOfDetail) = 0;
 
     };
 
@@ -35,6 +35,7 @@ namespace marengine {
     class FPipelineMeshTex2D;
     class FMeshBatchStaticColor;
     class FMeshBatchStaticTex2D;
+    class FMeshBatchStorageStaticColor;
 
 
     class IPipeline : public FRenderResource {
@@ -75,6 +76,12 @@ namespace marengine {
         virtual void fillPipelineFor(FPipelineMeshTex2D* const pPipeline,
                                      FMeshBatchStaticTex2D* const pBatch) const = 0;
 
+        virtual void fillPipelineFor(FPipelineMeshColor* const pPipeline,
+                                     FMeshBatchStorageStaticColor* const pStorage) const = 0;
+
+        virtual void fillPipelineFor(FPipelineMeshTex2D* const pPipeline,
+                                     const std::vector<FMeshBatchStaticTex2D*>& batches) const = 0;
+
     };
 
 
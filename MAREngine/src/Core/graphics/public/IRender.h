@@ -54,8 +54,23 @@ namespace marengine {
         NONE, VERTEX, INDEX, SSBO, UBO
     };
 
+    /// @brief STATIC buffers are updated rarely, PER_FRAME ones are persistently mapped and ring-buffered
+    enum class EBufferUsage {
+        STATIC, PER_FRAME
+    };
+
     enum class EInputType {
-        NONE, FLOAT, INT, VEC4, VEC3, VEC2, MAT4, OTHER
+        NONE, FLOAT, INT, UINT, VEC4, VEC3, VEC2, VEC2_SNORM16, VEC2_HALF, MAT4, OTHER
+    };
+
+    /// @brief FLOAT is layout of Vertex structure, PACKED uploads VertexPacked (compressed normal, uvs, shapeID)
+    enum class EVertexFormat {
+        FLOAT, PACKED
+    };
+
+    /// @brief UINT16 is picked for batches, which vertices can be all referenced with 16-bit indices
+    enum class EIndexType {
+        UINT32, UINT16
     };
 
     enum class EShaderStage {
@@ -77,6 +92,19 @@ namespace marengine {
 
     constexpr uint32 g_MeshStride{ 3 + 3 + 2 + 1 };
 
+    /**
+     * @struct VertexPacked IRender.h "Core/graphics/public/IRender.h"
+     * @brief GPU-side compact variant of Vertex (24 bytes instead of 36). Position stays in floats,
+     * normal is octahedral-encoded into two snorm16, texture coordinates are half floats and shapeID
+     * is read as an integer attribute.
+     */
+    struct VertexPacked {
+        maths::vec3 position;
+        int16_t normal[2]{ 0, 0 };
+        uint16_t textureCoordinates[2]{ 0, 0 };
+        uint32_t shapeID{ 0 };
+    };
+
     namespace GraphicLimits {
 
         constexpr uint32 maxTrianglesCount{ 100000 };
@@ -85,12 +113,50 @@ namespace marengine {
         constexpr int64 sizeOfVertices{ maxVerticesCount * sizeof(Vertex) };
         constexpr int64 sizeOfIndices{ maxIndicesCount * sizeof(uint32_t) };
 
-        constexpr uint32 maxTransforms{ 32 };
+        /// @brief default count of entities (transforms, colors, texture indexes) at single mesh batch
+        constexpr uint32 defaultEntitiesBudget{ 1024 };
+        /// @brief default count of entities sharing the same mesh, above which instanced batch is used
+        constexpr uint32 defaultInstancingThreshold{ 16 };
+        /// @brief count of entities filled during scene push, below which batches are filled without worker threads
+        constexpr uint32 minParallelFillsCount{ 4096 };
+        /// @brief count of unique textures, that can be bound for single mesh batch (sampler array at shader)
+        constexpr uint32 maxTextureSamplers{ 32 };
         constexpr uint32 maxLights{ 32 };
+        /// @brief default count of elements at single page of shared vertex / index buffers, page is bigger
+        /// only if single batch does not fit into default one
+        constexpr uint32 defaultVerticesPageCount{ 1 << 16 };
+        constexpr uint32 defaultIndicesPageCount{ 1 << 17 };
+        /// @brief batches with fewer vertices are drawn with 16-bit indices, 0xFFFF itself stays unused
+        constexpr uint32 maxShortIndexedVerticesCount{ 0xFFFF };
+        /// @brief size of post-transform vertex cache assumed by mesh optimizer and its ACMR statistic
+        constexpr uint32 vertexCacheSize{ 16 };
+        /// @brief max count of levels of detail of external mesh (including loaded one), every level has
+        /// half of triangles of previous one
+        constexpr uint32 maxMeshLevelsOfDetail{ 4 };
+        /// @brief part of screen height covered by mesh bounding sphere, below which first simplified level is
+        /// used, threshold of every next level is half of previous one
+        constexpr float defaultLevelOfDetailScreenSize{ 0.25f };
+        /// @brief relative margin around screen size threshold, that must be crossed to switch level of detail
+        constexpr float defaultLevelOfDetailHysteresis{ 0.1f };
+        /// @brief visible entities are split into this many slices, level of detail is selected for one slice per frame
+        constexpr uint32 levelOfDetailSlicesCount{ 4 };
+        /// @brief smallest range of elements handed out to batch at vertex / index page, must be power of two
+        constexpr uint32 minBufferBlockCount{ 256 };
+        /// @brief textures, which both sides are not longer than atlasMaxTextureSize, are packed into square
+        /// atlas pages instead of getting their own texture array layer
+        constexpr uint32 atlasPageSize{ 2048 };
+        constexpr uint32 atlasMaxTextureSize{ 512 };
+        constexpr uint32 atlasPadding{ 1 };
+        /// @brief resolution of CPU depth buffer, into which occluders are rasterized
+        constexpr uint32 occlusionBufferWidth{ 256 };
+        constexpr uint32 occlusionBufferHeight{ 128 };
+        /// @brief default count of the biggest visible entities rasterized as occluders every frame
+        constexpr uint32 defaultOccludersCount{ 16 };
 
     };
 
     typedef std::vector<Vertex> FVertexArray;
+    typedef std::vector<VertexPacked> FVertexPackedArray;
     typedef std::vector<uint32> FIndicesArray;
     typedef std::vector<maths::mat4> FTransformsArray;
     typedef std::vector<maths::vec4> FColorsArray;
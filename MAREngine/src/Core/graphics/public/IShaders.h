@@ -44,9 +44,21 @@ namespace marengine {
     };
 
 
+    /// @brief Paths to source code of every shader stage, nullptr if stage is not used
+    struct FShaderStagesPaths {
+        const char* vertex{ nullptr };
+        const char* fragment{ nullptr };
+        const char* geometry{ nullptr };
+        const char* tessEval{ nullptr };
+        const char* tessControl{ nullptr };
+        const char* compute{ nullptr };
+    };
+
+
     struct FShaderInputDescription {
         std::vector<FShaderInputVariableInfo> inputVariables;
         EBufferType bufferType{ EBufferType::NONE };
+        EBufferUsage usage{ EBufferUsage::STATIC };
         EShaderStage shaderStage{ EShaderStage::NONE };
         uint32 binding{ 0 };
     };
@@ -61,8 +73,15 @@ namespace marengine {
         virtual void passGeometry(const char* geometryShader) = 0;
         virtual void passCompute(const char* computeShader) = 0;
         virtual void passFragment(const char* fragmentShader) = 0;
+        virtual void passStages(const FShaderStagesPaths& stagesPaths) = 0;
 
         virtual uint32 getID() const = 0;
+        /// @brief returns true if program was loaded from on-disk binary cache instead of being compiled
+        virtual bool isLoadedFromBinary() const = 0;
+
+        virtual void acquire() = 0;
+        virtual uint32 release() = 0;
+        virtual uint32 getReferencesCount() const = 0;
 
         virtual void compile() = 0;
         virtual void close() = 0;
@@ -80,6 +99,7 @@ namespace marengine {
     public:
 
         virtual FShaders* emplace() = 0;
+        virtual FShaders* emplaceCached(const FShaderStagesPaths& stagesPaths) = 0;
 
     };
 
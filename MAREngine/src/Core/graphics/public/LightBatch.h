@@ -25,6 +25,7 @@
 
 
 #include "ILightBatch.h"
+#include "IMeshBatch.h"
 #include "Light.h"
 
 
@@ -57,12 +58,15 @@ namespace marengine {
 		void submitToBatch(const Entity& entity) final;
 
 		void updateLight(const Entity& entity);
+        MAR_NO_DISCARD const FBatchDirtyRanges& getDirtyLights() const;
+        void clearDirtyLights();
 
 		MAR_NO_DISCARD ELightBatchType getType() const final;
 
 	private:
 
 		std::vector<FPointLight> m_lights;
+        FBatchDirtyRanges m_dirtyLights;
 
 
 	};
@@ -25,6 +25,7 @@
 
 
 #include "IMaterial.h"
+#include "TextureAtlas.h"
 
 
 namespace marengine {
@@ -43,11 +44,46 @@ namespace marengine {
 
         virtual void setSampler(uint32 sampler) final { p_info.sampler = sampler; }
 
+        MAR_NO_DISCARD virtual const FTex2DPlacement& getPlacement() const final { return p_placement; }
+
         MAR_NO_DISCARD EMaterialType getType() const final { return EMaterialType::TEX2D; }
 
     protected:
 
         FTex2DInfo p_info;
+        FTex2DPlacement p_placement;
+
+    };
+
+
+    class FMaterialTex2DArray : public IMaterialTex2DArray {
+    public:
+
+        void passFormat(uint32 width, uint32 height, uint32 channels) final;
+        MAR_NO_DISCARD bool isMatching(uint32 width, uint32 height, uint32 channels) const final;
+
+        /// @brief pushes texture as next layer of array, returns that layer
+        MAR_NO_DISCARD uint32 pushLayer(int32 textureIndex) final;
+        MAR_NO_DISCARD bool isDirty() const final;
+
+        void passAtlasFormat(uint32 pageSize, uint32 channels) final;
+        MAR_NO_DISCARD bool isAtlas() const final;
+        MAR_NO_DISCARD bool isMatchingAtlas(uint32 channels) const final;
+        MAR_NO_DISCARD bool pushToAtlas(int32 textureIndex, uint32 width, uint32 height,
+                                        FTex2DPlacement& placement) final;
+        MAR_NO_DISCARD float getOccupancy() const final;
+
+    protected:
+
+        /// @brief texture (at material storage) copied into every region of array
+        std::vector<FTex2DArrayRegion> p_regions;
+        FTextureAtlas p_atlas;
+        uint32 p_layersCount{ 0 };
+        uint32 p_width{ 0 };
+        uint32 p_height{ 0 };
+        uint32 p_channels{ 0 };
+        bool p_isAtlas{ false };
+        bool p_dirty{ true };
 
     };
 
@@ -38,16 +38,68 @@ namespace marengine {
         MAR_NO_DISCARD const FVertexArray& getVertices() const final;
         MAR_NO_DISCARD const FIndicesArray& getIndices() const final;
         MAR_NO_DISCARD EMeshType getType() const final;
+        MAR_NO_DISCARD const FMeshBounds& getBounds() const final;
 
     protected:
 
+        /// @brief computes bounds from p_vertices, must be called whenever they are assigned
+        void computeBounds();
+
         FVertexArray p_vertices;
         FIndicesArray p_indices;
+        FMeshBounds p_bounds;
         EMeshType p_type{ EMeshType::NONE };
 
     };
 
 
+    /**
+     * @class FMeshLevelOfDetail Mesh.h "Core/graphics/public/Mesh.h"
+     * @brief Configurable levels of detail of external meshes. Levels count is applied to meshes loaded after
+     * the change, screen size thresholds and hysteresis are applied at every selection.
+     */
+    class FMeshLevelOfDetail {
+    public:
+
+        /// @brief count of levels generated at load, including loaded mesh (1 disables generation)
+        static void setLevelsCount(uint32 levelsCount);
+        static uint32 getLevelsCount();
+
+        static void setScreenSizeThreshold(float screenSize);
+        static float getScreenSizeThreshold();
+
+        static void setHysteresis(float hysteresis);
+        static float getHysteresis();
+
+        /**
+         * @brief Selects level of detail for mesh covering given part of screen height. Current level is
+         * changed only if screen size crosses threshold by more than hysteresis, so that entity standing
+         * near the boundary does not switch levels (and rebuild batches) every frame.
+         */
+        static uint32 select(uint32 currentLevel, uint32 levelsCount, float screenSize);
+
+    private:
+
+        static uint32 s_levelsCount;
+        static float s_screenSizeThreshold;
+        static float s_hysteresis;
+
+    };
+
+
+    class FMeshExternalLevel : public FMeshProxy {
+    public:
+
+        FMeshExternalLevel(std::string name, FVertexArray vertices, FIndicesArray indices);
+        MAR_NO_DISCARD const char* getName() const final { return p_name.c_str(); }
+
+    protected:
+
+        std::string p_name;
+
+    };
+
+
     class FMeshExternal : public FMeshProxy {
     public:
 
@@ -57,9 +109,18 @@ namespace marengine {
         MAR_NO_DISCARD const FMeshExternalInfo& getInfo() const;
         MAR_NO_DISCARD const char* getName() const final { return p_info.path.c_str(); }
 
+        /// @brief returns given level of detail, 0 is loaded mesh, too high level returns the coarsest one
+        MAR_NO_DISCARD const FMeshProxy* getLevelOfDetail(uint32 levelOfDetail) const;
+        MAR_NO_DISCARD uint32 getLevelsOfDetailCount() const;
+
+    private:
+
+        void generateLevelsOfDetail();
+
     protected:
 
         FMeshExternalInfo p_info;
+        std::vector<FMeshExternalLevel> p_levelsOfDetail;
 
     };
 
@@ -98,6 +159,7 @@ namespace marengine {
     public:
 
         MAR_NO_DISCARD const FMeshProxy* getExternal(int32 index) const final;
+        MAR_NO_DISCARD const FMeshExternal* getExternalMesh(int32 index) const;
         MAR_NO_DISCARD uint32 getCountExternal() const final;
 
         MAR_NO_DISCARD const FMeshProxy* getCube() const final;
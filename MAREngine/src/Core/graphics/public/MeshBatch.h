@@ -25,6 +25,7 @@
 
 
 #include "IMeshBatch.h"
+#include "IMaterial.h"
 
 
 namespace marengine {
@@ -35,6 +36,29 @@ namespace marengine {
     class FMaterialTex2D;
 
 
+    /**
+     * @class FMeshBatchBudget MeshBatch.h "Core/graphics/public/MeshBatch.h"
+     * @brief Configurable count of entities, that can be submitted to single mesh batch. Transform, color
+     * and texture index SSBOs are allocated for this count. Applied to batches created after the change.
+     */
+    class FMeshBatchBudget {
+    public:
+
+        static void setEntitiesCount(uint32 entitiesCount);
+        static uint32 getEntitiesCount();
+
+        /// @brief Mesh shared by more entities than threshold is rendered with instanced batch
+        static void setInstancingThreshold(uint32 instancingThreshold);
+        static uint32 getInstancingThreshold();
+
+    private:
+
+        static uint32 s_entitiesCount;
+        static uint32 s_instancingThreshold;
+
+    };
+
+
     class FMeshBatch : public IMeshBatch {
     public:
 
@@ -43,27 +67,44 @@ namespace marengine {
         MAR_NO_DISCARD const FVertexArray& getVertices() const final;
         MAR_NO_DISCARD const FIndicesArray& getIndices() const final;
         MAR_NO_DISCARD const FTransformsArray& getTransforms() const final;
+        MAR_NO_DISCARD const FBatchDirtyRanges& getDirtyTransforms() const final;
+        void clearDirtyTransforms() final;
 
-        void updateVertices(const Entity& entity) final;
-        void updateIndices(const Entity& entity) final;
+        /// @brief does nothing for culled entity, its transform is restored when it becomes visible again
         void updateTransform(const Entity& entity) final;
 
         void passVBO(int32 index) final ;
         void passIBO(int32 index) final;
         void passTransformSSBO(int32 index) final;
+        void passPipeline(int32 index) final;
+        void passArenaInfo(const FMeshBatchArenaInfo& arenaInfo) final;
 
         MAR_NO_DISCARD int32 getVBO() const final;
         MAR_NO_DISCARD int32 getIBO() const final;
         MAR_NO_DISCARD int32 getTransformSSBO() const final;
+        MAR_NO_DISCARD int32 getPipeline() const final;
+        MAR_NO_DISCARD const FMeshBatchArenaInfo& getArenaInfo() const final;
+        /**
+         * @brief Returns sorted and coalesced ranges of culled entities, that are left out of batch's draw
+         * commands (see FPipelineMesh::passCulledRanges). Ranges are counted in indices, for instanced batch
+         * in instances. Dirty flag is set, whenever they change.
+         */
+        MAR_NO_DISCARD const FMeshBatchRangeArray& getCulledRanges() const final;
+        MAR_NO_DISCARD bool isCullingDirty() const final;
+        void clearCullingDirty() final;
 
         void passMeshStorage(FMeshStorage* pMeshStorage) final;
         void passMaterialStorage(FMaterialStorage* pMaterialStorage) final;
 
     protected:
 
+        /// @brief transform with zero scale, entity drawn with it covers no pixels
+        MAR_NO_DISCARD static maths::mat4 getHiddenTransform();
+
         FVertexArray p_vertices;
         FIndicesArray p_indices;
         FTransformsArray p_transforms;
+        FBatchDirtyRanges p_dirtyTransforms;
 
         FMeshStorage* p_pMeshStorage{ nullptr };
         FMaterialStorage* p_pMaterialStorage{ nullptr };
@@ -71,6 +112,10 @@ namespace marengine {
         int32 p_vbo{ -1 };
         int32 p_ibo{ -1 };
         int32 p_transformSSBO{ -1 };
+        int32 p_pipeline{ -1 };
+        FMeshBatchArenaInfo p_arenaInfo;
+        FMeshBatchRangeArray p_culledRanges;
+        bool p_isCullingDirty{ false };
 
     };
 
@@ -83,17 +128,83 @@ namespace marengine {
         MAR_NO_DISCARD bool shouldBeBatched(const Entity& entity) const override;
         MAR_NO_DISCARD bool canBeBatched(const Entity& entity) const override;
         void submitToBatch(const Entity& entity) override;
+        void removeFromBatch(const Entity& entity) override;
+        /// @brief excludes indices (or instance) of culled entity from draw commands, restores transform once visible
+        void updateCulled(const Entity& entity, bool isCulled) final;
+
+        /**
+         * @brief Returns true, if there is place for one more entity with mesh of given size (material is not
+         * checked). Count of entities is limited by getEntitiesBudget(), for which transform, color and texture
+         * index SSBOs (or ranges of shared ones) are allocated once, when pipeline of batch is created. They are
+         * never grown, so full batch takes no entity until one is removed. FBatchManager::insertEntityToRender
+         * tries other drawn batches then and fails, if none has place, so scene has to be pushed again.
+         */
+        MAR_NO_DISCARD bool hasPlaceFor(uint32 verticesToPush, uint32 indicesToPush) const;
+        /// @brief Count of entities fixed at reset() of batch, changes of FMeshBatchBudget apply after next reset
+        MAR_NO_DISCARD uint32 getEntitiesBudget() const;
+        /// @brief returns smallest index type, that can reference every vertex currently at batch
+        MAR_NO_DISCARD EIndexType getFittingIndexType() const;
+
+        /**
+         * @brief Makes batch instanced one, it stores single copy of given mesh and every submitted entity
+         * is its instance (only transform and material are stored per entity).
+         */
+        void passInstancedMesh(EMeshType meshType, int32 meshIndex, uint32 levelOfDetail);
+        MAR_NO_DISCARD bool isInstanced() const;
+        MAR_NO_DISCARD bool isInstanceOf(const CRenderable& cRenderable) const;
+        MAR_NO_DISCARD uint32 getInstancesCount() const;
+
+        /**
+         * @brief With deferred fill submitToBatch only reserves slot and ranges for an entity. Copying vertices,
+         * offsetting indices and copying transforms is left for fillDeferred, which touches nothing but this
+         * batch, so that many batches can be filled at once on worker threads.
+         */
+        void passDeferredFill(bool isFillDeferred);
+        void fillDeferred();
+        MAR_NO_DISCARD bool hasDeferredFill() const;
+        MAR_NO_DISCARD uint32 getDeferredFillsCount() const;
 
     protected:
 
+        MAR_NO_DISCARD bool hasFreeSlot() const;
+        int32 acquireSlot();
+
         void submitRenderable(CRenderable& cRenderable);
         void submitVertices(CRenderable& cRenderable, const FVertexArray& vertices);
         void submitIndices(CRenderable& cRenderable, const FIndicesArray& indices);
-        void submitTransform(const CTransform& transformComponent);
-
+        void submitTransform(int32 slot, const CTransform& transformComponent);
+
+        void copyVertices(uint32 begin, const FVertexArray& vertices, float shapeID);
+        void copyIndices(uint32 begin, const FIndicesArray& indices, uint32 startVert);
+
+        /// @brief work reserved by submitToBatch for single entity, while fill is deferred
+        struct FDeferredFill {
+            const FVertexArray* pVertices{ nullptr };
+            const FIndicesArray* pIndices{ nullptr };
+            /// @brief world matrix resolved on the serial pass, workers never touch the registry
+            maths::mat4 transform;
+            int32 slot{ -1 };
+            uint32 startVert{ 0 };
+            uint32 startInd{ 0 };
+            float shapeID{ 0.f };
+        };
+
+        std::vector<FDeferredFill> p_deferredFills;
+        bool p_isFillDeferred{ false };
+
+        /// @brief ranges of vertices / indices released by removed entities, sorted and coalesced
+        FMeshBatchRangeArray p_freeVertices;
+        FMeshBatchRangeArray p_freeIndices;
+        /// @brief transform (shape) slots released by removed entities, reused before the batch grows
+        std::vector<int32> p_freeSlots;
 
         float p_shapeID{ 0.f };
+        /// @brief the largest index, that live entities may reference, decides if 16-bit indices fit batch
         uint32_t p_indicesMaxValue{ 0 };
+        uint32 p_entitiesBudget{ FMeshBatchBudget::getEntitiesCount() };
+        EMeshType p_instancedMeshType{ EMeshType::NONE };
+        int32 p_instancedMeshIndex{ -1 };
+        uint32 p_instancedMeshLevelOfDetail{ 0 };
 
     };
 
@@ -110,6 +221,8 @@ namespace marengine {
         MAR_NO_DISCARD const FColorsArray& getColors() const;
 
         void updateColor(const Entity& entity);
+        MAR_NO_DISCARD const FBatchDirtyRanges& getDirtyColors() const;
+        void clearDirtyColors();
 
         MAR_NO_DISCARD int32 getColorSSBO() const;
         void passColorSSBO(int32 id);
@@ -118,10 +231,11 @@ namespace marengine {
 
     private:
 
-        void submitColor(const maths::vec4& color);
+        void submitColor(int32 slot, const maths::vec4& color);
 
 
         FColorsArray m_colors;
+        FBatchDirtyRanges m_dirtyColors;
         int32 m_colorsSSBO{ -1 };
 
     };
@@ -135,16 +249,36 @@ namespace marengine {
         MAR_NO_DISCARD bool shouldBeBatched(const Entity& entity) const override;
         MAR_NO_DISCARD bool canBeBatched(const Entity& entity) const override;
         void submitToBatch(const Entity& entity) override;
+        void removeFromBatch(const Entity& entity) final;
 
         MAR_NO_DISCARD EBatchType getType() const final;
-        MAR_NO_DISCARD const std::vector<int32>& getTextureIndexes() const;
+        MAR_NO_DISCARD const std::vector<int32>& getTextures() const;
+        MAR_NO_DISCARD const std::vector<FTex2DShaderRef>& getTextureIndexes() const;
+
+        MAR_NO_DISCARD int32 getTextureIndexesSSBO() const;
+        void passTextureIndexesSSBO(int32 id);
+
+        /// @brief Called, when batch is drawn by pipeline shared with other batches. Samplers are bound per
+        /// pipeline, so from then on texture arrays bound at batch are neither rebound nor released.
+        void lockSamplers();
 
     private:
 
-        void submitTexture(FMaterialTex2D* pTexture2D);
+        MAR_NO_DISCARD bool isTextureAvailable(const FMaterialTex2D* pTexture2D) const;
+        void submitTexture(int32 slot, FMaterialTex2D* pTexture2D);
+        void releaseTexture(int32 slot);
 
 
-        std::vector<int32> m_textureIndexes;
+        /// @brief unique texture arrays bound at batch, position at array is sampler used for given array.
+        /// Stays empty with bindless textures, as every entity carries its own handle.
+        std::vector<int32> m_textures;
+        /// @brief count of entities sampling given texture array (same position as at m_textures), sampler
+        /// with zero usages is free and may be rebound to other array
+        std::vector<uint32> m_textureUsages;
+        /// @brief texture reference (see FTex2DShaderRef) for every entity slot at batch
+        std::vector<FTex2DShaderRef> m_textureIndexes;
+        int32 m_textureIndexesSSBO{ -1 };
+        bool m_areSamplersLocked{ false };
 
     };
 
@@ -192,7 +326,10 @@ namespace marengine {
 
         MAR_NO_DISCARD FMeshBatchStorageStaticColor* getStorageStaticColor() const final;
         MAR_NO_DISCARD FMeshBatchStorageStaticTex2D* getStorageStaticTex2D() const final;
+        MAR_NO_DISCARD FMeshBatchStorageStaticColor* getStorageInstancedColor() const final;
+        MAR_NO_DISCARD FMeshBatchStorageStaticTex2D* getStorageInstancedTex2D() const final;
         MAR_NO_DISCARD FMeshBatch* retrieve(const CRenderable& cRenderable) const;
+        MAR_NO_DISCARD FMeshBatchStaticColor* retrieveColor(const CRenderable& cRenderable) const;
 
         void reset() final;
 
@@ -200,6 +337,8 @@ namespace marengine {
 
         FMeshBatchStorageStaticColor m_storageStaticColor;
         FMeshBatchStorageStaticTex2D m_storageStaticTex2D;
+        FMeshBatchStorageStaticColor m_storageInstancedColor;
+        FMeshBatchStorageStaticTex2D m_storageInstancedTex2D;
 
     };
 
@@ -209,6 +348,10 @@ namespace marengine {
 
         MAR_NO_DISCARD FMeshBatchStaticColor* emplaceStaticColor() final;
         MAR_NO_DISCARD FMeshBatchStaticTex2D* emplaceStaticTex2D() final;
+        MAR_NO_DISCARD FMeshBatchStaticColor* emplaceInstancedColor(EMeshType meshType, int32 meshIndex,
+                                                                    uint32 levelOfDetail) final;
+        MAR_NO_DISCARD FMeshBatchStaticTex2D* emplaceInstancedTex2D(EMeshType meshType, int32 meshIndex,
+                                                                    uint32 levelOfDetail) final;
 
         template<typename TMeshBatchStorage>
         MAR_NO_DISCARD FMeshBatchStatic* emplaceStatic(TMeshBatchStorage* pMeshBatchStorage);
@@ -217,12 +360,15 @@ namespace marengine {
 
         void passMeshStorage(FMeshStorage* pMeshStorage);
         void passMaterialStorage(FMaterialStorage* pMaterialStorage);
+        /// @brief batches emplaced from now on defer their fill, see FMeshBatchStatic::passDeferredFill
+        void passDeferredFill(bool isFillDeferred);
 
     private:
 
         FMeshBatchStorage m_storage;
         FMeshStorage* m_pMeshStorage{ nullptr };
         FMaterialStorage* m_pMaterialStorage{ nullptr };
+        bool m_isFillDeferred{ false };
 
     };
 
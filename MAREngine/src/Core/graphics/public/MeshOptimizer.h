@@ -0,0 +1,68 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+
+
+#ifndef MARENGINE_MESHOPTIMIZER_H
+#define MARENGINE_MESHOPTIMIZER_H
+
+
+#include "IRender.h"
+
+
+namespace marengine {
+
+
+    /**
+     * @class FMeshOptimizer MeshOptimizer.h "Core/graphics/public/MeshOptimizer.h"
+     * @brief Import stage for external meshes. Identical vertices are merged, triangles are reordered
+     * for post-transform cache locality (Tipsify) and vertices are reordered for fetch locality.
+     */
+    class FMeshOptimizer {
+    public:
+
+        /// @brief when enabled, FMeshExternal::load optimizes every loaded mesh
+        static void setEnabledAtImport(bool enabled);
+        static bool isEnabledAtImport();
+
+        static void optimize(FVertexArray& vertices, FIndicesArray& indices);
+
+        /// @brief merges bitwise identical vertices, indices are remapped to the remaining ones
+        static void deduplicateVertices(FVertexArray& vertices, FIndicesArray& indices);
+        /// @brief reorders triangles with Tipsify, so that their vertices are reused while still in cache
+        static void optimizeVertexCache(FIndicesArray& indices, uint32 verticesCount, uint32 cacheSize);
+        /// @brief reorders vertices in order of first use by indices, unreferenced vertices are dropped
+        static void optimizeVertexFetch(FVertexArray& vertices, FIndicesArray& indices);
+
+        /// @brief average cache miss ratio, count of vertices transformed per triangle with FIFO cache
+        /// of given size. 3.0 is the worst case, 0.5 is usual limit for regular meshes.
+        static float computeACMR(const FIndicesArray& indices, uint32 verticesCount, uint32 cacheSize);
+
+    private:
+
+        static bool s_enabledAtImport;
+
+    };
+
+
+}
+
+
+#endif //MARENGINE_MESHOPTIMIZER_H
@@ -0,0 +1,110 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+
+
+#ifndef MARENGINE_MESHSIMPLIFIER_H
+#define MARENGINE_MESHSIMPLIFIER_H
+
+
+#include "IRender.h"
+
+
+namespace marengine {
+
+
+    /**
+     * @class FMeshSimplifier MeshSimplifier.h "Core/graphics/public/MeshSimplifier.h"
+     * @brief Quadric error mesh simplification (Garland-Heckbert) with half-edge collapses. Vertices
+     * sharing position are welded, so that seams (different normals / uvs) collapse together and no
+     * vertex is moved, simplified indices reference original vertices.
+     */
+    class FMeshSimplifier {
+    public:
+
+        /// @brief returns indices of simplified mesh with at most targetTrianglesCount triangles (if reachable
+        /// without flipping any triangle), referencing given vertices
+        MAR_NO_DISCARD FIndicesArray simplify(const FVertexArray& vertices, const FIndicesArray& indices,
+                                              uint32 targetTrianglesCount);
+
+    private:
+
+        struct FPoint {
+            double x{ 0.0 };
+            double y{ 0.0 };
+            double z{ 0.0 };
+
+            FPoint operator-(const FPoint& other) const { return { x - other.x, y - other.y, z - other.z }; }
+            MAR_NO_DISCARD double dot(const FPoint& other) const { return x * other.x + y * other.y + z * other.z; }
+            MAR_NO_DISCARD FPoint cross(const FPoint& other) const {
+                return { y * other.z - z * other.y, z * other.x - x * other.z, x * other.y - y * other.x };
+            }
+        };
+
+        /// @brief symmetric 4x4 matrix, only upper triangle is stored
+        struct FQuadric {
+            double a[10]{ 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+
+            void addPlane(const FPoint& normal, double distance, double weight);
+            void add(const FQuadric& other);
+            MAR_NO_DISCARD double evaluate(const FPoint& point) const;
+        };
+
+        struct FCollapse {
+            double cost{ 0.0 };
+            uint32 from{ 0 };
+            uint32 to{ 0 };
+            uint32 fromVersion{ 0 };
+            uint32 toVersion{ 0 };
+
+            bool operator>(const FCollapse& other) const { return cost > other.cost; }
+        };
+
+        void weldPositions(const FVertexArray& vertices);
+        void createTriangles(const FIndicesArray& indices);
+        void computeQuadrics();
+        void pushCollapse(uint32 a, uint32 b);
+        MAR_NO_DISCARD bool isFlipping(uint32 from, uint32 to) const;
+        void collapse(uint32 from, uint32 to);
+        MAR_NO_DISCARD uint32 getClosestWedge(const FVertexArray& vertices, uint32 vertex, uint32 position) const;
+
+        std::vector<FPoint> m_positions;
+        std::vector<FQuadric> m_quadrics;
+        std::vector<uint32> m_versions;
+        std::vector<bool> m_removed;
+        /// @brief welded position of every vertex
+        std::vector<uint32> m_positionOfVertex;
+        /// @brief vertices sharing given position
+        std::vector<std::vector<uint32>> m_wedges;
+        /// @brief triangles, which corners are at given position
+        std::vector<std::vector<uint32>> m_adjacency;
+        /// @brief corners of triangles as welded positions
+        std::vector<uint32> m_triangles;
+        std::vector<bool> m_alive;
+        uint32 m_aliveCount{ 0 };
+        std::priority_queue<FCollapse, std::vector<FCollapse>, std::greater<FCollapse>> m_collapses;
+
+    };
+
+
+}
+
+
+#endif //MARENGINE_MESHSIMPLIFIER_H
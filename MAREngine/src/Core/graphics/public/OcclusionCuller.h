@@ -0,0 +1,119 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+
+
+#ifndef MARENGINE_OCCLUSIONCULLER_H
+#define MARENGINE_OCCLUSIONCULLER_H
+
+
+#include "IMesh.h"
+
+
+namespace marengine {
+
+
+    /**
+     * @class FOcclusionCulling OcclusionCuller.h "Core/graphics/public/OcclusionCuller.h"
+     * @brief Configuration of occlusion culling stage, that runs after frustum culling.
+     */
+    class FOcclusionCulling {
+    public:
+
+        static void setEnabled(bool isEnabled);
+        static bool isEnabled();
+
+        /// @brief Count of the biggest (on screen) visible entities, that are rasterized as occluders
+        static void setOccludersCount(uint32 occludersCount);
+        static uint32 getOccludersCount();
+
+    private:
+
+        static bool s_isEnabled;
+        static uint32 s_occludersCount;
+
+    };
+
+
+    enum class EOcclusionKernel {
+        SCALAR, SSE41, AVX2
+    };
+
+
+    /**
+     * @class FOcclusionCuller OcclusionCuller.h "Core/graphics/public/OcclusionCuller.h"
+     * @brief Rasterizes occluder meshes on CPU into low resolution depth buffer and tests bounds of other
+     * meshes against its hierarchical-Z (mip chain, where every texel keeps the farthest depth of four texels
+     * below). Depth is NDC z, so no GPU readback is needed. SSE4.1 / AVX2 kernels fill 4 / 8 pixels of triangle
+     * span and reduce 4 / 8 texels of hierarchy at once, the fastest one supported by CPU is selected on first
+     * use. Every kernel is checked against scalar one before it is selected, scalar one is the fallback.
+     */
+    class FOcclusionCuller {
+    public:
+
+        /// @brief Clears depth buffer and sets view-projection matrix, with which occluders and bounds are projected
+        void begin(const maths::mat4& viewProjection);
+        /// @brief Rasterizes both sides of every triangle of given mesh transformed by given model matrix
+        void rasterize(const FVertexArray& vertices, const FIndicesArray& indices, const maths::mat4& transform);
+        /// @brief Builds hierarchical-Z from depth buffer, must be called after rasterizing all occluders
+        void buildHierarchy();
+        /// @brief Returns true, if given model space bounds transformed by given matrix are fully hidden by occluders
+        MAR_NO_DISCARD bool isOccluded(const FMeshBounds& bounds, const maths::mat4& transform) const;
+
+        MAR_NO_DISCARD uint32 getWidth() const;
+        MAR_NO_DISCARD uint32 getHeight() const;
+        /// @brief Returns depth buffer (row major, first row at the bottom of screen)
+        MAR_NO_DISCARD const std::vector<float>& getDepth() const;
+
+        /**
+         * @brief Forces given kernel (e.g. to compare it against scalar one), if CPU does not support it or it
+         * does not match scalar one, scalar kernel is used.
+         * @param kernel kernel, that should be used by rasterize and buildHierarchy
+         */
+        static void passKernel(EOcclusionKernel kernel);
+        MAR_NO_DISCARD static EOcclusionKernel getKernel();
+        MAR_NO_DISCARD static const char* getKernelName(EOcclusionKernel kernel);
+
+    private:
+
+        struct FDepthLevel {
+            std::vector<float> depth;
+            uint32 width{ 0 };
+            uint32 height{ 0 };
+        };
+
+        void rasterizeTriangle(const maths::vec4& clip0, const maths::vec4& clip1, const maths::vec4& clip2);
+
+        static void selectKernel();
+
+        maths::mat4 m_viewProjection;
+        /// @brief m_levels[0] is depth buffer itself
+        std::vector<FDepthLevel> m_levels;
+
+        static EOcclusionKernel s_kernel;
+        static bool s_isKernelSelected;
+
+    };
+
+
+}
+
+
+#endif //MARENGINE_OCCLUSIONCULLER_H
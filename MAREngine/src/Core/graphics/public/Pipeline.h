@@ -25,6 +25,8 @@
 
 
 #include "IPipeline.h"
+#include "IBuffer.h"
+#include "IMeshBatch.h"
 
 
 namespace marengine {
@@ -32,6 +34,7 @@ namespace marengine {
     class FShadersStorage;
     class FBufferStorage;
     class FMaterialStorage;
+    class FMeshBatchStatic;
     class FMeshBatchStaticColor;
 
 
@@ -60,7 +63,34 @@ namespace marengine {
         virtual void passCameraSSBO(int32 i) final;
         virtual void passPointLightSSBO(int32 i) final;
         virtual void passShaderPipeline(int32 i) final;
+        virtual void passInstancesCount(uint32 instancesCount) final;
+        virtual void passIndirectBuffer(int32 i) final;
+        virtual void passDrawCommands(const FDrawIndirectCommandsArray& drawCommands) final;
+        /// @brief format of vertices at pipeline's VBO, must be passed before the VBO is filled
+        virtual void passVertexFormat(EVertexFormat format) final;
+        /// @brief updates indices count of single draw command, visible draw commands are rebuilt before next draw
+        virtual void updateDrawCommand(uint32 commandIndex, uint32 indicesCount) final;
+        /// @brief ranges of batch drawn with command, that are left out of visible draw commands
+        virtual void passCulledRanges(uint32 commandIndex, const FMeshBatchRangeArray& culledRanges) final;
+        /**
+         * @brief Splits every draw command around its culled ranges (instances for instanced pipeline, indices
+         * otherwise) and uploads the result to indirect buffer. Does nothing if neither commands, nor culled
+         * ranges changed since last call.
+         */
+        virtual void updateVisibleDrawCommands() final;
+        /// @brief returns draw commands covering only visible entities, valid after updateVisibleDrawCommands
+        MAR_NO_DISCARD virtual const FDrawIndirectCommandsArray& getVisibleDrawCommands() const final;
+        /// @brief returns draw command describing where pipeline's batch lives at shared buffers
+        MAR_NO_DISCARD virtual const FDrawIndirectCommand& getDrawCommand(uint32 commandIndex) const final;
         MAR_NO_DISCARD virtual uint32 getIndicesCount() const final;
+        /// @brief returns count of instances drawn with pipeline, 0 if pipeline is not instanced
+        MAR_NO_DISCARD virtual uint32 getInstancesCount() const final;
+        /// @brief returns true if pipeline draws its visible draw commands with single multi-draw-indirect call
+        MAR_NO_DISCARD virtual bool isIndirect() const final;
+        MAR_NO_DISCARD virtual uint32 getDrawCommandsCount() const final;
+        MAR_NO_DISCARD virtual EVertexFormat getVertexFormat() const final;
+        /// @brief returns type of indices at pipeline's IBO
+        MAR_NO_DISCARD virtual EIndexType getIndexType() const final;
 
     protected:
 
@@ -70,6 +100,14 @@ namespace marengine {
         int32 p_iboIndex{ -1 };
         int32 p_camIndex{ -1 };
         int32 p_pointLightIndex{ -1 };
+        uint32 p_instancesCount{ 0 };
+        FDrawIndirectCommandsArray p_drawCommands;
+        /// @brief culled ranges of batch drawn with command at the same index of p_drawCommands
+        std::vector<FMeshBatchRangeArray> p_culledRanges;
+        FDrawIndirectCommandsArray p_visibleDrawCommands;
+        bool p_areVisibleDrawCommandsDirty{ true };
+        int32 p_indirectIndex{ -1 };
+        EVertexFormat p_vertexFormat{ EVertexFormat::FLOAT };
 
     };
 
@@ -92,6 +130,9 @@ namespace marengine {
         virtual void passSamplerArray(const std::array<const char*, 32>& samplerArray) final;
         virtual int32 discoverSamplerLocation(const char* samplerName) const = 0;
         virtual void passTexture(int32 i) final;
+        virtual void updateTexture(uint32 slot, int32 i) final;
+        virtual void passTexturesCount(uint32 count) final;
+        virtual void passTextureIndexesSSBO(int32 i) final;
 
     protected:
 
@@ -99,6 +140,7 @@ namespace marengine {
         std::array<const char*, 32> m_samplerNames;
         std::array<int32, 32> m_textures;
         uint32 m_texturesIndex{ 0 };
+        int32 p_textureIndexesIndex{ -1 };
 
     public:
 
@@ -121,9 +163,32 @@ namespace marengine {
         void fillPipelineFor(FPipelineMeshTex2D* const pPipeline,
                              FMeshBatchStaticTex2D* const pBatch) const final;
 
+        void fillPipelineFor(FPipelineMeshColor* const pPipeline,
+                             FMeshBatchStorageStaticColor* const pStorage) const final;
+
+        /// @brief Fills single pipeline, that draws all given batches with one multi-draw. Batches must bind
+        /// the same texture arrays (see FMeshBatchStaticTex2D::getTextures), as samplers are bound per pipeline.
+        void fillPipelineFor(FPipelineMeshTex2D* const pPipeline,
+                             const std::vector<FMeshBatchStaticTex2D*>& batches) const final;
+
         template<typename TMeshBatch>
         FPipelineMesh* emplaceMeshAndFill(TMeshBatch* pMeshBatch);
 
+    private:
+
+        /**
+         * @brief Pushes VBO / IBO pages, that hold all given batches, and allocates sub-range of both for
+         * every batch, so that in-place updates of single batch never overlap with its neighbours.
+         * @param batches batches drawn by the same pipeline
+         * @param arenaInfos vertices / indices placement of every batch is written here (same order as batches)
+         * @param format vertex format of pipeline
+         * @param vboIndex index of pushed VBO page is written here
+         * @param iboIndex index of pushed IBO page is written here
+         */
+        void allocateArenaRanges(const std::vector<FMeshBatchStatic*>& batches,
+                                 std::vector<FMeshBatchArenaInfo>& arenaInfos,
+                                 EVertexFormat format, int32& vboIndex, int32& iboIndex) const;
+
     };
 
 
@@ -30,7 +30,10 @@
 namespace marengine {
 
     class FMeshBatch;
+    class FMeshBatchStatic;
     class FMeshBatchStaticColor;
+    class FMeshBatchStaticTex2D;
+    struct FMeshBatchRange;
     class FPointLightBatch;
     class FRenderCamera;
     class FBatchManager;
@@ -38,7 +41,7 @@ namespace marengine {
 
 
     enum class ERenderBatchUpdateType {
-        NONE, TRANSFORM, RENDERABLE_COLOR, POINTLIGHT
+        NONE, TRANSFORM, RENDERABLE_COLOR, RENDERABLE_TEX2D, POINTLIGHT, VERTICES, INDICES, INSTANCES, VISIBILITY
     };
 
 
@@ -64,6 +67,7 @@ namespace marengine {
 
         void setCamera(const FRenderCamera* pRenderCamera);
         MAR_NO_DISCARD bool isCameraValid() const;
+        MAR_NO_DISCARD const FRenderCamera* getCamera() const;
         MAR_NO_DISCARD FFramebuffer* getViewportFramebuffer() const;
 
         void pushCameraToRender(const FRenderCamera* pRenderCamera);
@@ -72,6 +76,9 @@ namespace marengine {
         template<ERenderBatchUpdateType TUpdateType, typename TBatch>
         void update(TBatch* pBatch) const { }
 
+        template<ERenderBatchUpdateType TUpdateType, typename TBatch>
+        void update(TBatch* pBatch, const FMeshBatchRange& range) const { }
+
     private:
 
         const FRenderCamera* m_pRenderCamera{ nullptr };
@@ -90,6 +97,16 @@ namespace marengine {
             FPointLightBatch* pBatch) const;
     template<> void FRenderManager::update<ERenderBatchUpdateType::RENDERABLE_COLOR>(
             FMeshBatchStaticColor* pBatch) const;
+    template<> void FRenderManager::update<ERenderBatchUpdateType::RENDERABLE_TEX2D>(
+            FMeshBatchStaticTex2D* pBatch) const;
+    template<> void FRenderManager::update<ERenderBatchUpdateType::INSTANCES>(
+            FMeshBatchStatic* pBatch) const;
+    template<> void FRenderManager::update<ERenderBatchUpdateType::VISIBILITY>(
+            FMeshBatch* pBatch) const;
+    template<> void FRenderManager::update<ERenderBatchUpdateType::VERTICES>(
+            FMeshBatch* pBatch, const FMeshBatchRange& range) const;
+    template<> void FRenderManager::update<ERenderBatchUpdateType::INDICES>(
+            FMeshBatch* pBatch, const FMeshBatchRange& range) const;
 
 
 }
@@ -56,6 +56,22 @@ namespace marengine {
         uint32 coloredEntitiesCount{ 0 };
         uint32 textured2dEntitiesCount{ 0 };
         uint32 allRendererEntitiesCount{ 0 };
+        uint32 transformsUploadedBytes{ 0 };
+        uint32 colorsUploadedBytes{ 0 };
+        uint32 lightsUploadedBytes{ 0 };
+        uint32 bufferUpdatesCount{ 0 };
+        uint32 stateCallsIssued{ 0 };
+        uint32 stateCallsSkipped{ 0 };
+        /// @brief texture arrays bound for all Tex2D batches against textures these batches reference, the
+        /// latter is how many binds would be needed if every texture was bound separately
+        uint32 textureBindsCount{ 0 };
+        uint32 texturesReferencedCount{ 0 };
+        /// @brief rendered entities visible, outside of camera frustum and occluded at last culling
+        uint32 visibleEntitiesCount{ 0 };
+        uint32 culledEntitiesCount{ 0 };
+        uint32 occludedEntitiesCount{ 0 };
+        uint32 occludersCount{ 0 };
+        float occlusionCullingTime{ 0.f };
 	};
 
 
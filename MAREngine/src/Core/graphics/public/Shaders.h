@@ -39,6 +39,12 @@ namespace marengine {
         void passGeometry(const char* path) final;
         void passCompute(const char* path) final;
         void passFragment(const char* path) final;
+        void passStages(const FShaderStagesPaths& stagesPaths) final;
+
+        void acquire() final;
+        /// @brief returns count of references left after releasing one
+        MAR_NO_DISCARD uint32 release() final;
+        MAR_NO_DISCARD uint32 getReferencesCount() const final;
 
     protected:
 
@@ -48,20 +54,49 @@ namespace marengine {
         const char* p_tessEvalPath{ nullptr };
         const char* p_tessControlPath{ nullptr };
         const char* p_computePath{ nullptr };
+        uint32 p_referencesCount{ 0 };
 
     };
 
 
+    typedef std::array<std::string, 6> FShaderStagesKey;
+
+
+    /**
+     * @brief Stores shader programs. Programs are cached by paths of their stages, so that every pipeline
+     * using the same stages shares single program. Program is closed, when last pipeline releases it.
+     */
     class FShadersStorage : public IShadersStorage {
     public:
 
         virtual uint32 getCount() const = 0;
         virtual FShaders* get(int32 index) const = 0;
 
+        /// @brief returns cached program compiled from given stages, nullptr if there is no such program
+        MAR_NO_DISCARD FShaders* retrieve(const FShaderStagesPaths& stagesPaths) const;
+        void cache(const FShaderStagesPaths& stagesPaths, int32 index);
+        void release(int32 index);
+
+        /// @brief counts compiled program, so that binary cache hit rate can be logged
+        void passCompilation(const FShaders* pShaders, float milliseconds);
+        /// @brief logs count of programs compiled since last reset, their time and binary cache hit rate
+        void logCompilationStats() const;
+
+    protected:
+
+        std::map<FShaderStagesKey, int32> p_cachedIndexes;
+        uint32 p_compiledCount{ 0 };
+        uint32 p_loadedFromBinaryCount{ 0 };
+        float p_compilationTime{ 0.f };
+
     };
 
 
     class FShadersFactory : public IShadersFactory {
+    public:
+
+        /// @brief returns cached program for given stages (compiling it only once) and acquires it
+        MAR_NO_DISCARD FShaders* emplaceCached(const FShaderStagesPaths& stagesPaths) final;
 
     };
 
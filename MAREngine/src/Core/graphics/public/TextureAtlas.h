@@ -0,0 +1,99 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+
+
+#ifndef MARENGINE_TEXTUREATLAS_H
+#define MARENGINE_TEXTUREATLAS_H
+
+
+#include "../../../mar.h"
+
+
+namespace marengine {
+
+
+    /// @brief Skyline bottom-left packer over single atlas page, all sizes and positions are counted in texels.
+    /// Skyline is kept as list of horizontal segments, every rectangle is placed at lowest position it fits.
+    class FSkylinePacker {
+    public:
+
+        void create(uint32 width, uint32 height);
+
+        /// @brief finds place for rectangle, returns false if page is too full to hold it
+        MAR_NO_DISCARD bool insert(uint32 width, uint32 height, uint32& x, uint32& y);
+
+        /// @brief returns fraction of page area covered with inserted rectangles
+        MAR_NO_DISCARD float getOccupancy() const;
+
+    private:
+
+        /// @brief returns true if rectangle fits with its left edge at given segment, y is where it lands
+        MAR_NO_DISCARD bool fitsAt(uint32 segment, uint32 width, uint32 height, uint32& y) const;
+        void addSkylineLevel(uint32 segment, uint32 x, uint32 y, uint32 width, uint32 height);
+
+        struct FSegment {
+            uint32 x{ 0 };
+            uint32 y{ 0 };
+            uint32 width{ 0 };
+        };
+
+        std::vector<FSegment> m_skyline;
+        uint64 m_usedArea{ 0 };
+        uint32 m_width{ 0 };
+        uint32 m_height{ 0 };
+
+    };
+
+
+    struct FTextureAtlasRegion {
+        uint32 page{ 0 };
+        uint32 x{ 0 };
+        uint32 y{ 0 };
+    };
+
+
+    /// @brief Packs textures into square pages of atlas, new page is pushed when none of existing ones has place.
+    /// Every texture is surrounded with padding, so that linear filtering does not read its neighbours.
+    class FTextureAtlas {
+    public:
+
+        void create(uint32 pageSize, uint32 padding);
+
+        MAR_NO_DISCARD bool insert(uint32 width, uint32 height, FTextureAtlasRegion& region);
+
+        MAR_NO_DISCARD uint32 getPageCount() const;
+        MAR_NO_DISCARD uint32 getPageSize() const;
+        /// @brief returns fraction of all pages area covered with textures
+        MAR_NO_DISCARD float getOccupancy() const;
+
+    private:
+
+        std::vector<FSkylinePacker> m_pages;
+        uint32 m_pageSize{ 0 };
+        uint32 m_padding{ 0 };
+
+    };
+
+
+}
+
+
+#endif //MARENGINE_TEXTUREATLAS_H
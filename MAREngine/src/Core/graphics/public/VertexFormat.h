@@ -0,0 +1,72 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+
+
+#ifndef MARENGINE_VERTEXFORMAT_H
+#define MARENGINE_VERTEXFORMAT_H
+
+
+#include "IRender.h"
+
+
+namespace marengine {
+
+    class FVertexBuffer;
+
+
+    /**
+     * @class FVertexFormat VertexFormat.h "Core/graphics/public/VertexFormat.h"
+     * @brief Batches always keep vertices in Vertex layout, FVertexFormat converts them at upload time
+     * if pipeline was created with EVertexFormat::PACKED. Default format is applied to pipelines
+     * created after the change.
+     */
+    class FVertexFormat {
+    public:
+
+        static void setDefault(EVertexFormat format);
+        static EVertexFormat getDefault();
+
+        /// @brief returns size of single vertex at GPU buffer in bytes
+        static uint32 getStride(EVertexFormat format);
+
+        /// @brief uploads count of vertices starting at begin to vertex buffer at element offset,
+        /// packing them first if needed. Offset is counted in vertices, not bytes.
+        static void update(FVertexBuffer* pVertexBuffer, EVertexFormat format, const FVertexArray& vertices,
+                           uint32 begin, uint32 count, uint32 offset);
+
+        static VertexPacked pack(const Vertex& vertex);
+        /// @brief octahedral encoding of normal vector into two snorm16 values
+        static void encodeOctahedral(const maths::vec3& normal, int16_t& x, int16_t& y);
+        /// @brief converts float to IEEE 754 half, rounding to nearest even
+        static uint16_t toHalf(float value);
+
+    private:
+
+        static EVertexFormat s_defaultFormat;
+        static FVertexPackedArray s_packedVertices;
+
+    };
+
+
+}
+
+
+#endif //MARENGINE_VERTEXFORMAT_H
@@ -25,6 +25,8 @@
 
 
 #include "MAREnginePy_Trampoline.h"
+#include "PythonScript.h"
+#include "../ecs/Scene.h"
 
 
 namespace py = pybind11;
@@ -314,6 +316,50 @@ PYBIND11_EMBEDDED_MODULE(MAREnginePy, m) {
 		.def_readwrite("camera",	&PyEntity::camera)
 		.def_readwrite("color",		&PyEntity::renderable);
 
+	// -----------------------------------------------------------------------------------
+	// Scene queries (bounding volume hierarchy), entities are returned as list of their handles, as tags
+	// are not unique. Tag of returned entity can be read with getTag.
+	// -----------------------------------------------------------------------------------
+
+	auto getHandles = [](const FEntityArray& entities) {
+		py::list handles;
+		for (const Entity& entity : entities) {
+			handles.append(entt::to_integral(entity.getHandle()));
+		}
+		return handles;
+	};
+
+	m.def("queryBox",
+		[getHandles](vec3 min, vec3 max) {
+			Scene* pScene{ PythonScript::getScene() };
+			return pScene ? getHandles(pScene->queryBox({ min, max })) : py::list();
+		}, py::arg("min"), py::arg("max"));
+
+	m.def("querySphere",
+		[getHandles](vec3 center, float radius) {
+			Scene* pScene{ PythonScript::getScene() };
+			return pScene ? getHandles(pScene->querySphere(center, radius)) : py::list();
+		}, py::arg("center"), py::arg("radius"));
+
+	m.def("queryRay",
+		[getHandles](vec3 origin, vec3 direction, float maxDistance) {
+			Scene* pScene{ PythonScript::getScene() };
+			return pScene ? getHandles(pScene->queryRay(origin, direction, maxDistance)) : py::list();
+		}, py::arg("origin"), py::arg("direction"), py::arg("maxDistance"));
+
+	m.def("queryFrustum",
+		[getHandles](const mat4& viewProjection) {
+			Scene* pScene{ PythonScript::getScene() };
+			return pScene ? getHandles(pScene->queryFrustum(viewProjection)) : py::list();
+		}, py::arg("viewProjection"));
+
+	m.def("getTag",
+		[](uint32 handle) {
+			Scene* pScene{ PythonScript::getScene() };
+			const entt::entity enttEntity{ handle };
+			return pScene && pScene->isValid(enttEntity) ? pScene->getComponent<CTag>(enttEntity).tag : std::string();
+		}, py::arg("handle"));
+
 	// -----------------------------------------------------------------------------------
 	// Helper methods
 	// -----------------------------------------------------------------------------------
@@ -25,12 +25,23 @@
 #include "../../ProjectManager.h"
 #include "../filesystem/public/FileManager.h"
 #include "../ecs/Entity/Entity.h"
+#include "../ecs/TransformSystem.h"
 #include "MAREnginePy.cpp"
 
 
 namespace marengine {
 
+    Scene* PythonScript::s_pScene{ nullptr };
+
     
+    void PythonScript::passScene(Scene* pScene) {
+        s_pScene = pScene;
+    }
+
+    Scene* PythonScript::getScene() {
+        return s_pScene;
+    }
+
     void PythonScript::loadScript(const std::string& scriptPath) {
         const std::string from = FPythonInterpreter::changeSlashesToDots(scriptPath);
         const std::string what = FPythonInterpreter::getModuleFromPath(scriptPath);
@@ -93,6 +104,7 @@ namespace marengine {
         m_module.attr("update")();
     
         transform = m_module.attr("transform").cast<CTransform>();
+        FTransformSystem::markDirty(entity);
 
         if (entity.hasComponent<CPointLight>()) {
             entity.getComponent<CPointLight>().pointLight =
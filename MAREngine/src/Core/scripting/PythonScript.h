@@ -31,6 +31,7 @@ namespace marengine {
 
     namespace py = pybind11;
     class Entity;
+    class Scene;
     
 
     class PythonScript {
@@ -44,8 +45,14 @@ namespace marengine {
 
         void update(const Entity& entity) const;
 
+        /// @brief Passes scene, which is queried by MAREnginePy functions (queryBox, querySphere, queryRay)
+        static void passScene(Scene* pScene);
+        MAR_NO_DISCARD static Scene* getScene();
+
     private:
 
+        static Scene* s_pScene;
+
         py::module m_scriptModule;
         py::object m_module;
         bool m_initialized{ false };
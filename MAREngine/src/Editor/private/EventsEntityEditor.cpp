@@ -26,6 +26,7 @@
 #include "../../Core/ecs/SceneManagerEditor.h"
 #include "../../Core/ecs/Scene.h"
 #include "../../Core/ecs/Entity/Entity.h"
+#include "../../Core/ecs/Entity/EventsComponentEntity.h"
 
 
 namespace marengine {
@@ -40,15 +41,19 @@ namespace marengine {
     }
 
 	void FEventsEntityEditor::onCreateEntity() {
-		const Entity& createdEntity{ s_pSceneManagerEditor->getScene()->createEntity() };
+		const Entity createdEntity{ s_pSceneManagerEditor->getScene()->createEntity() };
 		onSelectedEntity(createdEntity);
 	}
 
 	void FEventsEntityEditor::onDestroyEntity(const Entity& entity) {
+        if(entity.hasComponent<CRenderable>()) {
+            FEventsComponentEntity::onRemove<CRenderable>(entity);
+        }
+        if(entity.hasComponent<CPointLight>()) {
+            FEventsComponentEntity::onRemove<CPointLight>(entity);
+        }
         s_pSceneManagerEditor->getScene()->destroyEntity(entity);
         s_pInspectorWidget->resetInspectedEntity();
-        // TODO: optimize it, because we don't need to reinitialize the whole render pipeline during entity destruction
-        s_pSceneManagerEditor->updateSceneAtBatchManager();
 	}
 
 	void FEventsEntityEditor::onSelectedEntity(const Entity& entity) {
@@ -78,16 +83,19 @@ namespace marengine {
 
 	void FEventsEntityEditor::onAssignChild(const Entity& entity, const Entity& child) {
 		entity.assignChild(child);
+		// child's transform is now relative to its parent
+		FEventsComponentEntity::onUpdate<CTransform>(child);
 		onSelectedEntity(child);
 	}
 
 	void FEventsEntityEditor::onRemoveChild(const Entity& entity, const Entity& child) {
 		entity.removeChild(child);
+		FEventsComponentEntity::onUpdate<CTransform>(child);
 		onUnselectedEntity(child);
 	}
 
 	void FEventsEntityEditor::onCreateChild(const Entity& entity) {
-		const Entity& createdChild{ s_pSceneManagerEditor->getScene()->createEntity() };
+		const Entity createdChild{ s_pSceneManagerEditor->getScene()->createEntity() };
 		onAssignChild(entity, createdChild);
 	}
 
@@ -56,7 +56,7 @@ namespace marengine {
 
         ImGui::Separator();
 
-        const FEntityArray& entities{ pScene->getEntities() };
+        const FEntityArray entities{ pScene->getEntities() };
         for (const Entity& entity : entities) {
             displayInfoAbout(entity);
             ImGui::Separator();
@@ -76,6 +76,18 @@ namespace marengine {
         ImGui::Text("Colored Entities: %d", storage.coloredEntitiesCount);
         ImGui::Text("Textured2D Entities: %d", storage.textured2dEntitiesCount);
         ImGui::Text("Rendered Entities: %d", storage.allRendererEntitiesCount);
+        ImGui::Text("Uploaded Transforms (bytes): %d", storage.transformsUploadedBytes);
+        ImGui::Text("Uploaded Colors (bytes): %d", storage.colorsUploadedBytes);
+        ImGui::Text("Uploaded Lights (bytes): %d", storage.lightsUploadedBytes);
+        ImGui::Text("Buffer Updates: %d", storage.bufferUpdatesCount);
+        ImGui::Text("GL State Calls Issued: %d", storage.stateCallsIssued);
+        ImGui::Text("GL State Calls Skipped: %d", storage.stateCallsSkipped);
+        ImGui::Text("Texture Binds: %d (textures referenced: %d)", storage.textureBindsCount,
+                    storage.texturesReferencedCount);
+        ImGui::Text("Visible Entities: %d", storage.visibleEntitiesCount);
+        ImGui::Text("Culled Entities: %d", storage.culledEntitiesCount);
+        ImGui::Text("Occluded Entities: %d (occluders: %d, %.3f ms)", storage.occludedEntitiesCount,
+                    storage.occludersCount, storage.occlusionCullingTime);
 
         ImGui::Separator();
 
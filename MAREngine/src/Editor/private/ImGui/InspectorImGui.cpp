@@ -118,10 +118,10 @@ namespace marengine {
     }
 
     void FInspectorWidgetImGui::displayComponentPopMenu() const {
-        const bool hasRenderable{ p_pInspectedEntity->hasComponent<CRenderable>() };
-        const bool hasLight{ p_pInspectedEntity->hasComponent<CPointLight>() };
-        const bool hasCamera{ p_pInspectedEntity->hasComponent<CCamera>() };
-        const bool hasScript{ p_pInspectedEntity->hasComponent<CPythonScript>() };
+        const bool hasRenderable{ p_inspectedEntity.hasComponent<CRenderable>() };
+        const bool hasLight{ p_inspectedEntity.hasComponent<CPointLight>() };
+        const bool hasCamera{ p_inspectedEntity.hasComponent<CCamera>() };
+        const bool hasScript{ p_inspectedEntity.hasComponent<CPythonScript>() };
 
         if (!hasRenderable && ImGui::MenuItem("Add CRenderable")) {
             FEventsComponentEditor::onAdd<CRenderable>(getInspectedEntity());
@@ -160,13 +160,13 @@ namespace marengine {
 
     template<>
     void FInspectorWidgetImGui::displayComponentPanel<CTag>() {
-        auto& tagComponent{ p_pInspectedEntity->getComponent<CTag>() };
+        auto& tagComponent{ p_inspectedEntity.getComponent<CTag>() };
         FCommonTypeHandler::drawStringInputPanel<70>(tagComponent.tag);
     }
 
     template<>
     void FInspectorWidgetImGui::displayComponentPanel<CTransform>() {
-        CTransform& tran{ p_pInspectedEntity->getComponent<CTransform>() };
+        CTransform& tran{ p_inspectedEntity.getComponent<CTransform>() };
 
         const bool updatedTransform = [&tran]()->bool {
             const bool updatedPosition{
@@ -209,13 +209,13 @@ namespace marengine {
             return;
         }
 
-        auto& cPythonScript{ p_pInspectedEntity->getComponent<CPythonScript>() };
+        auto& cPythonScript{ p_inspectedEntity.getComponent<CPythonScript>() };
         ImGui::Text("Current script: %s", cPythonScript.scriptsPath.c_str());
 
         if (ImGui::Button(openScriptButton)) {
-            p_pInspectedEntity->addComponent<CEvent>(EEventType::PYTHONSCRIPT_OPEN);
+            p_inspectedEntity.addComponent<CEvent>(EEventType::PYTHONSCRIPT_OPEN);
             FEventsComponentEditor::onUpdate<CPythonScript>(getInspectedEntity());
-            p_pInspectedEntity->removeComponent<CEvent>();
+            p_inspectedEntity.removeComponent<CEvent>();
 
         }
         if (ImGui::Button(createNewButton)) {
@@ -237,19 +237,19 @@ namespace marengine {
         const FFilesystemDialogInfo newDialogInfo =
                 m_pFilesystem->displaySaveWidget(newScriptWindow, pyExt);
         if(newDialogInfo.isValid()) {
-            p_pInspectedEntity->addComponent<CEvent>(EEventType::PYTHONSCRIPT_CREATE_ASSIGN,
+            p_inspectedEntity.addComponent<CEvent>(EEventType::PYTHONSCRIPT_CREATE_ASSIGN,
                                                      &newDialogInfo);
             FEventsComponentEditor::onUpdate<CPythonScript>(getInspectedEntity());
-            p_pInspectedEntity->removeComponent<CEvent>();
+            p_inspectedEntity.removeComponent<CEvent>();
         }
 
         const FFilesystemDialogInfo assignDialogInfo =
                 m_pFilesystem->displayOpenWidget(assignScriptWindow, pyExt);
         if(assignDialogInfo.isValid()) {
-            p_pInspectedEntity->addComponent<CEvent>(EEventType::PYTHONSCRIPT_ASSIGN,
+            p_inspectedEntity.addComponent<CEvent>(EEventType::PYTHONSCRIPT_ASSIGN,
                                                      &newDialogInfo);
             FEventsComponentEditor::onUpdate<CPythonScript>(getInspectedEntity());
-            p_pInspectedEntity->removeComponent<CEvent>();
+            p_inspectedEntity.removeComponent<CEvent>();
         }
     }
 
@@ -266,14 +266,14 @@ namespace marengine {
             return;
         }
 
-        CRenderable& cRenderable{ p_pInspectedEntity->getComponent<CRenderable>() };
+        CRenderable& cRenderable{ p_inspectedEntity.getComponent<CRenderable>() };
         ImGui::Text("Current: %s", cRenderable.mesh.path.c_str());
 
         const bool changedColor = ImGui::ColorEdit4("Color", &cRenderable.color.x);
         if(changedColor) {
-            p_pInspectedEntity->addComponent<CEvent>(EEventType::RENDERABLE_COLOR_UPDATE);
+            p_inspectedEntity.addComponent<CEvent>(EEventType::RENDERABLE_COLOR_UPDATE);
             FEventsComponentEditor::onUpdate<CRenderable>(getInspectedEntity());
-            p_pInspectedEntity->removeComponent<CEvent>();
+            p_inspectedEntity.removeComponent<CEvent>();
         }
 
         if (ImGui::Button(loadTexture2DButton)) {
@@ -282,9 +282,9 @@ namespace marengine {
 
         const bool selectedMesh{ m_pContentBrowser->drawMeshListBox(cRenderable) };
         if(selectedMesh) {
-            p_pInspectedEntity->addComponent<CEvent>(EEventType::RENDERABLE_MESH_UPDATE);
+            p_inspectedEntity.addComponent<CEvent>(EEventType::RENDERABLE_MESH_UPDATE);
             FEventsComponentEditor::onUpdate<CRenderable>(getInspectedEntity());
-            p_pInspectedEntity->removeComponent<CEvent>();
+            p_inspectedEntity.removeComponent<CEvent>();
         }
         if(m_loadTex2D) {
             m_pFilesystem->openWidget(loadTexture2D);
@@ -293,10 +293,10 @@ namespace marengine {
         const FFilesystemDialogInfo loadTex2DInfo =
                 m_pFilesystem->displayOpenWidget(loadTexture2D, jpgExt);
         if(loadTex2DInfo.isValid()) {
-            p_pInspectedEntity->addComponent<CEvent>(EEventType::RENDERABLE_TEX2D_LOAD,
+            p_inspectedEntity.addComponent<CEvent>(EEventType::RENDERABLE_TEX2D_LOAD,
                                                      &loadTex2DInfo);
             FEventsComponentEditor::onUpdate<CRenderable>(getInspectedEntity());
-            p_pInspectedEntity->removeComponent<CEvent>();
+            p_inspectedEntity.removeComponent<CEvent>();
         }
     }
 
@@ -306,7 +306,7 @@ namespace marengine {
             FEventsComponentEditor::onRemove<CCamera>(getInspectedEntity());
             return;
         }
-        CCamera& camera{ p_pInspectedEntity->getComponent<CCamera>() };
+        CCamera& camera{ p_inspectedEntity.getComponent<CCamera>() };
 
         ImGui::Text("WARNING: To use camera in PlayMode please set Camera ID to \"main\"!");
 
@@ -357,7 +357,7 @@ namespace marengine {
             FEventsComponentEditor::onRemove<CPointLight>(getInspectedEntity());
             return;
         }
-        FPointLight& pointLight{ p_pInspectedEntity->getComponent<CPointLight>().pointLight };
+        FPointLight& pointLight{ p_inspectedEntity.getComponent<CPointLight>().pointLight };
         bool updatedLight = false;
 
         if (FCommonTypeHandler::drawVectorInputPanel("Ambient", pointLight.ambient, 0.f, 100.f, 0.01f, 100.f)) { updatedLight = true; }
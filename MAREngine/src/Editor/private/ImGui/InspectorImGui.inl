@@ -34,7 +34,7 @@ namespace marengine {
 
     template<typename TComponent>
     void FInspectorWidgetImGui::handle(const char* componentName) {
-        if (p_pInspectedEntity->hasComponent<TComponent>() && ImGui::CollapsingHeader(componentName)) {
+        if (p_inspectedEntity.hasComponent<TComponent>() && ImGui::CollapsingHeader(componentName)) {
             displayComponentPanel<TComponent>();
         }
     }
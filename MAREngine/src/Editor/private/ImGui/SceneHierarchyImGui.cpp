@@ -31,7 +31,7 @@
 
 namespace marengine {
 
-    static void treesFor(const FEntityArray& entities);
+    static void treeFor(const Entity& entity);
 
 
     void FSceneHierarchyWidgetImGui::create(FServiceLocatorEditor* pServiceLocator) {
@@ -51,42 +51,43 @@ namespace marengine {
         ImGui::Text("SCENE - %s", m_pSceneManagerEditor->getScene()->getName().c_str());
         ImGui::Separator();
 
-        const FEntityArray& entities{ m_pSceneManagerEditor->getScene()->getEntities() };
-        treesFor(entities);
+        // Children are displayed under their parents, so only root entities start trees
+        for (const Entity& entity : m_pSceneManagerEditor->getScene()->getEntities()) {
+            if (!entity.hasParent()) {
+                treeFor(entity);
+            }
+        }
 
         popUpMenu();
 
         ImGui::End();
     }
 
-    void treesFor(const FEntityArray& entities) {
-        auto displayTreeOrMenuItemRecursively = [](const Entity& entity) {
-            constexpr ImGuiTreeNodeFlags treeNodeFlags{
-                    ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_OpenOnDoubleClick | ImGuiTreeNodeFlags_SpanAvailWidth
-            };
-            const char* entityTag{ entity.getComponent<CTag>().tag.c_str() };
+    void treeFor(const Entity& entity) {
+        constexpr ImGuiTreeNodeFlags treeNodeFlags{
+                ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_OpenOnDoubleClick | ImGuiTreeNodeFlags_SpanAvailWidth
+        };
+        const char* entityTag{ entity.getComponent<CTag>().tag.c_str() };
 
-            if (entity.hasChildren()) { // if entity has children we want tree nodes
-                const bool isTreeOpen{ ImGui::TreeNodeEx(entityTag, treeNodeFlags) };
-                if (ImGui::IsItemClicked()) {
-                    FEventsEntityEditor::onSelectedEntity(entity);
+        if (entity.hasChildren()) { // if entity has children we want tree nodes
+            const bool isTreeOpen{ ImGui::TreeNodeEx(entityTag, treeNodeFlags) };
+            if (ImGui::IsItemClicked()) {
+                FEventsEntityEditor::onSelectedEntity(entity);
 
+            }
+            if (isTreeOpen) {
+                for (const Entity& child : entity.getChildren()) {
+                    treeFor(child);
                 }
-                if (isTreeOpen) {
-                    const FEntityArray& children{ entity.getChildren() };
-                    treesFor(children);
 
-                    ImGui::TreePop();
-                }
+                ImGui::TreePop();
             }
-            else { // if not normal menu item
-                if (ImGui::MenuItem(entityTag)) {
-                    FEventsEntityEditor::onSelectedEntity(entity);
-                }
+        }
+        else { // if not normal menu item
+            if (ImGui::MenuItem(entityTag)) {
+                FEventsEntityEditor::onSelectedEntity(entity);
             }
-        };
-
-        std::for_each(entities.cbegin(), entities.cend(), displayTreeOrMenuItemRecursively);
+        }
     }
 
     void FSceneHierarchyWidgetImGui::buttonsAtPanel() const {
@@ -218,7 +218,7 @@ namespace marengine {
 
 
     static bool draw(ImGuizmo::OPERATION guizmoOperation, const FRenderCamera* pRenderCamera,
-                     CTransform& transformComponent);
+                     CTransform& transformComponent, const maths::mat4* pParentTransform);
 
     void drawGuizmo(ImGuizmo::OPERATION guizmoOperation, const FRenderCamera* pRenderCamera,
                     const Entity& currentEntity) {
@@ -227,14 +227,17 @@ namespace marengine {
             return;
         }
 
-        const bool userUsedGuizmo{ draw(guizmoOperation, pRenderCamera, transform) };
+        // Guizmo works on world matrix, but CTransform stores values relative to parent
+        const maths::mat4* pParentTransform{ currentEntity.hasParent() ?
+            &currentEntity.getParent().getComponent<CTransform>().getTransform() : nullptr };
+        const bool userUsedGuizmo{ draw(guizmoOperation, pRenderCamera, transform, pParentTransform) };
         if (userUsedGuizmo) {
             FEventsComponentEntity::onUpdate<CTransform>(currentEntity);
         }
     }
 
     bool draw(ImGuizmo::OPERATION guizmoOperation, const FRenderCamera* pRenderCamera,
-              CTransform& transformComponent) {
+              CTransform& transformComponent, const maths::mat4* pParentTransform) {
         using namespace maths;
 
         mat4 transform{ transformComponent.getTransform() };
@@ -257,6 +260,10 @@ namespace marengine {
         ImGuizmo::Manipulate(pView, pProjection, guizmoOperation, ImGuizmo::MODE::LOCAL, pTransform);
 
         if (ImGuizmo::IsUsing()) {
+            if (pParentTransform != nullptr) {
+                transform = mat4::inverse(*pParentTransform) * transform;
+            }
+
             vec3 rot;
             mat4::decompose(transform, transformComponent.position, rot, transformComponent.scale);
             transformComponent.rotation = transformComponent.rotation + (rot - transformComponent.rotation); // + deltaRotation, fighting with GimbleLock
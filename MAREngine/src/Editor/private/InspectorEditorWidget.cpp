@@ -28,19 +28,19 @@ namespace marengine {
 
 
     void FInspectorEditorWidget::resetInspectedEntity() {
-        p_pInspectedEntity = nullptr;
+        p_inspectedEntity = Entity{ entt::null, nullptr };
     }
 
     void FInspectorEditorWidget::setInspectedEntity(const Entity& entity) {
-        p_pInspectedEntity = &entity;
+        p_inspectedEntity = entity;
     }
 
     const Entity& FInspectorEditorWidget::getInspectedEntity() const {
-        return *p_pInspectedEntity;
+        return p_inspectedEntity;
     }
 
     bool FInspectorEditorWidget::isInspectedEntityValid() const {
-        return p_pInspectedEntity != nullptr;
+        return p_inspectedEntity.isValid();
     }
 
 
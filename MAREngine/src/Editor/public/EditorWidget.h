@@ -25,12 +25,11 @@
 
 
 #include "IEditorWidget.h"
+#include "../../Core/ecs/Entity/Entity.h"
 
 
 namespace marengine {
 
-    class Entity;
-
 
     class FDebugEditorWidget : public IDebugEditorWidget {
 
@@ -52,7 +51,8 @@ namespace marengine {
 
     protected:
 
-        const Entity* p_pInspectedEntity{ nullptr };
+        /// @brief stored by value (handle), so that destroying other entities at scene does not invalidate it
+        Entity p_inspectedEntity{ entt::null, nullptr };
 
     };
 
@@ -176,6 +176,11 @@ namespace marengine {
 
         while(!window.isGoingToClose() && !pEngine->isGoingToRestart()) {
             renderStatistics.reset();
+            renderCommands.prepareFrame();
+            sceneManager.updateTransforms();
+            batchManager.updateLevelsOfDetail(sceneManager.getScene());
+            batchManager.cullEntities(sceneManager.getScene());
+            batchManager.pushDirtyRangesToRender();
 
             pFramebufferViewport->clear();
 
@@ -188,6 +193,8 @@ namespace marengine {
             for(int32 i = 0; i < countTex2D; i++) {
                 renderCommands.draw(pFramebufferViewport, pPipelineStorage->getTex2DMesh(i));
             }
+            pFramebufferViewport->unbind();
+            renderContext.getBufferStorage()->endFrame();
 
             sceneManager.update();
             serviceManagerEditor.onUpdate();
@@ -270,6 +277,11 @@ namespace marengine {
 
         while(!window.isGoingToClose() && !pEngine->isGoingToRestart()) {
             renderStatistics.reset();
+            renderCommands.prepareFrame();
+            sceneManager.updateTransforms();
+            batchManager.updateLevelsOfDetail(sceneManager.getScene());
+            batchManager.cullEntities(sceneManager.getScene());
+            batchManager.pushDirtyRangesToRender();
             window.clear();
 
             const uint32_t countColor{ pPipelineStorage->getCountColorMesh() };
@@ -281,6 +293,7 @@ namespace marengine {
             for(uint32_t i = 0; i < countTex2D; i++) {
                 renderCommands.draw(pPipelineStorage->getTex2DMesh(i));
             }
+            renderContext.getBufferStorage()->endFrame();
 
             sceneManager.update();
 
@@ -164,13 +164,24 @@
 #include <fstream> 
 #include <string>
 #include <sstream>
+#include <iomanip>
 #include <vector> 
 #include <utility>
 #include <unordered_map>
+#include <map>
 #include <algorithm>
 #include <ctime>
+#include <chrono>
 #include <variant>
 #include <random>
 #include <filesystem>
 #include <type_traits>
+#include <limits>
+#include <array>
+#include <cstring>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <queue>
 
@@ -0,0 +1,42 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+#include "src/Benchmark.h"
+#include "Logging/Logger.h"
+
+
+using namespace marengine;
+
+
+/**
+ * @brief Usage: MAREngineBench [--smoke] [filter], only benchmarks which names contain filter are run.
+ * With --smoke every benchmark processes hundredth of its elements, so that its checks run quickly.
+ */
+int main(int argc, char** argv) {
+
+    FLogger::init();
+    const bool isSmokeRun{ argc > 1 && std::string(argv[1]) == "--smoke" };
+    const int32 filterArgument{ isSmokeRun ? 2 : 1 };
+    const std::string filter{ argc > filterArgument ? argv[filterArgument] : "" };
+    FBenchmark::passSmokeRun(isSmokeRun);
+    const uint32 failedChecksCount{ FBenchmark::run(filter) };
+
+    return failedChecksCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,227 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+#include "Benchmark.h"
+#include "Core/ecs/Scene.h"
+#include "Core/graphics/public/BatchManager.h"
+#include "Core/graphics/public/MeshManager.h"
+
+
+namespace marengine {
+
+
+    static void createRenderedEntities(Scene& scene, uint32 count, const std::vector<EMeshType>& meshTypes);
+
+    template<typename TMeshBatchStorage>
+    static uint32 countPartiallyFilledBatches(TMeshBatchStorage* pMeshBatchStorage);
+
+    static bool areAllEntitiesRendered(Scene& scene);
+
+    static uint32 countStaticColorVertices(const FMeshBatchStorage* pMeshBatchStorage);
+
+    static void markBatchesDrawn(FMeshBatchStorageStaticColor* pStorage);
+
+    static bool areIndicesInVerticesRange(const FMeshBatchStorageStaticColor* pStorage);
+
+
+    MAR_BENCHMARK(BatchSceneAssignment) {
+        const uint32 entitiesCount{ FBenchmark::getCount(100000) };
+        FMeshManager meshManager;
+        Scene scene("AssignmentBenchmark");
+        createRenderedEntities(scene, entitiesCount, { EMeshType::CUBE, EMeshType::PYRAMID, EMeshType::SURFACE });
+
+        // Three default meshes shared by all entities would be instanced, so static batches are measured
+        // with instancing turned off first
+        const uint32 instancingThreshold{ FMeshBatchBudget::getInstancingThreshold() };
+        for(const bool isInstancingEnabled : { false, true }) {
+            FMeshBatchBudget::setInstancingThreshold(isInstancingEnabled ? instancingThreshold :
+                                                                           std::numeric_limits<uint32>::max());
+            FBatchManager batchManager;
+            batchManager.create(nullptr, meshManager.getStorage(), nullptr);
+
+            const std::string label{ isInstancingEnabled ? "instanced" : "static" };
+            const float assignmentTime{ FBenchmark::measure("assign " + std::to_string(entitiesCount) +
+                                                            " entities to " + label + " batches", 3,
+                                                            [&batchManager, &scene]() {
+                batchManager.batchScene(&scene);
+            }) };
+            FBenchmark::report("entities assigned to " + label + " batches per second",
+                               (double)entitiesCount * 1000.0 / std::max(assignmentTime, 1e-6f), "entities/s");
+
+            FBenchmark::check(areAllEntitiesRendered(scene), label + ": every entity should be assigned to batch");
+            if(!isInstancingEnabled) {
+                // Meshes of any size share batches of the same texture set, so only the last batch is not full
+                const FMeshBatchStorage* pStorage{ batchManager.getMeshBatchStorage() };
+                const uint32 partiallyFilledCount{ countPartiallyFilledBatches(pStorage->getStorageStaticColor()) };
+                FBenchmark::check(partiallyFilledCount <= 1, "static batches should be filled up before new ones "
+                                  "are created, partially filled: " + std::to_string(partiallyFilledCount));
+            }
+        }
+        FMeshBatchBudget::setInstancingThreshold(instancingThreshold);
+        scene.close();
+    }
+
+
+    MAR_BENCHMARK(BatchInsertRemove) {
+        const uint32 entitiesCount{ FBenchmark::getCount(20000) };
+        const uint32 removedCount{ entitiesCount / 2 };
+        FMeshManager meshManager;
+        Scene scene("InsertRemoveBenchmark");
+        // Single mesh, so that every released range fits exactly the entity inserted back
+        createRenderedEntities(scene, entitiesCount, { EMeshType::CUBE });
+
+        const uint32 instancingThreshold{ FMeshBatchBudget::getInstancingThreshold() };
+        FMeshBatchBudget::setInstancingThreshold(std::numeric_limits<uint32>::max());
+        FBatchManager batchManager;
+        batchManager.create(nullptr, meshManager.getStorage(), nullptr);
+        // Without render manager scene is only batched, so rebuild and edits below measure the same CPU work
+        const float rebuildTime{ FBenchmark::measure("full rebuild of " + std::to_string(entitiesCount) +
+                                                     " entities (pushSceneToRender)", 3, [&]() {
+            batchManager.pushSceneToRender(&scene);
+        }) };
+        markBatchesDrawn(batchManager.getMeshBatchStorage()->getStorageStaticColor());
+        const uint32 verticesCountBefore{ countStaticColorVertices(batchManager.getMeshBatchStorage()) };
+
+        // Every second entity leaves its batch and comes back, so freed ranges are reused in the middle of batches
+        std::vector<entt::entity> removedEntities;
+        const auto view{ scene.getView<CRenderable>() };
+        for(const entt::entity enttEntity : view) {
+            if(removedEntities.size() == removedCount) {
+                break;
+            }
+            if(((uint32)enttEntity & 1) == 0) {
+                removedEntities.push_back(enttEntity);
+            }
+        }
+
+        bool wasEveryEntityInsertedBack{ true };
+        const float editTime{ FBenchmark::measure("remove and insert back " + std::to_string(removedEntities.size()) +
+                                                  " entities (removeEntityFromRender / insertEntityToRender)", 5,
+                                                  [&]() {
+            for(const entt::entity enttEntity : removedEntities) {
+                batchManager.removeEntityFromRender(Entity(enttEntity, scene.getRegistry()));
+            }
+            for(const entt::entity enttEntity : removedEntities) {
+                if(!batchManager.insertEntityToRender(Entity(enttEntity, scene.getRegistry()))) {
+                    wasEveryEntityInsertedBack = false;
+                }
+            }
+        }) };
+        // Single entity edit is worth it, as long as it is cheaper than rebuilding scene for that entity
+        FBenchmark::report("full rebuild time / time of single entity remove and insert",
+                           (double)rebuildTime * removedEntities.size() / std::max(editTime, 1e-6f), "x");
+
+        FBenchmark::check(wasEveryEntityInsertedBack, "removed entity should fit back into drawn batch");
+        FBenchmark::check(areAllEntitiesRendered(scene), "every entity should be rendered after insertion");
+        const uint32 verticesCountAfter{ countStaticColorVertices(batchManager.getMeshBatchStorage()) };
+        FBenchmark::check(verticesCountAfter == verticesCountBefore, "released ranges should be reused, vertices "
+                          "count changed from " + std::to_string(verticesCountBefore) + " to " +
+                          std::to_string(verticesCountAfter));
+
+        // Tail of batch is trimmed after removal, indices left in the middle must still point at its vertices
+        for(size_t i = 0; i < removedEntities.size(); i += 2) {
+            batchManager.removeEntityFromRender(Entity(removedEntities[i], scene.getRegistry()));
+        }
+        FBenchmark::check(areIndicesInVerticesRange(batchManager.getMeshBatchStorage()->getStorageStaticColor()),
+                          "indices of batch should reference only its vertices after removal");
+        FMeshBatchBudget::setInstancingThreshold(instancingThreshold);
+        scene.close();
+    }
+
+
+    void createRenderedEntities(Scene& scene, uint32 count, const std::vector<EMeshType>& meshTypes) {
+        for(uint32 i = 0; i < count; i++) {
+            const Entity entity{ scene.createEntity() };
+            auto& cTransform{ entity.getComponent<CTransform>() };
+            cTransform.position = { (float)(i % 100) * 3.f, (float)((i / 100) % 100) * 3.f, (float)(i / 10000) * 3.f };
+            cTransform.markDirty();
+            cTransform.updateTransform();
+            auto& cRenderable{ entity.addComponent<CRenderable>() };
+            cRenderable.mesh.type = meshTypes[i % meshTypes.size()];
+            cRenderable.mesh.index = 0;
+            cRenderable.color = { (float)(i % 7) / 7.f, (float)(i % 11) / 11.f, (float)(i % 13) / 13.f, 1.f };
+        }
+    }
+
+    template<typename TMeshBatchStorage>
+    uint32 countPartiallyFilledBatches(TMeshBatchStorage* pMeshBatchStorage) {
+        uint32 partiallyFilledCount{ 0 };
+        const uint32 count{ pMeshBatchStorage->getCount() };
+        for(uint32 i = 0; i < count; i++) {
+            const FMeshBatchStatic* pBatch{ pMeshBatchStorage->get((int32)i) };
+            const uint32 instancesCount{ pBatch->getInstancesCount() };
+            if(instancesCount == 0) {
+                continue;
+            }
+            // Batch is not full, if it still has place for its average mesh
+            const uint32 verticesPerEntity{ (uint32)pBatch->getVertices().size() / instancesCount };
+            const uint32 indicesPerEntity{ (uint32)pBatch->getIndices().size() / instancesCount };
+            if(pBatch->hasPlaceFor(verticesPerEntity, indicesPerEntity)) {
+                partiallyFilledCount++;
+            }
+        }
+        return partiallyFilledCount;
+    }
+
+    bool areAllEntitiesRendered(Scene& scene) {
+        const auto view{ scene.getView<CRenderable>() };
+        return std::all_of(view.begin(), view.end(), [&view](entt::entity enttEntity) {
+            return view.get<CRenderable>(enttEntity).isEntityRendered();
+        });
+    }
+
+    uint32 countStaticColorVertices(const FMeshBatchStorage* pMeshBatchStorage) {
+        const FMeshBatchStorageStaticColor* pStorage{ pMeshBatchStorage->getStorageStaticColor() };
+        uint32 verticesCount{ 0 };
+        for(uint32 i = 0; i < pStorage->getCount(); i++) {
+            verticesCount += (uint32)pStorage->get((int32)i)->getVertices().size();
+        }
+        return verticesCount;
+    }
+
+    void markBatchesDrawn(FMeshBatchStorageStaticColor* pStorage) {
+        // Render manager would pass pipeline to every non-empty batch, only drawn batches take inserted entities
+        for(uint32 i = 0; i < pStorage->getCount(); i++) {
+            FMeshBatchStaticColor* pBatch{ pStorage->get((int32)i) };
+            if(!pBatch->getVertices().empty()) {
+                pBatch->passPipeline(0);
+            }
+        }
+    }
+
+    bool areIndicesInVerticesRange(const FMeshBatchStorageStaticColor* pStorage) {
+        for(uint32 i = 0; i < pStorage->getCount(); i++) {
+            const FMeshBatchStaticColor* pBatch{ pStorage->get((int32)i) };
+            const FIndicesArray& indices{ pBatch->getIndices() };
+            if(indices.empty()) {
+                continue;
+            }
+            const uint32 maxIndex{ *std::max_element(indices.cbegin(), indices.cend()) };
+            const bool fitsIndexType{ pBatch->getFittingIndexType() == EIndexType::UINT32 ||
+                                      maxIndex <= GraphicLimits::maxShortIndexedVerticesCount };
+            if(maxIndex >= pBatch->getVertices().size() || !fitsIndexType) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+
+}
@@ -0,0 +1,80 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+#include "Benchmark.h"
+
+
+namespace marengine {
+
+
+    uint32 FBenchmark::s_failedChecksCount{ 0 };
+    bool FBenchmark::s_isSmokeRun{ false };
+
+    bool FBenchmark::registerBenchmark(const char* name, FBenchmarkFunction function) {
+        getBenchmarks().emplace_back(name, function);
+        return true;
+    }
+
+    uint32 FBenchmark::run(const std::string& filter) {
+        s_failedChecksCount = 0;
+        for(const auto& [name, function] : getBenchmarks()) {
+            if(std::string(name).find(filter) == std::string::npos) {
+                continue;
+            }
+            std::cout << "[" << name << "]\n";
+            function();
+        }
+        std::cout << "Failed checks: " << s_failedChecksCount << "\n";
+        return s_failedChecksCount;
+    }
+
+    void FBenchmark::passSmokeRun(bool isSmokeRun) {
+        s_isSmokeRun = isSmokeRun;
+    }
+
+    uint32 FBenchmark::getCount(uint32 count) {
+        return s_isSmokeRun ? std::max(count / s_smokeCountDivisor, 1u) : count;
+    }
+
+    void FBenchmark::check(bool condition, const std::string& message) {
+        if(!condition) {
+            s_failedChecksCount++;
+            std::cout << "    CHECK FAILED: " << message << "\n";
+        }
+    }
+
+    void FBenchmark::report(const std::string& label, double value, const std::string& unit) {
+        std::cout << "    " << std::left << std::setw(56) << label << std::right << std::setw(12)
+                  << std::fixed << std::setprecision(3) << value << " " << unit << "\n";
+    }
+
+    void FBenchmark::printTime(const std::string& label, float milliseconds) {
+        std::cout << "    " << std::left << std::setw(56) << label << std::right << std::setw(12)
+                  << std::fixed << std::setprecision(3) << milliseconds << " ms\n";
+    }
+
+    std::vector<std::pair<const char*, FBenchmark::FBenchmarkFunction>>& FBenchmark::getBenchmarks() {
+        // Function local storage, so that benchmarks registered during static initialization always find it
+        static std::vector<std::pair<const char*, FBenchmarkFunction>> benchmarks;
+        return benchmarks;
+    }
+
+
+}
@@ -0,0 +1,114 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+#ifndef MARENGINE_BENCHMARK_H
+#define MARENGINE_BENCHMARK_H
+
+
+#include "mar.h"
+
+
+namespace marengine {
+
+
+    /**
+     * @class FBenchmark Benchmark.h "MAREngineBench/src/Benchmark.h"
+     * @brief Minimal harness for engine benchmarks. Every benchmark is a function registered with MAR_BENCHMARK,
+     * it times its hot loops with measure and validates results of measured code with check, so that executable
+     * (and ctest with it) fails, when optimized code path returns wrong results.
+     */
+    class FBenchmark {
+    public:
+
+        typedef void(*FBenchmarkFunction)();
+
+        static bool registerBenchmark(const char* name, FBenchmarkFunction function);
+
+        /**
+         * @brief Runs every registered benchmark, which name contains given filter.
+         * @param filter part of benchmark name, empty string runs all benchmarks
+         * @return count of failed checks
+         */
+        static uint32 run(const std::string& filter);
+
+        /// @brief Smoke run (registered as ctest) checks every benchmark at small scale, see getCount
+        static void passSmokeRun(bool isSmokeRun);
+
+        /**
+         * @brief Returns count of elements (entities, vertices) processed by benchmark, it is divided by
+         * s_smokeCountDivisor (to at least 1) at smoke run, so that checks are fast enough to run with every build.
+         * @param count count of elements at full benchmark
+         */
+        static uint32 getCount(uint32 count);
+
+        /**
+         * @brief Calls given function repeatedly and prints the best time.
+         * @param label printed next to measured time
+         * @param repeatsCount count of calls, the fastest one is reported (the first one warms up caches)
+         * @return the best time in milliseconds
+         */
+        template<typename TFunction>
+        static float measure(const std::string& label, uint32 repeatsCount, TFunction&& function);
+
+        /// @brief Prints measured quantity other than time (bytes, throughput) aligned with measured times
+        static void report(const std::string& label, double value, const std::string& unit);
+
+        /// @brief Counts failed check and prints given message, if condition is false
+        static void check(bool condition, const std::string& message);
+
+    private:
+
+        static void printTime(const std::string& label, float milliseconds);
+        static std::vector<std::pair<const char*, FBenchmarkFunction>>& getBenchmarks();
+
+
+        static constexpr uint32 s_smokeCountDivisor{ 100 };
+        static uint32 s_failedChecksCount;
+        static bool s_isSmokeRun;
+
+    };
+
+
+    template<typename TFunction>
+    float FBenchmark::measure(const std::string& label, uint32 repeatsCount, TFunction&& function) {
+        float bestTime{ std::numeric_limits<float>::max() };
+        for(uint32 i = 0; i < repeatsCount; i++) {
+            const auto start{ std::chrono::high_resolution_clock::now() };
+            function();
+            const std::chrono::duration<float, std::milli> time{ std::chrono::high_resolution_clock::now() - start };
+            bestTime = std::min(bestTime, time.count());
+        }
+        printTime(label, bestTime);
+        return bestTime;
+    }
+
+
+}
+
+
+/// @brief Defines benchmark function and registers it before main is called
+#define MAR_BENCHMARK(BenchmarkName)                                                                    \
+    static void BenchmarkName();                                                                        \
+    static const bool g_registered##BenchmarkName{                                                      \
+        ::marengine::FBenchmark::registerBenchmark(#BenchmarkName, &BenchmarkName) };                   \
+    static void BenchmarkName()
+
+
+#endif //MARENGINE_BENCHMARK_H
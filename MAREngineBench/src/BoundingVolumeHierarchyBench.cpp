@@ -0,0 +1,155 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+#include "Benchmark.h"
+#include "Core/ecs/BoundingVolumeHierarchy.h"
+#include "Core/graphics/public/FrustumCuller.h"
+
+
+namespace marengine {
+
+
+    static void createRandomBoxes(uint32 count, float sceneSize, std::mt19937& randomEngine,
+                                  std::vector<entt::entity>& entities, std::vector<FBoundingBox>& boxes);
+
+    static bool areBoxesOverlapping(const FBoundingBox& lhs, const FBoundingBox& rhs);
+
+    static bool isBoxInsideFrustum(const std::array<maths::vec4, 6>& planes, const FBoundingBox& box);
+
+
+    MAR_BENCHMARK(BoundingVolumeHierarchyQueries) {
+        constexpr uint32 queriesCount{ 100 };
+        for(const uint32 fullCount : { 10000u, 100000u, 1000000u }) {
+            const uint32 count{ FBenchmark::getCount(fullCount) };
+            // Density stays the same, so every query returns similar count of entities at every scene size
+            const float sceneSize{ std::cbrt((float)count) * 4.f };
+            std::mt19937 randomEngine{ count };
+            std::vector<entt::entity> entities;
+            std::vector<FBoundingBox> boxes;
+            createRandomBoxes(count, sceneSize, randomEngine, entities, boxes);
+
+            FBoundingVolumeHierarchy hierarchy;
+            const std::string suffix{ " (" + std::to_string(count) + " entities)" };
+            FBenchmark::measure("build" + suffix, 1, [&hierarchy, &entities, &boxes]() {
+                hierarchy.build(entities, boxes);
+            });
+            FBenchmark::check(hierarchy.getCount() == count, "every entity should be held in leaf" + suffix);
+
+            std::uniform_real_distribution<float> positionDistribution{ 0.f, sceneSize };
+            std::vector<FBoundingBox> queryBoxes;
+            for(uint32 i = 0; i < queriesCount; i++) {
+                const maths::vec3 min{ positionDistribution(randomEngine), positionDistribution(randomEngine),
+                                       positionDistribution(randomEngine) };
+                queryBoxes.push_back({ min, { min.x + 8.f, min.y + 8.f, min.z + 8.f } });
+            }
+
+            size_t hitsCount{ 0 };
+            FBenchmark::measure(std::to_string(queriesCount) + " box queries" + suffix, 3, [&]() {
+                hitsCount = 0;
+                for(const FBoundingBox& queryBox : queryBoxes) {
+                    hitsCount += hierarchy.queryBox(queryBox).size();
+                }
+            });
+            size_t bruteForceHitsCount{ 0 };
+            FBenchmark::measure(std::to_string(queriesCount) + " box queries by brute force" + suffix, 1, [&]() {
+                bruteForceHitsCount = 0;
+                for(const FBoundingBox& queryBox : queryBoxes) {
+                    bruteForceHitsCount += std::count_if(boxes.cbegin(), boxes.cend(), [&queryBox](const auto& box) {
+                        return areBoxesOverlapping(queryBox, box);
+                    });
+                }
+            });
+            FBenchmark::check(hitsCount == bruteForceHitsCount,
+                              "box queries should find every overlapping box" + suffix);
+
+            FBenchmark::measure(std::to_string(queriesCount) + " sphere queries" + suffix, 3, [&]() {
+                hitsCount = 0;
+                for(const FBoundingBox& queryBox : queryBoxes) {
+                    hitsCount += hierarchy.querySphere(queryBox.max, 4.f).size();
+                }
+            });
+            FBenchmark::check(hitsCount != 0, "sphere queries should hit some boxes" + suffix);
+
+            FBenchmark::measure(std::to_string(queriesCount) + " ray queries" + suffix, 3, [&]() {
+                hitsCount = 0;
+                for(const FBoundingBox& queryBox : queryBoxes) {
+                    const maths::vec3 direction{ queryBox.max.x - queryBox.min.x, 1.f, -1.f };
+                    hitsCount += hierarchy.queryRay(queryBox.min, direction, sceneSize).size();
+                }
+            });
+            FBenchmark::check(hitsCount != 0, "ray queries should hit some boxes" + suffix);
+
+            // Camera at corner of scene looks at its center, so frustum holds big part of it
+            const maths::mat4 viewProjection{
+                maths::mat4::perspective(maths::trig::toRadians(45.f), 4.f / 3.f, 0.1f, sceneSize) *
+                maths::mat4::lookAt({ 0.f, 0.f, 0.f }, { sceneSize, sceneSize, sceneSize }, { 0.f, 1.f, 0.f }) };
+            FBenchmark::measure("frustum query" + suffix, 3, [&]() {
+                hitsCount = hierarchy.queryFrustum(viewProjection).size();
+            });
+            const std::array<maths::vec4, 6> planes{ FFrustumCuller::computePlanes(viewProjection) };
+            bruteForceHitsCount = std::count_if(boxes.cbegin(), boxes.cend(), [&planes](const FBoundingBox& box) {
+                return isBoxInsideFrustum(planes, box);
+            });
+            FBenchmark::check(hitsCount == bruteForceHitsCount,
+                              "frustum query should find every box inside frustum" + suffix);
+        }
+    }
+
+
+    void createRandomBoxes(uint32 count, float sceneSize, std::mt19937& randomEngine,
+                           std::vector<entt::entity>& entities, std::vector<FBoundingBox>& boxes) {
+        std::uniform_real_distribution<float> positionDistribution{ 0.f, sceneSize };
+        std::uniform_real_distribution<float> sizeDistribution{ 0.5f, 2.f };
+        entities.reserve(count);
+        boxes.reserve(count);
+        for(uint32 i = 0; i < count; i++) {
+            const maths::vec3 min{ positionDistribution(randomEngine), positionDistribution(randomEngine),
+                                   positionDistribution(randomEngine) };
+            const float size{ sizeDistribution(randomEngine) };
+            entities.push_back((entt::entity)i);
+            boxes.push_back({ min, { min.x + size, min.y + size, min.z + size } });
+        }
+    }
+
+    bool areBoxesOverlapping(const FBoundingBox& lhs, const FBoundingBox& rhs) {
+        return lhs.min.x <= rhs.max.x && rhs.min.x <= lhs.max.x
+            && lhs.min.y <= rhs.max.y && rhs.min.y <= lhs.max.y
+            && lhs.min.z <= rhs.max.z && rhs.min.z <= lhs.max.z;
+    }
+
+    bool isBoxInsideFrustum(const std::array<maths::vec4, 6>& planes, const FBoundingBox& box) {
+        // Box is outside, when its center is behind some plane further than box reaches towards it
+        const maths::vec3 center{ (box.min.x + box.max.x) * 0.5f, (box.min.y + box.max.y) * 0.5f,
+                                  (box.min.z + box.max.z) * 0.5f };
+        const maths::vec3 extent{ (box.max.x - box.min.x) * 0.5f, (box.max.y - box.min.y) * 0.5f,
+                                  (box.max.z - box.min.z) * 0.5f };
+        for(const maths::vec4& plane : planes) {
+            const float distance{ plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w };
+            const float reach{ std::abs(plane.x) * extent.x + std::abs(plane.y) * extent.y +
+                               std::abs(plane.z) * extent.z };
+            if(distance + reach < 0.f) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+
+}
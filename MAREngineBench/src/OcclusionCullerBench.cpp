@@ -0,0 +1,273 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+#include "Benchmark.h"
+#include "Core/graphics/public/OcclusionCuller.h"
+
+
+namespace marengine {
+
+
+    static maths::mat4 getViewProjection();
+
+    static void createWall(float halfSize, FVertexArray& vertices, FIndicesArray& indices);
+
+    static FMeshBounds getUnitCubeBounds();
+
+    static float computeDepth(const maths::mat4& viewProjection, const maths::vec3& point);
+
+
+    MAR_BENCHMARK(OcclusionCullerEmptyBuffer) {
+        FOcclusionCuller occlusionCuller;
+        occlusionCuller.begin(getViewProjection());
+        occlusionCuller.buildHierarchy();
+
+        const std::vector<float>& depth{ occlusionCuller.getDepth() };
+        FBenchmark::check(depth.size() == occlusionCuller.getWidth() * occlusionCuller.getHeight(),
+                          "depth buffer should have one texel per pixel");
+        FBenchmark::check(std::all_of(depth.cbegin(), depth.cend(), [](float d) { return d == 1.f; }),
+                          "empty depth buffer should be cleared to far plane");
+        FBenchmark::check(!occlusionCuller.isOccluded(getUnitCubeBounds(), maths::mat4::translation({ 0.f, 0.f, 0.f })),
+                          "nothing should be occluded without occluders");
+    }
+
+    MAR_BENCHMARK(OcclusionCullerWall) {
+        // Camera looks from z = 10 at wall at z = 0, that covers whole screen
+        const maths::mat4 viewProjection{ getViewProjection() };
+        FVertexArray vertices;
+        FIndicesArray indices;
+        createWall(50.f, vertices, indices);
+
+        FOcclusionCuller occlusionCuller;
+        occlusionCuller.begin(viewProjection);
+        occlusionCuller.rasterize(vertices, indices, maths::mat4::translation({ 0.f, 0.f, 0.f }));
+        occlusionCuller.buildHierarchy();
+
+        const std::vector<float>& depth{ occlusionCuller.getDepth() };
+        const uint32 centerPixel{ (occlusionCuller.getHeight() / 2) * occlusionCuller.getWidth() +
+                                  occlusionCuller.getWidth() / 2 };
+        const float wallDepth{ computeDepth(viewProjection, { 0.f, 0.f, 0.f }) };
+        FBenchmark::check(std::abs(depth[centerPixel] - wallDepth) < 1e-4f,
+                          "rasterized depth should be NDC depth of wall, expected " + std::to_string(wallDepth) +
+                          " got " + std::to_string(depth[centerPixel]));
+
+        const FMeshBounds cube{ getUnitCubeBounds() };
+        FBenchmark::check(occlusionCuller.isOccluded(cube, maths::mat4::translation({ 0.f, 0.f, -5.f })),
+                          "cube behind wall should be occluded");
+        FBenchmark::check(!occlusionCuller.isOccluded(cube, maths::mat4::translation({ 0.f, 0.f, 5.f })),
+                          "cube in front of wall should not be occluded");
+        FBenchmark::check(!occlusionCuller.isOccluded(cube, maths::mat4::translation({ 0.f, 0.f, 0.f })),
+                          "cube crossing wall should not be occluded");
+        FBenchmark::check(!occlusionCuller.isOccluded(cube, maths::mat4::translation({ 0.f, 0.f, 12.f })),
+                          "cube behind camera should not be occluded");
+    }
+
+    MAR_BENCHMARK(OcclusionCullerPartialWall) {
+        // Wall covers only center of screen, so box reaching past its edge stays visible
+        const maths::mat4 viewProjection{ getViewProjection() };
+        FVertexArray vertices;
+        FIndicesArray indices;
+        createWall(2.f, vertices, indices);
+
+        FOcclusionCuller occlusionCuller;
+        occlusionCuller.begin(viewProjection);
+        occlusionCuller.rasterize(vertices, indices, maths::mat4::translation({ 0.f, 0.f, 0.f }));
+        occlusionCuller.buildHierarchy();
+
+        const std::vector<float>& depth{ occlusionCuller.getDepth() };
+        FBenchmark::check(depth.front() == 1.f, "pixels outside of wall should stay at far plane");
+
+        const FMeshBounds cube{ getUnitCubeBounds() };
+        FBenchmark::check(occlusionCuller.isOccluded(cube, maths::mat4::translation({ 0.f, 0.f, -1.5f })),
+                          "small cube right behind wall should be occluded");
+        FBenchmark::check(!occlusionCuller.isOccluded(cube, maths::mat4::translation({ 2.5f, 0.f, -1.5f })),
+                          "cube reaching past edge of wall should not be occluded");
+        const maths::mat4 farBigCube{ maths::mat4::translation({ 0.f, 0.f, -30.f }) *
+                                      maths::mat4::scale({ 20.f, 20.f, 20.f }) };
+        FBenchmark::check(!occlusionCuller.isOccluded(cube, farBigCube),
+                          "far cube bigger on screen than wall should not be occluded");
+        FBenchmark::check(occlusionCuller.isOccluded(cube, maths::mat4::translation({ 0.f, 0.f, -30.f })),
+                          "far cube smaller on screen than wall should be occluded");
+    }
+
+    MAR_BENCHMARK(OcclusionCullerNearPlane) {
+        // Floor below camera reaches behind it, so its triangles crossing near plane are skipped and must not
+        // occlude anything
+        const maths::mat4 viewProjection{ getViewProjection() };
+        FVertexArray vertices;
+        FIndicesArray indices;
+        createWall(50.f, vertices, indices);
+        const maths::mat4 floorTransform{ maths::mat4::translation({ 0.f, -1.f, 0.f }) *
+                                          maths::mat4::rotation(maths::trig::toRadians(90.f), { 1.f, 0.f, 0.f }) };
+
+        FOcclusionCuller occlusionCuller;
+        occlusionCuller.begin(viewProjection);
+        occlusionCuller.rasterize(vertices, indices, floorTransform);
+        occlusionCuller.buildHierarchy();
+
+        const std::vector<float>& depth{ occlusionCuller.getDepth() };
+        FBenchmark::check(std::all_of(depth.cbegin(), depth.cend(), [](float d) { return d == 1.f; }),
+                          "floor crossing near plane should not be rasterized");
+        const maths::mat4 underFloor{ maths::mat4::translation({ 0.f, -3.f, -5.f }) };
+        FBenchmark::check(!occlusionCuller.isOccluded(getUnitCubeBounds(), underFloor),
+                          "nothing should be occluded by skipped floor");
+    }
+
+    MAR_BENCHMARK(OcclusionCullerThroughput) {
+        constexpr uint32 occludersCount{ 64 };
+        constexpr uint32 testedCount{ 10000 };
+        const maths::mat4 viewProjection{ getViewProjection() };
+        FVertexArray vertices;
+        FIndicesArray indices;
+        createWall(1.f, vertices, indices);
+
+        std::mt19937 randomEngine{ testedCount };
+        std::uniform_real_distribution<float> screenDistribution{ -6.f, 6.f };
+        std::uniform_real_distribution<float> depthDistribution{ -40.f, 0.f };
+        std::vector<maths::mat4> occluders;
+        for(uint32 i = 0; i < occludersCount; i++) {
+            occluders.push_back(maths::mat4::translation({ screenDistribution(randomEngine),
+                                                           screenDistribution(randomEngine), 2.f }));
+        }
+        std::vector<maths::mat4> tested;
+        for(uint32 i = 0; i < testedCount; i++) {
+            tested.push_back(maths::mat4::translation({ screenDistribution(randomEngine),
+                                                        screenDistribution(randomEngine),
+                                                        depthDistribution(randomEngine) }));
+        }
+
+        FOcclusionCuller occlusionCuller;
+        FBenchmark::measure("rasterize " + std::to_string(occludersCount) + " occluders and build hierarchy", 5,
+                            [&]() {
+            occlusionCuller.begin(viewProjection);
+            for(const maths::mat4& occluder : occluders) {
+                occlusionCuller.rasterize(vertices, indices, occluder);
+            }
+            occlusionCuller.buildHierarchy();
+        });
+
+        const FMeshBounds cube{ getUnitCubeBounds() };
+        uint32 occludedCount{ 0 };
+        FBenchmark::measure("test " + std::to_string(testedCount) + " bounds", 5, [&]() {
+            occludedCount = 0;
+            for(const maths::mat4& transform : tested) {
+                occludedCount += occlusionCuller.isOccluded(cube, transform) ? 1 : 0;
+            }
+        });
+        FBenchmark::check(occludedCount != 0 && occludedCount != testedCount,
+                          "some of tested bounds should be occluded, occluded: " + std::to_string(occludedCount));
+    }
+
+    MAR_BENCHMARK(OcclusionCullerKernels) {
+        constexpr uint32 occludersCount{ 256 };
+        constexpr uint32 testedCount{ 10000 };
+        const maths::mat4 viewProjection{ getViewProjection() };
+        FVertexArray vertices;
+        FIndicesArray indices;
+        createWall(1.f, vertices, indices);
+
+        std::mt19937 randomEngine{ occludersCount };
+        std::uniform_real_distribution<float> screenDistribution{ -6.f, 6.f };
+        std::uniform_real_distribution<float> depthDistribution{ -40.f, 2.f };
+        std::vector<maths::mat4> occluders;
+        for(uint32 i = 0; i < occludersCount; i++) {
+            occluders.push_back(maths::mat4::translation({ screenDistribution(randomEngine),
+                                                           screenDistribution(randomEngine),
+                                                           depthDistribution(randomEngine) }));
+        }
+        std::vector<maths::mat4> tested;
+        for(uint32 i = 0; i < testedCount; i++) {
+            tested.push_back(maths::mat4::translation({ screenDistribution(randomEngine),
+                                                        screenDistribution(randomEngine),
+                                                        depthDistribution(randomEngine) }));
+        }
+
+        const FMeshBounds cube{ getUnitCubeBounds() };
+        auto rasterizeWith = [&](EOcclusionKernel kernel, FOcclusionCuller& occlusionCuller,
+                                 std::vector<bool>& occluded) {
+            FOcclusionCuller::passKernel(kernel);
+            const EOcclusionKernel usedKernel{ FOcclusionCuller::getKernel() };
+            FBenchmark::measure("rasterize " + std::to_string(occludersCount) + " occluders with " +
+                                FOcclusionCuller::getKernelName(usedKernel) + " kernel", 10, [&]() {
+                occlusionCuller.begin(viewProjection);
+                for(const maths::mat4& occluder : occluders) {
+                    occlusionCuller.rasterize(vertices, indices, occluder);
+                }
+                occlusionCuller.buildHierarchy();
+            });
+            occluded.clear();
+            for(const maths::mat4& transform : tested) {
+                occluded.push_back(occlusionCuller.isOccluded(cube, transform));
+            }
+            return usedKernel;
+        };
+
+        const EOcclusionKernel selectedKernel{ FOcclusionCuller::getKernel() };
+        FOcclusionCuller expectedCuller;
+        std::vector<bool> expectedOccluded;
+        rasterizeWith(EOcclusionKernel::SCALAR, expectedCuller, expectedOccluded);
+
+        // Kernel not supported by CPU falls back to narrower one, so name of the one actually used is printed
+        for(const EOcclusionKernel kernel : { EOcclusionKernel::SSE41, EOcclusionKernel::AVX2 }) {
+            FOcclusionCuller occlusionCuller;
+            std::vector<bool> occluded;
+            const EOcclusionKernel usedKernel{ rasterizeWith(kernel, occlusionCuller, occluded) };
+            const std::string kernelName{ FOcclusionCuller::getKernelName(usedKernel) };
+            FBenchmark::check(occlusionCuller.getDepth() == expectedCuller.getDepth(),
+                              kernelName + " kernel should rasterize the same depth as scalar one");
+            FBenchmark::check(occluded == expectedOccluded,
+                              kernelName + " kernel hierarchy should occlude the same bounds as scalar one");
+        }
+        FOcclusionCuller::passKernel(selectedKernel);
+    }
+
+
+    maths::mat4 getViewProjection() {
+        return maths::mat4::perspective(maths::trig::toRadians(45.f), 2.f, 0.1f, 100.f) *
+               maths::mat4::lookAt({ 0.f, 0.f, 10.f }, { 0.f, 0.f, 0.f }, { 0.f, 1.f, 0.f });
+    }
+
+    void createWall(float halfSize, FVertexArray& vertices, FIndicesArray& indices) {
+        vertices = {
+            { { -halfSize, -halfSize, 0.f }, { 0.f, 0.f, 1.f }, { 0.f, 0.f }, 0.f },
+            { {  halfSize, -halfSize, 0.f }, { 0.f, 0.f, 1.f }, { 1.f, 0.f }, 0.f },
+            { {  halfSize,  halfSize, 0.f }, { 0.f, 0.f, 1.f }, { 1.f, 1.f }, 0.f },
+            { { -halfSize,  halfSize, 0.f }, { 0.f, 0.f, 1.f }, { 0.f, 1.f }, 0.f }
+        };
+        indices = { 0, 1, 2, 2, 3, 0 };
+    }
+
+    FMeshBounds getUnitCubeBounds() {
+        FMeshBounds bounds;
+        bounds.boxMin = { -0.5f, -0.5f, -0.5f };
+        bounds.boxMax = { 0.5f, 0.5f, 0.5f };
+        bounds.sphereRadius = 0.87f;
+        return bounds;
+    }
+
+    float computeDepth(const maths::mat4& viewProjection, const maths::vec3& point) {
+        const float* m{ viewProjection.value_ptr() };
+        const float z{ m[2] * point.x + m[6] * point.y + m[10] * point.z + m[14] };
+        const float w{ m[3] * point.x + m[7] * point.y + m[11] * point.z + m[15] };
+        return z / w;
+    }
+
+
+}
@@ -0,0 +1,111 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+#include "Benchmark.h"
+#include "Core/ecs/Scene.h"
+
+
+namespace marengine {
+
+
+    static void createEntities(Scene& scene, uint32 count, std::vector<entt::entity>& enttEntities);
+
+
+    MAR_BENCHMARK(SceneDestroyEntitiesByHandle) {
+        // Destroying costs O(1) at registry and O(log n) at bounding volumes, so time grows almost linearly
+        // with count of entities (searching array of entities made it quadratic)
+        for(const uint32 fullCount : { 10000u, 20000u, 40000u }) {
+            const uint32 count{ FBenchmark::getCount(fullCount) };
+            Scene scene("DestroyBenchmark");
+            std::vector<entt::entity> enttEntities;
+            createEntities(scene, count, enttEntities);
+
+            std::mt19937 randomEngine{ count };
+            std::shuffle(enttEntities.begin(), enttEntities.end(), randomEngine);
+            // Entity kept by caller (editor keeps inspected one and created child) must survive other destructions
+            const Entity keptEntity(enttEntities.back(), scene.getRegistry());
+            enttEntities.pop_back();
+
+            FBenchmark::measure("destroy " + std::to_string(count - 1) + " entities in random order", 1,
+                                [&scene, &enttEntities]() {
+                for(const entt::entity enttEntity : enttEntities) {
+                    scene.destroyEntity(Entity(enttEntity, scene.getRegistry()));
+                }
+            });
+
+            FBenchmark::check(scene.getEntitiesCount() == 1, "only kept entity should stay at scene");
+            FBenchmark::check(keptEntity.isValid(), "kept entity should stay valid");
+            const FBoundingBox sceneBox{ { -2.f, -2.f, -2.f }, { (float)count * 4.f, 2.f, 2.f } };
+            FBenchmark::check(scene.queryBox(sceneBox).size() == 1,
+                              "destroyed entities should be removed from bounding volumes");
+            scene.close();
+        }
+    }
+
+    MAR_BENCHMARK(SceneDestroyEntitiesWithChildren) {
+        const uint32 parentsCount{ FBenchmark::getCount(1000) };
+        constexpr uint32 childrenCount{ 10 };
+        Scene scene("DestroyChildrenBenchmark");
+        std::vector<Entity> parents;
+        for(uint32 i = 0; i < parentsCount; i++) {
+            const Entity parent{ scene.createEntity() };
+            for(uint32 j = 0; j < childrenCount; j++) {
+                parent.assignChild(scene.createEntity());
+            }
+            parents.push_back(parent);
+        }
+
+        FBenchmark::measure("destroy " + std::to_string(parentsCount) + " parents with " +
+                            std::to_string(childrenCount) + " children each", 1, [&scene, &parents]() {
+            for(const Entity& parent : parents) {
+                scene.destroyEntity(parent);
+            }
+        });
+
+        const size_t expectedCount{ parentsCount * childrenCount };
+        FBenchmark::check(scene.getEntitiesCount() == expectedCount, "children should outlive their parents");
+        bool areChildrenDetached{ true };
+        for(const Entity& entity : scene.getEntities()) {
+            areChildrenDetached = areChildrenDetached && !entity.hasParent();
+        }
+        FBenchmark::check(areChildrenDetached, "children of destroyed parents should become roots");
+        scene.close();
+    }
+
+
+    void createEntities(Scene& scene, uint32 count, std::vector<entt::entity>& enttEntities) {
+        for(uint32 i = 0; i < count; i++) {
+            (void)scene.createEntity();
+        }
+
+        // Every entity gets separate box, so that bounding volumes have to be updated at every destruction
+        std::vector<FBoundingBox> boxes;
+        enttEntities.reserve(count);
+        boxes.reserve(count);
+        for(const entt::entity enttEntity : scene.getView<CTag>()) {
+            const float position{ (float)enttEntities.size() * 4.f };
+            enttEntities.push_back(enttEntity);
+            boxes.push_back({ { position - 1.f, -1.f, -1.f }, { position + 1.f, 1.f, 1.f } });
+        }
+        scene.buildBoundingVolumes(enttEntities, boxes);
+    }
+
+
+}
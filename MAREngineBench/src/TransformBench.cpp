@@ -0,0 +1,195 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+#include "Benchmark.h"
+#include "Core/ecs/Scene.h"
+#include "Core/ecs/TransformSystem.h"
+
+
+namespace marengine {
+
+
+    static void createChain(Scene& scene, uint32 depth, std::vector<Entity>& roots, std::vector<Entity>& leaves);
+
+    static void createFan(Scene& scene, uint32 childrenCount, std::vector<Entity>& roots, std::vector<Entity>& leaves);
+
+    static void measurePropagation(Scene& scene, const std::string& shape, const std::vector<Entity>& roots,
+                                   const std::vector<Entity>& leaves, float expectedLeafX);
+
+    static float computeMaxRelativeError(const std::vector<maths::mat4>& expected,
+                                         const std::vector<maths::mat4>& composed);
+
+
+    MAR_BENCHMARK(TransformHierarchyDeep) {
+        constexpr uint32 chainsCount{ 100 };
+        const uint32 depth{ FBenchmark::getCount(1000) };
+        Scene scene("DeepHierarchyBenchmark");
+        std::vector<Entity> roots;
+        std::vector<Entity> leaves;
+        for(uint32 i = 0; i < chainsCount; i++) {
+            createChain(scene, depth, roots, leaves);
+        }
+        // Every child is moved by 1 at x from its parent, so leaf ends up at x of root + depth - 1
+        measurePropagation(scene, std::to_string(chainsCount) + " chains " + std::to_string(depth) + " deep",
+                           roots, leaves, (float)(depth - 1));
+        scene.close();
+    }
+
+    MAR_BENCHMARK(TransformHierarchyWide) {
+        constexpr uint32 fansCount{ 100 };
+        const uint32 childrenCount{ FBenchmark::getCount(1000) };
+        Scene scene("WideHierarchyBenchmark");
+        std::vector<Entity> roots;
+        std::vector<Entity> leaves;
+        for(uint32 i = 0; i < fansCount; i++) {
+            createFan(scene, childrenCount, roots, leaves);
+        }
+        measurePropagation(scene, std::to_string(fansCount) + " roots with " + std::to_string(childrenCount) +
+                           " children", roots, leaves, 1.f);
+        scene.close();
+    }
+
+    MAR_BENCHMARK(TransformComposerKernels) {
+        const size_t count{ FBenchmark::getCount(100000) };
+        std::mt19937 randomEngine{ (uint32)count };
+        std::uniform_real_distribution<float> positionDistribution{ -400.f, 400.f };
+        std::uniform_real_distribution<float> rotationDistribution{ -360.f, 360.f };
+        std::uniform_real_distribution<float> scaleDistribution{ 0.1f, 4.f };
+        FTransformsSoA transforms;
+        transforms.reserve(count);
+        for(size_t i = 0; i < count; i++) {
+            CTransform cTransform;
+            cTransform.position = { positionDistribution(randomEngine), positionDistribution(randomEngine),
+                                    positionDistribution(randomEngine) };
+            cTransform.rotation = { rotationDistribution(randomEngine), rotationDistribution(randomEngine),
+                                    rotationDistribution(randomEngine) };
+            cTransform.scale = { scaleDistribution(randomEngine), scaleDistribution(randomEngine),
+                                 scaleDistribution(randomEngine) };
+            transforms.push(cTransform);
+        }
+
+        const ETransformKernel selectedKernel{ FTransformComposer::getKernel() };
+        std::vector<maths::mat4> expected(count);
+        FTransformComposer::passKernel(ETransformKernel::SCALAR);
+        FBenchmark::measure("compose " + std::to_string(count) + " transforms with Scalar kernel", 10, [&]() {
+            FTransformComposer::compose(transforms, expected.data());
+        });
+
+        // Kernel not supported by CPU falls back to narrower one, so name of the one actually used is printed
+        for(const ETransformKernel kernel : { ETransformKernel::SSE41, ETransformKernel::AVX2 }) {
+            FTransformComposer::passKernel(kernel);
+            const ETransformKernel usedKernel{ FTransformComposer::getKernel() };
+            std::vector<maths::mat4> composed(count);
+            FBenchmark::measure("compose " + std::to_string(count) + " transforms with " +
+                                FTransformComposer::getKernelName(usedKernel) + " kernel", 10, [&]() {
+                FTransformComposer::compose(transforms, composed.data());
+            });
+            const float maxError{ computeMaxRelativeError(expected, composed) };
+            FBenchmark::check(maxError < 1e-3f, std::string{ FTransformComposer::getKernelName(usedKernel) } +
+                              " kernel should match scalar one, max relative error: " + std::to_string(maxError));
+        }
+        FTransformComposer::passKernel(selectedKernel);
+    }
+
+
+    void createChain(Scene& scene, uint32 depth, std::vector<Entity>& roots, std::vector<Entity>& leaves) {
+        Entity parent{ scene.createEntity() };
+        roots.push_back(parent);
+        for(uint32 i = 1; i < depth; i++) {
+            const Entity child{ scene.createEntity() };
+            auto& cTransform{ child.getComponent<CTransform>() };
+            cTransform.position = { 1.f, 0.f, 0.f };
+            FTransformSystem::markDirty(child);
+            parent.assignChild(child);
+            parent = child;
+        }
+        leaves.push_back(parent);
+    }
+
+    void createFan(Scene& scene, uint32 childrenCount, std::vector<Entity>& roots, std::vector<Entity>& leaves) {
+        const Entity root{ scene.createEntity() };
+        roots.push_back(root);
+        for(uint32 i = 0; i < childrenCount; i++) {
+            const Entity child{ scene.createEntity() };
+            auto& cTransform{ child.getComponent<CTransform>() };
+            cTransform.position = { 1.f, (float)i, 0.f };
+            FTransformSystem::markDirty(child);
+            root.assignChild(child);
+            leaves.push_back(child);
+        }
+    }
+
+    void measurePropagation(Scene& scene, const std::string& shape, const std::vector<Entity>& roots,
+                            const std::vector<Entity>& leaves, float expectedLeafX) {
+        const size_t entitiesCount{ scene.getEntitiesCount() };
+        // Roots are composed already at creation, so they are marked dirty to compose whole hierarchy
+        for(const Entity& root : roots) {
+            FTransformSystem::markDirty(root);
+        }
+        size_t composedCount{ 0 };
+        FBenchmark::measure("compose all of " + shape, 1, [&scene, &composedCount]() {
+            composedCount = FTransformSystem::update(&scene).size();
+        });
+        FBenchmark::check(composedCount == entitiesCount, "every transform should be composed at first update");
+
+        // Moving root recomposes its whole subtree
+        float rootX{ 0.f };
+        FBenchmark::measure("move roots of " + shape, 3, [&]() {
+            rootX += 1.f;
+            for(const Entity& root : roots) {
+                auto& cTransform{ root.getComponent<CTransform>() };
+                cTransform.position.x = rootX;
+                FTransformSystem::markDirty(root);
+            }
+            composedCount = FTransformSystem::update(&scene).size();
+        });
+        FBenchmark::check(composedCount == entitiesCount, "moving roots should recompose every descendant");
+        auto isLeafMoved = [rootX, expectedLeafX](const Entity& leaf) {
+            return leaf.getComponent<CTransform>().getWorldPosition().x == rootX + expectedLeafX;
+        };
+        const bool areLeavesMoved{ std::all_of(leaves.cbegin(), leaves.cend(), isLeafMoved) };
+        FBenchmark::check(areLeavesMoved, "leaves should follow their roots");
+
+        // Moving leaves touches nothing else
+        FBenchmark::measure("move leaves of " + shape, 3, [&]() {
+            for(const Entity& leaf : leaves) {
+                FTransformSystem::markDirty(leaf);
+            }
+            composedCount = FTransformSystem::update(&scene).size();
+        });
+        FBenchmark::check(composedCount == leaves.size(), "moving leaves should recompose only leaves");
+        FBenchmark::check(FTransformSystem::update(&scene).empty(), "clean hierarchy should not be recomposed");
+    }
+
+    float computeMaxRelativeError(const std::vector<maths::mat4>& expected, const std::vector<maths::mat4>& composed) {
+        float maxError{ 0.f };
+        for(size_t i = 0; i < expected.size(); i++) {
+            const float* pExpected{ expected[i].value_ptr() };
+            const float* pComposed{ composed[i].value_ptr() };
+            for(size_t k = 0; k < 16; k++) {
+                const float error{ std::abs(pExpected[k] - pComposed[k]) / std::max(1.f, std::abs(pExpected[k])) };
+                maxError = std::max(maxError, error);
+            }
+        }
+        return maxError;
+    }
+
+
+}
@@ -0,0 +1,143 @@
+/***********************************************************************
+* @internal @copyright
+*
+*  				MAREngine - open source 3D game engine
+*
+* Copyright (C) 2020-present Mateusz Rzeczyca <info@mateuszrzeczyca.pl>
+* All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+************************************************************************/
+#include "Benchmark.h"
+#include "Core/graphics/public/VertexFormat.h"
+#include "Core/graphics/public/Buffer.h"
+#include "Core/graphics/public/MeshManager.h"
+#include "Core/graphics/public/Mesh.h"
+#include "Core/graphics/public/MeshBatch.h"
+
+
+namespace marengine {
+
+
+    /// @brief Vertex buffer kept at CPU memory, it counts uploaded bytes instead of talking to GPU
+    class FVertexBufferMemory : public FVertexBuffer {
+    public:
+
+        void create(int64 memoryToAllocate) final { m_memory.resize(memoryToAllocate); }
+        void free() final { }
+        void destroy() final { m_memory.clear(); }
+        void bind() const final { }
+
+        void update(const float* data, uint32 offset, uint32 sizeOfData) const final {
+            copy(data, offset, sizeOfData);
+        }
+        void update(const uint32* data, uint32 offset, uint32 sizeOfData) const final {
+            copy(data, offset, sizeOfData);
+        }
+        void update(const int32* data, uint32 offset, uint32 sizeOfData) const final {
+            copy(data, offset, sizeOfData);
+        }
+        void update(const FVertexArray& vertices) const final {
+            copy(vertices.data(), 0, vertices.size() * sizeof(Vertex));
+        }
+
+        MAR_NO_DISCARD const std::vector<uint8_t>& getMemory() const { return m_memory; }
+        MAR_NO_DISCARD uint64 getUploadedBytes() const { return m_uploadedBytes; }
+        void resetUploadedBytes() { m_uploadedBytes = 0; }
+
+    private:
+
+        void copy(const void* data, uint32 offset, uint32 sizeOfData) const {
+            if(m_memory.size() < (size_t)offset + sizeOfData) {
+                m_memory.resize((size_t)offset + sizeOfData);
+            }
+            std::memcpy(m_memory.data() + offset, data, sizeOfData);
+            m_uploadedBytes += sizeOfData;
+        }
+
+        mutable std::vector<uint8_t> m_memory;
+        mutable uint64 m_uploadedBytes{ 0 };
+
+    };
+
+
+    static FVertexArray createMeshSet(const FMeshStorage* pMeshStorage, uint32 verticesCount);
+
+
+    MAR_BENCHMARK(VertexFormatUpload) {
+        const uint32 verticesCount{ FBenchmark::getCount(1000000) };
+        constexpr uint32 repeatsCount{ 5 };
+        FMeshManager meshManager;
+        const FVertexArray vertices{ createMeshSet(meshManager.getStorage(), verticesCount) };
+
+        uint64 floatBytes{ 0 };
+        uint64 packedBytes{ 0 };
+        for(const EVertexFormat format : { EVertexFormat::FLOAT, EVertexFormat::PACKED }) {
+            const bool isPacked{ format == EVertexFormat::PACKED };
+            const std::string label{ isPacked ? "packed" : "float" };
+            FVertexBufferMemory vertexBuffer;
+            vertexBuffer.create((int64)verticesCount * FVertexFormat::getStride(format));
+
+            const float time{ FBenchmark::measure("upload " + std::to_string(verticesCount) + " " + label +
+                                                  " vertices", repeatsCount, [&vertexBuffer, &vertices, format]() {
+                FVertexFormat::update(&vertexBuffer, format, vertices, 0, (uint32)vertices.size(), 0);
+            }) };
+            const uint64 uploadedBytes{ vertexBuffer.getUploadedBytes() / repeatsCount };
+            FBenchmark::report(label + " uploaded bytes", (double)uploadedBytes, "B");
+            FBenchmark::report(label + " vertices per second", verticesCount / (time / 1000.f), "vertices/s");
+            (isPacked ? packedBytes : floatBytes) = uploadedBytes;
+
+            // Buffer must hold exactly what the pipeline's vertex layout expects
+            bool isUploadCorrect{ true };
+            for(uint32 i = 0; i < verticesCount; i += 997) {
+                const size_t uploadedOffset{ (size_t)i * FVertexFormat::getStride(format) };
+                const uint8_t* pUploaded{ vertexBuffer.getMemory().data() + uploadedOffset };
+                if(isPacked) {
+                    const VertexPacked expected{ FVertexFormat::pack(vertices[i]) };
+                    isUploadCorrect &= std::memcmp(pUploaded, &expected, sizeof(VertexPacked)) == 0;
+                }
+                else {
+                    isUploadCorrect &= std::memcmp(pUploaded, &vertices[i], sizeof(Vertex)) == 0;
+                }
+            }
+            FBenchmark::check(isUploadCorrect, label + ": uploaded vertices should match source mesh set");
+        }
+
+        FBenchmark::check(packedBytes * sizeof(Vertex) == floatBytes * sizeof(VertexPacked),
+                          "packed upload should be " + std::to_string(sizeof(VertexPacked)) + "/" +
+                          std::to_string(sizeof(Vertex)) + " of float upload, got " + std::to_string(packedBytes) +
+                          " and " + std::to_string(floatBytes) + " bytes");
+    }
+
+
+    FVertexArray createMeshSet(const FMeshStorage* pMeshStorage, uint32 verticesCount) {
+        // Default meshes are repeated like at batch, every copy gets its own shapeID
+        const std::array<const FMeshProxy*, 3> meshes{
+            pMeshStorage->getCube(), pMeshStorage->getPyramid(), pMeshStorage->getSurface()
+        };
+        FVertexArray vertices;
+        vertices.reserve(verticesCount);
+        for(uint32 copy = 0; vertices.size() < verticesCount; copy++) {
+            for(const Vertex& vertex : meshes[copy % meshes.size()]->getVertices()) {
+                if(vertices.size() == verticesCount) {
+                    break;
+                }
+                Vertex& copiedVertex{ vertices.emplace_back(vertex) };
+                copiedVertex.shapeID = (float)(copy % FMeshBatchBudget::getEntitiesCount());
+            }
+        }
+        return vertices;
+    }
+
+
+}
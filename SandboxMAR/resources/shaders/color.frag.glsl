@@ -26,7 +26,7 @@ layout(std430, binding = 2) buffer PointLightSSBO {
 } PointLigts;
 
 layout(std430, binding = 3) buffer ColorsSSBO {
-	vec4 Color[32];
+	vec4 Color[];
 } Colors;
 
 vec4 computeAllLights(vec4 batchColor);
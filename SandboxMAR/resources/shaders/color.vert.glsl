@@ -1,5 +1,6 @@
 
 #version 450
+#extension GL_ARB_shader_draw_parameters : require
 
 layout(location = 0) in vec3 position;
 layout(location = 1) in vec3 lightNormal;
@@ -17,12 +18,13 @@ layout(std430, binding = 0) buffer CameraSSBO {
 } Camera;
 
 layout(std430, binding = 5) buffer TransformSSBO {
-	mat4 Transform[32];
+	mat4 Transform[];
 } Transforms;
 
 void main() {
 	// Calculate all transformations
-	int intShapeIndex = int(shapeIndex);
+	// Batches share transform buffer, baseInstance is the offset of current batch (0 for single draw)
+	int intShapeIndex = gl_BaseInstanceARB + int(shapeIndex);
 	vec4 vertexComputed = Transforms.Transform[intShapeIndex] * vec4(position, 1.f);
 	gl_Position = Camera.MVP * vertexComputed;
 
@@ -0,0 +1,37 @@
+
+#version 450
+#extension GL_ARB_shader_draw_parameters : require
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 lightNormal;
+layout(location = 2) in vec2 texCoord;
+layout(location = 3) in float shapeIndex; // unused, instance index is taken from gl_BaseInstanceARB + gl_InstanceID
+
+layout(location = 0) out vec3 v_Position;
+layout(location = 1) out vec3 v_lightNormal;
+layout(location = 2) out vec2 v_texCoords2D;
+layout(location = 4) out flat int v_shapeIndex;
+
+
+layout(std430, binding = 0) buffer CameraSSBO {
+	mat4 MVP;
+} Camera;
+
+layout(std430, binding = 5) buffer TransformSSBO {
+	mat4 Transform[];
+} Transforms;
+
+void main() {
+	// Calculate all transformations
+	// Visible instances are drawn in ranges, baseInstance is the first instance of current range
+	int intShapeIndex = gl_BaseInstanceARB + gl_InstanceID;
+	vec4 vertexComputed = Transforms.Transform[intShapeIndex] * vec4(position, 1.f);
+	gl_Position = Camera.MVP * vertexComputed;
+
+	// Pass values to fragment shader
+	v_Position = vertexComputed.xyz;
+	v_lightNormal = lightNormal;
+	v_texCoords2D = texCoord;
+	v_shapeIndex = intShapeIndex;
+	
+}
@@ -0,0 +1,46 @@
+
+#version 450
+#extension GL_ARB_shader_draw_parameters : require
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec2 packedNormal;
+layout(location = 2) in vec2 texCoord;
+layout(location = 3) in uint shapeIndex;
+
+layout(location = 0) out vec3 v_Position;
+layout(location = 1) out vec3 v_lightNormal;
+layout(location = 2) out vec2 v_texCoords2D;
+layout(location = 4) out flat int v_shapeIndex;
+
+
+layout(std430, binding = 0) buffer CameraSSBO {
+	mat4 MVP;
+} Camera;
+
+layout(std430, binding = 5) buffer TransformSSBO {
+	mat4 Transform[];
+} Transforms;
+
+// Octahedral encoded normal, lower hemisphere is folded over diagonals
+vec3 decodeNormal(vec2 encoded) {
+	vec3 n = vec3(encoded.xy, 1.f - abs(encoded.x) - abs(encoded.y));
+	float t = max(-n.z, 0.f);
+	n.x += n.x >= 0.f ? -t : t;
+	n.y += n.y >= 0.f ? -t : t;
+	return normalize(n);
+}
+
+void main() {
+	// Calculate all transformations
+	// Batches share transform buffer, baseInstance is the offset of current batch (0 for single draw)
+	int intShapeIndex = gl_BaseInstanceARB + int(shapeIndex);
+	vec4 vertexComputed = Transforms.Transform[intShapeIndex] * vec4(position, 1.f);
+	gl_Position = Camera.MVP * vertexComputed;
+
+	// Pass values to fragment shader
+	v_Position = vertexComputed.xyz;
+	v_lightNormal = decodeNormal(packedNormal);
+	v_texCoords2D = texCoord;
+	v_shapeIndex = intShapeIndex;
+	
+}
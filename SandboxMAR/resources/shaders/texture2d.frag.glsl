@@ -25,12 +25,25 @@ layout(std430, binding = 2) buffer PointLightSSBO {
 	int LightMaterialSize;
 } PointLigts;
 
-layout(binding = 4) uniform sampler2D samplerTexture2D[32];
+// uvRect - offset (xy) and scale (zw) of texture region at atlas page, identity for not atlased textures
+// index - x is sampler of texture array bound at batch, y is layer at that array
+struct TextureRef {
+	vec4 uvRect;
+	ivec2 index;
+};
+
+layout(std430, binding = 6) buffer TextureIndexSSBO {
+	TextureRef TextureIndex[];
+} TextureIndexes;
+
+layout(binding = 4) uniform sampler2DArray samplerTexture2DArray[32];
 
 vec4 computeAllLights(vec4 batchColor);
 
 void main() {
-	vec4 batchColor = texture(samplerTexture2D[v_shapeIndex], v_texCoords2D);
+	TextureRef textureRef = TextureIndexes.TextureIndex[v_shapeIndex];
+	vec2 texCoords = textureRef.uvRect.xy + clamp(v_texCoords2D, 0.0f, 1.0f) * textureRef.uvRect.zw;
+	vec4 batchColor = texture(samplerTexture2DArray[textureRef.index.x], vec3(texCoords, float(textureRef.index.y)));
 	vec4 lightColor = computeAllLights(batchColor);
 
 	outColor = batchColor * lightColor;